@@ -5,24 +5,12 @@
  * SSE2-safe on CPUs/firmware that can't execute AVX2.
  */
 
-#include <efi.h>
-#include <efilib.h>
+#include "djiblas.h"
+#include "djiblas_vmath.h"
 
 #if defined(__x86_64__) || defined(_M_X64)
 #include <immintrin.h>
 
-static inline float hsum256_ps(__m256 v) {
-    __m128 lo = _mm256_castps256_ps128(v);
-    __m128 hi = _mm256_extractf128_ps(v, 1);
-    lo = _mm_add_ps(lo, hi);
-    // horizontal sum of __m128
-    __m128 shuf = _mm_movehdup_ps(lo);
-    __m128 sums = _mm_add_ps(lo, shuf);
-    shuf = _mm_movehl_ps(shuf, sums);
-    sums = _mm_add_ss(sums, shuf);
-    return _mm_cvtss_f32(sums);
-}
-
 float llmk_dot_f32_avx2(const float *a, const float *b, int n) {
     __m256 sum = _mm256_setzero_ps();
     int i = 0;
@@ -35,7 +23,7 @@ float llmk_dot_f32_avx2(const float *a, const float *b, int n) {
         sum = _mm256_add_ps(sum, _mm256_mul_ps(va, vb));
 #endif
     }
-    float total = hsum256_ps(sum);
+    float total = djiblas_hsum256_ps(sum);
     for (; i < n; i++) total += a[i] * b[i];
     return total;
 }
@@ -5,6 +5,17 @@ Made in Senegal 🇸🇳 by Djiby Diop
 
 Usage:
     python convert_to_djibquant.py stories110M.bin stories110M.djibq
+    python convert_to_djibquant.py --format q8 stories110M.bin stories110M.djibq
+
+Formats:
+    q6 (default)  DjibQuant Q6 v2, every tensor quantized (groups of 64),
+                  4 values packed in 3 bytes
+    q6-v1         DjibQuant Q6 v1, one int8 per value (older builds)
+    q8            Q8_0 matrices (int8, one scale per 32), fp32 norm weights,
+                  wcls only when the model has its own classifier
+    q4            Q4 matrices (4-bit, one fp16 scale per 32), otherwise as q8
+    q4-f32        Q4 with fp32 scales
+    f16 / bf16    half-precision matrices (no scales), otherwise as q8
     
 Benefits:
     - 25% smaller than Q8 (6-bit vs 8-bit)
@@ -20,9 +31,23 @@ from pathlib import Path
 
 # DjibQuant constants
 DJIBQUANT_MAGIC = 0xD31B0006  # Must match djibquant.h
-DJIBQUANT_VERSION = 1
+DJIBQUANT_VERSION = 2              # v2: Q6 values packed 4 per 3 bytes
+DJIBQUANT_VERSION_UNPACKED = 1     # v1: one int8 per Q6 value
 DJIBQUANT_GROUP_SIZE = 64
 
+# Other tensor record types (djibquant.h)
+DJIBQUANT_MAGIC_Q8 = 0xD31B0008
+DJIBQUANT_MAGIC_F32 = 0xD31B0032
+DJIBQUANT_MAGIC_Q4 = 0xD31B0004
+DJIBQUANT_MAGIC_F16 = 0xD31B0016
+DJIBQUANT_MAGIC_BF16 = 0xD31B00BF
+DJIBQUANT_Q8_GROUP_SIZE = 32
+DJIBQUANT_Q4_GROUP_SIZE = 32
+DJIBQUANT_SCALE_F32 = 0
+DJIBQUANT_SCALE_F16 = 1
+
+NORM_TENSORS = ('rms_att_weight', 'rms_ffn_weight', 'rms_final_weight')
+
 def quantize_q6_group(values):
     """Quantize a group of floats to 6-bit signed integers [-31, 31]"""
     max_abs = np.abs(values).max()
@@ -66,6 +91,55 @@ def quantize_tensor_q6(tensor):
     
     return q_values, scales, n_elements, n_groups
 
+def pack_q6(q_values):
+    """Pack int8 Q6 values 4 per 3 bytes: value 4k+j is bits [6j, 6j+6)
+    of the little-endian 24-bit word at byte 3k (djiblas_unpack_q6p)."""
+    pad = (-q_values.size) % 4
+    u = np.pad(q_values, (0, pad)).astype(np.uint32) & 0x3F
+    u = u.reshape(-1, 4)
+    words = u[:, 0] | (u[:, 1] << 6) | (u[:, 2] << 12) | (u[:, 3] << 18)
+    packed = np.stack([words & 0xFF, (words >> 8) & 0xFF, (words >> 16) & 0xFF], axis=1)
+    return packed.astype(np.uint8).flatten()
+
+def quantize_tensor_q8(tensor):
+    """Quantize to Q8_0: int8 [-127, 127] with one float32 scale per 32 values.
+    Groups run along rows, so the row length must be a multiple of 32."""
+    flat = tensor.astype(np.float32).flatten()
+    if flat.size % DJIBQUANT_Q8_GROUP_SIZE:
+        raise ValueError(f"Q8_0 needs a multiple of {DJIBQUANT_Q8_GROUP_SIZE} elements, got {flat.size}")
+    groups = flat.reshape(-1, DJIBQUANT_Q8_GROUP_SIZE)
+    max_abs = np.abs(groups).max(axis=1)
+    scales = np.where(max_abs > 0, max_abs / 127.0, 1.0).astype(np.float32)
+    q_values = np.clip(np.round(groups / scales[:, None]), -127, 127).astype(np.int8)
+    return q_values.flatten(), scales, flat.size, groups.shape[0]
+
+def quantize_tensor_q4(tensor, scale_dtype):
+    """Q4: 32-value groups, q in [-8, 7] stored as q+8. Byte j of a group holds
+    value j (low nibble) and value j+16 (high nibble)."""
+    flat = tensor.astype(np.float32).flatten()
+    if flat.size % DJIBQUANT_Q4_GROUP_SIZE:
+        raise ValueError(f"Q4 needs a multiple of {DJIBQUANT_Q4_GROUP_SIZE} elements, got {flat.size}")
+    groups = flat.reshape(-1, DJIBQUANT_Q4_GROUP_SIZE)
+    max_abs = np.abs(groups).max(axis=1)
+    scales = np.where(max_abs > 0, max_abs / 7.0, 1.0).astype(scale_dtype)
+    d = scales.astype(np.float32)   # quantize against the stored scale
+    q = np.clip(np.round(groups / d[:, None]), -8, 7).astype(np.int16) + 8
+    half = DJIBQUANT_Q4_GROUP_SIZE // 2
+    packed = (q[:, :half] | (q[:, half:] << 4)).astype(np.uint8)
+    return packed.flatten(), scales, flat.size, groups.shape[0]
+
+def to_bf16(tensor):
+    """fp32 -> bfloat16 bits (round to nearest even), as uint16."""
+    u = tensor.astype(np.float32).flatten().view(np.uint32).astype(np.uint64)
+    u = (u + 0x7FFF + ((u >> 16) & 1)) >> 16
+    return u.astype(np.uint16)
+
+def write_record(f, magic, n_elements, n_groups, group_size, *arrays, scale_type=DJIBQUANT_SCALE_F32):
+    """One tensor record: DjibQuantHeader followed by its payload arrays."""
+    f.write(struct.pack('8I', magic, DJIBQUANT_VERSION, n_elements, n_groups, group_size, scale_type, 0, 0))
+    for a in arrays:
+        a.tofile(f)
+
 def load_llama2_model(model_path):
     """Load Llama2 format model (stories*.bin)"""
     print(f"Loading model from {model_path}...")
@@ -74,6 +148,7 @@ def load_llama2_model(model_path):
         # Read config (7 int32 values)
         config = struct.unpack('7i', f.read(7 * 4))
         dim, hidden_dim, n_layers, n_heads, n_kv_heads, vocab_size, seq_len = config
+        vocab_size = abs(vocab_size)  # negative = shared classifier (llama2.c)
         
         print(f"  dim={dim}, layers={n_layers}, heads={n_heads}, vocab={vocab_size}, seq={seq_len}")
         
@@ -99,18 +174,23 @@ def load_llama2_model(model_path):
         weights['w3'] = np.fromfile(f, dtype=np.float32, count=n_layers * hidden_dim * dim)
         weights['rms_final_weight'] = np.fromfile(f, dtype=np.float32, count=dim)
         
+        # Skip freq_cis_real / freq_cis_imag (not stored in .djibq)
+        f.seek(seq_len * head_size * 4, 1)
+
         # Optional: classifier weights (shared with embeddings in TinyStories)
         remaining = f.read()
-        if len(remaining) >= vocab_size * dim * 4:
+        shared = len(remaining) < vocab_size * dim * 4
+        if not shared:
             weights['wcls'] = np.frombuffer(remaining[:vocab_size * dim * 4], dtype=np.float32)
         else:
             weights['wcls'] = weights['token_embedding_table'].copy()
         
-    return config, weights
+    return config, weights, shared
 
-def save_djibquant_model(output_path, config, weights):
-    """Save model in DjibQuant Q6 format"""
-    print(f"\nConverting to DjibQuant Q6 format...")
+def save_djibquant_model(output_path, config, weights, packed=True):
+    """Save model in DjibQuant Q6 format (v2 packed, or v1 one byte per value)"""
+    version = DJIBQUANT_VERSION if packed else DJIBQUANT_VERSION_UNPACKED
+    print(f"\nConverting to DjibQuant Q6 v{version} format...")
     
     # Magic constant must match djibquant.h
     MAGIC = 0xD31B0006  # DJIB + 06 (Q6)
@@ -130,18 +210,20 @@ def save_djibquant_model(output_path, config, weights):
             
             # Write DjibQuant header for this tensor
             f.write(struct.pack('I', MAGIC))                    # magic
-            f.write(struct.pack('I', DJIBQUANT_VERSION))        # version
+            f.write(struct.pack('I', version))                  # version
             f.write(struct.pack('I', n_elements))               # n_elements
             f.write(struct.pack('I', n_groups))                 # n_groups
             f.write(struct.pack('I', DJIBQUANT_GROUP_SIZE))     # group_size
             f.write(struct.pack('III', 0, 0, 0))                # reserved
             
             # Write quantized data
-            q_values.tofile(f)      # int8 array
+            if packed:
+                q_values = pack_q6(q_values)
+            q_values.tofile(f)      # int8 array (v1) or packed bytes (v2)
             scales.tofile(f)        # float32 array
             
             original_size = n_elements * 4  # float32
-            djibq_size = n_elements * 1 + n_groups * 4  # int8 + scales
+            djibq_size = q_values.size + n_groups * 4  # values + scales
             total_original_size += original_size
             total_djibq_size += djibq_size
             
@@ -151,29 +233,87 @@ def save_djibquant_model(output_path, config, weights):
         total_compression = 100.0 * (1.0 - total_djibq_size / total_original_size)
         print(f"\n✅ Total compression: {total_compression:.1f}% ({total_original_size:,} → {total_djibq_size:,} bytes)")
 
+def save_grouped_model(output_path, config, weights, shared, fmt='q8'):
+    """Save model with Q8_0 / Q4 / fp16 / bf16 matrices and fp32 norm weights"""
+    print(f"\nConverting to {fmt.upper()} format...")
+
+    with open(output_path, 'wb') as f:
+        f.write(struct.pack('7i', *config))
+
+        total_original_size = 0
+        total_djibq_size = 0
+
+        for name, tensor in weights.items():
+            if name == 'wcls' and shared:
+                continue  # loader reuses the embedding
+
+            original_size = tensor.size * 4
+            if name in NORM_TENSORS:
+                print(f"  Keeping {name} as fp32: {tensor.size} elements")
+                write_record(f, DJIBQUANT_MAGIC_F32, tensor.size, 0, 0, tensor.astype(np.float32))
+                djibq_size = original_size
+            elif fmt in ('f16', 'bf16'):
+                print(f"  Converting {name} to {fmt}: {tensor.size} elements")
+                if fmt == 'f16':
+                    half = tensor.astype(np.float16).flatten()
+                    write_record(f, DJIBQUANT_MAGIC_F16, tensor.size, 0, 0, half)
+                else:
+                    half = to_bf16(tensor)
+                    write_record(f, DJIBQUANT_MAGIC_BF16, tensor.size, 0, 0, half)
+                djibq_size = half.nbytes
+            else:
+                print(f"  Quantizing {name}: {tensor.shape} = {tensor.size} elements")
+                if fmt == 'q8':
+                    q_values, scales, n_elements, n_groups = quantize_tensor_q8(tensor)
+                    write_record(f, DJIBQUANT_MAGIC_Q8, n_elements, n_groups, DJIBQUANT_Q8_GROUP_SIZE,
+                                 q_values, scales)
+                else:
+                    f16 = (fmt == 'q4')
+                    q_values, scales, n_elements, n_groups = quantize_tensor_q4(
+                        tensor, np.float16 if f16 else np.float32)
+                    write_record(f, DJIBQUANT_MAGIC_Q4, n_elements, n_groups, DJIBQUANT_Q4_GROUP_SIZE,
+                                 q_values, scales,
+                                 scale_type=DJIBQUANT_SCALE_F16 if f16 else DJIBQUANT_SCALE_F32)
+                djibq_size = q_values.size + scales.nbytes
+
+            total_original_size += original_size
+            total_djibq_size += djibq_size
+
+        total_compression = 100.0 * (1.0 - total_djibq_size / total_original_size)
+        print(f"\n✅ Total compression: {total_compression:.1f}% ({total_original_size:,} → {total_djibq_size:,} bytes)")
+
 def main():
-    if len(sys.argv) != 3:
-        print("Usage: python convert_to_djibquant.py <input.bin> <output.djibq>")
+    args = sys.argv[1:]
+    fmt = 'q6'
+    if len(args) >= 2 and args[0] == '--format':
+        fmt = args[1]
+        args = args[2:]
+    if len(args) != 2 or fmt not in ('q6', 'q6-v1', 'q8', 'q4', 'q4-f32', 'f16', 'bf16'):
+        print("Usage: python convert_to_djibquant.py [--format q6|q6-v1|q8|q4|q4-f32|f16|bf16] <input.bin> <output.djibq>")
         print("\nExample:")
         print("  python convert_to_djibquant.py stories110M.bin stories110M.djibq")
+        print("  python convert_to_djibquant.py --format q8 stories110M.bin stories110M.djibq")
         sys.exit(1)
     
-    input_path = Path(sys.argv[1])
-    output_path = Path(sys.argv[2])
+    input_path = Path(args[0])
+    output_path = Path(args[1])
     
     if not input_path.exists():
         print(f"❌ Error: Input file not found: {input_path}")
         sys.exit(1)
     
     print("=" * 60)
-    print("DjibQuant Q6 Converter 🇸🇳")
+    print(f"DjibQuant {fmt.upper()} Converter 🇸🇳")
     print("=" * 60)
     
     # Load original model
-    config, weights = load_llama2_model(input_path)
+    config, weights, shared = load_llama2_model(input_path)
     
     # Convert and save
-    save_djibquant_model(output_path, config, weights)
+    if fmt in ('q8', 'q4', 'q4-f32', 'f16', 'bf16'):
+        save_grouped_model(output_path, config, weights, shared, fmt)
+    else:
+        save_djibquant_model(output_path, config, weights, packed=(fmt == 'q6'))
     
     print(f"\n✅ DjibQuant model saved to: {output_path}")
     print(f"📊 File size: {output_path.stat().st_size:,} bytes")
@@ -9,16 +9,41 @@
 #include "djiblas.h"
 
 // CPUID for x86 feature detection
-static inline void cpuid(UINT32 leaf, UINT32 *eax, UINT32 *ebx, UINT32 *ecx, UINT32 *edx) {
+static inline void cpuid_count(UINT32 leaf, UINT32 sub, UINT32 *eax, UINT32 *ebx, UINT32 *ecx, UINT32 *edx) {
 #if defined(__x86_64__) || defined(_M_X64)
     __asm__ volatile("cpuid"
                      : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
-                     : "a"(leaf), "c"(0));
+                     : "a"(leaf), "c"(sub));
 #else
+    (void)leaf; (void)sub;
     *eax = *ebx = *ecx = *edx = 0;
 #endif
 }
 
+static inline void cpuid(UINT32 leaf, UINT32 *eax, UINT32 *ebx, UINT32 *ecx, UINT32 *edx) {
+    cpuid_count(leaf, 0, eax, ebx, ecx, edx);
+}
+
+// Largest data/unified cache described by a deterministic cache parameters
+// leaf (Intel leaf 4, AMD 0x8000001D: same layout), 0 if it lists none.
+static UINT64 djiblas_cache_leaf_max_bytes(UINT32 leaf) {
+    UINT64 best = 0;
+    for (UINT32 sub = 0; sub < 16; sub++) {
+        UINT32 eax, ebx, ecx, edx;
+        cpuid_count(leaf, sub, &eax, &ebx, &ecx, &edx);
+        UINT32 type = eax & 0x1Fu;              // 0 = no more caches, 2 = instruction
+        if (type == 0) break;
+        if (type == 2) continue;
+        UINT64 ways = (UINT64)((ebx >> 22) & 0x3FFu) + 1ULL;
+        UINT64 parts = (UINT64)((ebx >> 12) & 0x3FFu) + 1ULL;
+        UINT64 line = (UINT64)(ebx & 0xFFFu) + 1ULL;
+        UINT64 sets = (UINT64)ecx + 1ULL;
+        UINT64 bytes = ways * parts * line * sets;
+        if (bytes > best) best = bytes;
+    }
+    return best;
+}
+
 static inline UINT64 xgetbv0(void) {
 #if defined(__x86_64__) || defined(_M_X64)
     UINT32 eax, edx;
@@ -37,8 +62,12 @@ void djiblas_detect_cpu(CPUFeatures *features) {
     features->has_avx = FALSE;
     features->has_avx2 = FALSE;
     features->has_fma = FALSE;
+    features->has_f16c = FALSE;
     features->has_avx512f = FALSE;
+    features->has_avx512vl = FALSE;
     features->has_avx512_vnni = FALSE;
+    features->signature = 0;
+    features->llc_bytes = 0;
 
 #if DJIBLAS_DISABLE_CPUID
     // Safe baseline: we compile the project with at least SSE2 enabled.
@@ -51,22 +80,34 @@ void djiblas_detect_cpu(CPUFeatures *features) {
     // Check for CPUID support
     cpuid(0, &eax, &ebx, &ecx, &edx);
     if (eax == 0) return;
+    UINT32 max_leaf = eax;
+
+    // Last-level cache size: leaf 4 (Intel), else 0x8000001D (AMD reports
+    // zeros in leaf 4).
+    if (max_leaf >= 4) features->llc_bytes = djiblas_cache_leaf_max_bytes(4);
+    if (features->llc_bytes == 0) {
+        cpuid(0x80000000u, &eax, &ebx, &ecx, &edx);
+        if (eax >= 0x8000001Du) features->llc_bytes = djiblas_cache_leaf_max_bytes(0x8000001Du);
+    }
     
     // CPUID leaf 1: SSE2, AVX, FMA
     cpuid(1, &eax, &ebx, &ecx, &edx);
+    features->signature = eax;
     features->has_sse2 = (edx & (1 << 26)) != 0;  // SSE2
 
     // AVX requires OSXSAVE + XCR0 enabling XMM/YMM state.
     BOOLEAN osxsave = (ecx & (1 << 27)) != 0;
     BOOLEAN avx_hw = (ecx & (1 << 28)) != 0;
     BOOLEAN fma_hw = (ecx & (1 << 12)) != 0;
+    UINT64 xcr0 = 0;
     if (osxsave && avx_hw) {
-        UINT64 xcr0 = xgetbv0();
+        xcr0 = xgetbv0();
         // XMM (bit 1) and YMM (bit 2) must be enabled.
         if ((xcr0 & 0x6ULL) == 0x6ULL) {
             features->has_avx = TRUE;
-            // Only report FMA if AVX state is usable.
+            // Only report FMA / F16C if AVX state is usable.
             features->has_fma = fma_hw;
+            features->has_f16c = (ecx & (1 << 29)) != 0;
         }
     }
     
@@ -76,8 +117,15 @@ void djiblas_detect_cpu(CPUFeatures *features) {
     if (features->has_avx) {
         features->has_avx2 = (ebx & (1 << 5)) != 0;        // AVX2
     }
-    features->has_avx512f = (ebx & (1 << 16)) != 0;    // AVX512F
-    features->has_avx512_vnni = (ecx & (1 << 11)) != 0; // AVX512_VNNI
+    // AVX-512 additionally needs opmask (bit 5), ZMM0-15 upper halves (bit 6)
+    // and ZMM16-31 (bit 7) enabled in XCR0; otherwise EVEX code would #UD.
+    if (features->has_avx && (xcr0 & 0xE6ULL) == 0xE6ULL) {
+        features->has_avx512f = (ebx & (1 << 16)) != 0;    // AVX512F
+        features->has_avx512vl = features->has_avx512f &&
+                                 (ebx & (1u << 31)) != 0;   // AVX512VL
+        features->has_avx512_vnni = features->has_avx512f &&
+                                    (ecx & (1 << 11)) != 0; // AVX512_VNNI
+    }
 #endif
 }
 
@@ -99,11 +147,44 @@ void djiblas_sgemm_scalar(int m, int n, int k,
     }
 }
 
+// GEMV: 4 output rows per pass with independent accumulators.
+void djiblas_sgemv_scalar(int d, int n,
+                          const float *W, int ldw,
+                          const float *x,
+                          float *y) {
+    int i = 0;
+    for (; i + 4 <= d; i += 4) {
+        const float *w0 = W + (UINTN)ldw * (i + 0);
+        const float *w1 = W + (UINTN)ldw * (i + 1);
+        const float *w2 = W + (UINTN)ldw * (i + 2);
+        const float *w3 = W + (UINTN)ldw * (i + 3);
+        float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+        for (int l = 0; l < n; l++) {
+            float xv = x[l];
+            s0 += w0[l] * xv;
+            s1 += w1[l] * xv;
+            s2 += w2[l] * xv;
+            s3 += w3[l] * xv;
+        }
+        y[i + 0] = s0;
+        y[i + 1] = s1;
+        y[i + 2] = s2;
+        y[i + 3] = s3;
+    }
+    for (; i < d; i++) {
+        const float *w0 = W + (UINTN)ldw * i;
+        float s0 = 0.0f;
+        for (int l = 0; l < n; l++) s0 += w0[l] * x[l];
+        y[i] = s0;
+    }
+}
+
 // ===================================================================
 // SSE2 KERNEL (baseline x86-64)
 // ===================================================================
 #if defined(__x86_64__) || defined(_M_X64)
 #include <emmintrin.h>  // SSE2
+#include "djiblas_vmath.h"
 
 void djiblas_sgemm_sse2(int m, int n, int k,
                          const float *A, int lda,
@@ -135,6 +216,53 @@ void djiblas_sgemm_sse2(int m, int n, int k,
         }
     }
 }
+
+void djiblas_sgemv_sse2(int d, int n,
+                        const float *W, int ldw,
+                        const float *x,
+                        float *y) {
+    // 4 rows per pass: x is loaded once per step and shared by all 4 rows.
+    // The 4 horizontal sums are done together with a single transpose.
+    int i = 0;
+    for (; i + 4 <= d; i += 4) {
+        const float *w0 = W + (UINTN)ldw * (i + 0);
+        const float *w1 = W + (UINTN)ldw * (i + 1);
+        const float *w2 = W + (UINTN)ldw * (i + 2);
+        const float *w3 = W + (UINTN)ldw * (i + 3);
+        __m128 c0 = _mm_setzero_ps();
+        __m128 c1 = _mm_setzero_ps();
+        __m128 c2 = _mm_setzero_ps();
+        __m128 c3 = _mm_setzero_ps();
+
+        int l = 0;
+        for (; l + 4 <= n; l += 4) {
+            __m128 xv = _mm_loadu_ps(x + l);
+            c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(w0 + l), xv));
+            c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(w1 + l), xv));
+            c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(w2 + l), xv));
+            c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(w3 + l), xv));
+        }
+
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        __m128 sum = _mm_add_ps(_mm_add_ps(c0, c1), _mm_add_ps(c2, c3));
+
+        if (l < n) {
+            float tail[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            for (; l < n; l++) {
+                float xv = x[l];
+                tail[0] += w0[l] * xv;
+                tail[1] += w1[l] * xv;
+                tail[2] += w2[l] * xv;
+                tail[3] += w3[l] * xv;
+            }
+            sum = _mm_add_ps(sum, _mm_loadu_ps(tail));
+        }
+        _mm_storeu_ps(y + i, sum);
+    }
+    if (i < d) {
+        djiblas_sgemv_scalar(d - i, n, W + (UINTN)ldw * i, ldw, x, y + i);
+    }
+}
 #else
 void djiblas_sgemm_sse2(int m, int n, int k,
                          const float *A, int lda,
@@ -142,32 +270,18 @@ void djiblas_sgemm_sse2(int m, int n, int k,
                          float *C, int ldc) {
     djiblas_sgemm_scalar(m, n, k, A, lda, B, ldb, C, ldc);
 }
+
+void djiblas_sgemv_sse2(int d, int n,
+                        const float *W, int ldw,
+                        const float *x,
+                        float *y) {
+    djiblas_sgemv_scalar(d, n, W, ldw, x, y);
+}
 #endif
 
 // AVX2 implementation is in djiblas_avx2.c (compiled with -mavx2 -mfma).
 
-// ===================================================================
-// AVX512 KERNEL (16 floats at once)
-// ===================================================================
-#if defined(__AVX512F__)
-#include <immintrin.h>
-
-void djiblas_sgemm_avx512(int m, int n, int k,
-                           const float *A, int lda,
-                           const float *B, int ldb,
-                           float *C, int ldc) {
-    // AVX512 implementation would go here
-    // For now, fallback to AVX2
-    djiblas_sgemm_avx2(m, n, k, A, lda, B, ldb, C, ldc);
-}
-#else
-void djiblas_sgemm_avx512(int m, int n, int k,
-                           const float *A, int lda,
-                           const float *B, int ldb,
-                           float *C, int ldc) {
-    djiblas_sgemm_avx2(m, n, k, A, lda, B, ldb, C, ldc);
-}
-#endif
+// AVX-512F implementation is in djiblas_avx512.c (compiled with -mavx512f -mfma).
 
 // ===================================================================
 // KERNEL SELECTION
@@ -185,6 +299,1341 @@ sgemm_kernel_t djiblas_get_best_kernel(CPUFeatures *features) {
     return djiblas_sgemm_scalar;
 }
 
+sgemv_kernel_t djiblas_get_best_gemv_kernel(CPUFeatures *features) {
+    if (features->has_avx512f) {
+        return djiblas_sgemv_avx512;
+    }
+    if (features->has_avx2 && features->has_fma) {
+        return djiblas_sgemv_avx2;
+    }
+    if (features->has_sse2) {
+        return djiblas_sgemv_sse2;
+    }
+    return djiblas_sgemv_scalar;
+}
+
+// ===================================================================
+// VECTOR PRIMITIVES (SSE2 baseline)
+// ===================================================================
+
+// Cheap exp approximation shared by softmax / SwiGLU / sampler.
+float djiblas_fast_exp(float x) {
+    if (x < -10.0f) return 0.0f;
+    if (x > 10.0f) return 22026.0f;
+    x = 1.0f + x / 256.0f;
+    x *= x; x *= x; x *= x; x *= x;
+    x *= x; x *= x; x *= x; x *= x;
+    return x;
+}
+
+// Row t of an fp32 / fp16 / int8 KV cache as floats: fp32 rows are used in
+// place, the others are widened into buf (head_size <= DJIBLAS_ATTN_MAX_HEAD).
+static inline const float *djiblas_attn_row(const void *base, const float *S, int type,
+                                            int t, int ld, int sld, int head_size, float *buf) {
+    UINTN off = (UINTN)t * (UINTN)ld;
+    if (type == DJIBLAS_KV_F32) return (const float *)base + off;
+    if (type == DJIBLAS_KV_F16) {
+        djiblas_widen_f16((const UINT16 *)base + off, buf, head_size);
+    } else {
+        const INT8 *r = (const INT8 *)base + off;
+        float sc = S[(UINTN)t * (UINTN)sld];
+        for (int i = 0; i < head_size; i++) buf[i] = (float)r[i] * sc;
+    }
+    return buf;
+}
+
+void djiblas_silu_scalar(float *hb, const float *hb2, int n) {
+    for (int i = 0; i < n; i++) {
+        float val = hb[i];
+        val *= (1.0f / (1.0f + djiblas_fast_exp(-val)));
+        hb[i] = val * hb2[i];
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+float djiblas_dot_sse2(const float *a, const float *b, int n) {
+    __m128 sum = _mm_setzero_ps();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 va = _mm_loadu_ps(a + i);
+        __m128 vb = _mm_loadu_ps(b + i);
+        sum = _mm_add_ps(sum, _mm_mul_ps(va, vb));
+    }
+    float tmp[4];
+    _mm_storeu_ps(tmp, sum);
+    float total = tmp[0] + tmp[1] + tmp[2] + tmp[3];
+    for (; i < n; i++) total += a[i] * b[i];
+    return total;
+}
+
+void djiblas_axpy_sse2(float *dst, const float *src, float alpha, int n) {
+    __m128 va = _mm_set1_ps(alpha);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 vd = _mm_loadu_ps(dst + i);
+        __m128 vs = _mm_loadu_ps(src + i);
+        vd = _mm_add_ps(vd, _mm_mul_ps(va, vs));
+        _mm_storeu_ps(dst + i, vd);
+    }
+    for (; i < n; i++) dst[i] += alpha * src[i];
+}
+
+void djiblas_rmsnorm_sse2(float *o, const float *x, const float *weight, int n) {
+    __m128 vss = _mm_setzero_ps();
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m128 v = _mm_loadu_ps(x + j);
+        vss = _mm_add_ps(vss, _mm_mul_ps(v, v));
+    }
+    float tmp[4];
+    _mm_storeu_ps(tmp, vss);
+    float ss = tmp[0] + tmp[1] + tmp[2] + tmp[3];
+    for (; j < n; j++) ss += x[j] * x[j];
+    ss /= n;
+    ss += 1e-5f;
+    // Full-precision sqrt: one instruction, no Newton steps needed.
+    ss = 1.0f / _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(ss)));
+
+    __m128 vs = _mm_set1_ps(ss);
+    j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(x + j), vs);
+        _mm_storeu_ps(o + j, _mm_mul_ps(_mm_loadu_ps(weight + j), v));
+    }
+    for (; j < n; j++) o[j] = weight[j] * (ss * x[j]);
+}
+
+void djiblas_residual_rmsnorm_sse2(float *x, const float *delta, const float *weight, float *out, int n) {
+    // Pass 1: residual add, written back, with the sum of squares on the fly.
+    __m128 vss = _mm_setzero_ps();
+    int j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(x + j), _mm_loadu_ps(delta + j));
+        _mm_storeu_ps(x + j, v);
+        vss = _mm_add_ps(vss, _mm_mul_ps(v, v));
+    }
+    float tmp[4];
+    _mm_storeu_ps(tmp, vss);
+    float ss = tmp[0] + tmp[1] + tmp[2] + tmp[3];
+    for (; j < n; j++) {
+        x[j] += delta[j];
+        ss += x[j] * x[j];
+    }
+    ss /= n;
+    ss += 1e-5f;
+    ss = 1.0f / _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(ss)));
+
+    // Pass 2: normalize (x is still hot in L1).
+    __m128 vs = _mm_set1_ps(ss);
+    j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m128 v = _mm_mul_ps(_mm_loadu_ps(x + j), vs);
+        _mm_storeu_ps(out + j, _mm_mul_ps(_mm_loadu_ps(weight + j), v));
+    }
+    for (; j < n; j++) out[j] = weight[j] * (ss * x[j]);
+}
+
+float djiblas_exp_sum_sse2(float *x, int n) {
+    if (n <= 0) return 0.0f;
+    float max_val = x[0];
+    __m128 vmax = _mm_set1_ps(max_val);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vmax = _mm_max_ps(vmax, _mm_loadu_ps(&x[i]));
+    }
+    __m128 shuf = _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(2, 3, 0, 1));
+    vmax = _mm_max_ps(vmax, shuf);
+    shuf = _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(1, 0, 3, 2));
+    vmax = _mm_max_ps(vmax, shuf);
+    _mm_store_ss(&max_val, vmax);
+    for (; i < n; i++) {
+        if (x[i] > max_val) max_val = x[i];
+    }
+
+    __m128 vm = _mm_set1_ps(max_val);
+    __m128 vsum = _mm_setzero_ps();
+    i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 e = djiblas_exp128_ps(_mm_sub_ps(_mm_loadu_ps(&x[i]), vm));
+        _mm_storeu_ps(&x[i], e);
+        vsum = _mm_add_ps(vsum, e);
+    }
+    if (i < n) {
+        // Tail through one padded vector: the pad lanes come out as 0.
+        float t[4] = { DJIBLAS_EXP_PAD, DJIBLAS_EXP_PAD, DJIBLAS_EXP_PAD, DJIBLAS_EXP_PAD };
+        for (int j = 0; j < n - i; j++) t[j] = x[i + j];
+        __m128 e = djiblas_exp128_ps(_mm_sub_ps(_mm_loadu_ps(t), vm));
+        _mm_storeu_ps(t, e);
+        for (int j = 0; j < n - i; j++) x[i + j] = t[j];
+        vsum = _mm_add_ps(vsum, e);
+    }
+    shuf = _mm_shuffle_ps(vsum, vsum, _MM_SHUFFLE(2, 3, 0, 1));
+    vsum = _mm_add_ps(vsum, shuf);
+    shuf = _mm_shuffle_ps(vsum, vsum, _MM_SHUFFLE(1, 0, 3, 2));
+    vsum = _mm_add_ps(vsum, shuf);
+    return _mm_cvtss_f32(vsum);
+}
+
+void djiblas_softmax_sse2(float *x, int n) {
+    float sum = djiblas_exp_sum_sse2(x, n);
+    if (sum <= 0.0f) return;
+
+    float invsum = 1.0f / sum;
+    __m128 vinv = _mm_set1_ps(invsum);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(&x[i], _mm_mul_ps(_mm_loadu_ps(&x[i]), vinv));
+    }
+    for (; i < n; i++) x[i] *= invsum;
+}
+
+void djiblas_silu_sse2(float *hb, const float *hb2, int n) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 g = _mm_loadu_ps(hb + i);
+        __m128 u = _mm_loadu_ps(hb2 + i);
+        _mm_storeu_ps(hb + i, djiblas_silu_mul128_ps(g, u));
+    }
+    if (i < n) {
+        float g[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        float u[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int j = 0; j < n - i; j++) { g[j] = hb[i + j]; u[j] = hb2[i + j]; }
+        _mm_storeu_ps(g, djiblas_silu_mul128_ps(_mm_loadu_ps(g), _mm_loadu_ps(u)));
+        for (int j = 0; j < n - i; j++) hb[i + j] = g[j];
+    }
+}
+
+void djiblas_dequant_sse2(const INT8 *q, float scale, float *out, UINT32 n) {
+    // Pure SSE2 sign extension (no SSE4.1 pmovsx): interleave each byte with
+    // itself / each word with itself, then arithmetic-shift the copy away.
+    __m128 vs = _mm_set1_ps(scale);
+    UINT32 i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i b = _mm_loadu_si128((const __m128i *)(q + i));
+        __m128i w_lo = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+        __m128i w_hi = _mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8);
+        __m128i d0 = _mm_srai_epi32(_mm_unpacklo_epi16(w_lo, w_lo), 16);
+        __m128i d1 = _mm_srai_epi32(_mm_unpackhi_epi16(w_lo, w_lo), 16);
+        __m128i d2 = _mm_srai_epi32(_mm_unpacklo_epi16(w_hi, w_hi), 16);
+        __m128i d3 = _mm_srai_epi32(_mm_unpackhi_epi16(w_hi, w_hi), 16);
+        _mm_storeu_ps(out + i + 0, _mm_mul_ps(_mm_cvtepi32_ps(d0), vs));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(d1), vs));
+        _mm_storeu_ps(out + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(d2), vs));
+        _mm_storeu_ps(out + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(d3), vs));
+    }
+    for (; i < n; i++) out[i] = (float)q[i] * scale;
+}
+
+// Online softmax over tiles of 8 timesteps: the running max m only moves
+// once per tile, and then out and the running sum l are rescaled together.
+// type selects the KV element (DJIBLAS_KV_*); Ks/Vs/sld are int8 row scales.
+static void djiblas_attn_core_sse2(const float *q, const void *K, const float *Ks, const void *V,
+                                   const float *Vs, int type, int ld, int sld, int n,
+                                   int head_size, float scale, float *out) {
+    float p[DJIBLAS_ATTN_TILE];
+    float buf[DJIBLAS_ATTN_MAX_HEAD];
+    float m = DJIBLAS_EXP_PAD;
+    float l = 0.0f;
+    for (int i = 0; i < head_size; i++) out[i] = 0.0f;
+    for (int t0 = 0; t0 < n; t0 += DJIBLAS_ATTN_TILE) {
+        int nt = (n - t0 < DJIBLAS_ATTN_TILE) ? n - t0 : DJIBLAS_ATTN_TILE;
+        float tm = DJIBLAS_EXP_PAD;
+        for (int j = 0; j < DJIBLAS_ATTN_TILE; j++) {
+            p[j] = DJIBLAS_EXP_PAD;
+            if (j < nt) {
+                const float *k = djiblas_attn_row(K, Ks, type, t0 + j, ld, sld, head_size, buf);
+                p[j] = djiblas_dot_sse2(q, k, head_size) * scale;
+            }
+            if (p[j] > tm) tm = p[j];
+        }
+        if (tm > m) {
+            float corr = _mm_cvtss_f32(djiblas_exp128_ps(_mm_set_ss(m - tm)));
+            __m128 vc = _mm_set1_ps(corr);
+            int i = 0;
+            for (; i + 4 <= head_size; i += 4) _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(out + i), vc));
+            for (; i < head_size; i++) out[i] *= corr;
+            l *= corr;
+            m = tm;
+        }
+        __m128 vm = _mm_set1_ps(m);
+        __m128 e0 = djiblas_exp128_ps(_mm_sub_ps(_mm_loadu_ps(p), vm));
+        __m128 e1 = djiblas_exp128_ps(_mm_sub_ps(_mm_loadu_ps(p + 4), vm));
+        _mm_storeu_ps(p, e0);
+        _mm_storeu_ps(p + 4, e1);
+        for (int j = 0; j < nt; j++) {
+            l += p[j];
+            const float *v = djiblas_attn_row(V, Vs, type, t0 + j, ld, sld, head_size, buf);
+            djiblas_axpy_sse2(out, v, p[j], head_size);
+        }
+    }
+    float inv = (l > 0.0f) ? 1.0f / l : 0.0f;
+    for (int i = 0; i < head_size; i++) out[i] *= inv;
+}
+
+// djiblas_attn_core_sse2 for g heads sharing K/V: each tile's rows are
+// widened once (kt / vt) and then scored and accumulated per head, with
+// one running max / sum per head.
+static void djiblas_attn_group_core_sse2(const float *q, int g, const void *K, const float *Ks,
+                                         const void *V, const float *Vs, int type, int ld, int sld,
+                                         int n, int head_size, float scale, float *out) {
+    float p[DJIBLAS_ATTN_TILE];
+    float kt[DJIBLAS_ATTN_TILE * DJIBLAS_ATTN_MAX_HEAD];
+    float vt[DJIBLAS_ATTN_TILE * DJIBLAS_ATTN_MAX_HEAD];
+    const float *kr[DJIBLAS_ATTN_TILE];
+    const float *vr[DJIBLAS_ATTN_TILE];
+    float m[DJIBLAS_ATTN_MAX_GROUP];
+    float l[DJIBLAS_ATTN_MAX_GROUP];
+    for (int gc; g > 0; g -= gc, q += gc * head_size, out += gc * head_size) {
+        gc = (g < DJIBLAS_ATTN_MAX_GROUP) ? g : DJIBLAS_ATTN_MAX_GROUP;
+        for (int i = 0; i < gc * head_size; i++) out[i] = 0.0f;
+        for (int i = 0; i < gc; i++) {
+            m[i] = DJIBLAS_EXP_PAD;
+            l[i] = 0.0f;
+        }
+        for (int t0 = 0; t0 < n; t0 += DJIBLAS_ATTN_TILE) {
+            int nt = (n - t0 < DJIBLAS_ATTN_TILE) ? n - t0 : DJIBLAS_ATTN_TILE;
+            for (int j = 0; j < nt; j++) {
+                kr[j] = djiblas_attn_row(K, Ks, type, t0 + j, ld, sld, head_size, kt + j * head_size);
+                vr[j] = djiblas_attn_row(V, Vs, type, t0 + j, ld, sld, head_size, vt + j * head_size);
+            }
+            for (int h = 0; h < gc; h++) {
+                const float *qh = q + h * head_size;
+                float *oh = out + h * head_size;
+                float tm = DJIBLAS_EXP_PAD;
+                for (int j = 0; j < DJIBLAS_ATTN_TILE; j++) {
+                    p[j] = (j < nt) ? djiblas_dot_sse2(qh, kr[j], head_size) * scale : DJIBLAS_EXP_PAD;
+                    if (p[j] > tm) tm = p[j];
+                }
+                if (tm > m[h]) {
+                    float corr = _mm_cvtss_f32(djiblas_exp128_ps(_mm_set_ss(m[h] - tm)));
+                    __m128 vc = _mm_set1_ps(corr);
+                    int i = 0;
+                    for (; i + 4 <= head_size; i += 4) _mm_storeu_ps(oh + i, _mm_mul_ps(_mm_loadu_ps(oh + i), vc));
+                    for (; i < head_size; i++) oh[i] *= corr;
+                    l[h] *= corr;
+                    m[h] = tm;
+                }
+                __m128 vm = _mm_set1_ps(m[h]);
+                _mm_storeu_ps(p, djiblas_exp128_ps(_mm_sub_ps(_mm_loadu_ps(p), vm)));
+                _mm_storeu_ps(p + 4, djiblas_exp128_ps(_mm_sub_ps(_mm_loadu_ps(p + 4), vm)));
+                for (int j = 0; j < nt; j++) {
+                    l[h] += p[j];
+                    djiblas_axpy_sse2(oh, vr[j], p[j], head_size);
+                }
+            }
+        }
+        for (int h = 0; h < gc; h++) {
+            float inv = (l[h] > 0.0f) ? 1.0f / l[h] : 0.0f;
+            for (int i = 0; i < head_size; i++) out[h * head_size + i] *= inv;
+        }
+    }
+}
+
+#else
+
+static float djiblas_rsqrt_scalar(float x) {
+    float xhalf = 0.5f * x;
+    union { float f; INT32 i; } u;
+    u.f = x;
+    u.i = 0x5f3759df - (u.i >> 1);
+    float y = u.f;
+    y = y * (1.5f - xhalf * y * y);
+    y = y * (1.5f - xhalf * y * y);
+    return y;
+}
+
+float djiblas_dot_sse2(const float *a, const float *b, int n) {
+    float total = 0.0f;
+    for (int i = 0; i < n; i++) total += a[i] * b[i];
+    return total;
+}
+
+void djiblas_axpy_sse2(float *dst, const float *src, float alpha, int n) {
+    for (int i = 0; i < n; i++) dst[i] += alpha * src[i];
+}
+
+void djiblas_rmsnorm_sse2(float *o, const float *x, const float *weight, int n) {
+    float ss = 0.0f;
+    for (int j = 0; j < n; j++) ss += x[j] * x[j];
+    ss /= n;
+    ss += 1e-5f;
+    ss = djiblas_rsqrt_scalar(ss);
+    for (int j = 0; j < n; j++) o[j] = weight[j] * (ss * x[j]);
+}
+
+void djiblas_residual_rmsnorm_sse2(float *x, const float *delta, const float *weight, float *out, int n) {
+    float ss = 0.0f;
+    for (int j = 0; j < n; j++) {
+        x[j] += delta[j];
+        ss += x[j] * x[j];
+    }
+    ss /= n;
+    ss += 1e-5f;
+    ss = djiblas_rsqrt_scalar(ss);
+    for (int j = 0; j < n; j++) out[j] = weight[j] * (ss * x[j]);
+}
+
+float djiblas_exp_sum_sse2(float *x, int n) {
+    if (n <= 0) return 0.0f;
+    float max_val = x[0];
+    for (int i = 1; i < n; i++) {
+        if (x[i] > max_val) max_val = x[i];
+    }
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        x[i] = djiblas_fast_exp(x[i] - max_val);
+        sum += x[i];
+    }
+    return sum;
+}
+
+void djiblas_softmax_sse2(float *x, int n) {
+    float sum = djiblas_exp_sum_sse2(x, n);
+    if (sum <= 0.0f) return;
+    float invsum = 1.0f / sum;
+    for (int i = 0; i < n; i++) x[i] *= invsum;
+}
+
+void djiblas_silu_sse2(float *hb, const float *hb2, int n) {
+    djiblas_silu_scalar(hb, hb2, n);
+}
+
+void djiblas_dequant_sse2(const INT8 *q, float scale, float *out, UINT32 n) {
+    for (UINT32 i = 0; i < n; i++) out[i] = (float)q[i] * scale;
+}
+
+static void djiblas_attn_core_sse2(const float *q, const void *K, const float *Ks, const void *V,
+                                   const float *Vs, int type, int ld, int sld, int n,
+                                   int head_size, float scale, float *out) {
+    float p[DJIBLAS_ATTN_TILE];
+    float buf[DJIBLAS_ATTN_MAX_HEAD];
+    float m = -1.0e30f;
+    float l = 0.0f;
+    for (int i = 0; i < head_size; i++) out[i] = 0.0f;
+    for (int t0 = 0; t0 < n; t0 += DJIBLAS_ATTN_TILE) {
+        int nt = (n - t0 < DJIBLAS_ATTN_TILE) ? n - t0 : DJIBLAS_ATTN_TILE;
+        float tm = -1.0e30f;
+        for (int j = 0; j < nt; j++) {
+            const float *k = djiblas_attn_row(K, Ks, type, t0 + j, ld, sld, head_size, buf);
+            p[j] = djiblas_dot_sse2(q, k, head_size) * scale;
+            if (p[j] > tm) tm = p[j];
+        }
+        if (tm > m) {
+            float corr = djiblas_fast_exp(m - tm);
+            for (int i = 0; i < head_size; i++) out[i] *= corr;
+            l *= corr;
+            m = tm;
+        }
+        for (int j = 0; j < nt; j++) {
+            p[j] = djiblas_fast_exp(p[j] - m);
+            l += p[j];
+            const float *v = djiblas_attn_row(V, Vs, type, t0 + j, ld, sld, head_size, buf);
+            djiblas_axpy_sse2(out, v, p[j], head_size);
+        }
+    }
+    float inv = (l > 0.0f) ? 1.0f / l : 0.0f;
+    for (int i = 0; i < head_size; i++) out[i] *= inv;
+}
+
+static void djiblas_attn_group_core_sse2(const float *q, int g, const void *K, const float *Ks,
+                                         const void *V, const float *Vs, int type, int ld, int sld,
+                                         int n, int head_size, float scale, float *out) {
+    for (int h = 0; h < g; h++) {
+        djiblas_attn_core_sse2(q + h * head_size, K, Ks, V, Vs, type, ld, sld, n, head_size, scale,
+                               out + h * head_size);
+    }
+}
+
+#endif
+
+// ===================================================================
+// Q8_0 KERNELS (scalar / SSE2 baseline)
+// ===================================================================
+
+void djiblas_gemv_q8_scalar(int d, int n, const INT8 *W, const float *Wd,
+                            const INT8 *xq, const float *xd, float *y) {
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        float sum = 0.0f;
+        for (int b = 0; b < nb; b++) {
+            INT32 acc = 0;
+            for (int l = 0; l < DJIBLAS_Q8_BLOCK; l++) {
+                acc += (INT32)w[b * DJIBLAS_Q8_BLOCK + l] * (INT32)xq[b * DJIBLAS_Q8_BLOCK + l];
+            }
+            sum += (float)acc * wd[b] * xd[b];
+        }
+        y[i] = sum;
+    }
+}
+
+void djiblas_gemm_q8_scalar(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                            const INT8 *xq, const float *xd, float *Y, int ldy) {
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int c = 0; c < ncol; c++) {
+        djiblas_gemv_q8_scalar(d, n, W, Wd, xq + (UINTN)c * (UINTN)n, xd + (UINTN)c * (UINTN)nb,
+                               Y + (UINTN)c * (UINTN)ldy);
+    }
+}
+
+// DjibQuant v2 packing: value 4k + j is bits [6j, 6j + 6) of the little-endian
+// 24-bit word at p[3k], two's complement.
+void djiblas_unpack_q6p(const UINT8 *p, INT8 *out, int n) {
+    for (int k = 0; k < n / 4; k++) {
+        UINT32 v = (UINT32)p[3 * k] | ((UINT32)p[3 * k + 1] << 8) | ((UINT32)p[3 * k + 2] << 16);
+        out[4 * k + 0] = (INT8)((INT32)(v << 26) >> 26);
+        out[4 * k + 1] = (INT8)((INT32)(v << 20) >> 26);
+        out[4 * k + 2] = (INT8)((INT32)(v << 14) >> 26);
+        out[4 * k + 3] = (INT8)((INT32)(v << 8) >> 26);
+    }
+}
+
+void djiblas_gemv_q6_q8_scalar(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                               const INT8 *xq, const float *xd, float *y) {
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        UINT64 e = e0 + (UINT64)i * (UINT64)n;
+        float sum = 0.0f;
+        for (int b = 0; b < nb; b++) {
+            INT32 acc = 0;
+            for (int l = 0; l < DJIBLAS_Q8_BLOCK; l++) {
+                acc += (INT32)w[b * DJIBLAS_Q8_BLOCK + l] * (INT32)xq[b * DJIBLAS_Q8_BLOCK + l];
+            }
+            sum += (float)acc * S[(e + (UINT64)b * DJIBLAS_Q8_BLOCK) / DJIBLAS_Q6_GROUP] * xd[b];
+        }
+        y[i] = sum;
+    }
+}
+
+void djiblas_gemv_q6p_q8_scalar(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                                const INT8 *xq, const float *xd, float *y) {
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    INT8 q[DJIBLAS_Q8_BLOCK];
+    for (int i = 0; i < d; i++) {
+        const UINT8 *w = W + (UINTN)i * (UINTN)n / 4 * 3;
+        UINT64 e = e0 + (UINT64)i * (UINT64)n;
+        float sum = 0.0f;
+        for (int b = 0; b < nb; b++) {
+            djiblas_unpack_q6p(w + b * (DJIBLAS_Q8_BLOCK / 4 * 3), q, DJIBLAS_Q8_BLOCK);
+            INT32 acc = 0;
+            for (int l = 0; l < DJIBLAS_Q8_BLOCK; l++) acc += (INT32)q[l] * (INT32)xq[b * DJIBLAS_Q8_BLOCK + l];
+            sum += (float)acc * S[(e + (UINT64)b * DJIBLAS_Q8_BLOCK) / DJIBLAS_Q6_GROUP] * xd[b];
+        }
+        y[i] = sum;
+    }
+}
+
+// fp16 -> fp32 without F16C: move exponent+mantissa into place and rescale by
+// 2^112 (handles subnormals; Inf/NaN come out as large finite values, which
+// never occur in weights).
+void djiblas_widen_f16(const UINT16 *h, float *out, int n) {
+    union { UINT32 u; float f; } v, k;
+    k.u = 0x77800000u;   // 2^112
+    for (int i = 0; i < n; i++) {
+        v.u = (UINT32)(h[i] & 0x7FFF) << 13;
+        v.f *= k.f;
+        v.u |= (UINT32)(h[i] & 0x8000) << 16;
+        out[i] = v.f;
+    }
+}
+
+void djiblas_widen_bf16(const UINT16 *h, float *out, int n) {
+    union { UINT32 u; float f; } v;
+    for (int i = 0; i < n; i++) {
+        v.u = (UINT32)h[i] << 16;
+        out[i] = v.f;
+    }
+}
+
+void djiblas_attn_sse2(const float *q, const float *K, const float *V, int ld, int n,
+                       int head_size, float scale, float *out) {
+    djiblas_attn_core_sse2(q, K, 0, V, 0, DJIBLAS_KV_F32, ld, 0, n, head_size, scale, out);
+}
+
+void djiblas_attn_f16_sse2(const float *q, const UINT16 *K, const UINT16 *V, int ld, int n,
+                           int head_size, float scale, float *out) {
+    djiblas_attn_core_sse2(q, K, 0, V, 0, DJIBLAS_KV_F16, ld, 0, n, head_size, scale, out);
+}
+
+void djiblas_attn_q8_sse2(const float *q, const INT8 *K, const float *Ks, const INT8 *V, const float *Vs,
+                          int ld, int sld, int n, int head_size, float scale, float *out) {
+    djiblas_attn_core_sse2(q, K, Ks, V, Vs, DJIBLAS_KV_Q8, ld, sld, n, head_size, scale, out);
+}
+
+void djiblas_attn_gqa_sse2(const float *q, int g, const float *K, const float *V, int ld, int n,
+                           int head_size, float scale, float *out) {
+    djiblas_attn_group_core_sse2(q, g, K, 0, V, 0, DJIBLAS_KV_F32, ld, 0, n, head_size, scale, out);
+}
+
+void djiblas_attn_gqa_f16_sse2(const float *q, int g, const UINT16 *K, const UINT16 *V, int ld, int n,
+                               int head_size, float scale, float *out) {
+    djiblas_attn_group_core_sse2(q, g, K, 0, V, 0, DJIBLAS_KV_F16, ld, 0, n, head_size, scale, out);
+}
+
+void djiblas_attn_gqa_q8_sse2(const float *q, int g, const INT8 *K, const float *Ks, const INT8 *V,
+                              const float *Vs, int ld, int sld, int n, int head_size, float scale, float *out) {
+    djiblas_attn_group_core_sse2(q, g, K, Ks, V, Vs, DJIBLAS_KV_Q8, ld, sld, n, head_size, scale, out);
+}
+
+// fp32 -> fp16, round to nearest even: rebias the exponent and round on the
+// 13 dropped mantissa bits; results below the smallest normal half are
+// rounded by adding 0.5 so the FPU aligns them; overflow gives Inf.
+void djiblas_narrow_f16(const float *x, UINT16 *h, int n) {
+    union { UINT32 u; float f; } v;
+    for (int i = 0; i < n; i++) {
+        v.f = x[i];
+        UINT32 sign = (v.u >> 16) & 0x8000u;
+        UINT32 a = v.u & 0x7FFFFFFFu;
+        UINT32 r;
+        if (a >= 0x47800000u) {
+            r = (a > 0x7F800000u) ? 0x7E00u : 0x7C00u;
+        } else if (a < 0x38800000u) {
+            v.u = a;
+            v.f += 0.5f;
+            r = v.u - 0x3F000000u;
+        } else {
+            r = (a + 0xC8000FFFu + ((a >> 13) & 1u)) >> 13;
+        }
+        h[i] = (UINT16)(r | sign);
+    }
+}
+
+float djiblas_quantize_kv_q8(const float *x, INT8 *q, int n) {
+    float m = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float a = (x[i] < 0.0f) ? -x[i] : x[i];
+        if (a > m) m = a;
+    }
+    float id = (m > 0.0f) ? (127.0f / m) : 0.0f;
+    for (int i = 0; i < n; i++) {
+        float v = x[i] * id;
+        q[i] = (INT8)(INT32)(v + ((v >= 0.0f) ? 0.5f : -0.5f));
+    }
+    return m / 127.0f;
+}
+
+void djiblas_rope_sse2(float *q, int q_dim, float *k, int k_dim, int head_size,
+                       const float *C, const float *S) {
+    for (int kv = 0; kv < 2; kv++) {
+        float *x = kv ? k : q;
+        int n = kv ? k_dim : q_dim;
+        for (int h = 0; h < n; h += head_size, x += head_size) {
+            int i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+            for (; i + 4 <= head_size; i += 4) {
+                __m128 v = _mm_loadu_ps(x + i);
+                __m128 w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+                _mm_storeu_ps(x + i, _mm_add_ps(_mm_mul_ps(v, _mm_loadu_ps(C + i)),
+                                                _mm_mul_ps(w, _mm_loadu_ps(S + i))));
+            }
+#endif
+            for (; i < head_size; i += 2) {
+                float x0 = x[i], x1 = x[i + 1];
+                x[i] = x0 * C[i] + x1 * S[i];
+                x[i + 1] = x1 * C[i + 1] + x0 * S[i + 1];
+            }
+        }
+    }
+}
+
+void djiblas_unpack_q4(const UINT8 *p, INT8 *out) {
+    for (int j = 0; j < DJIBLAS_Q4_BLOCK_BYTES; j++) {
+        out[j] = (INT8)((p[j] & 0x0F) - 8);
+        out[j + DJIBLAS_Q4_BLOCK_BYTES] = (INT8)((p[j] >> 4) - 8);
+    }
+}
+
+void djiblas_gemv_q4_scalar(int d, int n, const UINT8 *W, const float *Wd,
+                            const INT8 *xq, const float *xd, float *y) {
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    INT8 w[DJIBLAS_Q8_BLOCK];
+    for (int i = 0; i < d; i++) {
+        const UINT8 *row = W + (UINTN)i * (UINTN)nb * DJIBLAS_Q4_BLOCK_BYTES;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        float sum = 0.0f;
+        for (int b = 0; b < nb; b++) {
+            djiblas_unpack_q4(row + b * DJIBLAS_Q4_BLOCK_BYTES, w);
+            INT32 acc = 0;
+            for (int l = 0; l < DJIBLAS_Q8_BLOCK; l++) acc += (INT32)w[l] * (INT32)xq[b * DJIBLAS_Q8_BLOCK + l];
+            sum += (float)acc * wd[b] * xd[b];
+        }
+        y[i] = sum;
+    }
+}
+
+void djiblas_gemm_q4_scalar(int d, int n, int ncol, const UINT8 *W, const float *Wd,
+                            const INT8 *xq, const float *xd, float *Y, int ldy) {
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int c = 0; c < ncol; c++) {
+        djiblas_gemv_q4_scalar(d, n, W, Wd, xq + (UINTN)c * (UINTN)n, xd + (UINTN)c * (UINTN)nb,
+                               Y + (UINTN)c * (UINTN)ldy);
+    }
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+void djiblas_quantize_q8_sse2(const float *x, int n, INT8 *xq, float *xd) {
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (int b = 0; b < n / DJIBLAS_Q8_BLOCK; b++) {
+        const float *p = x + b * DJIBLAS_Q8_BLOCK;
+        __m128 v[8];
+        __m128 amax = _mm_setzero_ps();
+        for (int j = 0; j < 8; j++) {
+            v[j] = _mm_loadu_ps(p + 4 * j);
+            amax = _mm_max_ps(amax, _mm_andnot_ps(sign, v[j]));
+        }
+        amax = _mm_max_ps(amax, _mm_movehl_ps(amax, amax));
+        amax = _mm_max_ss(amax, _mm_shuffle_ps(amax, amax, 1));
+        float m = _mm_cvtss_f32(amax);
+        float d = m / 127.0f;
+        __m128 id = _mm_set1_ps((m > 0.0f) ? (127.0f / m) : 0.0f);
+        xd[b] = d;
+
+        // cvtps rounds to nearest; |v * id| <= 127 so the packs never saturate.
+        __m128i i0 = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(v[0], id)), _mm_cvtps_epi32(_mm_mul_ps(v[1], id)));
+        __m128i i1 = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(v[2], id)), _mm_cvtps_epi32(_mm_mul_ps(v[3], id)));
+        __m128i i2 = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(v[4], id)), _mm_cvtps_epi32(_mm_mul_ps(v[5], id)));
+        __m128i i3 = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(v[6], id)), _mm_cvtps_epi32(_mm_mul_ps(v[7], id)));
+        _mm_storeu_si128((__m128i *)(xq + b * DJIBLAS_Q8_BLOCK), _mm_packs_epi16(i0, i1));
+        _mm_storeu_si128((__m128i *)(xq + b * DJIBLAS_Q8_BLOCK + 16), _mm_packs_epi16(i2, i3));
+    }
+}
+
+// 16 int8 x int8 products summed into 4 int32 lanes (SSE2 has no pmaddubsw:
+// sign-extend both sides to int16 and use pmaddwd).
+static inline __m128i djiblas_dot16_i8_sse2(__m128i a, __m128i b) {
+    __m128i a_lo = _mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8);
+    __m128i a_hi = _mm_srai_epi16(_mm_unpackhi_epi8(a, a), 8);
+    __m128i b_lo = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+    __m128i b_hi = _mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8);
+    return _mm_add_epi32(_mm_madd_epi16(a_lo, b_lo), _mm_madd_epi16(a_hi, b_hi));
+}
+
+void djiblas_gemv_q8_sse2(int d, int n, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        __m128 acc = _mm_setzero_ps();
+        for (int b = 0; b < nb; b++) {
+            const __m128i *pw = (const __m128i *)(w + b * DJIBLAS_Q8_BLOCK);
+            const __m128i *px = (const __m128i *)(xq + b * DJIBLAS_Q8_BLOCK);
+            __m128i s = _mm_add_epi32(djiblas_dot16_i8_sse2(_mm_loadu_si128(pw), _mm_loadu_si128(px)),
+                                      djiblas_dot16_i8_sse2(_mm_loadu_si128(pw + 1), _mm_loadu_si128(px + 1)));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(s), _mm_set1_ps(wd[b] * xd[b])));
+        }
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+        y[i] = _mm_cvtss_f32(acc);
+    }
+}
+
+// One 32-value block of x against w already sign-extended to int16 (w[0..4)
+// = values 0-7, 8-15, 16-23, 24-31): 4 int32 lanes.
+static inline __m128i djiblas_dot32_w16_sse2(const __m128i *w, const INT8 *x) {
+    __m128i x0 = _mm_loadu_si128((const __m128i *)x);
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(x + 16));
+    __m128i s = _mm_madd_epi16(w[0], _mm_srai_epi16(_mm_unpacklo_epi8(x0, x0), 8));
+    s = _mm_add_epi32(s, _mm_madd_epi16(w[1], _mm_srai_epi16(_mm_unpackhi_epi8(x0, x0), 8)));
+    s = _mm_add_epi32(s, _mm_madd_epi16(w[2], _mm_srai_epi16(_mm_unpacklo_epi8(x1, x1), 8)));
+    return _mm_add_epi32(s, _mm_madd_epi16(w[3], _mm_srai_epi16(_mm_unpackhi_epi8(x1, x1), 8)));
+}
+
+static inline float djiblas_hsum_sse2(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+void djiblas_gemm_q8_sse2(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    // The weight block is sign-extended once and reused for every column.
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        int c = 0;
+        for (; c + DJIBLAS_Q8_NCOL <= ncol; c += DJIBLAS_Q8_NCOL) {
+            const INT8 *x = xq + (UINTN)c * (UINTN)n;
+            const float *dx = xd + (UINTN)c * (UINTN)nb;
+            __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+            __m128 a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+            for (int b = 0; b < nb; b++) {
+                __m128i v0 = _mm_loadu_si128((const __m128i *)(w + b * DJIBLAS_Q8_BLOCK));
+                __m128i v1 = _mm_loadu_si128((const __m128i *)(w + b * DJIBLAS_Q8_BLOCK + 16));
+                __m128i w16[4];
+                w16[0] = _mm_srai_epi16(_mm_unpacklo_epi8(v0, v0), 8);
+                w16[1] = _mm_srai_epi16(_mm_unpackhi_epi8(v0, v0), 8);
+                w16[2] = _mm_srai_epi16(_mm_unpacklo_epi8(v1, v1), 8);
+                w16[3] = _mm_srai_epi16(_mm_unpackhi_epi8(v1, v1), 8);
+                const INT8 *xb = x + b * DJIBLAS_Q8_BLOCK;
+                a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_cvtepi32_ps(djiblas_dot32_w16_sse2(w16, xb)),
+                                               _mm_set1_ps(wd[b] * dx[b])));
+                a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_cvtepi32_ps(djiblas_dot32_w16_sse2(w16, xb + n)),
+                                               _mm_set1_ps(wd[b] * dx[b + nb])));
+                a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_cvtepi32_ps(djiblas_dot32_w16_sse2(w16, xb + 2 * n)),
+                                               _mm_set1_ps(wd[b] * dx[b + 2 * nb])));
+                a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_cvtepi32_ps(djiblas_dot32_w16_sse2(w16, xb + 3 * n)),
+                                               _mm_set1_ps(wd[b] * dx[b + 3 * nb])));
+            }
+            Y[(UINTN)c * (UINTN)ldy + i] = djiblas_hsum_sse2(a0);
+            Y[(UINTN)(c + 1) * (UINTN)ldy + i] = djiblas_hsum_sse2(a1);
+            Y[(UINTN)(c + 2) * (UINTN)ldy + i] = djiblas_hsum_sse2(a2);
+            Y[(UINTN)(c + 3) * (UINTN)ldy + i] = djiblas_hsum_sse2(a3);
+        }
+        for (; c < ncol; c++) {
+            djiblas_gemv_q8_sse2(1, n, w, wd, xq + (UINTN)c * (UINTN)n, xd + (UINTN)c * (UINTN)nb,
+                                 Y + (UINTN)c * (UINTN)ldy + i);
+        }
+    }
+}
+
+void djiblas_gemv_q4_sse2(int d, int n, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i eight = _mm_set1_epi8(8);
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const UINT8 *w = W + (UINTN)i * (UINTN)nb * DJIBLAS_Q4_BLOCK_BYTES;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        __m128 acc = _mm_setzero_ps();
+        for (int b = 0; b < nb; b++) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(w + b * DJIBLAS_Q4_BLOCK_BYTES));
+            __m128i lo = _mm_sub_epi8(_mm_and_si128(v, mask), eight);
+            __m128i hi = _mm_sub_epi8(_mm_and_si128(_mm_srli_epi16(v, 4), mask), eight);
+            const __m128i *px = (const __m128i *)(xq + b * DJIBLAS_Q8_BLOCK);
+            __m128i s = _mm_add_epi32(djiblas_dot16_i8_sse2(lo, _mm_loadu_si128(px)),
+                                      djiblas_dot16_i8_sse2(hi, _mm_loadu_si128(px + 1)));
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(s), _mm_set1_ps(wd[b] * xd[b])));
+        }
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+        y[i] = _mm_cvtss_f32(acc);
+    }
+}
+
+void djiblas_gemm_q4_sse2(int d, int n, int ncol, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    const __m128i eight = _mm_set1_epi8(8);
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const UINT8 *w = W + (UINTN)i * (UINTN)nb * DJIBLAS_Q4_BLOCK_BYTES;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        int c = 0;
+        for (; c + DJIBLAS_Q8_NCOL <= ncol; c += DJIBLAS_Q8_NCOL) {
+            const INT8 *x = xq + (UINTN)c * (UINTN)n;
+            const float *dx = xd + (UINTN)c * (UINTN)nb;
+            __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+            __m128 a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+            for (int b = 0; b < nb; b++) {
+                __m128i v = _mm_loadu_si128((const __m128i *)(w + b * DJIBLAS_Q4_BLOCK_BYTES));
+                __m128i lo = _mm_sub_epi8(_mm_and_si128(v, mask), eight);
+                __m128i hi = _mm_sub_epi8(_mm_and_si128(_mm_srli_epi16(v, 4), mask), eight);
+                __m128i w16[4];
+                w16[0] = _mm_srai_epi16(_mm_unpacklo_epi8(lo, lo), 8);
+                w16[1] = _mm_srai_epi16(_mm_unpackhi_epi8(lo, lo), 8);
+                w16[2] = _mm_srai_epi16(_mm_unpacklo_epi8(hi, hi), 8);
+                w16[3] = _mm_srai_epi16(_mm_unpackhi_epi8(hi, hi), 8);
+                const INT8 *xb = x + b * DJIBLAS_Q8_BLOCK;
+                a0 = _mm_add_ps(a0, _mm_mul_ps(_mm_cvtepi32_ps(djiblas_dot32_w16_sse2(w16, xb)),
+                                               _mm_set1_ps(wd[b] * dx[b])));
+                a1 = _mm_add_ps(a1, _mm_mul_ps(_mm_cvtepi32_ps(djiblas_dot32_w16_sse2(w16, xb + n)),
+                                               _mm_set1_ps(wd[b] * dx[b + nb])));
+                a2 = _mm_add_ps(a2, _mm_mul_ps(_mm_cvtepi32_ps(djiblas_dot32_w16_sse2(w16, xb + 2 * n)),
+                                               _mm_set1_ps(wd[b] * dx[b + 2 * nb])));
+                a3 = _mm_add_ps(a3, _mm_mul_ps(_mm_cvtepi32_ps(djiblas_dot32_w16_sse2(w16, xb + 3 * n)),
+                                               _mm_set1_ps(wd[b] * dx[b + 3 * nb])));
+            }
+            Y[(UINTN)c * (UINTN)ldy + i] = djiblas_hsum_sse2(a0);
+            Y[(UINTN)(c + 1) * (UINTN)ldy + i] = djiblas_hsum_sse2(a1);
+            Y[(UINTN)(c + 2) * (UINTN)ldy + i] = djiblas_hsum_sse2(a2);
+            Y[(UINTN)(c + 3) * (UINTN)ldy + i] = djiblas_hsum_sse2(a3);
+        }
+        for (; c < ncol; c++) {
+            djiblas_gemv_q4_sse2(1, n, w, wd, xq + (UINTN)c * (UINTN)n, xd + (UINTN)c * (UINTN)nb,
+                                 Y + (UINTN)c * (UINTN)ldy + i);
+        }
+    }
+}
+
+// 4 halves (zero-extended in 32-bit lanes) -> 4 floats, as djiblas_widen_f16.
+static inline __m128 djiblas_cvtph4_sse2(__m128i h) {
+    __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+    __m128i em = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7FFF)), 13);
+    __m128 f = _mm_mul_ps(_mm_castsi128_ps(em), _mm_castsi128_ps(_mm_set1_epi32(0x77800000)));
+    return _mm_or_ps(f, _mm_castsi128_ps(sign));
+}
+
+// bf16 selects the bf16 widening (interleave under zeros) instead of fp16.
+static void djiblas_gemv_half_core_sse2(int d, int n, const UINT16 *W, BOOLEAN bf16,
+                                        const float *x, float *y) {
+    const __m128i zero = _mm_setzero_si128();
+    for (int i = 0; i < d; i++) {
+        const UINT16 *w = W + (UINTN)i * (UINTN)n;
+        __m128 s0 = _mm_setzero_ps();
+        __m128 s1 = _mm_setzero_ps();
+        int l = 0;
+        for (; l + 8 <= n; l += 8) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(w + l));
+            __m128 f0, f1;
+            if (bf16) {
+                f0 = _mm_castsi128_ps(_mm_unpacklo_epi16(zero, v));
+                f1 = _mm_castsi128_ps(_mm_unpackhi_epi16(zero, v));
+            } else {
+                f0 = djiblas_cvtph4_sse2(_mm_unpacklo_epi16(v, zero));
+                f1 = djiblas_cvtph4_sse2(_mm_unpackhi_epi16(v, zero));
+            }
+            s0 = _mm_add_ps(s0, _mm_mul_ps(f0, _mm_loadu_ps(x + l)));
+            s1 = _mm_add_ps(s1, _mm_mul_ps(f1, _mm_loadu_ps(x + l + 4)));
+        }
+        s0 = _mm_add_ps(s0, s1);
+        s0 = _mm_add_ps(s0, _mm_movehl_ps(s0, s0));
+        s0 = _mm_add_ss(s0, _mm_shuffle_ps(s0, s0, 1));
+        float sum = _mm_cvtss_f32(s0);
+        for (; l < n; l++) {
+            float t;
+            if (bf16) djiblas_widen_bf16(w + l, &t, 1);
+            else djiblas_widen_f16(w + l, &t, 1);
+            sum += t * x[l];
+        }
+        y[i] = sum;
+    }
+}
+
+void djiblas_gemv_f16_sse2(int d, int n, const UINT16 *W, const float *x, float *y) {
+    djiblas_gemv_half_core_sse2(d, n, W, FALSE, x, y);
+}
+
+void djiblas_gemv_bf16_sse2(int d, int n, const UINT16 *W, const float *x, float *y) {
+    djiblas_gemv_half_core_sse2(d, n, W, TRUE, x, y);
+}
+
+// packed: W holds DjibQuant v2 bytes (row i starts at byte i * n * 3 / 4); each
+// group segment is unpacked to int8 on the stack first (no pshufb in SSE2).
+static void djiblas_gemv_q6_core_sse2(int d, int n, const void *W, BOOLEAN packed, const float *S,
+                                      UINT64 e0, const float *x, float *y) {
+    INT8 seg[DJIBLAS_Q6_GROUP];
+    for (int i = 0; i < d; i++) {
+        const INT8 *row = (const INT8 *)W + (UINTN)i * (UINTN)n;
+        const UINT8 *prow = (const UINT8 *)W + (UINTN)i * (UINTN)n / 4 * 3;
+        UINT64 e = e0 + (UINT64)i * (UINT64)n;
+        __m128 acc = _mm_setzero_ps();
+        float tail = 0.0f;
+        int l = 0;
+        while (l < n) {
+            // One group (or the part of it inside this row).
+            UINT64 g = (e + (UINT64)l) / DJIBLAS_Q6_GROUP;
+            int end = (int)((g + 1) * DJIBLAS_Q6_GROUP - e);
+            if (end > n) end = n;
+            const INT8 *w = row;
+            if (packed) {
+                djiblas_unpack_q6p(prow + l / 4 * 3, seg, end - l);
+                w = seg - l;
+            }
+            __m128 s = _mm_setzero_ps();
+            for (; l + 16 <= end; l += 16) {
+                __m128i b = _mm_loadu_si128((const __m128i *)(w + l));
+                __m128i w_lo = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+                __m128i w_hi = _mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8);
+                __m128 f0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(w_lo, w_lo), 16));
+                __m128 f1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(w_lo, w_lo), 16));
+                __m128 f2 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(w_hi, w_hi), 16));
+                __m128 f3 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(w_hi, w_hi), 16));
+                s = _mm_add_ps(s, _mm_mul_ps(f0, _mm_loadu_ps(x + l)));
+                s = _mm_add_ps(s, _mm_mul_ps(f1, _mm_loadu_ps(x + l + 4)));
+                s = _mm_add_ps(s, _mm_mul_ps(f2, _mm_loadu_ps(x + l + 8)));
+                s = _mm_add_ps(s, _mm_mul_ps(f3, _mm_loadu_ps(x + l + 12)));
+            }
+            float st = 0.0f;
+            for (; l < end; l++) st += (float)w[l] * x[l];
+            acc = _mm_add_ps(acc, _mm_mul_ps(s, _mm_set1_ps(S[g])));
+            tail += st * S[g];
+        }
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+        y[i] = _mm_cvtss_f32(acc) + tail;
+    }
+}
+
+void djiblas_gemv_q6_sse2(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                          const float *x, float *y) {
+    djiblas_gemv_q6_core_sse2(d, n, W, FALSE, S, e0, x, y);
+}
+
+void djiblas_gemv_q6p_sse2(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                           const float *x, float *y) {
+    djiblas_gemv_q6_core_sse2(d, n, W, TRUE, S, e0, x, y);
+}
+
+#else
+
+void djiblas_quantize_q8_sse2(const float *x, int n, INT8 *xq, float *xd) {
+    for (int b = 0; b < n / DJIBLAS_Q8_BLOCK; b++) {
+        const float *p = x + b * DJIBLAS_Q8_BLOCK;
+        float m = 0.0f;
+        for (int j = 0; j < DJIBLAS_Q8_BLOCK; j++) {
+            float a = (p[j] < 0.0f) ? -p[j] : p[j];
+            if (a > m) m = a;
+        }
+        float id = (m > 0.0f) ? (127.0f / m) : 0.0f;
+        xd[b] = m / 127.0f;
+        for (int j = 0; j < DJIBLAS_Q8_BLOCK; j++) {
+            float v = p[j] * id;
+            xq[b * DJIBLAS_Q8_BLOCK + j] = (INT8)(INT32)(v + ((v >= 0.0f) ? 0.5f : -0.5f));
+        }
+    }
+}
+
+void djiblas_gemv_q8_sse2(int d, int n, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    djiblas_gemv_q8_scalar(d, n, W, Wd, xq, xd, y);
+}
+
+void djiblas_gemm_q8_sse2(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    djiblas_gemm_q8_scalar(d, n, ncol, W, Wd, xq, xd, Y, ldy);
+}
+
+void djiblas_gemv_q4_sse2(int d, int n, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    djiblas_gemv_q4_scalar(d, n, W, Wd, xq, xd, y);
+}
+
+void djiblas_gemm_q4_sse2(int d, int n, int ncol, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    djiblas_gemm_q4_scalar(d, n, ncol, W, Wd, xq, xd, Y, ldy);
+}
+
+static void djiblas_gemv_half_scalar(int d, int n, const UINT16 *W, BOOLEAN bf16,
+                                     const float *x, float *y) {
+    for (int i = 0; i < d; i++) {
+        const UINT16 *w = W + (UINTN)i * (UINTN)n;
+        float sum = 0.0f;
+        for (int l = 0; l < n; l++) {
+            float t;
+            if (bf16) djiblas_widen_bf16(w + l, &t, 1);
+            else djiblas_widen_f16(w + l, &t, 1);
+            sum += t * x[l];
+        }
+        y[i] = sum;
+    }
+}
+
+void djiblas_gemv_f16_sse2(int d, int n, const UINT16 *W, const float *x, float *y) {
+    djiblas_gemv_half_scalar(d, n, W, FALSE, x, y);
+}
+
+void djiblas_gemv_bf16_sse2(int d, int n, const UINT16 *W, const float *x, float *y) {
+    djiblas_gemv_half_scalar(d, n, W, TRUE, x, y);
+}
+
+void djiblas_gemv_q6_sse2(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                          const float *x, float *y) {
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        UINT64 e = e0 + (UINT64)i * (UINT64)n;
+        float sum = 0.0f;
+        for (int l = 0; l < n; l++) sum += (float)w[l] * S[(e + (UINT64)l) / DJIBLAS_Q6_GROUP] * x[l];
+        y[i] = sum;
+    }
+}
+
+void djiblas_gemv_q6p_sse2(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                           const float *x, float *y) {
+    INT8 seg[4];
+    for (int i = 0; i < d; i++) {
+        const UINT8 *w = W + (UINTN)i * (UINTN)n / 4 * 3;
+        UINT64 e = e0 + (UINT64)i * (UINT64)n;
+        float sum = 0.0f;
+        for (int l = 0; l < n; l += 4) {
+            djiblas_unpack_q6p(w + l / 4 * 3, seg, 4);
+            for (int j = 0; j < 4; j++) sum += (float)seg[j] * S[(e + (UINT64)(l + j)) / DJIBLAS_Q6_GROUP] * x[l + j];
+        }
+        y[i] = sum;
+    }
+}
+
+#endif
+
+// ===================================================================
+// DISPATCH TABLE
+// ===================================================================
+
+// Static SSE2 baseline so calls made before djiblas_dispatch_init() still work.
+DjibLasDispatch g_djiblas = {
+    .sgemm = djiblas_sgemm_sse2,
+    .gemv = djiblas_sgemv_sse2,
+    .dot = djiblas_dot_sse2,
+    .axpy = djiblas_axpy_sse2,
+    .attn = djiblas_attn_sse2,
+    .attn_f16 = djiblas_attn_f16_sse2,
+    .attn_q8 = djiblas_attn_q8_sse2,
+    .attn_gqa = djiblas_attn_gqa_sse2,
+    .attn_gqa_f16 = djiblas_attn_gqa_f16_sse2,
+    .attn_gqa_q8 = djiblas_attn_gqa_q8_sse2,
+    .rmsnorm = djiblas_rmsnorm_sse2,
+    .residual_rmsnorm = djiblas_residual_rmsnorm_sse2,
+    .softmax = djiblas_softmax_sse2,
+    .exp_sum = djiblas_exp_sum_sse2,
+    .silu = djiblas_silu_sse2,
+    .rope = djiblas_rope_sse2,
+    .dequant = djiblas_dequant_sse2,
+    .quant_q8 = djiblas_quantize_q8_sse2,
+    .gemv_q8 = djiblas_gemv_q8_sse2,
+    .gemm_q8 = djiblas_gemm_q8_sse2,
+    .gemv_q4 = djiblas_gemv_q4_sse2,
+    .gemm_q4 = djiblas_gemm_q4_sse2,
+    .gemv_f16 = djiblas_gemv_f16_sse2,
+    .gemv_bf16 = djiblas_gemv_bf16_sse2,
+    .gemv_q6 = djiblas_gemv_q6_sse2,
+    .gemv_q6p = djiblas_gemv_q6p_sse2,
+    .gate_up = djiblas_ffn_gate_up_blocked,
+    .llc_bytes = DJIBLAS_LLC_DEFAULT_BYTES,
+    .stream_pf = DJIBLAS_STREAM_PF_DEFAULT,
+    .stream_nta = FALSE,
+    .attn_auto_avx2 = FALSE,
+    .attn_force = -1,
+    .sgemm_name = L"SSE2",
+    .gemv_name = L"SSE2",
+    .attn_name = L"SSE2",
+    .dequant_name = L"SSE2",
+    .panel_name = L"none",
+    .q8_name = L"SSE2",
+    .q4_name = L"SSE2",
+    .f16_name = L"SSE2",
+    .bf16_name = L"SSE2",
+    .q6_name = L"SSE2",
+    .q6p_name = L"SSE2",
+    .vmath_name = L"SSE2",
+    .norm_name = L"SSE2",
+    .stream_name = L"none",
+};
+
+static const CHAR16 *djiblas_kernel_name(const CPUFeatures *f) {
+    if (f->has_avx512f) return L"AVX512F";
+    if (f->has_avx2 && f->has_fma) return L"AVX2+FMA";
+    if (f->has_sse2) return L"SSE2";
+    return L"scalar";
+}
+
+static void djiblas_dispatch_apply_attn(void) {
+    BOOLEAN use_avx2 = g_djiblas.attn_auto_avx2;
+    if (g_djiblas.attn_force == 0) use_avx2 = FALSE;
+    else if (g_djiblas.attn_force == 1) use_avx2 = TRUE;
+
+    if (use_avx2) {
+        g_djiblas.dot = llmk_dot_f32_avx2;
+        g_djiblas.axpy = llmk_axpy_f32_avx2;
+        g_djiblas.attn = djiblas_attn_avx2;
+        g_djiblas.attn_f16 = g_djiblas.cpu.has_f16c ? djiblas_attn_f16_f16c : djiblas_attn_f16_sse2;
+        g_djiblas.attn_q8 = djiblas_attn_q8_avx2;
+        g_djiblas.attn_gqa = djiblas_attn_gqa_avx2;
+        g_djiblas.attn_gqa_f16 = g_djiblas.cpu.has_f16c ? djiblas_attn_gqa_f16_f16c : djiblas_attn_gqa_f16_sse2;
+        g_djiblas.attn_gqa_q8 = djiblas_attn_gqa_q8_avx2;
+        g_djiblas.attn_name = L"AVX2";
+    } else {
+        g_djiblas.dot = djiblas_dot_sse2;
+        g_djiblas.axpy = djiblas_axpy_sse2;
+        g_djiblas.attn = djiblas_attn_sse2;
+        g_djiblas.attn_f16 = djiblas_attn_f16_sse2;
+        g_djiblas.attn_q8 = djiblas_attn_q8_sse2;
+        g_djiblas.attn_gqa = djiblas_attn_gqa_sse2;
+        g_djiblas.attn_gqa_f16 = djiblas_attn_gqa_f16_sse2;
+        g_djiblas.attn_gqa_q8 = djiblas_attn_gqa_q8_sse2;
+        g_djiblas.attn_name = L"SSE2";
+    }
+}
+
+void djiblas_dispatch_init(void) {
+    CPUFeatures *f = &g_djiblas.cpu;
+    djiblas_detect_cpu(f);
+
+    g_djiblas.sgemm = djiblas_get_best_kernel(f);
+    g_djiblas.gemv = djiblas_get_best_gemv_kernel(f);
+    g_djiblas.sgemm_name = djiblas_kernel_name(f);
+    g_djiblas.gemv_name = djiblas_kernel_name(f);
+
+    // attention_avx2.c is built with -mavx2 -mfma: require both.
+    g_djiblas.attn_auto_avx2 = (f->has_avx2 && f->has_fma);
+    if (g_djiblas.attn_force == 1 && !g_djiblas.attn_auto_avx2) g_djiblas.attn_force = -1;
+    djiblas_dispatch_apply_attn();
+
+    if (f->has_avx2 && f->has_fma) {
+        g_djiblas.dequant = djiblas_dequant_avx2;
+        g_djiblas.dequant_name = L"AVX2";
+    } else {
+        g_djiblas.dequant = djiblas_dequant_sse2;
+        g_djiblas.dequant_name = L"SSE2";
+    }
+
+    // Q8_0: vpdpbusd needs the EVEX YMM form (AVX512_VNNI + VL); the AVX2
+    // TU is built with -mfma, so it needs FMA as well.
+    if (f->has_avx512_vnni && f->has_avx512vl && f->has_avx2 && f->has_fma) {
+        g_djiblas.gemv_q8 = djiblas_gemv_q8_vnni;
+        g_djiblas.gemm_q8 = djiblas_gemm_q8_vnni;
+        g_djiblas.q8_name = L"AVX512-VNNI";
+    } else if (f->has_avx2 && f->has_fma) {
+        g_djiblas.gemv_q8 = djiblas_gemv_q8_avx2;
+        g_djiblas.gemm_q8 = djiblas_gemm_q8_avx2;
+        g_djiblas.q8_name = L"AVX2";
+    } else {
+        g_djiblas.gemv_q8 = djiblas_gemv_q8_sse2;
+        g_djiblas.gemm_q8 = djiblas_gemm_q8_sse2;
+        g_djiblas.q8_name = L"SSE2";
+    }
+    g_djiblas.quant_q8 = (f->has_avx2 && f->has_fma) ? djiblas_quantize_q8_avx2 : djiblas_quantize_q8_sse2;
+    g_djiblas.gemv_q4 = (f->has_avx2 && f->has_fma) ? djiblas_gemv_q4_avx2 : djiblas_gemv_q4_sse2;
+    g_djiblas.gemm_q4 = (f->has_avx2 && f->has_fma) ? djiblas_gemm_q4_avx2 : djiblas_gemm_q4_sse2;
+    g_djiblas.q4_name = (f->has_avx2 && f->has_fma) ? L"AVX2" : L"SSE2";
+
+    if (f->has_avx512f) {
+        g_djiblas.gemv_f16 = djiblas_gemv_f16_avx512;
+        g_djiblas.f16_name = L"AVX512F";
+        g_djiblas.gemv_bf16 = djiblas_gemv_bf16_avx512;
+        g_djiblas.bf16_name = L"AVX512F";
+    } else if (f->has_avx2 && f->has_fma) {
+        if (f->has_f16c) {
+            g_djiblas.gemv_f16 = djiblas_gemv_f16_f16c;
+            g_djiblas.f16_name = L"F16C";
+        } else {
+            g_djiblas.gemv_f16 = djiblas_gemv_f16_sse2;
+            g_djiblas.f16_name = L"SSE2";
+        }
+        g_djiblas.gemv_bf16 = djiblas_gemv_bf16_avx2;
+        g_djiblas.bf16_name = L"AVX2";
+    } else {
+        g_djiblas.gemv_f16 = djiblas_gemv_f16_sse2;
+        g_djiblas.f16_name = L"SSE2";
+        g_djiblas.gemv_bf16 = djiblas_gemv_bf16_sse2;
+        g_djiblas.bf16_name = L"SSE2";
+    }
+
+    if (f->has_avx512f) {
+        g_djiblas.gemv_q6 = djiblas_gemv_q6_avx512;
+        g_djiblas.q6_name = L"AVX512F";
+    } else if (f->has_avx2 && f->has_fma) {
+        g_djiblas.gemv_q6 = djiblas_gemv_q6_avx2;
+        g_djiblas.q6_name = L"AVX2";
+    } else {
+        g_djiblas.gemv_q6 = djiblas_gemv_q6_sse2;
+        g_djiblas.q6_name = L"SSE2";
+    }
+    // The packed unpack is pshufb + vpsllvd; AVX-512 CPUs take the AVX2 kernel.
+    if (f->has_avx2 && f->has_fma) {
+        g_djiblas.gemv_q6p = djiblas_gemv_q6p_avx2;
+        g_djiblas.q6p_name = L"AVX2";
+    } else {
+        g_djiblas.gemv_q6p = djiblas_gemv_q6p_sse2;
+        g_djiblas.q6p_name = L"SSE2";
+    }
+
+    // Integer Q6 against the cached activation: only where an int8 dot
+    // instruction beats the fp32 kernel (no SSE2 variant).
+    if (f->has_avx512_vnni && f->has_avx512vl && f->has_avx2 && f->has_fma) {
+        g_djiblas.gemv_q6_q8 = djiblas_gemv_q6_q8_vnni;
+    } else if (f->has_avx2 && f->has_fma) {
+        g_djiblas.gemv_q6_q8 = djiblas_gemv_q6_q8_avx2;
+    }
+    if (f->has_avx2 && f->has_fma) g_djiblas.gemv_q6p_q8 = djiblas_gemv_q6p_q8_avx2;
+
+    // Panel width follows the GEMV vector width.
+    if (f->has_avx512f) {
+        g_djiblas.gate_up = djiblas_ffn_gate_up_avx512;
+        g_djiblas.gate_up_panel = djiblas_ffn_gate_up_panel16_avx512;
+        g_djiblas.gemv_panel = djiblas_sgemv_panel16_avx512;
+        g_djiblas.panel_rows = 16;
+        g_djiblas.panel_width = 16;
+        g_djiblas.panel_name = L"AVX512F 16x16";
+    } else if (f->has_avx2 && f->has_fma) {
+        g_djiblas.gate_up = djiblas_ffn_gate_up_avx2;
+        g_djiblas.gate_up_panel = djiblas_ffn_gate_up_panel8_avx2;
+        g_djiblas.gemv_panel = djiblas_sgemv_panel8_avx2;
+        g_djiblas.panel_rows = 8;
+        g_djiblas.panel_width = 8;
+        g_djiblas.panel_name = L"AVX2 8x8";
+    } else {
+        g_djiblas.gate_up = djiblas_ffn_gate_up_blocked;
+        g_djiblas.gate_up_panel = 0;
+        g_djiblas.gemv_panel = 0;
+        g_djiblas.panel_rows = 0;
+        g_djiblas.panel_width = 0;
+        g_djiblas.panel_name = L"none";
+    }
+
+    // Streaming kernels: AVX-512 CPUs take the AVX2 row-major one (memory
+    // bound either way) and a panel16 variant matching their repack layout.
+    g_djiblas.gemv_stream = 0;
+    g_djiblas.gate_up_stream = 0;
+    g_djiblas.gemv_panel_stream = 0;
+    g_djiblas.gate_up_panel_stream = 0;
+    g_djiblas.stream_name = L"none";
+    if (f->has_avx2 && f->has_fma) {
+        g_djiblas.gemv_stream = djiblas_sgemv_stream_avx2;
+        g_djiblas.gate_up_stream = djiblas_ffn_gate_up_stream_avx2;
+        if (f->has_avx512f) {
+            g_djiblas.gemv_panel_stream = djiblas_sgemv_panel16_stream_avx512;
+            g_djiblas.gate_up_panel_stream = djiblas_ffn_gate_up_panel16_stream_avx512;
+            g_djiblas.stream_name = L"AVX2 rows + AVX512F 16x16";
+        } else {
+            g_djiblas.gemv_panel_stream = djiblas_sgemv_panel8_stream_avx2;
+            g_djiblas.gate_up_panel_stream = djiblas_ffn_gate_up_panel8_stream_avx2;
+            g_djiblas.stream_name = L"AVX2";
+        }
+    }
+    djiblas_stream_config(0, g_djiblas.stream_pf, g_djiblas.stream_nta);
+
+    g_djiblas.rmsnorm = djiblas_rmsnorm_sse2;
+    if (f->has_avx2 && f->has_fma) {
+        g_djiblas.residual_rmsnorm = djiblas_residual_rmsnorm_avx2;
+        g_djiblas.rope = djiblas_rope_avx2;
+        g_djiblas.norm_name = L"AVX2";
+    } else {
+        g_djiblas.residual_rmsnorm = djiblas_residual_rmsnorm_sse2;
+        g_djiblas.rope = djiblas_rope_sse2;
+        g_djiblas.norm_name = L"SSE2";
+    }
+    // exp-based primitives (softmax, SwiGLU) share one vector exp per ISA.
+    if (f->has_avx512f) {
+        g_djiblas.softmax = djiblas_softmax_avx512;
+        g_djiblas.exp_sum = djiblas_exp_sum_avx512;
+        g_djiblas.silu = djiblas_silu_avx512;
+        g_djiblas.vmath_name = L"AVX512F";
+    } else if (f->has_avx2 && f->has_fma) {
+        g_djiblas.softmax = djiblas_softmax_avx2;
+        g_djiblas.exp_sum = djiblas_exp_sum_avx2;
+        g_djiblas.silu = djiblas_silu_avx2;
+        g_djiblas.vmath_name = L"AVX2+FMA";
+    } else {
+        g_djiblas.softmax = djiblas_softmax_sse2;
+        g_djiblas.exp_sum = djiblas_exp_sum_sse2;
+        g_djiblas.silu = djiblas_silu_sse2;
+        g_djiblas.vmath_name = L"SSE2";
+    }
+    g_djiblas.initialized = TRUE;
+}
+
+void djiblas_stream_config(UINT64 llc_bytes, int pf_bytes, BOOLEAN nta) {
+    if (llc_bytes == 0) llc_bytes = g_djiblas.cpu.llc_bytes;
+    if (llc_bytes == 0) llc_bytes = DJIBLAS_LLC_DEFAULT_BYTES;
+    if (pf_bytes < 0) pf_bytes = 0;
+    g_djiblas.llc_bytes = llc_bytes;
+    g_djiblas.stream_pf = (pf_bytes + 63) & ~63;
+    g_djiblas.stream_nta = nta;
+}
+
+BOOLEAN djiblas_dispatch_force_attn(int mode) {
+    if (mode == 1 && !g_djiblas.attn_auto_avx2) return FALSE;
+    if (mode < -1 || mode > 1) return FALSE;
+    g_djiblas.attn_force = mode;
+    djiblas_dispatch_apply_attn();
+    return TRUE;
+}
+
 // ===================================================================
 // PUBLIC API
 // ===================================================================
@@ -192,8 +1641,575 @@ void djiblas_sgemm_f32(int m, int n, int k,
                         const float *A, int lda,
                         const float *B, int ldb,
                         float *C, int ldc) {
-    CPUFeatures features;
-    djiblas_detect_cpu(&features);
-    sgemm_kernel_t kernel = djiblas_get_best_kernel(&features);
-    kernel(m, n, k, A, lda, B, ldb, C, ldc);
+    g_djiblas.sgemm(m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+void djiblas_sgemv_f32(int d, int n,
+                       const float *W, int ldw,
+                       const float *x,
+                       float *y) {
+    g_djiblas.gemv(d, n, W, ldw, x, y);
+}
+
+UINT64 djiblas_workspace_bytes(int max_cols) {
+    UINT64 nb = (UINT64)(max_cols + DJIBLAS_Q8_BLOCK - 1) / DJIBLAS_Q8_BLOCK;
+    return nb * DJIBLAS_Q8_BLOCK + nb * sizeof(float) + 64;
+}
+
+void djiblas_set_workspace(void *buf, UINT64 bytes) {
+    g_djiblas.ws_q = 0;
+    g_djiblas.ws_d = 0;
+    g_djiblas.ws_cols = 0;
+    g_djiblas.act_x = 0;
+    g_djiblas.act_n = 0;
+    if (!buf || bytes < djiblas_workspace_bytes(DJIBLAS_Q8_BLOCK)) return;
+
+    // [ int8 q | fp32 scales ], scales 4-byte aligned after the q bytes.
+    UINT64 nb = (bytes - 64) / (DJIBLAS_Q8_BLOCK + sizeof(float));
+    UINTN q_end = (UINTN)buf + (UINTN)(nb * DJIBLAS_Q8_BLOCK);
+    g_djiblas.ws_q = (INT8 *)buf;
+    g_djiblas.ws_d = (float *)((q_end + 3) & ~(UINTN)3);
+    g_djiblas.ws_cols = (int)(nb * DJIBLAS_Q8_BLOCK);
+}
+
+// Quantize columns B_j0 .. B_j0+nc back to back into the workspace, column j
+// at ws_q + j*k, ws_d + j*k/32 (the layout of the multi-column kernels).
+static void djiblas_q8_quant_cols(const float *B, int ldb, int k, int nc) {
+    g_djiblas.act_x = 0;
+    for (int j = 0; j < nc; j++) {
+        g_djiblas.quant_q8(B + (UINTN)ldb * j, k, g_djiblas.ws_q + (UINTN)j * (UINTN)k,
+                           g_djiblas.ws_d + (UINTN)j * (UINTN)(k / DJIBLAS_Q8_BLOCK));
+    }
+}
+
+void djiblas_sgemm_q8(int m, int n, int k,
+                      const INT8 *A, const float *Ad, int lda,
+                      const float *B, int ldb,
+                      float *C, int ldc) {
+    const float *Adr = Ad;
+    int nb = lda / DJIBLAS_Q8_BLOCK;
+    // As many columns as fit the workspace are quantized back to back and go
+    // through the multi-column kernel: each weight row is read once per
+    // group of columns instead of once per column.
+    int per = (lda == k && k > 0) ? g_djiblas.ws_cols / k : 0;
+    if (per > 0) {
+        for (int j0 = 0; j0 < n; j0 += per) {
+            int nc = (n - j0 < per) ? (n - j0) : per;
+            djiblas_q8_quant_cols(B + (UINTN)ldb * j0, ldb, k, nc);
+            g_djiblas.gemm_q8(m, k, nc, A, Adr, g_djiblas.ws_q, g_djiblas.ws_d, C + (UINTN)ldc * j0, ldc);
+        }
+        return;
+    }
+    for (int j = 0; j < n; j++) {
+        const float *b = B + (UINTN)ldb * j;
+        float *c = C + (UINTN)ldc * j;
+        // No workspace (or strided rows): dequantize 32 at a time and dot in fp32.
+        for (int i = 0; i < m; i++) {
+            const INT8 *a = A + (UINTN)lda * i;
+            float w[DJIBLAS_Q8_BLOCK];
+            float sum = 0.0f;
+            for (int l = 0; l < k; l += DJIBLAS_Q8_BLOCK) {
+                g_djiblas.dequant(a + l, Adr[(UINTN)nb * i + l / DJIBLAS_Q8_BLOCK], w, DJIBLAS_Q8_BLOCK);
+                sum += g_djiblas.dot(w, b + l, DJIBLAS_Q8_BLOCK);
+            }
+            c[i] = sum;
+        }
+    }
+}
+
+// ===================================================================
+// MATRIX DESCRIPTORS
+// ===================================================================
+void djiblas_matrix_init_f32(DjibLasMatrix *M, const float *data, int rows, int cols) {
+    M->data = data;
+    M->type = DJIBLAS_MAT_F32;
+    M->rows = rows;
+    M->cols = cols;
+    M->layer_stride = (UINT64)rows * (UINT64)cols;
+    M->panel_rows = 0;
+    M->panel_width = 0;
+    M->scales = 0;
+    M->gemv = 0;
+    M->sgemm = 0;
+    M->row_block = 0;
+    M->stream = FALSE;
+}
+
+void djiblas_matrix_init_q8(DjibLasMatrix *M, const INT8 *q, const float *scales, int rows, int cols) {
+    M->data = q;
+    M->type = DJIBLAS_MAT_Q8_0;
+    M->rows = rows;
+    M->cols = cols;
+    M->layer_stride = (UINT64)rows * (UINT64)cols;
+    M->panel_rows = 0;
+    M->panel_width = 0;
+    M->scales = scales;
+    M->gemv = 0;
+    M->sgemm = 0;
+    M->row_block = 0;
+    M->stream = FALSE;
+}
+
+void djiblas_matrix_init_q6(DjibLasMatrix *M, const INT8 *q, const float *scales, int rows, int cols) {
+    djiblas_matrix_init_q8(M, q, scales, rows, cols);
+    M->type = DJIBLAS_MAT_Q6;
+}
+
+void djiblas_matrix_init_q4(DjibLasMatrix *M, const UINT8 *q, const float *scales, int rows, int cols) {
+    djiblas_matrix_init_q8(M, (const INT8 *)q, scales, rows, cols);
+    M->type = DJIBLAS_MAT_Q4;
+}
+
+void djiblas_matrix_init_half(DjibLasMatrix *M, int type, const UINT16 *data, int rows, int cols) {
+    djiblas_matrix_init_f32(M, (const float *)data, rows, cols);
+    M->type = type;
+}
+
+void djiblas_matrix_init_q6p(DjibLasMatrix *M, const UINT8 *q, const float *scales, int rows, int cols) {
+    djiblas_matrix_init_q8(M, (const INT8 *)q, scales, rows, cols);
+    M->type = DJIBLAS_MAT_Q6P;
+}
+
+BOOLEAN djiblas_matrix_set_stream(DjibLasMatrix *M, int n_layers) {
+    // The whole stacked tensor passes through the cache once per token, so
+    // that (not one layer) is what is compared against the LLC.
+    UINT64 bytes = (UINT64)n_layers * M->layer_stride * sizeof(float);
+    // A panel is already one sequential stream that the hardware prefetcher
+    // follows, so a T0 prefetch only adds instructions there; only the NTA
+    // hint (keeping the weights out of the outer caches) is worth it.
+    BOOLEAN kernel = FALSE;
+    if (M->type == DJIBLAS_MAT_F32) kernel = (g_djiblas.gemv_stream != 0);
+    else if (M->type == DJIBLAS_MAT_F32_PANEL) kernel = (g_djiblas.gemv_panel_stream != 0) && g_djiblas.stream_nta;
+    M->stream = kernel && g_djiblas.stream_pf > 0 && bytes > g_djiblas.llc_bytes;
+    return M->stream;
+}
+
+BOOLEAN djiblas_act_quantize(const float *x, int n) {
+    g_djiblas.act_x = 0;
+    if (n > g_djiblas.ws_cols || (n % DJIBLAS_Q8_BLOCK) != 0) return FALSE;
+    g_djiblas.quant_q8(x, n, g_djiblas.ws_q, g_djiblas.ws_d);
+    g_djiblas.act_x = x;
+    g_djiblas.act_n = n;
+    return TRUE;
+}
+
+void djiblas_act_release(void) {
+    g_djiblas.act_x = 0;
+}
+
+// x is the activation held by djiblas_act_quantize().
+static BOOLEAN djiblas_act_cached(const float *x, int n) {
+    return x == g_djiblas.act_x && n == g_djiblas.act_n;
+}
+
+// Quantize x into the workspace for the Q8 kernels (unless it is already
+// there). FALSE if it does not fit (callers then take the fp32 fallback in
+// djiblas_sgemm_q8).
+static BOOLEAN djiblas_q8_prepare(const float *x, int n) {
+    if (djiblas_act_cached(x, n)) return TRUE;
+    if (n > g_djiblas.ws_cols) return FALSE;
+    g_djiblas.act_x = 0;
+    g_djiblas.quant_q8(x, n, g_djiblas.ws_q, g_djiblas.ws_d);
+    return TRUE;
+}
+
+BOOLEAN djiblas_matrix_act_q8(const DjibLasMatrix *M) {
+    if (!g_djiblas.ws_cols) return FALSE;
+    if (M->type == DJIBLAS_MAT_Q8_0 || M->type == DJIBLAS_MAT_Q4) return TRUE;
+    if (M->type == DJIBLAS_MAT_Q6) return g_djiblas.gemv_q6_q8 != 0;
+    if (M->type == DJIBLAS_MAT_Q6P) return g_djiblas.gemv_q6p_q8 != 0;
+    return FALSE;
+}
+
+// Rows [r0, r1) of a Q8_0 or Q4 matrix; have_xq: x is already in the workspace.
+static void djiblas_q8_rows(const DjibLasMatrix *M, int layer, int r0, int r1,
+                            const float *x, BOOLEAN have_xq, float *y) {
+    int n = M->cols;
+    UINT64 e0 = (UINT64)layer * M->layer_stride + (UINT64)r0 * (UINT64)n;
+    const INT8 *W = (const INT8 *)M->data + e0;
+    const float *Wd = M->scales + e0 / DJIBLAS_Q8_BLOCK;
+    if (M->type == DJIBLAS_MAT_Q4) {
+        const UINT8 *W4 = (const UINT8 *)M->data + e0 / 2;
+        if (have_xq) {
+            g_djiblas.gemv_q4(r1 - r0, n, W4, Wd, g_djiblas.ws_q, g_djiblas.ws_d, y);
+            return;
+        }
+        // No workspace: unpack and dot against the float activation.
+        int nb = n / DJIBLAS_Q8_BLOCK;
+        for (int i = 0; i < r1 - r0; i++) {
+            const UINT8 *row = W4 + (UINTN)i * (UINTN)nb * DJIBLAS_Q4_BLOCK_BYTES;
+            INT8 q[DJIBLAS_Q8_BLOCK];
+            float w[DJIBLAS_Q8_BLOCK];
+            float sum = 0.0f;
+            for (int b = 0; b < nb; b++) {
+                djiblas_unpack_q4(row + b * DJIBLAS_Q4_BLOCK_BYTES, q);
+                g_djiblas.dequant(q, Wd[(UINTN)i * (UINTN)nb + b], w, DJIBLAS_Q8_BLOCK);
+                sum += g_djiblas.dot(w, x + b * DJIBLAS_Q8_BLOCK, DJIBLAS_Q8_BLOCK);
+            }
+            y[i] = sum;
+        }
+        return;
+    }
+    if (have_xq) {
+        g_djiblas.gemv_q8(r1 - r0, n, W, Wd, g_djiblas.ws_q, g_djiblas.ws_d, y);
+    } else {
+        djiblas_sgemm_q8(r1 - r0, 1, n, W, Wd, n, x, n, y, r1 - r0);
+    }
+}
+
+void djiblas_gemv_rows(const DjibLasMatrix *M, int layer, int r0, int r1, const float *x, float *y) {
+    const float *W = (const float *)M->data + (UINTN)layer * (UINTN)M->layer_stride;
+    int n = M->cols;
+    if (r1 <= r0) return;
+
+    if (M->type == DJIBLAS_MAT_Q8_0 || M->type == DJIBLAS_MAT_Q4) {
+        djiblas_q8_rows(M, layer, r0, r1, x, djiblas_q8_prepare(x, n), y);
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_Q6) {
+        UINT64 e0 = (UINT64)layer * M->layer_stride + (UINT64)r0 * (UINT64)n;
+        // act_n is a multiple of 32, hence so is e0: blocks stay inside a group.
+        if (g_djiblas.gemv_q6_q8 && djiblas_act_cached(x, n)) {
+            g_djiblas.gemv_q6_q8(r1 - r0, n, (const INT8 *)M->data + e0, M->scales, e0,
+                                 g_djiblas.ws_q, g_djiblas.ws_d, y);
+            return;
+        }
+        g_djiblas.gemv_q6(r1 - r0, n, (const INT8 *)M->data + e0, M->scales, e0, x, y);
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_Q6P) {
+        UINT64 e0 = (UINT64)layer * M->layer_stride + (UINT64)r0 * (UINT64)n;
+        if (g_djiblas.gemv_q6p_q8 && djiblas_act_cached(x, n)) {
+            g_djiblas.gemv_q6p_q8(r1 - r0, n, (const UINT8 *)M->data + e0 / 4 * 3, M->scales, e0,
+                                  g_djiblas.ws_q, g_djiblas.ws_d, y);
+            return;
+        }
+        g_djiblas.gemv_q6p(r1 - r0, n, (const UINT8 *)M->data + e0 / 4 * 3, M->scales, e0, x, y);
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_F16 || M->type == DJIBLAS_MAT_BF16) {
+        const UINT16 *H = (const UINT16 *)M->data + (UINTN)layer * (UINTN)M->layer_stride + (UINTN)r0 * (UINTN)n;
+        if (M->type == DJIBLAS_MAT_F16) g_djiblas.gemv_f16(r1 - r0, n, H, x, y);
+        else g_djiblas.gemv_bf16(r1 - r0, n, H, x, y);
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_F32_PANEL) {
+        // The kernel works on whole panels. Partial panels at either end are
+        // computed into a small buffer and only the requested rows copied out.
+        int R = M->panel_rows;
+        float part[16];
+        int r = r0;
+        while (r < r1) {
+            int p0 = r - (r % R);
+            const float *P = W + (UINTN)p0 * (UINTN)n;
+            if (r == p0 && r + R <= r1) {
+                int whole = ((r1 - r) / R) * R;
+                if (M->stream) g_djiblas.gemv_panel_stream(whole, n, P, x, y + (r - r0));
+                else g_djiblas.gemv_panel(whole, n, P, x, y + (r - r0));
+                r += whole;
+            } else {
+                int end = (p0 + R < r1) ? (p0 + R) : r1;
+                g_djiblas.gemv_panel(R, n, P, x, part);
+                for (int i = r; i < end; i++) y[i - r0] = part[i - p0];
+                r = end;
+            }
+        }
+        return;
+    }
+    // A tuned kernel wins; the tuner times the streaming one on M->stream tensors.
+    sgemv_kernel_t gemv = M->gemv ? M->gemv : (M->stream ? g_djiblas.gemv_stream : g_djiblas.gemv);
+    gemv(r1 - r0, n, W + (UINTN)r0 * (UINTN)n, n, x, y);
+}
+
+void djiblas_gemv(const DjibLasMatrix *M, int layer, const float *x, float *y) {
+    djiblas_gemv_rows(M, layer, 0, M->rows, x, y);
+}
+
+void djiblas_gemm_rows(const DjibLasMatrix *M, int layer, int r0, int r1,
+                       const float *X, int ldx, int ntok, float *Y, int ldy) {
+    const float *W = (const float *)M->data + (UINTN)layer * (UINTN)M->layer_stride;
+    int n = M->cols;
+    if (r1 <= r0 || ntok <= 0) return;
+
+    if (M->type == DJIBLAS_MAT_Q8_0) {
+        UINT64 e0 = (UINT64)layer * M->layer_stride + (UINT64)r0 * (UINT64)n;
+        djiblas_sgemm_q8(r1 - r0, ntok, n,
+                         (const INT8 *)M->data + e0, M->scales + e0 / DJIBLAS_Q8_BLOCK, n,
+                         X, ldx, Y, ldy);
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_Q4) {
+        // As djiblas_sgemm_q8: token columns quantized in groups that fit the
+        // workspace, each group through the multi-column kernel.
+        int per = g_djiblas.ws_cols / n;
+        if (per > 0) {
+            UINT64 e0 = (UINT64)layer * M->layer_stride + (UINT64)r0 * (UINT64)n;
+            for (int t0 = 0; t0 < ntok; t0 += per) {
+                int nc = (ntok - t0 < per) ? (ntok - t0) : per;
+                djiblas_q8_quant_cols(X + (UINTN)t0 * (UINTN)ldx, ldx, n, nc);
+                g_djiblas.gemm_q4(r1 - r0, n, nc, (const UINT8 *)M->data + e0 / 2, M->scales + e0 / DJIBLAS_Q8_BLOCK,
+                                  g_djiblas.ws_q, g_djiblas.ws_d, Y + (UINTN)t0 * (UINTN)ldy, ldy);
+            }
+            return;
+        }
+        // No workspace: the fp32 fallback one token at a time.
+        for (int t = 0; t < ntok; t++) {
+            const float *x = X + (UINTN)t * (UINTN)ldx;
+            djiblas_q8_rows(M, layer, r0, r1, x, djiblas_q8_prepare(x, n), Y + (UINTN)t * (UINTN)ldy);
+        }
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_Q6 || M->type == DJIBLAS_MAT_Q6P ||
+        M->type == DJIBLAS_MAT_F16 || M->type == DJIBLAS_MAT_BF16) {
+        // Same token-inner idea as the panels: a block of rows (16 unless
+        // tuned) stays in cache while every token of the block goes through it.
+        int B = M->row_block > 0 ? M->row_block : 16;
+        for (int i = r0; i < r1; i += B) {
+            int end = (i + B < r1) ? (i + B) : r1;
+            for (int t = 0; t < ntok; t++) {
+                djiblas_gemv_rows(M, layer, i, end, X + (UINTN)t * (UINTN)ldx, Y + (UINTN)t * (UINTN)ldy + (i - r0));
+            }
+        }
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_F32_PANEL) {
+        // Token-inner loop: a block of panels (one R x n panel unless tuned)
+        // is pulled from memory once and then hit in cache for every token.
+        int R = M->panel_rows;
+        int B = (M->row_block > R) ? M->row_block - M->row_block % R : R;
+        float part[16];
+        for (int b0 = r0 - (r0 % R); b0 < r1; b0 += B) {
+            int b1 = (b0 + B < r1) ? (b0 + B) : r1;
+            for (int t = 0; t < ntok; t++) {
+                const float *x = X + (UINTN)t * (UINTN)ldx;
+                float *y = Y + (UINTN)t * (UINTN)ldy - r0;
+                for (int p0 = b0; p0 < b1; p0 += R) {
+                    const float *P = W + (UINTN)p0 * (UINTN)n;
+                    int lo = (p0 > r0) ? p0 : r0;
+                    int hi = (p0 + R < r1) ? (p0 + R) : r1;
+                    if (lo == p0 && hi == p0 + R) {
+                        g_djiblas.gemv_panel(R, n, P, x, y + p0);
+                    } else {
+                        g_djiblas.gemv_panel(R, n, P, x, part);
+                        for (int i = lo; i < hi; i++) y[i] = part[i - p0];
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    // C[ldc*j + i] = A_i . B_j with A = weight rows, B = token rows, so each
+    // token's outputs land contiguously in Y.
+    sgemm_kernel_t sgemm = M->sgemm ? M->sgemm : g_djiblas.sgemm;
+    sgemm(r1 - r0, ntok, n,
+          W + (UINTN)r0 * (UINTN)n, n,
+          X, ldx,
+          Y, ldy);
+}
+
+void djiblas_gemm(const DjibLasMatrix *M, int layer,
+                  const float *X, int ldx, int ntok, float *Y, int ldy) {
+    djiblas_gemm_rows(M, layer, 0, M->rows, X, ldx, ntok, Y, ldy);
+}
+
+void djiblas_ffn_gate_up_blocked(int d, int n, const float *W1, const float *W3, int ldw,
+                                 const float *x, float *hb) {
+    // Baseline: 16 rows of gate and up at a time through the selected GEMV,
+    // SwiGLU from a small stack block instead of a hidden_dim-sized hb2.
+    float u[16];
+    for (int i = 0; i < d; i += 16) {
+        int rows = (d - i < 16) ? (d - i) : 16;
+        g_djiblas.gemv(rows, n, W1 + (UINTN)ldw * i, ldw, x, hb + i);
+        g_djiblas.gemv(rows, n, W3 + (UINTN)ldw * i, ldw, x, u);
+        g_djiblas.silu(hb + i, u, rows);
+    }
+}
+
+void djiblas_ffn_gate_up(const DjibLasMatrix *W1, const DjibLasMatrix *W3, int layer,
+                         const float *x, float *hb) {
+    const float *A = (const float *)W1->data + (UINTN)layer * (UINTN)W1->layer_stride;
+    const float *B = (const float *)W3->data + (UINTN)layer * (UINTN)W3->layer_stride;
+    int d = W1->rows;
+    int n = W1->cols;
+
+    BOOLEAN stream = W1->stream && W3->stream;
+    if (W1->type == DJIBLAS_MAT_F32 && W3->type == DJIBLAS_MAT_F32) {
+        if (stream) g_djiblas.gate_up_stream(d, n, A, B, n, x, hb);
+        else g_djiblas.gate_up(d, n, A, B, n, x, hb);
+        return;
+    }
+    if (W1->type == DJIBLAS_MAT_F32_PANEL && W3->type == DJIBLAS_MAT_F32_PANEL &&
+        g_djiblas.gate_up_panel) {
+        if (stream) g_djiblas.gate_up_panel_stream(d, n, A, B, x, hb);
+        else g_djiblas.gate_up_panel(d, n, A, B, x, hb);
+        return;
+    }
+
+    float u[16];
+    if ((W1->type == DJIBLAS_MAT_Q8_0 || W1->type == DJIBLAS_MAT_Q4) &&
+        (W3->type == DJIBLAS_MAT_Q8_0 || W3->type == DJIBLAS_MAT_Q4)) {
+        // x is quantized once for both projections.
+        BOOLEAN have_xq = djiblas_q8_prepare(x, n);
+        for (int i = 0; i < d; i += 16) {
+            int end = (i + 16 < d) ? (i + 16) : d;
+            djiblas_q8_rows(W1, layer, i, end, x, have_xq, hb + i);
+            djiblas_q8_rows(W3, layer, i, end, x, have_xq, u);
+            g_djiblas.silu(hb + i, u, end - i);
+        }
+        return;
+    }
+
+    // Mixed layouts: row blocks through the generic row-range GEMV.
+    for (int i = 0; i < d; i += 16) {
+        int end = (i + 16 < d) ? (i + 16) : d;
+        djiblas_gemv_rows(W1, layer, i, end, x, hb + i);
+        djiblas_gemv_rows(W3, layer, i, end, x, u);
+        g_djiblas.silu(hb + i, u, end - i);
+    }
+}
+
+void djiblas_gemv_split3(const DjibLasMatrix *M, int layer, const float *x,
+                         float *y0, int n0, float *y1, int n1, float *y2, int n2) {
+    // Rows are contiguous, so the three calls walk the layer's weights as one
+    // forward stream while x stays hot in L1.
+    if (M->type == DJIBLAS_MAT_Q8_0 || M->type == DJIBLAS_MAT_Q4) {
+        BOOLEAN have_xq = djiblas_q8_prepare(x, M->cols);
+        djiblas_q8_rows(M, layer, 0, n0, x, have_xq, y0);
+        djiblas_q8_rows(M, layer, n0, n0 + n1, x, have_xq, y1);
+        djiblas_q8_rows(M, layer, n0 + n1, n0 + n1 + n2, x, have_xq, y2);
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_F32_PANEL) {
+        // One pass over the panels: a run of whole panels inside one output
+        // goes straight to it, a panel straddling a boundary (kv_dim not a
+        // multiple of R) is computed once and its rows scattered.
+        const float *W = (const float *)M->data + (UINTN)layer * (UINTN)M->layer_stride;
+        int R = M->panel_rows;
+        int n = M->cols;
+        int base[4] = { 0, n0, n0 + n1, n0 + n1 + n2 };
+        float *dst[3] = { y0, y1, y2 };
+        float part[16];
+        int r = 0, s = 0;
+        while (r < base[3]) {
+            while (r >= base[s + 1]) s++;
+            const float *P = W + (UINTN)r * (UINTN)n;
+            if (r + R <= base[s + 1]) {
+                int whole = ((base[s + 1] - r) / R) * R;
+                if (M->stream) g_djiblas.gemv_panel_stream(whole, n, P, x, dst[s] + (r - base[s]));
+                else g_djiblas.gemv_panel(whole, n, P, x, dst[s] + (r - base[s]));
+                r += whole;
+            } else {
+                int end = (r + R < base[3]) ? (r + R) : base[3];
+                g_djiblas.gemv_panel(R, n, P, x, part);
+                for (int i = r; i < end; i++) {
+                    while (i >= base[s + 1]) s++;
+                    dst[s][i - base[s]] = part[i - r];
+                }
+                r = end;
+            }
+        }
+        return;
+    }
+    djiblas_gemv_rows(M, layer, 0, n0, x, y0);
+    djiblas_gemv_rows(M, layer, n0, n0 + n1, x, y1);
+    djiblas_gemv_rows(M, layer, n0 + n1, n0 + n1 + n2, x, y2);
+}
+
+void djiblas_matrix_get_row(const DjibLasMatrix *M, int row, float *out) {
+    const float *W = (const float *)M->data;
+    int n = M->cols;
+    if (M->type == DJIBLAS_MAT_Q8_0) {
+        UINT64 e0 = (UINT64)row * (UINT64)n;
+        const INT8 *q = (const INT8 *)M->data + e0;
+        const float *d = M->scales + e0 / DJIBLAS_Q8_BLOCK;
+        for (int l = 0; l < n; l += DJIBLAS_Q8_BLOCK) {
+            g_djiblas.dequant(q + l, d[l / DJIBLAS_Q8_BLOCK], out + l, DJIBLAS_Q8_BLOCK);
+        }
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_F16 || M->type == DJIBLAS_MAT_BF16) {
+        const UINT16 *h = (const UINT16 *)M->data + (UINTN)row * (UINTN)n;
+        if (M->type == DJIBLAS_MAT_F16) djiblas_widen_f16(h, out, n);
+        else djiblas_widen_bf16(h, out, n);
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_Q4) {
+        UINT64 e0 = (UINT64)row * (UINT64)n;
+        const UINT8 *p = (const UINT8 *)M->data + e0 / 2;
+        const float *d = M->scales + e0 / DJIBLAS_Q8_BLOCK;
+        INT8 q[DJIBLAS_Q8_BLOCK];
+        for (int l = 0; l < n; l += DJIBLAS_Q8_BLOCK) {
+            djiblas_unpack_q4(p + l / 2, q);
+            g_djiblas.dequant(q, d[l / DJIBLAS_Q8_BLOCK], out + l, DJIBLAS_Q8_BLOCK);
+        }
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_Q6 || M->type == DJIBLAS_MAT_Q6P) {
+        UINT64 e = (UINT64)row * (UINT64)n;
+        const INT8 *q = (const INT8 *)M->data + e;
+        INT8 seg[DJIBLAS_Q6_GROUP];
+        int l = 0;
+        while (l < n) {
+            UINT64 g = (e + (UINT64)l) / DJIBLAS_Q6_GROUP;
+            int end = (int)((g + 1) * DJIBLAS_Q6_GROUP - e);
+            if (end > n) end = n;
+            if (M->type == DJIBLAS_MAT_Q6P) {
+                djiblas_unpack_q6p((const UINT8 *)M->data + (e + (UINT64)l) / 4 * 3, seg, end - l);
+                g_djiblas.dequant(seg, M->scales[g], out + l, (UINT32)(end - l));
+            } else {
+                g_djiblas.dequant(q + l, M->scales[g], out + l, (UINT32)(end - l));
+            }
+            l = end;
+        }
+        return;
+    }
+    if (M->type == DJIBLAS_MAT_F32_PANEL) {
+        int R = M->panel_rows;
+        int V = M->panel_width;
+        const float *p = W + (UINTN)(row / R) * (UINTN)R * (UINTN)n + (UINTN)(row % R) * (UINTN)V;
+        for (int l = 0; l < n; l += V) {
+            for (int v = 0; v < V; v++) out[l + v] = p[v];
+            p += (UINTN)R * (UINTN)V;
+        }
+        return;
+    }
+    const float *r = W + (UINTN)row * (UINTN)n;
+    for (int l = 0; l < n; l++) out[l] = r[l];
+}
+
+UINT64 djiblas_panel_tmp_floats(int cols) {
+    return (UINT64)(g_djiblas.panel_rows ? g_djiblas.panel_rows : 16) * (UINT64)cols;
+}
+
+BOOLEAN djiblas_repack_panels(DjibLasMatrix *M, int n_layers, float *tmp) {
+    int R = g_djiblas.panel_rows;
+    int V = g_djiblas.panel_width;
+    if (!g_djiblas.gemv_panel || R <= 0 || V <= 0) return FALSE;
+    if (M->type != DJIBLAS_MAT_F32 || !tmp) return FALSE;
+    if ((M->rows % R) != 0 || (M->cols % V) != 0) return FALSE;
+    if (M->layer_stride != (UINT64)M->rows * (UINT64)M->cols) return FALSE;
+
+    // Layers are back to back and rows % R == 0, so the whole stack is
+    // just (n_layers * rows) / R consecutive panels.
+    int n = M->cols;
+    UINT64 n_panels = ((UINT64)n_layers * (UINT64)M->rows) / (UINT64)R;
+    UINTN panel_floats = (UINTN)R * (UINTN)n;
+    float *W = (float *)M->data;
+    for (UINT64 p = 0; p < n_panels; p++) {
+        float *panel = W + (UINTN)p * panel_floats;
+        for (UINTN i = 0; i < panel_floats; i++) tmp[i] = panel[i];
+        float *dst = panel;
+        for (int l = 0; l < n; l += V) {
+            for (int r = 0; r < R; r++) {
+                const float *src = tmp + (UINTN)r * (UINTN)n + (UINTN)l;
+                for (int v = 0; v < V; v++) *dst++ = src[v];
+            }
+        }
+    }
+
+    M->type = DJIBLAS_MAT_F32_PANEL;
+    M->panel_rows = R;
+    M->panel_width = V;
+    return TRUE;
 }
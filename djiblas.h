@@ -24,8 +24,12 @@ typedef struct {
     BOOLEAN has_avx;
     BOOLEAN has_avx2;
     BOOLEAN has_fma;
+    BOOLEAN has_f16c;
     BOOLEAN has_avx512f;
+    BOOLEAN has_avx512vl;
     BOOLEAN has_avx512_vnni;
+    UINT32 signature;       // CPUID.1:EAX (stepping/model/family), 0 if unknown
+    UINT64 llc_bytes;       // last-level cache (CPUID leaf 4 / 0x8000001D), 0 if unknown
 } CPUFeatures;
 
 // Detect CPU capabilities via CPUID
@@ -42,11 +46,25 @@ void djiblas_sgemm_f32(
     float *C, int ldc
 );
 
-// Quantized 8-bit matrix multiplication
+// Matrix-vector product for single-token decode: y = W * x
+// W: d x n, row-major with row stride ldw (llama2.c weight layout)
+// x: n
+// y: d (output)
+void djiblas_sgemv_f32(
+    int d, int n,
+    const float *W, int ldw,
+    const float *x,
+    float *y
+);
+
+// Quantized 8-bit matrix multiplication (Q8_0, see below), same convention
+// as djiblas_sgemm_f32: C[ldc*j + i] = A_i . B_j.
+// A: m rows of k int8 (k % 32 == 0), Ad: lda/32 scales per row
+// B: n float rows, quantized to int8 on the fly (needs djiblas_set_workspace)
 void djiblas_sgemm_q8(
     int m, int n, int k,
-    const char *A, int lda,
-    const char *B, int ldb,
+    const INT8 *A, const float *Ad, int lda,
+    const float *B, int ldb,
     float *C, int ldc
 );
 
@@ -56,13 +74,655 @@ typedef void (*sgemm_kernel_t)(int m, int n, int k,
                                 const float *B, int ldb,
                                 float *C, int ldc);
 
+typedef void (*sgemv_kernel_t)(int d, int n,
+                               const float *W, int ldw,
+                               const float *x,
+                               float *y);
+
 // Get best kernel for current CPU
 sgemm_kernel_t djiblas_get_best_kernel(CPUFeatures *features);
+sgemv_kernel_t djiblas_get_best_gemv_kernel(CPUFeatures *features);
 
 // Individual kernel implementations
 void djiblas_sgemm_avx2(int m, int n, int k, const float *A, int lda, const float *B, int ldb, float *C, int ldc);
+void djiblas_sgemm_avx2_2x4(int m, int n, int k, const float *A, int lda, const float *B, int ldb, float *C, int ldc);
 void djiblas_sgemm_avx512(int m, int n, int k, const float *A, int lda, const float *B, int ldb, float *C, int ldc);
 void djiblas_sgemm_sse2(int m, int n, int k, const float *A, int lda, const float *B, int ldb, float *C, int ldc);
 void djiblas_sgemm_scalar(int m, int n, int k, const float *A, int lda, const float *B, int ldb, float *C, int ldc);
 
+void djiblas_sgemv_avx512(int d, int n, const float *W, int ldw, const float *x, float *y);
+void djiblas_sgemv_avx2(int d, int n, const float *W, int ldw, const float *x, float *y);
+void djiblas_sgemv4_avx2(int d, int n, const float *W, int ldw, const float *x, float *y);
+void djiblas_sgemv_sse2(int d, int n, const float *W, int ldw, const float *x, float *y);
+void djiblas_sgemv_scalar(int d, int n, const float *W, int ldw, const float *x, float *y);
+
+// ===================================================================
+// VECTOR PRIMITIVES (attention, norms, activations, dequant)
+// ===================================================================
+
+typedef float (*djiblas_dot_fn)(const float *a, const float *b, int n);
+typedef void (*djiblas_axpy_fn)(float *dst, const float *src, float alpha, int n);
+// o = weight * x / rms(x)
+typedef void (*djiblas_rmsnorm_fn)(float *o, const float *x, const float *weight, int n);
+// Residual + norm in two passes: x += delta, then out = weight * x / rms(x).
+// out may alias x or delta (delta is fully consumed by the first pass).
+typedef void (*djiblas_residual_rmsnorm_fn)(float *x, const float *delta, const float *weight,
+                                            float *out, int n);
+// In-place softmax over x[0..n)
+typedef void (*djiblas_softmax_fn)(float *x, int n);
+// Fused max + exp + sum: x[i] = exp(x[i] - max(x)), returns the sum
+// (softmax without the final normalization).
+typedef float (*djiblas_exp_sum_fn)(float *x, int n);
+// SwiGLU: hb[i] = silu(hb[i]) * hb2[i]
+typedef void (*djiblas_silu_fn)(float *hb, const float *hb2, int n);
+// DjibQuant group dequant: out[i] = q[i] * scale
+typedef void (*djiblas_dequant_fn)(const INT8 *q, float scale, float *out, UINT32 n);
+
+float djiblas_fast_exp(float x);
+
+float djiblas_dot_sse2(const float *a, const float *b, int n);
+void djiblas_axpy_sse2(float *dst, const float *src, float alpha, int n);
+void djiblas_rmsnorm_sse2(float *o, const float *x, const float *weight, int n);
+void djiblas_residual_rmsnorm_sse2(float *x, const float *delta, const float *weight, float *out, int n);
+void djiblas_residual_rmsnorm_avx2(float *x, const float *delta, const float *weight, float *out, int n);
+void djiblas_softmax_sse2(float *x, int n);
+void djiblas_softmax_avx2(float *x, int n);
+void djiblas_softmax_avx512(float *x, int n);
+float djiblas_exp_sum_sse2(float *x, int n);
+float djiblas_exp_sum_avx2(float *x, int n);
+float djiblas_exp_sum_avx512(float *x, int n);
+void djiblas_silu_scalar(float *hb, const float *hb2, int n);
+void djiblas_silu_sse2(float *hb, const float *hb2, int n);
+void djiblas_silu_avx2(float *hb, const float *hb2, int n);
+void djiblas_silu_avx512(float *hb, const float *hb2, int n);
+void djiblas_dequant_sse2(const INT8 *q, float scale, float *out, UINT32 n);
+void djiblas_dequant_avx2(const INT8 *q, float scale, float *out, UINT32 n);
+
+// ===================================================================
+// DECODE ATTENTION (online softmax)
+// ===================================================================
+// out = sum_t softmax_t(scale * q . K_t) * V_t over t in [0, n), with K_t and
+// V_t the head_size floats at K + t*ld and V + t*ld. K and V are streamed
+// once, DJIBLAS_ATTN_TILE timesteps at a time, with a running max and sum:
+// the accumulator is rescaled only when a tile raises the max, and no score
+// row is ever written. The AVX2 kernel keeps the accumulator in registers
+// for head_size % 8 == 0 up to DJIBLAS_ATTN_MAX_HEAD (other sizes: SSE2).
+#define DJIBLAS_ATTN_TILE      8
+#define DJIBLAS_ATTN_MAX_HEAD  128
+
+typedef void (*djiblas_attn_fn)(const float *q, const float *K, const float *V, int ld, int n,
+                                int head_size, float scale, float *out);
+
+void djiblas_attn_sse2(const float *q, const float *K, const float *V, int ld, int n,
+                       int head_size, float scale, float *out);
+void djiblas_attn_avx2(const float *q, const float *K, const float *V, int ld, int n,
+                       int head_size, float scale, float *out);
+
+// Reduced-precision KV cache, dequantized on the fly by the same online
+// softmax (head_size <= DJIBLAS_ATTN_MAX_HEAD):
+//   fp16: K_t / V_t are head_size halves at K + t*ld / V + t*ld.
+//   int8: K_t / V_t are head_size int8 values with one fp32 scale per row,
+//         Ks[t*sld] / Vs[t*sld] (djiblas_quantize_kv_q8).
+#define DJIBLAS_KV_F32  0
+#define DJIBLAS_KV_F16  1
+#define DJIBLAS_KV_Q8   2
+
+typedef void (*djiblas_attn_f16_fn)(const float *q, const UINT16 *K, const UINT16 *V, int ld, int n,
+                                    int head_size, float scale, float *out);
+typedef void (*djiblas_attn_q8_fn)(const float *q, const INT8 *K, const float *Ks,
+                                   const INT8 *V, const float *Vs, int ld, int sld, int n,
+                                   int head_size, float scale, float *out);
+
+void djiblas_attn_f16_sse2(const float *q, const UINT16 *K, const UINT16 *V, int ld, int n,
+                           int head_size, float scale, float *out);
+void djiblas_attn_f16_f16c(const float *q, const UINT16 *K, const UINT16 *V, int ld, int n,
+                           int head_size, float scale, float *out);   // AVX2+FMA+F16C
+void djiblas_attn_q8_sse2(const float *q, const INT8 *K, const float *Ks, const INT8 *V, const float *Vs,
+                          int ld, int sld, int n, int head_size, float scale, float *out);
+void djiblas_attn_q8_avx2(const float *q, const INT8 *K, const float *Ks, const INT8 *V, const float *Vs,
+                          int ld, int sld, int n, int head_size, float scale, float *out);
+
+// New cache rows: x rounded to fp16 (nearest-even), or to int8 with the
+// returned scale max|x| / 127.
+void djiblas_narrow_f16(const float *x, UINT16 *h, int n);
+float djiblas_quantize_kv_q8(const float *x, INT8 *q, int n);
+
+// Grouped-query attention: the g query heads at q + i*head_size (i < g) that
+// share one KV head, outputs at out + i*head_size. Each tile of
+// DJIBLAS_ATTN_TILE K/V rows is loaded (and widened, for fp16 / int8) once
+// and scored against all g heads while it is in L1, instead of being
+// streamed again per head; the g online-softmax states stay independent.
+// Groups larger than DJIBLAS_ATTN_MAX_GROUP are processed in chunks.
+#define DJIBLAS_ATTN_MAX_GROUP 16
+
+typedef void (*djiblas_attn_gqa_fn)(const float *q, int g, const float *K, const float *V, int ld, int n,
+                                    int head_size, float scale, float *out);
+typedef void (*djiblas_attn_gqa_f16_fn)(const float *q, int g, const UINT16 *K, const UINT16 *V, int ld,
+                                        int n, int head_size, float scale, float *out);
+typedef void (*djiblas_attn_gqa_q8_fn)(const float *q, int g, const INT8 *K, const float *Ks,
+                                       const INT8 *V, const float *Vs, int ld, int sld, int n,
+                                       int head_size, float scale, float *out);
+
+void djiblas_attn_gqa_sse2(const float *q, int g, const float *K, const float *V, int ld, int n,
+                           int head_size, float scale, float *out);
+void djiblas_attn_gqa_avx2(const float *q, int g, const float *K, const float *V, int ld, int n,
+                           int head_size, float scale, float *out);
+void djiblas_attn_gqa_f16_sse2(const float *q, int g, const UINT16 *K, const UINT16 *V, int ld, int n,
+                               int head_size, float scale, float *out);
+void djiblas_attn_gqa_f16_f16c(const float *q, int g, const UINT16 *K, const UINT16 *V, int ld, int n,
+                               int head_size, float scale, float *out);   // AVX2+FMA+F16C
+void djiblas_attn_gqa_q8_sse2(const float *q, int g, const INT8 *K, const float *Ks, const INT8 *V,
+                              const float *Vs, int ld, int sld, int n, int head_size, float scale, float *out);
+void djiblas_attn_gqa_q8_avx2(const float *q, int g, const INT8 *K, const float *Ks, const INT8 *V,
+                              const float *Vs, int ld, int sld, int n, int head_size, float scale, float *out);
+
+// ===================================================================
+// ROTARY POSITION EMBEDDING
+// ===================================================================
+// Rotates every head of q[0..q_dim) and k[0..k_dim) in place by one
+// position's table row. C and S are head_size floats, pre-expanded per pair
+// (c_j, c_j) and (-s_j, s_j), so pair j of each head becomes
+//   (x0 c_j - x1 s_j, x1 c_j + x0 s_j)  =  x * C + swap_pairs(x) * S.
+// head_size must be even; q_dim and k_dim are multiples of it.
+typedef void (*djiblas_rope_fn)(float *q, int q_dim, float *k, int k_dim, int head_size,
+                                const float *C, const float *S);
+
+void djiblas_rope_sse2(float *q, int q_dim, float *k, int k_dim, int head_size,
+                       const float *C, const float *S);
+void djiblas_rope_avx2(float *q, int q_dim, float *k, int k_dim, int head_size,
+                       const float *C, const float *S);
+
+// ===================================================================
+// PANEL-INTERLEAVED GEMV
+// ===================================================================
+// Panel layout: rows are grouped in panels of R rows; inside a panel the
+// k dimension is walked in chunks of V floats, and each chunk stores the
+// V floats of row 0, then row 1, ... row R-1:
+//
+//   panel p = [k0: r0[0..V) r1[0..V) ... rR-1[0..V)] [k1: r0[V..2V) ...] ...
+//
+// A panel is the same R*n floats as the row-major rows it replaces, so the
+// repack is in place, and the GEMV reads one contiguous stream per panel.
+typedef void (*sgemv_panel_kernel_t)(int d, int n, const float *P, const float *x, float *y);
+
+void djiblas_sgemv_panel8_avx2(int d, int n, const float *P, const float *x, float *y);     // R=8,  V=8
+void djiblas_sgemv_panel16_avx512(int d, int n, const float *P, const float *x, float *y);  // R=16, V=16
+
+// ===================================================================
+// FUSED FFN GATE/UP (SwiGLU)
+// ===================================================================
+// hb[i] = silu(W1[i] . x) * (W3[i] . x) for the d rows of W1/W3, computed
+// block by block so the up projection (hb2) is never written to memory.
+typedef void (*djiblas_gate_up_fn)(int d, int n, const float *W1, const float *W3, int ldw,
+                                   const float *x, float *hb);
+typedef void (*djiblas_gate_up_panel_fn)(int d, int n, const float *P1, const float *P3,
+                                         const float *x, float *hb);
+
+void djiblas_ffn_gate_up_blocked(int d, int n, const float *W1, const float *W3, int ldw,
+                                 const float *x, float *hb);
+void djiblas_ffn_gate_up_avx2(int d, int n, const float *W1, const float *W3, int ldw,
+                              const float *x, float *hb);
+void djiblas_ffn_gate_up_avx512(int d, int n, const float *W1, const float *W3, int ldw,
+                                const float *x, float *hb);
+void djiblas_ffn_gate_up_panel8_avx2(int d, int n, const float *P1, const float *P3,
+                                     const float *x, float *hb);
+void djiblas_ffn_gate_up_panel16_avx512(int d, int n, const float *P1, const float *P3,
+                                        const float *x, float *hb);
+
+// ===================================================================
+// Q8_0 INT8 WEIGHTS
+// ===================================================================
+// Q8_0: int8 weights with one fp32 scale per 32 consecutive elements of a
+// row (w = q * d). The activation is quantized the same way per matmul, so
+// each block is a pure int8 x int8 dot product scaled once by d_w * d_x.
+#define DJIBLAS_Q8_BLOCK 32
+
+// xq[i] = round(x[i] / xd[i/32]), xd[b] = max|x[32b .. 32b+32)| / 127. n % 32 == 0.
+typedef void (*djiblas_quant_q8_fn)(const float *x, int n, INT8 *xq, float *xd);
+// y[i] = sum_b Wd[i*n/32 + b] * xd[b] * (W_i . xq) over block b. n % 32 == 0.
+typedef void (*djiblas_gemv_q8_fn)(int d, int n, const INT8 *W, const float *Wd,
+                                   const INT8 *xq, const float *xd, float *y);
+
+void djiblas_quantize_q8_sse2(const float *x, int n, INT8 *xq, float *xd);
+void djiblas_quantize_q8_avx2(const float *x, int n, INT8 *xq, float *xd);
+
+void djiblas_gemv_q8_scalar(int d, int n, const INT8 *W, const float *Wd,
+                            const INT8 *xq, const float *xd, float *y);
+void djiblas_gemv_q8_sse2(int d, int n, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y);
+void djiblas_gemv_q8_avx2(int d, int n, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y);   // maddubs + madd
+void djiblas_gemv_q8_vnni(int d, int n, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y);   // vpdpbusd (AVX512_VNNI+VL)
+
+// Several activations against the same rows (prefill): column c is quantized
+// at xq + c*n, xd + c*n/32 and Y[c*ldy + i] = row i . column c. Each weight
+// block is loaded once and dotted against DJIBLAS_Q8_NCOL columns at a time.
+#define DJIBLAS_Q8_NCOL 4
+typedef void (*djiblas_gemm_q8_fn)(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                                   const INT8 *xq, const float *xd, float *Y, int ldy);
+
+void djiblas_gemm_q8_scalar(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                            const INT8 *xq, const float *xd, float *Y, int ldy);
+void djiblas_gemm_q8_sse2(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy);
+void djiblas_gemm_q8_avx2(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy);
+void djiblas_gemm_q8_vnni(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy);
+
+// Scratch for the quantized activation (int8 + one scale per 32), set once
+// at boot. djiblas_sgemm_q8 quantizes as many token columns as fit, so sizing
+// it for prefill block x widest input lets a whole block share one pass over
+// the weights. Without it Q8 matrices fall back to dequantize-and-dot against
+// the float activation.
+UINT64 djiblas_workspace_bytes(int max_cols);
+void djiblas_set_workspace(void *buf, UINT64 bytes);
+
+// Activation quant cache. djiblas_act_quantize() quantizes x into the
+// workspace once and tags it with x; until djiblas_act_release(), every
+// integer GEMV on that x (Q8_0 / Q4 / Q6 / Q6P rows) reuses it instead of
+// quantizing again. Release before x is overwritten. Untagged calls keep
+// quantizing per matmul. FALSE if x does not fit (n % 32 == 0 required).
+BOOLEAN djiblas_act_quantize(const float *x, int n);
+void djiblas_act_release(void);
+
+// ===================================================================
+// Q4 WEIGHTS (4-bit, groups of 32)
+// ===================================================================
+// Each 32-value block of a row is 16 bytes: byte j holds value j in its low
+// nibble and value j + 16 in its high nibble, stored as q + 8 (q in [-8, 7]).
+// One fp32 scale per block, like Q8_0, so the activation goes through the
+// same Q8_0 workspace and every block is an int8 x int8 dot product.
+#define DJIBLAS_Q4_BLOCK_BYTES 16
+
+typedef void (*djiblas_gemv_q4_fn)(int d, int n, const UINT8 *W, const float *Wd,
+                                   const INT8 *xq, const float *xd, float *y);
+
+void djiblas_unpack_q4(const UINT8 *p, INT8 *out);   // one block -> 32 int8
+void djiblas_gemv_q4_scalar(int d, int n, const UINT8 *W, const float *Wd,
+                            const INT8 *xq, const float *xd, float *y);
+void djiblas_gemv_q4_sse2(int d, int n, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y);
+void djiblas_gemv_q4_avx2(int d, int n, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y);   // and/srli + maddubs
+
+// Multi-column form, as djiblas_gemm_q8_fn: each block is unpacked once.
+typedef void (*djiblas_gemm_q4_fn)(int d, int n, int ncol, const UINT8 *W, const float *Wd,
+                                   const INT8 *xq, const float *xd, float *Y, int ldy);
+
+void djiblas_gemm_q4_scalar(int d, int n, int ncol, const UINT8 *W, const float *Wd,
+                            const INT8 *xq, const float *xd, float *Y, int ldy);
+void djiblas_gemm_q4_sse2(int d, int n, int ncol, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy);
+void djiblas_gemm_q4_avx2(int d, int n, int ncol, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy);
+
+// ===================================================================
+// HALF-PRECISION WEIGHTS (fp16 / bf16)
+// ===================================================================
+// Row-major UINT16 weights widened to fp32 in registers and accumulated in
+// fp32 against the float activation: half the bytes of fp32, no scales.
+// fp16 uses vcvtph2ps (F16C / AVX-512F); bf16 is the top half of an fp32,
+// so widening is a 16-bit shift.
+typedef void (*djiblas_gemv_h_fn)(int d, int n, const UINT16 *W, const float *x, float *y);
+
+void djiblas_widen_f16(const UINT16 *h, float *out, int n);
+void djiblas_widen_bf16(const UINT16 *h, float *out, int n);
+
+void djiblas_gemv_f16_sse2(int d, int n, const UINT16 *W, const float *x, float *y);
+void djiblas_gemv_f16_f16c(int d, int n, const UINT16 *W, const float *x, float *y);   // AVX2+FMA+F16C
+void djiblas_gemv_f16_avx512(int d, int n, const UINT16 *W, const float *x, float *y);
+void djiblas_gemv_bf16_sse2(int d, int n, const UINT16 *W, const float *x, float *y);
+void djiblas_gemv_bf16_avx2(int d, int n, const UINT16 *W, const float *x, float *y);
+void djiblas_gemv_bf16_avx512(int d, int n, const UINT16 *W, const float *x, float *y);
+
+// ===================================================================
+// DJIBQUANT Q6 WEIGHTS (fused dequant-GEMV)
+// ===================================================================
+// DjibQuant Q6 (djibquant.h): int8 values in [-31, 31], one fp32 scale per 64
+// consecutive elements of the whole tensor, so a group may straddle two
+// rows. The GEMV sign-extends each group straight into registers, multiplies
+// it with x and applies the group scale once; no float weights are written.
+#define DJIBLAS_Q6_GROUP 64
+
+// y[i] = W_i . x for d rows of n int8 values. S is the tensor's scale array
+// and e0 the element index of W[0] in it (scale of W[i*n + l] is
+// S[(e0 + i*n + l) / 64]).
+typedef void (*djiblas_gemv_q6_fn)(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                                   const float *x, float *y);
+
+void djiblas_gemv_q6_sse2(int d, int n, const INT8 *W, const float *S, UINT64 e0, const float *x, float *y);
+void djiblas_gemv_q6_avx2(int d, int n, const INT8 *W, const float *S, UINT64 e0, const float *x, float *y);
+void djiblas_gemv_q6_avx512(int d, int n, const INT8 *W, const float *S, UINT64 e0, const float *x, float *y);
+
+// DjibQuant v2 stores 4 values in 3 bytes: value 4k + j is bits [6j, 6j + 6)
+// of the little-endian 24-bit word at byte 3k. Same scales as above; W points
+// at the byte of element e0 (e0 and n multiples of 4).
+typedef void (*djiblas_gemv_q6p_fn)(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                                    const float *x, float *y);
+
+void djiblas_unpack_q6p(const UINT8 *p, INT8 *out, int n);
+void djiblas_gemv_q6p_sse2(int d, int n, const UINT8 *W, const float *S, UINT64 e0, const float *x, float *y);
+void djiblas_gemv_q6p_avx2(int d, int n, const UINT8 *W, const float *S, UINT64 e0, const float *x, float *y);
+
+// Same weights against the cached int8 activation (djiblas_act_quantize):
+// each 32-block is an int8 dot product scaled by S[group] * xd[block]. Needs
+// n and e0 multiples of 32, so no block straddles two scale groups.
+typedef void (*djiblas_gemv_q6_q8_fn)(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                                      const INT8 *xq, const float *xd, float *y);
+typedef void (*djiblas_gemv_q6p_q8_fn)(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                                       const INT8 *xq, const float *xd, float *y);
+
+void djiblas_gemv_q6_q8_scalar(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                               const INT8 *xq, const float *xd, float *y);
+void djiblas_gemv_q6_q8_avx2(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                             const INT8 *xq, const float *xd, float *y);    // maddubs + madd
+void djiblas_gemv_q6_q8_vnni(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                             const INT8 *xq, const float *xd, float *y);    // vpdpbusd (AVX512_VNNI+VL)
+void djiblas_gemv_q6p_q8_scalar(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                                const INT8 *xq, const float *xd, float *y);
+void djiblas_gemv_q6p_q8_avx2(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                              const INT8 *xq, const float *xd, float *y);   // pshufb unpack + maddubs
+
+// ===================================================================
+// MATRIX DESCRIPTORS
+// ===================================================================
+#define DJIBLAS_MAT_F32        0   // row-major float32 (llama2.c layout)
+#define DJIBLAS_MAT_F32_PANEL  1   // float32, panel-interleaved (see above)
+#define DJIBLAS_MAT_Q8_0       2   // row-major int8 + one fp32 scale per 32 elements
+#define DJIBLAS_MAT_Q6         3   // row-major int8 (DjibQuant Q6) + one fp32 scale per 64 elements
+#define DJIBLAS_MAT_Q6P        4   // DjibQuant v2: 4 values per 3 bytes, scales as DJIBLAS_MAT_Q6
+#define DJIBLAS_MAT_Q4         5   // 16 bytes per 32-element block + one fp32 scale per block
+#define DJIBLAS_MAT_F16        6   // row-major IEEE half
+#define DJIBLAS_MAT_BF16       7   // row-major bfloat16
+
+// One weight tensor, stacked over layers: layer l starts at
+// data + l * layer_stride elements and is a rows x cols GEMV operand.
+typedef struct {
+    const void *data;
+    int type;               // DJIBLAS_MAT_*
+    int rows;               // d (outputs) per layer
+    int cols;               // n (inputs)
+    UINT64 layer_stride;    // elements between consecutive layers
+    int panel_rows;         // R (panel types only)
+    int panel_width;        // V (panel types only)
+    const float *scales;    // quantized types: scale of element e is scales[e / group]
+
+    // Per-shape overrides from the boot autotuner (djiblas_tune_apply);
+    // 0 = use the dispatch table default.
+    sgemv_kernel_t gemv;    // DJIBLAS_MAT_F32 GEMV
+    sgemm_kernel_t sgemm;   // DJIBLAS_MAT_F32 prefill GEMM
+    int row_block;          // rows per token-inner block in djiblas_gemm_rows
+
+    BOOLEAN stream;         // larger than the LLC: prefetch-ahead kernels (djiblas_matrix_set_stream)
+} DjibLasMatrix;
+
+void djiblas_matrix_init_f32(DjibLasMatrix *M, const float *data, int rows, int cols);
+// cols must be a multiple of DJIBLAS_Q8_BLOCK (groups never straddle rows).
+void djiblas_matrix_init_q8(DjibLasMatrix *M, const INT8 *q, const float *scales, int rows, int cols);
+// Element e of layer l is q[l * rows * cols + e] (groups may straddle rows).
+void djiblas_matrix_init_q6(DjibLasMatrix *M, const INT8 *q, const float *scales, int rows, int cols);
+void djiblas_matrix_init_q6p(DjibLasMatrix *M, const UINT8 *q, const float *scales, int rows, int cols);
+void djiblas_matrix_init_q4(DjibLasMatrix *M, const UINT8 *q, const float *scales, int rows, int cols);
+// type: DJIBLAS_MAT_F16 or DJIBLAS_MAT_BF16
+void djiblas_matrix_init_half(DjibLasMatrix *M, int type, const UINT16 *data, int rows, int cols);
+
+// y = M[layer] * x
+void djiblas_gemv(const DjibLasMatrix *M, int layer, const float *x, float *y);
+
+// y[0 .. r1-r0) = rows [r0, r1) of M[layer] * x. Works for any r0/r1, also
+// when they split a panel.
+void djiblas_gemv_rows(const DjibLasMatrix *M, int layer, int r0, int r1, const float *x, float *y);
+
+// Batched form for prefill: for each of ntok activation rows X[t] (stride
+// ldx), Y[t] (stride ldy) = rows [r0, r1) of M[layer] * X[t]. Row-major
+// weights go through the SGEMM kernel; panel weights are streamed once per
+// panel and reused from cache for every token.
+void djiblas_gemm_rows(const DjibLasMatrix *M, int layer, int r0, int r1,
+                       const float *X, int ldx, int ntok, float *Y, int ldy);
+void djiblas_gemm(const DjibLasMatrix *M, int layer,
+                  const float *X, int ldx, int ntok, float *Y, int ldy);
+
+// Fused projection over a stacked matrix (e.g. [wq; wk; wv]): one pass over
+// the layer's rows, written to three separate outputs of n0/n1/n2 rows.
+void djiblas_gemv_split3(const DjibLasMatrix *M, int layer, const float *x,
+                         float *y0, int n0, float *y1, int n1, float *y2, int n2);
+
+// hb = silu(W1[layer] x) * (W3[layer] x), fused (W1 and W3 have equal shape).
+void djiblas_ffn_gate_up(const DjibLasMatrix *W1, const DjibLasMatrix *W3, int layer,
+                         const float *x, float *hb);
+
+// TRUE if GEMVs on M consume the int8 activation, i.e. quantizing x once
+// with djiblas_act_quantize() pays off when several projections share it.
+BOOLEAN djiblas_matrix_act_q8(const DjibLasMatrix *M);
+
+// Copy one row of layer 0 out of M (works for every layout).
+void djiblas_matrix_get_row(const DjibLasMatrix *M, int row, float *out);
+
+// Repack all n_layers of a DJIBLAS_MAT_F32 matrix in place into the panel
+// layout of the boot-selected kernel. tmp must hold djiblas_panel_tmp_floats(cols)
+// floats. Returns FALSE (matrix untouched) if there is no panel kernel or the
+// shape does not tile exactly.
+UINT64 djiblas_panel_tmp_floats(int cols);
+BOOLEAN djiblas_repack_panels(DjibLasMatrix *M, int n_layers, float *tmp);
+
+// ===================================================================
+// STREAMING GEMV (weights larger than the last-level cache)
+// ===================================================================
+// A weight tensor that does not fit the LLC is re-read from DRAM on every
+// token and, with plain loads, evicts the KV cache and activations on its
+// way through. Such matrices (M->stream) use prefetch-ahead variants of the
+// row-major and panel kernels: every weight stream is prefetched stream_pf
+// bytes ahead with PREFETCHNTA (or PREFETCHT0), x stays an ordinary load.
+// Weights are ordinary write-back memory, where MOVNTDQA is just a load, so
+// the NTA prefetch is what keeps them out of the outer cache levels.
+#define DJIBLAS_LLC_DEFAULT_BYTES  (8ULL << 20)   // CPUID reports no cache
+#define DJIBLAS_STREAM_PF_DEFAULT  512            // bytes ahead per stream
+
+void djiblas_sgemv_stream_avx2(int d, int n, const float *W, int ldw, const float *x, float *y);
+void djiblas_ffn_gate_up_stream_avx2(int d, int n, const float *W1, const float *W3, int ldw,
+                                     const float *x, float *hb);
+void djiblas_sgemv_panel8_stream_avx2(int d, int n, const float *P, const float *x, float *y);
+void djiblas_ffn_gate_up_panel8_stream_avx2(int d, int n, const float *P1, const float *P3,
+                                            const float *x, float *hb);
+void djiblas_sgemv_panel16_stream_avx512(int d, int n, const float *P, const float *x, float *y);
+void djiblas_ffn_gate_up_panel16_stream_avx512(int d, int n, const float *P1, const float *P3,
+                                               const float *x, float *hb);
+
+// Streaming threshold and prefetch: llc_bytes 0 = CPUID value (or
+// DJIBLAS_LLC_DEFAULT_BYTES), pf_bytes 0 = never stream.
+void djiblas_stream_config(UINT64 llc_bytes, int pf_bytes, BOOLEAN nta);
+// Mark M (all n_layers) for streaming if it exceeds the threshold and a
+// stream kernel exists for its layout (panel layouts: NTA hint only).
+// A tuned M->gemv still wins. Returns M->stream.
+BOOLEAN djiblas_matrix_set_stream(DjibLasMatrix *M, int n_layers);
+
+// AVX2 attention helpers live in attention_avx2.c (compiled with -mavx2)
+float llmk_dot_f32_avx2(const float *a, const float *b, int n);
+void llmk_axpy_f32_avx2(float *dst, const float *src, float alpha, int n);
+
+// ===================================================================
+// BOOT AUTOTUNE (djiblas_tune.c)
+// ===================================================================
+// Times the candidate kernels / block sizes on a matrix's real layer-0
+// weights with rdtsc and keeps the fastest per (layout, rows, cols):
+//   F32 row-major: GEMV kernel (ISA x rows per pass, plus the prefetch-ahead
+//                  kernel on M->stream tensors: mark those first), SGEMM tile
+//   panel / Q6 / Q6P / F16 / BF16: rows per token-inner prefill block
+// Q8_0 / Q4 have nothing to tune. Profiles round-trip through a small
+// ASCII format (the djiblas.tune file) and only load on the CPU and ISA
+// set they were measured on.
+#define DJIBLAS_TUNE_MAX_SHAPES 16
+
+typedef struct {
+    int type;               // DJIBLAS_MAT_*
+    int rows;
+    int cols;
+    int gemv;               // candidate index, -1 = not tuned
+    int sgemm;              // candidate index, -1 = not tuned
+    int row_block;          // 0 = not tuned
+    UINT64 gemv_cycles;     // best time of the winner (0 when loaded from file)
+    UINT64 gemm_cycles;
+} DjibLasTuneEntry;
+
+typedef struct {
+    UINT32 cpu_signature;
+    UINT32 isa;             // DJIBLAS_TUNE_ISA_* bits the candidates depend on
+    int n;
+    DjibLasTuneEntry e[DJIBLAS_TUNE_MAX_SHAPES];
+} DjibLasTuneProfile;
+
+#define DJIBLAS_TUNE_ISA_SSE2    0x1u
+#define DJIBLAS_TUNE_ISA_AVX2    0x2u   // AVX2 + FMA
+#define DJIBLAS_TUNE_ISA_AVX512  0x4u
+#define DJIBLAS_TUNE_ISA_F16C    0x8u   // kernel check only: no tuned candidate needs it
+#define DJIBLAS_TUNE_ISA_VNNI    0x10u  // kernel check only: AVX512_VNNI + AVX512VL
+
+// Empty profile for the running CPU (call after djiblas_dispatch_init).
+void djiblas_tune_init(DjibLasTuneProfile *P);
+// Entry for M's layout and shape, or NULL.
+const DjibLasTuneEntry *djiblas_tune_find(const DjibLasTuneProfile *P, const DjibLasMatrix *M);
+// Measure M and add its entry. Repetitions rotate over the n_layers stacked
+// layers so a small model's matrix is not timed cache-hot. ntok: tokens per
+// prefill block for the GEMM timings (0 = GEMV only). scratch holds
+// djiblas_tune_scratch_floats(M, ntok) floats. FALSE if M has nothing to
+// tune, the profile is full or scratch is too small.
+UINT64 djiblas_tune_scratch_floats(const DjibLasMatrix *M, int ntok);
+BOOLEAN djiblas_tune_matrix(DjibLasTuneProfile *P, const DjibLasMatrix *M, int n_layers, int ntok,
+                            float *scratch, UINT64 scratch_floats);
+// Copy the profile's choices for M's shape into M (no-op if none).
+void djiblas_tune_apply(const DjibLasTuneProfile *P, DjibLasMatrix *M);
+
+// ASCII round-trip. format returns the length written (< cap). parse
+// returns FALSE (with P left empty) if the text was measured on another
+// CPU / ISA set or is malformed; unknown kernel names just drop that choice.
+int djiblas_tune_format(const DjibLasTuneProfile *P, char *buf, int cap);
+BOOLEAN djiblas_tune_parse(DjibLasTuneProfile *P, const char *buf, int len);
+// Candidate names for printing ("-" when not tuned).
+const char *djiblas_tune_gemv_name(int idx);
+const char *djiblas_tune_sgemm_name(int idx);
+const char *djiblas_tune_type_name(int type);
+
+// ===================================================================
+// KERNEL CHECK (djiblas_check.c)
+// ===================================================================
+// The x86 kernels the CPU supports (fp32 row-major / panel / streaming SGEMV
+// and SGEMM, Q8_0 / Q4 GEMV and GEMM, Q6 / Q6P GEMV on fp32 and int8
+// activations, fp16 / bf16 GEMV, fused gate/up, dot / axpy / dequant,
+// softmax / exp_sum / silu, the two rmsnorms, attention, RoPE) checked against a scalar or double reference on
+// the stories15M / stories110M shapes and timed with rdtsc. Error is in ULPs
+// of sum |a*b| per output (|ref| for the vector primitives); a k-term
+// reduction may differ by 4*sqrt(k) ULPs, axpy by 2, dequant not at all,
+// attention by 32 (exp + score rounding). One CSV row per (kernel, shape) goes to
+// emit; status is ok / FAIL / ref / skip (ISA missing or scratch too small).
+#define DJIBLAS_CHECK_CSV_HEADER "kernel,shape,max_ulp,tol_ulp,status,cycles,gflops,gbps"
+
+typedef void (*djiblas_check_emit_fn)(void *ctx, const char *line);
+
+typedef struct {
+    int n_run;
+    int n_fail;
+    int n_skip;
+} DjibLasCheckSummary;
+
+// Floats of scratch that fit every shape (smaller buffers skip the big ones).
+UINT64 djiblas_check_scratch_floats(void);
+// tsc_hz: TSC ticks per second for GFLOP/s and GB/s (0 = print zeros).
+void djiblas_check_run(float *scratch, UINT64 scratch_floats, UINT64 tsc_hz,
+                       djiblas_check_emit_fn emit, void *ctx, DjibLasCheckSummary *out);
+
+// ===================================================================
+// DISPATCH TABLE
+// ===================================================================
+// Filled once at boot by djiblas_dispatch_init(); hot paths call through it
+// and never re-run CPUID (a serializing VM exit under QEMU/KVM).
+// Before init it holds the SSE2 baseline, so it is always safe to call.
+typedef struct {
+    CPUFeatures cpu;
+    BOOLEAN initialized;
+
+    sgemm_kernel_t sgemm;
+    sgemv_kernel_t gemv;
+    djiblas_dot_fn dot;
+    djiblas_axpy_fn axpy;
+    djiblas_attn_fn attn;       // follows dot/axpy (/attn, repl.cfg attn=)
+    djiblas_attn_f16_fn attn_f16;
+    djiblas_attn_q8_fn attn_q8;
+    djiblas_attn_gqa_fn attn_gqa;   // n_kv_heads < n_heads
+    djiblas_attn_gqa_f16_fn attn_gqa_f16;
+    djiblas_attn_gqa_q8_fn attn_gqa_q8;
+    djiblas_rmsnorm_fn rmsnorm;
+    djiblas_residual_rmsnorm_fn residual_rmsnorm;
+    djiblas_softmax_fn softmax;
+    djiblas_exp_sum_fn exp_sum;
+    djiblas_silu_fn silu;
+    djiblas_rope_fn rope;
+    djiblas_dequant_fn dequant;
+    djiblas_quant_q8_fn quant_q8;
+    djiblas_gemv_q8_fn gemv_q8;
+    djiblas_gemm_q8_fn gemm_q8;
+    djiblas_gemv_q4_fn gemv_q4;
+    djiblas_gemm_q4_fn gemm_q4;
+    djiblas_gemv_h_fn gemv_f16;
+    djiblas_gemv_h_fn gemv_bf16;
+    djiblas_gemv_q6_fn gemv_q6;
+    djiblas_gemv_q6p_fn gemv_q6p;
+    djiblas_gemv_q6_q8_fn gemv_q6_q8;      // NULL: Q6 stays on the fp32-activation kernel
+    djiblas_gemv_q6p_q8_fn gemv_q6p_q8;
+
+    // Panel GEMV (NULL if the selected ISA has no panel kernel)
+    sgemv_panel_kernel_t gemv_panel;
+    int panel_rows;
+    int panel_width;
+
+    // Fused gate/up + SwiGLU (row-major and panel variants)
+    djiblas_gate_up_fn gate_up;
+    djiblas_gate_up_panel_fn gate_up_panel;
+
+    // Prefetch-ahead kernels for matrices larger than the LLC (NULL if none)
+    sgemv_kernel_t gemv_stream;
+    djiblas_gate_up_fn gate_up_stream;
+    sgemv_panel_kernel_t gemv_panel_stream;
+    djiblas_gate_up_panel_fn gate_up_panel_stream;
+    UINT64 llc_bytes;           // streaming threshold (djiblas_stream_config)
+    int stream_pf;              // prefetch distance in bytes, 0 = streaming off
+    BOOLEAN stream_nta;         // PREFETCHNTA (TRUE) or PREFETCHT0
+
+    // Attention dot/axpy: auto choice + user override (/attn, repl.cfg attn=)
+    BOOLEAN attn_auto_avx2;
+    int attn_force;             // -1=auto, 0=force SSE2, 1=force AVX2
+
+    const CHAR16 *sgemm_name;
+    const CHAR16 *gemv_name;
+    const CHAR16 *attn_name;
+    const CHAR16 *dequant_name;
+    const CHAR16 *panel_name;
+    const CHAR16 *q8_name;
+    const CHAR16 *q4_name;
+    const CHAR16 *f16_name;
+    const CHAR16 *bf16_name;
+    const CHAR16 *q6_name;
+    const CHAR16 *q6p_name;
+    const CHAR16 *vmath_name;
+    const CHAR16 *norm_name;
+    const CHAR16 *stream_name;
+
+    // Activation quantization scratch (djiblas_set_workspace)
+    INT8 *ws_q;
+    float *ws_d;
+    int ws_cols;
+    const float *act_x;         // activation held in ws_q/ws_d (djiblas_act_quantize), or NULL
+    int act_n;
+} DjibLasDispatch;
+
+extern DjibLasDispatch g_djiblas;
+
+// Detect the CPU once and fill g_djiblas.
+void djiblas_dispatch_init(void);
+
+// Override attention dot/axpy: -1=auto, 0=SSE2, 1=AVX2.
+// Returns FALSE (and leaves the table unchanged) if AVX2 is requested but not usable.
+BOOLEAN djiblas_dispatch_force_attn(int mode);
+
 #endif // DJIBLAS_H
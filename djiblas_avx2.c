@@ -6,19 +6,381 @@
  */
 
 #include "djiblas.h"
+#include "djibquant.h"
+#include "djiblas_vmath.h"
 
 #if defined(__x86_64__) || defined(_M_X64)
 #include <immintrin.h>
 
-static inline float hsum_avx(__m256 v) {
-    __m128 lo = _mm256_castps256_ps128(v);
-    __m128 hi = _mm256_extractf128_ps(v, 1);
-    lo = _mm_add_ps(lo, hi);
-    hi = _mm_movehl_ps(hi, lo);
-    lo = _mm_add_ps(lo, hi);
-    hi = _mm_shuffle_ps(lo, lo, 1);
-    lo = _mm_add_ss(lo, hi);
-    return _mm_cvtss_f32(lo);
+// Dot products of 8 consecutive rows (stride ldw) with x, returned as one
+// register: lane r = row r.
+static inline __m256 rows8_dot_avx2(const float *W, int ldw, int n, const float *x) {
+    const float *w0 = W + (UINTN)ldw * 0;
+    const float *w1 = W + (UINTN)ldw * 1;
+    const float *w2 = W + (UINTN)ldw * 2;
+    const float *w3 = W + (UINTN)ldw * 3;
+    const float *w4 = W + (UINTN)ldw * 4;
+    const float *w5 = W + (UINTN)ldw * 5;
+    const float *w6 = W + (UINTN)ldw * 6;
+    const float *w7 = W + (UINTN)ldw * 7;
+    __m256 c0 = _mm256_setzero_ps();
+    __m256 c1 = _mm256_setzero_ps();
+    __m256 c2 = _mm256_setzero_ps();
+    __m256 c3 = _mm256_setzero_ps();
+    __m256 c4 = _mm256_setzero_ps();
+    __m256 c5 = _mm256_setzero_ps();
+    __m256 c6 = _mm256_setzero_ps();
+    __m256 c7 = _mm256_setzero_ps();
+
+    int l = 0;
+    for (; l + 8 <= n; l += 8) {
+        __m256 xv = _mm256_loadu_ps(x + l);
+        c0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + l), xv, c0);
+        c1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + l), xv, c1);
+        c2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + l), xv, c2);
+        c3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + l), xv, c3);
+        c4 = _mm256_fmadd_ps(_mm256_loadu_ps(w4 + l), xv, c4);
+        c5 = _mm256_fmadd_ps(_mm256_loadu_ps(w5 + l), xv, c5);
+        c6 = _mm256_fmadd_ps(_mm256_loadu_ps(w6 + l), xv, c6);
+        c7 = _mm256_fmadd_ps(_mm256_loadu_ps(w7 + l), xv, c7);
+    }
+
+    __m256 sum = djiblas_hsum8x8_ps(c0, c1, c2, c3, c4, c5, c6, c7);
+    if (l < n) {
+        float tail[8] = {0};
+        for (; l < n; l++) {
+            float xv = x[l];
+            tail[0] += w0[l] * xv;
+            tail[1] += w1[l] * xv;
+            tail[2] += w2[l] * xv;
+            tail[3] += w3[l] * xv;
+            tail[4] += w4[l] * xv;
+            tail[5] += w5[l] * xv;
+            tail[6] += w6[l] * xv;
+            tail[7] += w7[l] * xv;
+        }
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(tail));
+    }
+    return sum;
+}
+
+static inline float row_dot_avx2(const float *w0, int n, const float *x) {
+    __m256 c0 = _mm256_setzero_ps();
+    int l = 0;
+    for (; l + 8 <= n; l += 8) {
+        c0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + l), _mm256_loadu_ps(x + l), c0);
+    }
+    float total = djiblas_hsum256_ps(c0);
+    for (; l < n; l++) total += w0[l] * x[l];
+    return total;
+}
+
+// One 8-row panel (see djiblas.h): each k-step is 8 consecutive YMM loads
+// (256 bytes), so the whole panel is a single forward stream.
+static inline __m256 panel8_dot_avx2(const float *p, int n, const float *x) {
+    __m256 c0 = _mm256_setzero_ps();
+    __m256 c1 = _mm256_setzero_ps();
+    __m256 c2 = _mm256_setzero_ps();
+    __m256 c3 = _mm256_setzero_ps();
+    __m256 c4 = _mm256_setzero_ps();
+    __m256 c5 = _mm256_setzero_ps();
+    __m256 c6 = _mm256_setzero_ps();
+    __m256 c7 = _mm256_setzero_ps();
+    for (int l = 0; l < n; l += 8) {
+        __m256 xv = _mm256_loadu_ps(x + l);
+        c0 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 0), xv, c0);
+        c1 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 8), xv, c1);
+        c2 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 16), xv, c2);
+        c3 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 24), xv, c3);
+        c4 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 32), xv, c4);
+        c5 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 40), xv, c5);
+        c6 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 48), xv, c6);
+        c7 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 56), xv, c7);
+        p += 64;
+    }
+    return djiblas_hsum8x8_ps(c0, c1, c2, c3, c4, c5, c6, c7);
+}
+
+void djiblas_sgemv_avx2(int d, int n,
+                        const float *W, int ldw,
+                        const float *x,
+                        float *y) {
+    // 8 rows per pass, one accumulator per row. x is loaded once per step and
+    // shared by all 8 rows; the horizontal sums are deferred to a single
+    // 8-way reduction that lands directly in y.
+    int i = 0;
+    for (; i + 8 <= d; i += 8) {
+        _mm256_storeu_ps(y + i, rows8_dot_avx2(W + (UINTN)ldw * i, ldw, n, x));
+    }
+
+    // Leftover rows (d % 8): one row at a time.
+    for (; i < d; i++) {
+        y[i] = row_dot_avx2(W + (UINTN)ldw * i, n, x);
+    }
+}
+
+void djiblas_sgemv4_avx2(int d, int n,
+                         const float *W, int ldw,
+                         const float *x,
+                         float *y) {
+    // Autotune candidate: 4 rows per pass with k unrolled by 2. Same 8
+    // accumulators as the 8-row kernel but half the concurrent row streams,
+    // which wins on cores whose L1 prefetcher tracks few streams.
+    int i = 0;
+    for (; i + 4 <= d; i += 4) {
+        const float *w0 = W + (UINTN)ldw * (i + 0);
+        const float *w1 = W + (UINTN)ldw * (i + 1);
+        const float *w2 = W + (UINTN)ldw * (i + 2);
+        const float *w3 = W + (UINTN)ldw * (i + 3);
+        __m256 a0 = _mm256_setzero_ps(), b0 = _mm256_setzero_ps();
+        __m256 a1 = _mm256_setzero_ps(), b1 = _mm256_setzero_ps();
+        __m256 a2 = _mm256_setzero_ps(), b2 = _mm256_setzero_ps();
+        __m256 a3 = _mm256_setzero_ps(), b3 = _mm256_setzero_ps();
+
+        int l = 0;
+        for (; l + 16 <= n; l += 16) {
+            __m256 x0 = _mm256_loadu_ps(x + l);
+            __m256 x1 = _mm256_loadu_ps(x + l + 8);
+            a0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + l), x0, a0);
+            b0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + l + 8), x1, b0);
+            a1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + l), x0, a1);
+            b1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + l + 8), x1, b1);
+            a2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + l), x0, a2);
+            b2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + l + 8), x1, b2);
+            a3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + l), x0, a3);
+            b3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + l + 8), x1, b3);
+        }
+        for (; l + 8 <= n; l += 8) {
+            __m256 x0 = _mm256_loadu_ps(x + l);
+            a0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + l), x0, a0);
+            a1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + l), x0, a1);
+            a2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + l), x0, a2);
+            a3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + l), x0, a3);
+        }
+
+        const __m256 z = _mm256_setzero_ps();
+        __m256 sum8 = djiblas_hsum8x8_ps(_mm256_add_ps(a0, b0), _mm256_add_ps(a1, b1),
+                                  _mm256_add_ps(a2, b2), _mm256_add_ps(a3, b3), z, z, z, z);
+        __m128 sum = _mm256_castps256_ps128(sum8);
+        if (l < n) {
+            float tail[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+            for (; l < n; l++) {
+                float xv = x[l];
+                tail[0] += w0[l] * xv;
+                tail[1] += w1[l] * xv;
+                tail[2] += w2[l] * xv;
+                tail[3] += w3[l] * xv;
+            }
+            sum = _mm_add_ps(sum, _mm_loadu_ps(tail));
+        }
+        _mm_storeu_ps(y + i, sum);
+    }
+    for (; i < d; i++) {
+        y[i] = row_dot_avx2(W + (UINTN)ldw * i, n, x);
+    }
+}
+
+void djiblas_ffn_gate_up_avx2(int d, int n,
+                              const float *W1, const float *W3, int ldw,
+                              const float *x, float *hb) {
+    // Gate and up projections for the same 8 rows back to back, then
+    // SwiGLU on the two result registers: hb2 never exists in memory.
+    int i = 0;
+    for (; i + 8 <= d; i += 8) {
+        __m256 g = rows8_dot_avx2(W1 + (UINTN)ldw * i, ldw, n, x);
+        __m256 u = rows8_dot_avx2(W3 + (UINTN)ldw * i, ldw, n, x);
+        _mm256_storeu_ps(hb + i, djiblas_silu_mul256_ps(g, u));
+    }
+    if (i < d) {
+        float g[8] = {0};
+        float u[8] = {0};
+        float h[8];
+        int rem = d - i;
+        for (int r = 0; r < rem; r++) {
+            g[r] = row_dot_avx2(W1 + (UINTN)ldw * (i + r), n, x);
+            u[r] = row_dot_avx2(W3 + (UINTN)ldw * (i + r), n, x);
+        }
+        _mm256_storeu_ps(h, djiblas_silu_mul256_ps(_mm256_loadu_ps(g), _mm256_loadu_ps(u)));
+        for (int r = 0; r < rem; r++) hb[i + r] = h[r];
+    }
+}
+
+void djiblas_sgemv_panel8_avx2(int d, int n, const float *P, const float *x, float *y) {
+    for (int i = 0; i < d; i += 8) {
+        _mm256_storeu_ps(y + i, panel8_dot_avx2(P + (UINTN)i * (UINTN)n, n, x));
+    }
+}
+
+void djiblas_ffn_gate_up_panel8_avx2(int d, int n, const float *P1, const float *P3,
+                                     const float *x, float *hb) {
+    for (int i = 0; i < d; i += 8) {
+        __m256 g = panel8_dot_avx2(P1 + (UINTN)i * (UINTN)n, n, x);
+        __m256 u = panel8_dot_avx2(P3 + (UINTN)i * (UINTN)n, n, x);
+        _mm256_storeu_ps(hb + i, djiblas_silu_mul256_ps(g, u));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Streaming variants (matrices larger than the LLC, see djiblas.h): the same
+// dot products with every weight stream prefetched pf bytes ahead.
+// ----------------------------------------------------------------------------
+
+static inline __attribute__((always_inline)) void stream_prefetch(const float *p, BOOLEAN nta) {
+    if (nta) _mm_prefetch((const char *)p, _MM_HINT_NTA);
+    else _mm_prefetch((const char *)p, _MM_HINT_T0);
+}
+
+// rows8_dot_avx2 with k stepped by one cache line (16 floats) per row, so
+// each step issues exactly one prefetch per row stream.
+static inline __attribute__((always_inline)) __m256 rows8_dot_stream_avx2(const float *W, int ldw, int n, const float *x,
+                                           int pf, BOOLEAN nta) {
+    const float *w0 = W + (UINTN)ldw * 0;
+    const float *w1 = W + (UINTN)ldw * 1;
+    const float *w2 = W + (UINTN)ldw * 2;
+    const float *w3 = W + (UINTN)ldw * 3;
+    const float *w4 = W + (UINTN)ldw * 4;
+    const float *w5 = W + (UINTN)ldw * 5;
+    const float *w6 = W + (UINTN)ldw * 6;
+    const float *w7 = W + (UINTN)ldw * 7;
+    __m256 c0 = _mm256_setzero_ps();
+    __m256 c1 = _mm256_setzero_ps();
+    __m256 c2 = _mm256_setzero_ps();
+    __m256 c3 = _mm256_setzero_ps();
+    __m256 c4 = _mm256_setzero_ps();
+    __m256 c5 = _mm256_setzero_ps();
+    __m256 c6 = _mm256_setzero_ps();
+    __m256 c7 = _mm256_setzero_ps();
+
+    int l = 0;
+    for (; l + 16 <= n; l += 16) {
+        stream_prefetch(w0 + l + pf, nta);
+        stream_prefetch(w1 + l + pf, nta);
+        stream_prefetch(w2 + l + pf, nta);
+        stream_prefetch(w3 + l + pf, nta);
+        stream_prefetch(w4 + l + pf, nta);
+        stream_prefetch(w5 + l + pf, nta);
+        stream_prefetch(w6 + l + pf, nta);
+        stream_prefetch(w7 + l + pf, nta);
+        __m256 xa = _mm256_loadu_ps(x + l);
+        __m256 xb = _mm256_loadu_ps(x + l + 8);
+        c0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + l), xa, c0);
+        c1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + l), xa, c1);
+        c2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + l), xa, c2);
+        c3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + l), xa, c3);
+        c4 = _mm256_fmadd_ps(_mm256_loadu_ps(w4 + l), xa, c4);
+        c5 = _mm256_fmadd_ps(_mm256_loadu_ps(w5 + l), xa, c5);
+        c6 = _mm256_fmadd_ps(_mm256_loadu_ps(w6 + l), xa, c6);
+        c7 = _mm256_fmadd_ps(_mm256_loadu_ps(w7 + l), xa, c7);
+        c0 = _mm256_fmadd_ps(_mm256_loadu_ps(w0 + l + 8), xb, c0);
+        c1 = _mm256_fmadd_ps(_mm256_loadu_ps(w1 + l + 8), xb, c1);
+        c2 = _mm256_fmadd_ps(_mm256_loadu_ps(w2 + l + 8), xb, c2);
+        c3 = _mm256_fmadd_ps(_mm256_loadu_ps(w3 + l + 8), xb, c3);
+        c4 = _mm256_fmadd_ps(_mm256_loadu_ps(w4 + l + 8), xb, c4);
+        c5 = _mm256_fmadd_ps(_mm256_loadu_ps(w5 + l + 8), xb, c5);
+        c6 = _mm256_fmadd_ps(_mm256_loadu_ps(w6 + l + 8), xb, c6);
+        c7 = _mm256_fmadd_ps(_mm256_loadu_ps(w7 + l + 8), xb, c7);
+    }
+
+    // The (< 16) remainder and the tail go through the plain kernel's order.
+    __m256 sum = djiblas_hsum8x8_ps(c0, c1, c2, c3, c4, c5, c6, c7);
+    if (l < n) {
+        sum = _mm256_add_ps(sum, rows8_dot_avx2(W + l, ldw, n - l, x + l));
+    }
+    return sum;
+}
+
+// panel8_dot_avx2 plus four line prefetches (the 256-byte k-step) pf ahead.
+static inline __attribute__((always_inline)) __m256 panel8_dot_stream_avx2(const float *p, int n, const float *x,
+                                            int pf, BOOLEAN nta) {
+    __m256 c0 = _mm256_setzero_ps();
+    __m256 c1 = _mm256_setzero_ps();
+    __m256 c2 = _mm256_setzero_ps();
+    __m256 c3 = _mm256_setzero_ps();
+    __m256 c4 = _mm256_setzero_ps();
+    __m256 c5 = _mm256_setzero_ps();
+    __m256 c6 = _mm256_setzero_ps();
+    __m256 c7 = _mm256_setzero_ps();
+    for (int l = 0; l < n; l += 8) {
+        stream_prefetch(p + pf, nta);
+        stream_prefetch(p + pf + 16, nta);
+        stream_prefetch(p + pf + 32, nta);
+        stream_prefetch(p + pf + 48, nta);
+        __m256 xv = _mm256_loadu_ps(x + l);
+        c0 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 0), xv, c0);
+        c1 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 8), xv, c1);
+        c2 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 16), xv, c2);
+        c3 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 24), xv, c3);
+        c4 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 32), xv, c4);
+        c5 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 40), xv, c5);
+        c6 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 48), xv, c6);
+        c7 = _mm256_fmadd_ps(_mm256_loadu_ps(p + 56), xv, c7);
+        p += 64;
+    }
+    return djiblas_hsum8x8_ps(c0, c1, c2, c3, c4, c5, c6, c7);
+}
+
+// The hint is a compile-time constant in each loop below (nta ? f(TRUE) :
+// f(FALSE)), so the inlined dot products carry no per-step branch.
+void djiblas_sgemv_stream_avx2(int d, int n,
+                               const float *W, int ldw,
+                               const float *x,
+                               float *y) {
+    int pf = g_djiblas.stream_pf / (int)sizeof(float);
+    BOOLEAN nta = g_djiblas.stream_nta;
+    int i = 0;
+    for (; i + 8 <= d; i += 8) {
+        const float *Wi = W + (UINTN)ldw * i;
+        __m256 v = nta ? rows8_dot_stream_avx2(Wi, ldw, n, x, pf, TRUE)
+                       : rows8_dot_stream_avx2(Wi, ldw, n, x, pf, FALSE);
+        _mm256_storeu_ps(y + i, v);
+    }
+    for (; i < d; i++) {
+        y[i] = row_dot_avx2(W + (UINTN)ldw * i, n, x);
+    }
+}
+
+void djiblas_ffn_gate_up_stream_avx2(int d, int n,
+                                     const float *W1, const float *W3, int ldw,
+                                     const float *x, float *hb) {
+    int pf = g_djiblas.stream_pf / (int)sizeof(float);
+    BOOLEAN nta = g_djiblas.stream_nta;
+    int i = 0;
+    for (; i + 8 <= d; i += 8) {
+        const float *A = W1 + (UINTN)ldw * i;
+        const float *B = W3 + (UINTN)ldw * i;
+        __m256 g = nta ? rows8_dot_stream_avx2(A, ldw, n, x, pf, TRUE)
+                       : rows8_dot_stream_avx2(A, ldw, n, x, pf, FALSE);
+        __m256 u = nta ? rows8_dot_stream_avx2(B, ldw, n, x, pf, TRUE)
+                       : rows8_dot_stream_avx2(B, ldw, n, x, pf, FALSE);
+        _mm256_storeu_ps(hb + i, djiblas_silu_mul256_ps(g, u));
+    }
+    if (i < d) {
+        djiblas_ffn_gate_up_avx2(d - i, n, W1 + (UINTN)ldw * i, W3 + (UINTN)ldw * i, ldw, x, hb + i);
+    }
+}
+
+void djiblas_sgemv_panel8_stream_avx2(int d, int n, const float *P, const float *x, float *y) {
+    int pf = g_djiblas.stream_pf / (int)sizeof(float);
+    BOOLEAN nta = g_djiblas.stream_nta;
+    for (int i = 0; i < d; i += 8) {
+        const float *Pi = P + (UINTN)i * (UINTN)n;
+        __m256 v = nta ? panel8_dot_stream_avx2(Pi, n, x, pf, TRUE)
+                       : panel8_dot_stream_avx2(Pi, n, x, pf, FALSE);
+        _mm256_storeu_ps(y + i, v);
+    }
+}
+
+void djiblas_ffn_gate_up_panel8_stream_avx2(int d, int n, const float *P1, const float *P3,
+                                            const float *x, float *hb) {
+    int pf = g_djiblas.stream_pf / (int)sizeof(float);
+    BOOLEAN nta = g_djiblas.stream_nta;
+    for (int i = 0; i < d; i += 8) {
+        const float *A = P1 + (UINTN)i * (UINTN)n;
+        const float *B = P3 + (UINTN)i * (UINTN)n;
+        __m256 g = nta ? panel8_dot_stream_avx2(A, n, x, pf, TRUE) : panel8_dot_stream_avx2(A, n, x, pf, FALSE);
+        __m256 u = nta ? panel8_dot_stream_avx2(B, n, x, pf, TRUE) : panel8_dot_stream_avx2(B, n, x, pf, FALSE);
+        _mm256_storeu_ps(hb + i, djiblas_silu_mul256_ps(g, u));
+    }
 }
 
 void djiblas_sgemm_avx2(int m, int n, int k,
@@ -41,12 +403,19 @@ void djiblas_sgemm_avx2(int m, int n, int k,
             __m256 c22 = _mm256_setzero_ps();
             __m256 c23 = _mm256_setzero_ps();
 
+            // Edge tiles (n % 4) re-read the last valid B row instead of
+            // running past the end of B; those results are never stored.
+            const float *bp0 = &B[ldb * (j + 0)];
+            const float *bp1 = &B[ldb * (j + 1 < n ? j + 1 : j)];
+            const float *bp2 = &B[ldb * (j + 2 < n ? j + 2 : j)];
+            const float *bp3 = &B[ldb * (j + 3 < n ? j + 3 : j)];
+
             int l = 0;
             for (; l + 8 <= k; l += 8) {
-                __m256 b0 = _mm256_loadu_ps(&B[ldb * (j + 0) + l]);
-                __m256 b1 = _mm256_loadu_ps(&B[ldb * (j + 1) + l]);
-                __m256 b2 = _mm256_loadu_ps(&B[ldb * (j + 2) + l]);
-                __m256 b3 = _mm256_loadu_ps(&B[ldb * (j + 3) + l]);
+                __m256 b0 = _mm256_loadu_ps(bp0 + l);
+                __m256 b1 = _mm256_loadu_ps(bp1 + l);
+                __m256 b2 = _mm256_loadu_ps(bp2 + l);
+                __m256 b3 = _mm256_loadu_ps(bp3 + l);
 
                 if (i + 0 < m) {
                     __m256 a0 = _mm256_loadu_ps(&A[lda * (i + 0) + l]);
@@ -75,22 +444,22 @@ void djiblas_sgemm_avx2(int m, int n, int k,
 
             // Store results
             if (i + 0 < m) {
-                if (j + 0 < n) C[ldc * (j + 0) + (i + 0)] = hsum_avx(c00);
-                if (j + 1 < n) C[ldc * (j + 1) + (i + 0)] = hsum_avx(c01);
-                if (j + 2 < n) C[ldc * (j + 2) + (i + 0)] = hsum_avx(c02);
-                if (j + 3 < n) C[ldc * (j + 3) + (i + 0)] = hsum_avx(c03);
+                if (j + 0 < n) C[ldc * (j + 0) + (i + 0)] = djiblas_hsum256_ps(c00);
+                if (j + 1 < n) C[ldc * (j + 1) + (i + 0)] = djiblas_hsum256_ps(c01);
+                if (j + 2 < n) C[ldc * (j + 2) + (i + 0)] = djiblas_hsum256_ps(c02);
+                if (j + 3 < n) C[ldc * (j + 3) + (i + 0)] = djiblas_hsum256_ps(c03);
             }
             if (i + 1 < m) {
-                if (j + 0 < n) C[ldc * (j + 0) + (i + 1)] = hsum_avx(c10);
-                if (j + 1 < n) C[ldc * (j + 1) + (i + 1)] = hsum_avx(c11);
-                if (j + 2 < n) C[ldc * (j + 2) + (i + 1)] = hsum_avx(c12);
-                if (j + 3 < n) C[ldc * (j + 3) + (i + 1)] = hsum_avx(c13);
+                if (j + 0 < n) C[ldc * (j + 0) + (i + 1)] = djiblas_hsum256_ps(c10);
+                if (j + 1 < n) C[ldc * (j + 1) + (i + 1)] = djiblas_hsum256_ps(c11);
+                if (j + 2 < n) C[ldc * (j + 2) + (i + 1)] = djiblas_hsum256_ps(c12);
+                if (j + 3 < n) C[ldc * (j + 3) + (i + 1)] = djiblas_hsum256_ps(c13);
             }
             if (i + 2 < m) {
-                if (j + 0 < n) C[ldc * (j + 0) + (i + 2)] = hsum_avx(c20);
-                if (j + 1 < n) C[ldc * (j + 1) + (i + 2)] = hsum_avx(c21);
-                if (j + 2 < n) C[ldc * (j + 2) + (i + 2)] = hsum_avx(c22);
-                if (j + 3 < n) C[ldc * (j + 3) + (i + 2)] = hsum_avx(c23);
+                if (j + 0 < n) C[ldc * (j + 0) + (i + 2)] = djiblas_hsum256_ps(c20);
+                if (j + 1 < n) C[ldc * (j + 1) + (i + 2)] = djiblas_hsum256_ps(c21);
+                if (j + 2 < n) C[ldc * (j + 2) + (i + 2)] = djiblas_hsum256_ps(c22);
+                if (j + 3 < n) C[ldc * (j + 3) + (i + 2)] = djiblas_hsum256_ps(c23);
             }
 
             // Handle remainder with scalar
@@ -105,6 +474,747 @@ void djiblas_sgemm_avx2(int m, int n, int k,
     }
 }
 
+void djiblas_sgemm_avx2_2x4(int m, int n, int k,
+                            const float *A, int lda,
+                            const float *B, int ldb,
+                            float *C, int ldc) {
+    // Autotune candidate: 2x4 tile. 8 accumulators + 4 B rows + 1 A row fit
+    // the 16 YMM registers without spills (the 3x4 tile needs 17), at the
+    // cost of more B loads per FMA. Edge tiles clamp their row pointers to
+    // the last valid row and skip those stores.
+    for (int i = 0; i < m; i += 2) {
+        const int mi = (m - i < 2) ? (m - i) : 2;
+        const float *a0 = A + (UINTN)lda * i;
+        const float *a1 = A + (UINTN)lda * (i + (mi > 1 ? 1 : 0));
+
+        for (int j = 0; j < n; j += 4) {
+            const int nj = (n - j < 4) ? (n - j) : 4;
+            const float *b0 = B + (UINTN)ldb * j;
+            const float *b1 = B + (UINTN)ldb * (j + (nj > 1 ? 1 : 0));
+            const float *b2 = B + (UINTN)ldb * (j + (nj > 2 ? 2 : 0));
+            const float *b3 = B + (UINTN)ldb * (j + (nj > 3 ? 3 : 0));
+
+            __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+            __m256 c02 = _mm256_setzero_ps(), c03 = _mm256_setzero_ps();
+            __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+            __m256 c12 = _mm256_setzero_ps(), c13 = _mm256_setzero_ps();
+
+            int l = 0;
+            for (; l + 8 <= k; l += 8) {
+                __m256 bv0 = _mm256_loadu_ps(b0 + l);
+                __m256 bv1 = _mm256_loadu_ps(b1 + l);
+                __m256 bv2 = _mm256_loadu_ps(b2 + l);
+                __m256 bv3 = _mm256_loadu_ps(b3 + l);
+                __m256 av = _mm256_loadu_ps(a0 + l);
+                c00 = _mm256_fmadd_ps(av, bv0, c00);
+                c01 = _mm256_fmadd_ps(av, bv1, c01);
+                c02 = _mm256_fmadd_ps(av, bv2, c02);
+                c03 = _mm256_fmadd_ps(av, bv3, c03);
+                av = _mm256_loadu_ps(a1 + l);
+                c10 = _mm256_fmadd_ps(av, bv0, c10);
+                c11 = _mm256_fmadd_ps(av, bv1, c11);
+                c12 = _mm256_fmadd_ps(av, bv2, c12);
+                c13 = _mm256_fmadd_ps(av, bv3, c13);
+            }
+
+            // Lane (r * 4 + c) = row r, column c of the tile.
+            float t[8];
+            _mm256_storeu_ps(t, djiblas_hsum8x8_ps(c00, c01, c02, c03, c10, c11, c12, c13));
+            for (; l < k; l++) {
+                float x0 = a0[l], x1 = a1[l];
+                t[0] += x0 * b0[l]; t[1] += x0 * b1[l]; t[2] += x0 * b2[l]; t[3] += x0 * b3[l];
+                t[4] += x1 * b0[l]; t[5] += x1 * b1[l]; t[6] += x1 * b2[l]; t[7] += x1 * b3[l];
+            }
+            for (int jj = 0; jj < nj; jj++) {
+                for (int ii = 0; ii < mi; ii++) {
+                    C[(UINTN)ldc * (j + jj) + i + ii] = t[ii * 4 + jj];
+                }
+            }
+        }
+    }
+}
+
+void djiblas_dequant_avx2(const INT8 *q, float scale, float *out, UINT32 n) {
+    djibquant_dequantize_avx2(q, scale, out, n);
+}
+
+// ===================================================================
+// Q8_0
+// ===================================================================
+
+void djiblas_quantize_q8_avx2(const float *x, int n, INT8 *xq, float *xd) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    // packs works per 128-bit lane; this restores element order afterwards.
+    const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (int b = 0; b < n / DJIBLAS_Q8_BLOCK; b++) {
+        const float *p = x + b * DJIBLAS_Q8_BLOCK;
+        __m256 v0 = _mm256_loadu_ps(p);
+        __m256 v1 = _mm256_loadu_ps(p + 8);
+        __m256 v2 = _mm256_loadu_ps(p + 16);
+        __m256 v3 = _mm256_loadu_ps(p + 24);
+        __m256 amax = _mm256_max_ps(_mm256_max_ps(_mm256_andnot_ps(sign, v0), _mm256_andnot_ps(sign, v1)),
+                                    _mm256_max_ps(_mm256_andnot_ps(sign, v2), _mm256_andnot_ps(sign, v3)));
+        __m128 m4 = _mm_max_ps(_mm256_castps256_ps128(amax), _mm256_extractf128_ps(amax, 1));
+        m4 = _mm_max_ps(m4, _mm_movehl_ps(m4, m4));
+        m4 = _mm_max_ss(m4, _mm_shuffle_ps(m4, m4, 1));
+        float m = _mm_cvtss_f32(m4);
+        xd[b] = m / 127.0f;
+        __m256 id = _mm256_set1_ps((m > 0.0f) ? (127.0f / m) : 0.0f);
+
+        __m256i i0 = _mm256_cvtps_epi32(_mm256_mul_ps(v0, id));
+        __m256i i1 = _mm256_cvtps_epi32(_mm256_mul_ps(v1, id));
+        __m256i i2 = _mm256_cvtps_epi32(_mm256_mul_ps(v2, id));
+        __m256i i3 = _mm256_cvtps_epi32(_mm256_mul_ps(v3, id));
+        __m256i q = _mm256_packs_epi16(_mm256_packs_epi32(i0, i1), _mm256_packs_epi32(i2, i3));
+        _mm256_storeu_si256((__m256i *)(xq + b * DJIBLAS_Q8_BLOCK), _mm256_permutevar8x32_epi32(q, perm));
+    }
+}
+
+void djiblas_gemv_q8_avx2(int d, int n, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    // maddubs is unsigned x signed: move w's sign onto x and use |w|.
+    const __m256i ones = _mm256_set1_epi16(1);
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        __m256 acc = _mm256_setzero_ps();
+        for (int b = 0; b < nb; b++) {
+            __m256i vw = _mm256_loadu_si256((const __m256i *)(w + b * DJIBLAS_Q8_BLOCK));
+            __m256i vx = _mm256_loadu_si256((const __m256i *)(xq + b * DJIBLAS_Q8_BLOCK));
+            __m256i p16 = _mm256_maddubs_epi16(_mm256_sign_epi8(vw, vw), _mm256_sign_epi8(vx, vw));
+            __m256i p32 = _mm256_madd_epi16(p16, ones);
+            acc = _mm256_fmadd_ps(_mm256_cvtepi32_ps(p32), _mm256_set1_ps(wd[b] * xd[b]), acc);
+        }
+        y[i] = djiblas_hsum256_ps(acc);
+    }
+}
+
+// |w| against sign(w) * x for one block: 8 int32 lanes as floats.
+static inline __m256 q8_block_dot_avx2(__m256i uw, __m256i vw, const INT8 *x) {
+    __m256i vx = _mm256_loadu_si256((const __m256i *)x);
+    __m256i p16 = _mm256_maddubs_epi16(uw, _mm256_sign_epi8(vx, vw));
+    return _mm256_cvtepi32_ps(_mm256_madd_epi16(p16, _mm256_set1_epi16(1)));
+}
+
+void djiblas_gemm_q8_avx2(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    // |w| is formed once per block and reused for DJIBLAS_Q8_NCOL columns.
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        int c = 0;
+        for (; c + DJIBLAS_Q8_NCOL <= ncol; c += DJIBLAS_Q8_NCOL) {
+            const INT8 *x = xq + (UINTN)c * (UINTN)n;
+            const float *dx = xd + (UINTN)c * (UINTN)nb;
+            __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+            __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+            for (int b = 0; b < nb; b++) {
+                __m256i vw = _mm256_loadu_si256((const __m256i *)(w + b * DJIBLAS_Q8_BLOCK));
+                __m256i uw = _mm256_sign_epi8(vw, vw);
+                const INT8 *xb = x + b * DJIBLAS_Q8_BLOCK;
+                a0 = _mm256_fmadd_ps(q8_block_dot_avx2(uw, vw, xb), _mm256_set1_ps(wd[b] * dx[b]), a0);
+                a1 = _mm256_fmadd_ps(q8_block_dot_avx2(uw, vw, xb + n), _mm256_set1_ps(wd[b] * dx[b + nb]), a1);
+                a2 = _mm256_fmadd_ps(q8_block_dot_avx2(uw, vw, xb + 2 * n), _mm256_set1_ps(wd[b] * dx[b + 2 * nb]), a2);
+                a3 = _mm256_fmadd_ps(q8_block_dot_avx2(uw, vw, xb + 3 * n), _mm256_set1_ps(wd[b] * dx[b + 3 * nb]), a3);
+            }
+            Y[(UINTN)c * (UINTN)ldy + i] = djiblas_hsum256_ps(a0);
+            Y[(UINTN)(c + 1) * (UINTN)ldy + i] = djiblas_hsum256_ps(a1);
+            Y[(UINTN)(c + 2) * (UINTN)ldy + i] = djiblas_hsum256_ps(a2);
+            Y[(UINTN)(c + 3) * (UINTN)ldy + i] = djiblas_hsum256_ps(a3);
+        }
+        for (; c < ncol; c++) {
+            djiblas_gemv_q8_avx2(1, n, w, wd, xq + (UINTN)c * (UINTN)n, xd + (UINTN)c * (UINTN)nb,
+                                 Y + (UINTN)c * (UINTN)ldy + i);
+        }
+    }
+}
+
+void djiblas_gemv_q6_avx2(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                          const float *x, float *y) {
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        UINT64 e = e0 + (UINT64)i * (UINT64)n;
+        __m256 acc = _mm256_setzero_ps();
+        float tail = 0.0f;
+        int l = 0;
+        while (l < n) {
+            UINT64 g = (e + (UINT64)l) / DJIBLAS_Q6_GROUP;
+            int end = (int)((g + 1) * DJIBLAS_Q6_GROUP - e);
+            if (end > n) end = n;
+            __m256 s0 = _mm256_setzero_ps();
+            __m256 s1 = _mm256_setzero_ps();
+            for (; l + 16 <= end; l += 16) {
+                __m256 w0 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)(w + l))));
+                __m256 w1 = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)(w + l + 8))));
+                s0 = _mm256_fmadd_ps(w0, _mm256_loadu_ps(x + l), s0);
+                s1 = _mm256_fmadd_ps(w1, _mm256_loadu_ps(x + l + 8), s1);
+            }
+            float st = 0.0f;
+            for (; l < end; l++) st += (float)w[l] * x[l];
+            acc = _mm256_fmadd_ps(_mm256_add_ps(s0, s1), _mm256_set1_ps(S[g]), acc);
+            tail += st * S[g];
+        }
+        y[i] = djiblas_hsum256_ps(acc) + tail;
+    }
+}
+
+void djiblas_gemv_q4_avx2(int d, int n, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    // Low nibbles are values 0..15 of the block, high nibbles 16..31: one
+    // and + one srli/and give the 32 bytes in order, then the Q8 sign trick.
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    const __m256i eight = _mm256_set1_epi8(8);
+    const __m256i ones = _mm256_set1_epi16(1);
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const UINT8 *w = W + (UINTN)i * (UINTN)nb * DJIBLAS_Q4_BLOCK_BYTES;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        __m256 acc = _mm256_setzero_ps();
+        for (int b = 0; b < nb; b++) {
+            __m128i v = _mm_loadu_si128((const __m128i *)(w + b * DJIBLAS_Q4_BLOCK_BYTES));
+            __m256i vv = _mm256_inserti128_si256(_mm256_castsi128_si256(v), _mm_srli_epi16(v, 4), 1);
+            __m256i vw = _mm256_sub_epi8(_mm256_and_si256(vv, mask), eight);
+            __m256i vx = _mm256_loadu_si256((const __m256i *)(xq + b * DJIBLAS_Q8_BLOCK));
+            __m256i p16 = _mm256_maddubs_epi16(_mm256_sign_epi8(vw, vw), _mm256_sign_epi8(vx, vw));
+            __m256i p32 = _mm256_madd_epi16(p16, ones);
+            acc = _mm256_fmadd_ps(_mm256_cvtepi32_ps(p32), _mm256_set1_ps(wd[b] * xd[b]), acc);
+        }
+        y[i] = djiblas_hsum256_ps(acc);
+    }
+}
+
+void djiblas_gemm_q4_avx2(int d, int n, int ncol, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    // The block is unpacked (and |w| formed) once for DJIBLAS_Q8_NCOL columns.
+    const __m256i mask = _mm256_set1_epi8(0x0F);
+    const __m256i eight = _mm256_set1_epi8(8);
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const UINT8 *w = W + (UINTN)i * (UINTN)nb * DJIBLAS_Q4_BLOCK_BYTES;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        int c = 0;
+        for (; c + DJIBLAS_Q8_NCOL <= ncol; c += DJIBLAS_Q8_NCOL) {
+            const INT8 *x = xq + (UINTN)c * (UINTN)n;
+            const float *dx = xd + (UINTN)c * (UINTN)nb;
+            __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+            __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+            for (int b = 0; b < nb; b++) {
+                __m128i v = _mm_loadu_si128((const __m128i *)(w + b * DJIBLAS_Q4_BLOCK_BYTES));
+                __m256i vv = _mm256_inserti128_si256(_mm256_castsi128_si256(v), _mm_srli_epi16(v, 4), 1);
+                __m256i vw = _mm256_sub_epi8(_mm256_and_si256(vv, mask), eight);
+                __m256i uw = _mm256_sign_epi8(vw, vw);
+                const INT8 *xb = x + b * DJIBLAS_Q8_BLOCK;
+                a0 = _mm256_fmadd_ps(q8_block_dot_avx2(uw, vw, xb), _mm256_set1_ps(wd[b] * dx[b]), a0);
+                a1 = _mm256_fmadd_ps(q8_block_dot_avx2(uw, vw, xb + n), _mm256_set1_ps(wd[b] * dx[b + nb]), a1);
+                a2 = _mm256_fmadd_ps(q8_block_dot_avx2(uw, vw, xb + 2 * n), _mm256_set1_ps(wd[b] * dx[b + 2 * nb]), a2);
+                a3 = _mm256_fmadd_ps(q8_block_dot_avx2(uw, vw, xb + 3 * n), _mm256_set1_ps(wd[b] * dx[b + 3 * nb]), a3);
+            }
+            Y[(UINTN)c * (UINTN)ldy + i] = djiblas_hsum256_ps(a0);
+            Y[(UINTN)(c + 1) * (UINTN)ldy + i] = djiblas_hsum256_ps(a1);
+            Y[(UINTN)(c + 2) * (UINTN)ldy + i] = djiblas_hsum256_ps(a2);
+            Y[(UINTN)(c + 3) * (UINTN)ldy + i] = djiblas_hsum256_ps(a3);
+        }
+        for (; c < ncol; c++) {
+            djiblas_gemv_q4_avx2(1, n, w, wd, xq + (UINTN)c * (UINTN)n, xd + (UINTN)c * (UINTN)nb,
+                                 Y + (UINTN)c * (UINTN)ldy + i);
+        }
+    }
+}
+
+void djiblas_gemv_bf16_avx2(int d, int n, const UINT16 *W, const float *x, float *y) {
+    // bf16 -> fp32 is zero-extend + shift left 16.
+    for (int i = 0; i < d; i++) {
+        const UINT16 *w = W + (UINTN)i * (UINTN)n;
+        __m256 s0 = _mm256_setzero_ps();
+        __m256 s1 = _mm256_setzero_ps();
+        int l = 0;
+        for (; l + 16 <= n; l += 16) {
+            __m256i v = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(w + l)));
+            __m256i u = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(w + l + 8)));
+            s0 = _mm256_fmadd_ps(_mm256_castsi256_ps(_mm256_slli_epi32(v, 16)), _mm256_loadu_ps(x + l), s0);
+            s1 = _mm256_fmadd_ps(_mm256_castsi256_ps(_mm256_slli_epi32(u, 16)), _mm256_loadu_ps(x + l + 8), s1);
+        }
+        float sum = djiblas_hsum256_ps(_mm256_add_ps(s0, s1));
+        for (; l < n; l++) {
+            float t;
+            djiblas_widen_bf16(w + l, &t, 1);
+            sum += t * x[l];
+        }
+        y[i] = sum;
+    }
+}
+
+// 32 packed values = 24 bytes. Each output dword gets the 3 bytes of its
+// 4-value word via pshufb, vpsllvd moves its 6-bit field to the top and
+// vpsrad 26 sign-extends it. The second load starts at byte 8 so nothing
+// past the 24 bytes is read.
+static inline void q6p_unpack32_epi32_avx2(const UINT8 *p, __m256i *i0, __m256i *i1, __m256i *i2, __m256i *i3) {
+    const __m256i sh0 = _mm256_setr_epi8(0, 1, 2, -1, 0, 1, 2, -1, 0, 1, 2, -1, 0, 1, 2, -1,
+                                         3, 4, 5, -1, 3, 4, 5, -1, 3, 4, 5, -1, 3, 4, 5, -1);
+    const __m256i sh1 = _mm256_setr_epi8(6, 7, 8, -1, 6, 7, 8, -1, 6, 7, 8, -1, 6, 7, 8, -1,
+                                         9, 10, 11, -1, 9, 10, 11, -1, 9, 10, 11, -1, 9, 10, 11, -1);
+    const __m256i sh2 = _mm256_add_epi8(sh0, _mm256_set1_epi32(0x00040404));
+    const __m256i sh3 = _mm256_add_epi8(sh1, _mm256_set1_epi32(0x00040404));
+    const __m256i sl = _mm256_setr_epi32(26, 20, 14, 8, 26, 20, 14, 8);
+    __m256i lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)p));
+    __m256i hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(p + 8)));
+    *i0 = _mm256_srai_epi32(_mm256_sllv_epi32(_mm256_shuffle_epi8(lo, sh0), sl), 26);
+    *i1 = _mm256_srai_epi32(_mm256_sllv_epi32(_mm256_shuffle_epi8(lo, sh1), sl), 26);
+    *i2 = _mm256_srai_epi32(_mm256_sllv_epi32(_mm256_shuffle_epi8(hi, sh2), sl), 26);
+    *i3 = _mm256_srai_epi32(_mm256_sllv_epi32(_mm256_shuffle_epi8(hi, sh3), sl), 26);
+}
+
+static inline void q6p_unpack32_avx2(const UINT8 *p, __m256 *f0, __m256 *f1, __m256 *f2, __m256 *f3) {
+    __m256i i0, i1, i2, i3;
+    q6p_unpack32_epi32_avx2(p, &i0, &i1, &i2, &i3);
+    *f0 = _mm256_cvtepi32_ps(i0);
+    *f1 = _mm256_cvtepi32_ps(i1);
+    *f2 = _mm256_cvtepi32_ps(i2);
+    *f3 = _mm256_cvtepi32_ps(i3);
+}
+
+void djiblas_gemv_q6p_avx2(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                           const float *x, float *y) {
+    INT8 seg[4];
+    for (int i = 0; i < d; i++) {
+        const UINT8 *w = W + (UINTN)i * (UINTN)n / 4 * 3;
+        UINT64 e = e0 + (UINT64)i * (UINT64)n;
+        __m256 acc = _mm256_setzero_ps();
+        float tail = 0.0f;
+        int l = 0;
+        while (l < n) {
+            UINT64 g = (e + (UINT64)l) / DJIBLAS_Q6_GROUP;
+            int end = (int)((g + 1) * DJIBLAS_Q6_GROUP - e);
+            if (end > n) end = n;
+            __m256 s0 = _mm256_setzero_ps();
+            __m256 s1 = _mm256_setzero_ps();
+            for (; l + 32 <= end; l += 32) {
+                __m256 f0, f1, f2, f3;
+                q6p_unpack32_avx2(w + l / 4 * 3, &f0, &f1, &f2, &f3);
+                s0 = _mm256_fmadd_ps(f0, _mm256_loadu_ps(x + l), s0);
+                s1 = _mm256_fmadd_ps(f1, _mm256_loadu_ps(x + l + 8), s1);
+                s0 = _mm256_fmadd_ps(f2, _mm256_loadu_ps(x + l + 16), s0);
+                s1 = _mm256_fmadd_ps(f3, _mm256_loadu_ps(x + l + 24), s1);
+            }
+            float st = 0.0f;
+            for (; l < end; l += 4) {
+                djiblas_unpack_q6p(w + l / 4 * 3, seg, 4);
+                for (int j = 0; j < 4; j++) st += (float)seg[j] * x[l + j];
+            }
+            acc = _mm256_fmadd_ps(_mm256_add_ps(s0, s1), _mm256_set1_ps(S[g]), acc);
+            tail += st * S[g];
+        }
+        y[i] = djiblas_hsum256_ps(acc) + tail;
+    }
+}
+
+// Against the cached activation: e0 and n are multiples of 32, so each
+// 32-block has a single scale S[group] * xd[block].
+void djiblas_gemv_q6_q8_avx2(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                             const INT8 *xq, const float *xd, float *y) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        const float *s = S + (e0 + (UINT64)i * (UINT64)n) / DJIBLAS_Q6_GROUP;
+        int odd = (int)(((e0 + (UINT64)i * (UINT64)n) / DJIBLAS_Q8_BLOCK) & 1);
+        __m256 acc = _mm256_setzero_ps();
+        for (int b = 0; b < nb; b++) {
+            __m256i vw = _mm256_loadu_si256((const __m256i *)(w + b * DJIBLAS_Q8_BLOCK));
+            __m256i vx = _mm256_loadu_si256((const __m256i *)(xq + b * DJIBLAS_Q8_BLOCK));
+            __m256i p16 = _mm256_maddubs_epi16(_mm256_sign_epi8(vw, vw), _mm256_sign_epi8(vx, vw));
+            __m256i p32 = _mm256_madd_epi16(p16, ones);
+            acc = _mm256_fmadd_ps(_mm256_cvtepi32_ps(p32), _mm256_set1_ps(s[(b + odd) >> 1] * xd[b]), acc);
+        }
+        y[i] = djiblas_hsum256_ps(acc);
+    }
+}
+
+void djiblas_gemv_q6p_q8_avx2(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                              const INT8 *xq, const float *xd, float *y) {
+    // Unpacked dwords narrowed to bytes with packs (per 128-bit lane), then
+    // the same permute as the Q8 quantizer restores element order.
+    const __m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const __m256i ones = _mm256_set1_epi16(1);
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const UINT8 *w = W + (UINTN)i * (UINTN)n / 4 * 3;
+        const float *s = S + (e0 + (UINT64)i * (UINT64)n) / DJIBLAS_Q6_GROUP;
+        int odd = (int)(((e0 + (UINT64)i * (UINT64)n) / DJIBLAS_Q8_BLOCK) & 1);
+        __m256 acc = _mm256_setzero_ps();
+        for (int b = 0; b < nb; b++) {
+            __m256i i0, i1, i2, i3;
+            q6p_unpack32_epi32_avx2(w + b * (DJIBLAS_Q8_BLOCK / 4 * 3), &i0, &i1, &i2, &i3);
+            __m256i vw = _mm256_packs_epi16(_mm256_packs_epi32(i0, i1), _mm256_packs_epi32(i2, i3));
+            vw = _mm256_permutevar8x32_epi32(vw, perm);
+            __m256i vx = _mm256_loadu_si256((const __m256i *)(xq + b * DJIBLAS_Q8_BLOCK));
+            __m256i p16 = _mm256_maddubs_epi16(_mm256_sign_epi8(vw, vw), _mm256_sign_epi8(vx, vw));
+            __m256i p32 = _mm256_madd_epi16(p16, ones);
+            acc = _mm256_fmadd_ps(_mm256_cvtepi32_ps(p32), _mm256_set1_ps(s[(b + odd) >> 1] * xd[b]), acc);
+        }
+        y[i] = djiblas_hsum256_ps(acc);
+    }
+}
+
+void djiblas_residual_rmsnorm_avx2(float *x, const float *delta, const float *weight, float *out, int n) {
+    // Pass 1: x += delta, sum of squares from the registers just stored.
+    __m256 s0 = _mm256_setzero_ps();
+    __m256 s1 = _mm256_setzero_ps();
+    int j = 0;
+    for (; j + 16 <= n; j += 16) {
+        __m256 v0 = _mm256_add_ps(_mm256_loadu_ps(x + j), _mm256_loadu_ps(delta + j));
+        __m256 v1 = _mm256_add_ps(_mm256_loadu_ps(x + j + 8), _mm256_loadu_ps(delta + j + 8));
+        _mm256_storeu_ps(x + j, v0);
+        _mm256_storeu_ps(x + j + 8, v1);
+        s0 = _mm256_fmadd_ps(v0, v0, s0);
+        s1 = _mm256_fmadd_ps(v1, v1, s1);
+    }
+    for (; j + 8 <= n; j += 8) {
+        __m256 v = _mm256_add_ps(_mm256_loadu_ps(x + j), _mm256_loadu_ps(delta + j));
+        _mm256_storeu_ps(x + j, v);
+        s0 = _mm256_fmadd_ps(v, v, s0);
+    }
+    float ss = djiblas_hsum256_ps(_mm256_add_ps(s0, s1));
+    for (; j < n; j++) {
+        x[j] += delta[j];
+        ss += x[j] * x[j];
+    }
+    ss /= n;
+    ss += 1e-5f;
+    ss = 1.0f / _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(ss)));
+
+    // Pass 2: out = weight * x * ss.
+    const __m256 vs = _mm256_set1_ps(ss);
+    j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256 v = _mm256_mul_ps(_mm256_loadu_ps(x + j), vs);
+        _mm256_storeu_ps(out + j, _mm256_mul_ps(_mm256_loadu_ps(weight + j), v));
+    }
+    for (; j < n; j++) out[j] = weight[j] * (ss * x[j]);
+}
+
+// q and k in one call: the table row stays in L1 across all heads, and the
+// pair swap is one in-lane permute.
+void djiblas_rope_avx2(float *q, int q_dim, float *k, int k_dim, int head_size,
+                       const float *C, const float *S) {
+    for (int kv = 0; kv < 2; kv++) {
+        float *x = kv ? k : q;
+        int n = kv ? k_dim : q_dim;
+        for (int h = 0; h < n; h += head_size, x += head_size) {
+            int i = 0;
+            for (; i + 8 <= head_size; i += 8) {
+                __m256 v = _mm256_loadu_ps(x + i);
+                __m256 w = _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1));
+                _mm256_storeu_ps(x + i, _mm256_fmadd_ps(v, _mm256_loadu_ps(C + i),
+                                                        _mm256_mul_ps(w, _mm256_loadu_ps(S + i))));
+            }
+            for (; i < head_size; i += 2) {
+                float x0 = x[i], x1 = x[i + 1];
+                x[i] = x0 * C[i] + x1 * S[i];
+                x[i + 1] = x1 * C[i + 1] + x0 * S[i + 1];
+            }
+        }
+    }
+}
+
+// ===================================================================
+// exp-based vector primitives (softmax, SwiGLU)
+// ===================================================================
+
+float djiblas_exp_sum_avx2(float *x, int n) {
+    if (n <= 0) return 0.0f;
+    __m256 m0 = _mm256_set1_ps(x[0]);
+    __m256 m1 = m0;
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        m0 = _mm256_max_ps(m0, _mm256_loadu_ps(x + i));
+        m1 = _mm256_max_ps(m1, _mm256_loadu_ps(x + i + 8));
+    }
+    float max_val = djiblas_hmax256_ps(_mm256_max_ps(m0, m1));
+    for (; i < n; i++) {
+        if (x[i] > max_val) max_val = x[i];
+    }
+
+    const __m256 vm = _mm256_set1_ps(max_val);
+    __m256 s0 = _mm256_setzero_ps();
+    __m256 s1 = _mm256_setzero_ps();
+    i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 e0 = djiblas_exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), vm));
+        __m256 e1 = djiblas_exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i + 8), vm));
+        _mm256_storeu_ps(x + i, e0);
+        _mm256_storeu_ps(x + i + 8, e1);
+        s0 = _mm256_add_ps(s0, e0);
+        s1 = _mm256_add_ps(s1, e1);
+    }
+    for (; i < n; i += 8) {
+        // Padded tail: the pad lanes come out as exp(-huge) = 0.
+        float t[8];
+        int rem = n - i < 8 ? n - i : 8;
+        for (int j = 0; j < 8; j++) t[j] = j < rem ? x[i + j] : DJIBLAS_EXP_PAD;
+        __m256 e = djiblas_exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(t), vm));
+        _mm256_storeu_ps(t, e);
+        for (int j = 0; j < rem; j++) x[i + j] = t[j];
+        s0 = _mm256_add_ps(s0, e);
+    }
+    return djiblas_hsum256_ps(_mm256_add_ps(s0, s1));
+}
+
+void djiblas_softmax_avx2(float *x, int n) {
+    float sum = djiblas_exp_sum_avx2(x, n);
+    if (sum <= 0.0f) return;
+    const float invsum = 1.0f / sum;
+    const __m256 vinv = _mm256_set1_ps(invsum);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), vinv));
+    }
+    for (; i < n; i++) x[i] *= invsum;
+}
+
+void djiblas_silu_avx2(float *hb, const float *hb2, int n) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 g = _mm256_loadu_ps(hb + i);
+        __m256 u = _mm256_loadu_ps(hb2 + i);
+        _mm256_storeu_ps(hb + i, djiblas_silu_mul256_ps(g, u));
+    }
+    if (i < n) {
+        float g[8] = {0};
+        float u[8] = {0};
+        int rem = n - i;
+        for (int j = 0; j < rem; j++) { g[j] = hb[i + j]; u[j] = hb2[i + j]; }
+        _mm256_storeu_ps(g, djiblas_silu_mul256_ps(_mm256_loadu_ps(g), _mm256_loadu_ps(u)));
+        for (int j = 0; j < rem; j++) hb[i + j] = g[j];
+    }
+}
+
+// ===================================================================
+// Decode attention (online softmax)
+// ===================================================================
+
+// NV = head_size / 8 is a constant after inlining, so acc[] lives in YMM
+// registers (NV = 16 leaves no spare register and spills a few).
+static inline __attribute__((always_inline)) void attn_avx2_nv(const float *q, const float *K, const float *V,
+                                                               int ld, int n, float scale, float *out,
+                                                               const int NV) {
+    __m256 acc[16];
+    for (int c = 0; c < NV; c++) acc[c] = _mm256_setzero_ps();
+    const __m256 vscale = _mm256_set1_ps(scale);
+    float p[DJIBLAS_ATTN_TILE];
+    float m = DJIBLAS_EXP_PAD;
+    float l = 0.0f;
+    for (int t0 = 0; t0 < n; t0 += DJIBLAS_ATTN_TILE) {
+        int nt = (n - t0 < DJIBLAS_ATTN_TILE) ? n - t0 : DJIBLAS_ATTN_TILE;
+        const float *k = K + (UINTN)t0 * (UINTN)ld;
+        const float *v = V + (UINTN)t0 * (UINTN)ld;
+        __m256 s;
+        if (nt == DJIBLAS_ATTN_TILE) {
+            s = _mm256_mul_ps(rows8_dot_avx2(k, ld, NV * 8, q), vscale);
+        } else {
+            // Last partial tile: rows past n are never read; pad scores give p = 0.
+            for (int j = 0; j < DJIBLAS_ATTN_TILE; j++) {
+                p[j] = (j < nt) ? row_dot_avx2(k + (UINTN)j * (UINTN)ld, NV * 8, q) * scale : DJIBLAS_EXP_PAD;
+            }
+            s = _mm256_loadu_ps(p);
+        }
+
+        float tm = djiblas_hmax256_ps(s);
+        if (tm > m) {
+            __m256 corr = djiblas_exp256_ps(_mm256_set1_ps(m - tm));
+            for (int c = 0; c < NV; c++) acc[c] = _mm256_mul_ps(acc[c], corr);
+            l *= _mm256_cvtss_f32(corr);
+            m = tm;
+        }
+        __m256 e = djiblas_exp256_ps(_mm256_sub_ps(s, _mm256_set1_ps(m)));
+        l += djiblas_hsum256_ps(e);
+        _mm256_storeu_ps(p, e);
+
+        for (int j = 0; j < nt; j++) {
+            const __m256 pj = _mm256_broadcast_ss(p + j);
+            const float *vj = v + (UINTN)j * (UINTN)ld;
+            for (int c = 0; c < NV; c++) acc[c] = _mm256_fmadd_ps(pj, _mm256_loadu_ps(vj + 8 * c), acc[c]);
+        }
+    }
+    const __m256 inv = _mm256_set1_ps((l > 0.0f) ? 1.0f / l : 0.0f);
+    for (int c = 0; c < NV; c++) _mm256_storeu_ps(out + 8 * c, _mm256_mul_ps(acc[c], inv));
+}
+
+void djiblas_attn_avx2(const float *q, const float *K, const float *V, int ld, int n,
+                       int head_size, float scale, float *out) {
+#define DJIBLAS_ATTN_NV(nv) case nv: attn_avx2_nv(q, K, V, ld, n, scale, out, nv); return
+    if ((head_size & 7) == 0) {
+        switch (head_size >> 3) {
+        DJIBLAS_ATTN_NV(1);  DJIBLAS_ATTN_NV(2);  DJIBLAS_ATTN_NV(3);  DJIBLAS_ATTN_NV(4);
+        DJIBLAS_ATTN_NV(5);  DJIBLAS_ATTN_NV(6);  DJIBLAS_ATTN_NV(7);  DJIBLAS_ATTN_NV(8);
+        DJIBLAS_ATTN_NV(9);  DJIBLAS_ATTN_NV(10); DJIBLAS_ATTN_NV(11); DJIBLAS_ATTN_NV(12);
+        DJIBLAS_ATTN_NV(13); DJIBLAS_ATTN_NV(14); DJIBLAS_ATTN_NV(15); DJIBLAS_ATTN_NV(16);
+        default: break;
+        }
+    }
+#undef DJIBLAS_ATTN_NV
+    djiblas_attn_sse2(q, K, V, ld, n, head_size, scale, out);
+}
+
+// 8 int8 KV values widened to fp32.
+static inline __m256 kv_q8_load8(const INT8 *p) {
+    return _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)p)));
+}
+
+// attn_avx2_nv over an int8 cache: rows are widened in registers, dotted
+// with q unscaled, and the row scale is applied once per score (K) or folded
+// into the softmax weight (V).
+static inline __attribute__((always_inline)) void attn_q8_avx2_nv(const float *q, const INT8 *K, const float *Ks,
+                                                                  const INT8 *V, const float *Vs, int ld, int sld,
+                                                                  int n, float scale, float *out, const int NV) {
+    __m256 acc[16];
+    for (int c = 0; c < NV; c++) acc[c] = _mm256_setzero_ps();
+    float p[DJIBLAS_ATTN_TILE];
+    float rs[DJIBLAS_ATTN_TILE];
+    float m = DJIBLAS_EXP_PAD;
+    float l = 0.0f;
+    for (int t0 = 0; t0 < n; t0 += DJIBLAS_ATTN_TILE) {
+        int nt = (n - t0 < DJIBLAS_ATTN_TILE) ? n - t0 : DJIBLAS_ATTN_TILE;
+        const INT8 *k = K + (UINTN)t0 * (UINTN)ld;
+        const INT8 *v = V + (UINTN)t0 * (UINTN)ld;
+        for (int j = 0; j < DJIBLAS_ATTN_TILE; j++) {
+            rs[j] = (j < nt) ? Ks[(UINTN)(t0 + j) * (UINTN)sld] * scale : 0.0f;
+        }
+        __m256 s;
+        if (nt == DJIBLAS_ATTN_TILE) {
+            __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+            __m256 c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps();
+            __m256 c4 = _mm256_setzero_ps(), c5 = _mm256_setzero_ps();
+            __m256 c6 = _mm256_setzero_ps(), c7 = _mm256_setzero_ps();
+            for (int c = 0; c < NV; c++) {
+                const __m256 qv = _mm256_loadu_ps(q + 8 * c);
+                const INT8 *kc = k + 8 * c;
+                c0 = _mm256_fmadd_ps(kv_q8_load8(kc + (UINTN)ld * 0), qv, c0);
+                c1 = _mm256_fmadd_ps(kv_q8_load8(kc + (UINTN)ld * 1), qv, c1);
+                c2 = _mm256_fmadd_ps(kv_q8_load8(kc + (UINTN)ld * 2), qv, c2);
+                c3 = _mm256_fmadd_ps(kv_q8_load8(kc + (UINTN)ld * 3), qv, c3);
+                c4 = _mm256_fmadd_ps(kv_q8_load8(kc + (UINTN)ld * 4), qv, c4);
+                c5 = _mm256_fmadd_ps(kv_q8_load8(kc + (UINTN)ld * 5), qv, c5);
+                c6 = _mm256_fmadd_ps(kv_q8_load8(kc + (UINTN)ld * 6), qv, c6);
+                c7 = _mm256_fmadd_ps(kv_q8_load8(kc + (UINTN)ld * 7), qv, c7);
+            }
+            s = _mm256_mul_ps(djiblas_hsum8x8_ps(c0, c1, c2, c3, c4, c5, c6, c7), _mm256_loadu_ps(rs));
+        } else {
+            for (int j = 0; j < DJIBLAS_ATTN_TILE; j++) {
+                p[j] = DJIBLAS_EXP_PAD;
+                if (j < nt) {
+                    __m256 c0 = _mm256_setzero_ps();
+                    for (int c = 0; c < NV; c++) {
+                        c0 = _mm256_fmadd_ps(kv_q8_load8(k + (UINTN)j * (UINTN)ld + 8 * c),
+                                             _mm256_loadu_ps(q + 8 * c), c0);
+                    }
+                    p[j] = djiblas_hsum256_ps(c0) * rs[j];
+                }
+            }
+            s = _mm256_loadu_ps(p);
+        }
+
+        float tm = djiblas_hmax256_ps(s);
+        if (tm > m) {
+            __m256 corr = djiblas_exp256_ps(_mm256_set1_ps(m - tm));
+            for (int c = 0; c < NV; c++) acc[c] = _mm256_mul_ps(acc[c], corr);
+            l *= _mm256_cvtss_f32(corr);
+            m = tm;
+        }
+        __m256 e = djiblas_exp256_ps(_mm256_sub_ps(s, _mm256_set1_ps(m)));
+        l += djiblas_hsum256_ps(e);
+        _mm256_storeu_ps(p, e);
+
+        for (int j = 0; j < nt; j++) {
+            const __m256 pj = _mm256_set1_ps(p[j] * Vs[(UINTN)(t0 + j) * (UINTN)sld]);
+            const INT8 *vj = v + (UINTN)j * (UINTN)ld;
+            for (int c = 0; c < NV; c++) acc[c] = _mm256_fmadd_ps(pj, kv_q8_load8(vj + 8 * c), acc[c]);
+        }
+    }
+    const __m256 inv = _mm256_set1_ps((l > 0.0f) ? 1.0f / l : 0.0f);
+    for (int c = 0; c < NV; c++) _mm256_storeu_ps(out + 8 * c, _mm256_mul_ps(acc[c], inv));
+}
+
+void djiblas_attn_q8_avx2(const float *q, const INT8 *K, const float *Ks, const INT8 *V, const float *Vs,
+                          int ld, int sld, int n, int head_size, float scale, float *out) {
+#define DJIBLAS_ATTN_NV(nv) case nv: attn_q8_avx2_nv(q, K, Ks, V, Vs, ld, sld, n, scale, out, nv); return
+    if ((head_size & 7) == 0) {
+        switch (head_size >> 3) {
+        DJIBLAS_ATTN_NV(1);  DJIBLAS_ATTN_NV(2);  DJIBLAS_ATTN_NV(3);  DJIBLAS_ATTN_NV(4);
+        DJIBLAS_ATTN_NV(5);  DJIBLAS_ATTN_NV(6);  DJIBLAS_ATTN_NV(7);  DJIBLAS_ATTN_NV(8);
+        DJIBLAS_ATTN_NV(9);  DJIBLAS_ATTN_NV(10); DJIBLAS_ATTN_NV(11); DJIBLAS_ATTN_NV(12);
+        DJIBLAS_ATTN_NV(13); DJIBLAS_ATTN_NV(14); DJIBLAS_ATTN_NV(15); DJIBLAS_ATTN_NV(16);
+        default: break;
+        }
+    }
+#undef DJIBLAS_ATTN_NV
+    djiblas_attn_q8_sse2(q, K, Ks, V, Vs, ld, sld, n, head_size, scale, out);
+}
+
+// Grouped-query attention: fp32 tiles are scored in place, int8 tiles are
+// widened (row scale applied) into kt / vt once and shared by all heads.
+static void attn_gqa_avx2(const float *q, int g, const void *K, const float *Ks, const void *V,
+                          const float *Vs, int type, int ld, int sld, int n, int head_size,
+                          float scale, float *out) {
+    float kt[DJIBLAS_ATTN_TILE * DJIBLAS_ATTN_MAX_HEAD];
+    float vt[DJIBLAS_ATTN_TILE * DJIBLAS_ATTN_MAX_HEAD];
+    float m[DJIBLAS_ATTN_MAX_GROUP];
+    float l[DJIBLAS_ATTN_MAX_GROUP];
+    for (int gc; g > 0; g -= gc, q += gc * head_size, out += gc * head_size) {
+        gc = (g < DJIBLAS_ATTN_MAX_GROUP) ? g : DJIBLAS_ATTN_MAX_GROUP;
+        for (int i = 0; i < gc * head_size; i++) out[i] = 0.0f;
+        for (int i = 0; i < gc; i++) {
+            m[i] = DJIBLAS_EXP_PAD;
+            l[i] = 0.0f;
+        }
+        for (int t0 = 0; t0 < n; t0 += DJIBLAS_ATTN_TILE) {
+            int nt = (n - t0 < DJIBLAS_ATTN_TILE) ? n - t0 : DJIBLAS_ATTN_TILE;
+            UINTN off = (UINTN)t0 * (UINTN)ld;
+            if (type == DJIBLAS_KV_F32) {
+                djiblas_attn_group_tile256(q, gc, (const float *)K + off, ld, (const float *)V + off, ld,
+                                           nt, head_size, scale, m, l, out);
+                continue;
+            }
+            for (int j = 0; j < nt; j++) {
+                const INT8 *kj = (const INT8 *)K + off + (UINTN)j * (UINTN)ld;
+                const INT8 *vj = (const INT8 *)V + off + (UINTN)j * (UINTN)ld;
+                const __m256 ks = _mm256_set1_ps(Ks[(UINTN)(t0 + j) * (UINTN)sld]);
+                const __m256 vs = _mm256_set1_ps(Vs[(UINTN)(t0 + j) * (UINTN)sld]);
+                for (int d = 0; d < head_size; d += 8) {
+                    _mm256_storeu_ps(kt + j * head_size + d, _mm256_mul_ps(kv_q8_load8(kj + d), ks));
+                    _mm256_storeu_ps(vt + j * head_size + d, _mm256_mul_ps(kv_q8_load8(vj + d), vs));
+                }
+            }
+            djiblas_attn_group_tile256(q, gc, kt, head_size, vt, head_size, nt, head_size, scale, m, l, out);
+        }
+        for (int i = 0; i < gc; i++) {
+            const __m256 inv = _mm256_set1_ps((l[i] > 0.0f) ? 1.0f / l[i] : 0.0f);
+            float *oi = out + i * head_size;
+            for (int d = 0; d < head_size; d += 8) _mm256_storeu_ps(oi + d, _mm256_mul_ps(_mm256_loadu_ps(oi + d), inv));
+        }
+    }
+}
+
+void djiblas_attn_gqa_avx2(const float *q, int g, const float *K, const float *V, int ld, int n,
+                           int head_size, float scale, float *out) {
+    if ((head_size & 7) || head_size > DJIBLAS_ATTN_MAX_HEAD) {
+        djiblas_attn_gqa_sse2(q, g, K, V, ld, n, head_size, scale, out);
+        return;
+    }
+    attn_gqa_avx2(q, g, K, 0, V, 0, DJIBLAS_KV_F32, ld, 0, n, head_size, scale, out);
+}
+
+void djiblas_attn_gqa_q8_avx2(const float *q, int g, const INT8 *K, const float *Ks, const INT8 *V,
+                              const float *Vs, int ld, int sld, int n, int head_size, float scale, float *out) {
+    if ((head_size & 7) || head_size > DJIBLAS_ATTN_MAX_HEAD) {
+        djiblas_attn_gqa_q8_sse2(q, g, K, Ks, V, Vs, ld, sld, n, head_size, scale, out);
+        return;
+    }
+    attn_gqa_avx2(q, g, K, Ks, V, Vs, DJIBLAS_KV_Q8, ld, sld, n, head_size, scale, out);
+}
+
 #else
 void djiblas_sgemm_avx2(int m, int n, int k,
                         const float *A, int lda,
@@ -113,4 +1223,156 @@ void djiblas_sgemm_avx2(int m, int n, int k,
     // Non-x86 build: fall back to scalar path via SSE2/Scalar in other translation units.
     djiblas_sgemm_sse2(m, n, k, A, lda, B, ldb, C, ldc);
 }
+
+void djiblas_sgemv_avx2(int d, int n,
+                        const float *W, int ldw,
+                        const float *x,
+                        float *y) {
+    djiblas_sgemv_sse2(d, n, W, ldw, x, y);
+}
+
+void djiblas_sgemv4_avx2(int d, int n,
+                         const float *W, int ldw,
+                         const float *x,
+                         float *y) {
+    djiblas_sgemv_sse2(d, n, W, ldw, x, y);
+}
+
+void djiblas_sgemm_avx2_2x4(int m, int n, int k,
+                            const float *A, int lda,
+                            const float *B, int ldb,
+                            float *C, int ldc) {
+    djiblas_sgemm_sse2(m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+void djiblas_sgemv_stream_avx2(int d, int n,
+                               const float *W, int ldw,
+                               const float *x,
+                               float *y) {
+    djiblas_sgemv_sse2(d, n, W, ldw, x, y);
+}
+
+void djiblas_ffn_gate_up_stream_avx2(int d, int n,
+                                     const float *W1, const float *W3, int ldw,
+                                     const float *x, float *hb) {
+    djiblas_ffn_gate_up_avx2(d, n, W1, W3, ldw, x, hb);
+}
+
+void djiblas_sgemv_panel8_stream_avx2(int d, int n, const float *P, const float *x, float *y) {
+    djiblas_sgemv_panel8_avx2(d, n, P, x, y);
+}
+
+void djiblas_ffn_gate_up_panel8_stream_avx2(int d, int n, const float *P1, const float *P3,
+                                            const float *x, float *hb) {
+    djiblas_ffn_gate_up_panel8_avx2(d, n, P1, P3, x, hb);
+}
+
+void djiblas_dequant_avx2(const INT8 *q, float scale, float *out, UINT32 n) {
+    djiblas_dequant_sse2(q, scale, out, n);
+}
+
+void djiblas_sgemv_panel8_avx2(int d, int n, const float *P, const float *x, float *y) {
+    // Never selected on non-x86 (no panel kernel in the dispatch table).
+    (void)d; (void)n; (void)P; (void)x; (void)y;
+}
+
+void djiblas_ffn_gate_up_avx2(int d, int n,
+                              const float *W1, const float *W3, int ldw,
+                              const float *x, float *hb) {
+    djiblas_ffn_gate_up_blocked(d, n, W1, W3, ldw, x, hb);
+}
+
+void djiblas_ffn_gate_up_panel8_avx2(int d, int n, const float *P1, const float *P3,
+                                     const float *x, float *hb) {
+    (void)d; (void)n; (void)P1; (void)P3; (void)x; (void)hb;
+}
+
+void djiblas_quantize_q8_avx2(const float *x, int n, INT8 *xq, float *xd) {
+    djiblas_quantize_q8_sse2(x, n, xq, xd);
+}
+
+void djiblas_gemv_q8_avx2(int d, int n, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    djiblas_gemv_q8_sse2(d, n, W, Wd, xq, xd, y);
+}
+
+void djiblas_gemm_q8_avx2(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    djiblas_gemm_q8_sse2(d, n, ncol, W, Wd, xq, xd, Y, ldy);
+}
+
+void djiblas_gemv_q6_avx2(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                          const float *x, float *y) {
+    djiblas_gemv_q6_sse2(d, n, W, S, e0, x, y);
+}
+
+void djiblas_gemv_q4_avx2(int d, int n, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    djiblas_gemv_q4_sse2(d, n, W, Wd, xq, xd, y);
+}
+
+void djiblas_gemm_q4_avx2(int d, int n, int ncol, const UINT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    djiblas_gemm_q4_sse2(d, n, ncol, W, Wd, xq, xd, Y, ldy);
+}
+
+void djiblas_gemv_bf16_avx2(int d, int n, const UINT16 *W, const float *x, float *y) {
+    djiblas_gemv_bf16_sse2(d, n, W, x, y);
+}
+
+void djiblas_gemv_q6p_avx2(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                           const float *x, float *y) {
+    djiblas_gemv_q6p_sse2(d, n, W, S, e0, x, y);
+}
+
+void djiblas_gemv_q6_q8_avx2(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                             const INT8 *xq, const float *xd, float *y) {
+    djiblas_gemv_q6_q8_scalar(d, n, W, S, e0, xq, xd, y);
+}
+
+void djiblas_gemv_q6p_q8_avx2(int d, int n, const UINT8 *W, const float *S, UINT64 e0,
+                              const INT8 *xq, const float *xd, float *y) {
+    djiblas_gemv_q6p_q8_scalar(d, n, W, S, e0, xq, xd, y);
+}
+
+void djiblas_residual_rmsnorm_avx2(float *x, const float *delta, const float *weight, float *out, int n) {
+    djiblas_residual_rmsnorm_sse2(x, delta, weight, out, n);
+}
+
+void djiblas_rope_avx2(float *q, int q_dim, float *k, int k_dim, int head_size,
+                       const float *C, const float *S) {
+    djiblas_rope_sse2(q, q_dim, k, k_dim, head_size, C, S);
+}
+
+float djiblas_exp_sum_avx2(float *x, int n) {
+    return djiblas_exp_sum_sse2(x, n);
+}
+
+void djiblas_softmax_avx2(float *x, int n) {
+    djiblas_softmax_sse2(x, n);
+}
+
+void djiblas_silu_avx2(float *hb, const float *hb2, int n) {
+    djiblas_silu_sse2(hb, hb2, n);
+}
+
+void djiblas_attn_avx2(const float *q, const float *K, const float *V, int ld, int n,
+                       int head_size, float scale, float *out) {
+    djiblas_attn_sse2(q, K, V, ld, n, head_size, scale, out);
+}
+
+void djiblas_attn_q8_avx2(const float *q, const INT8 *K, const float *Ks, const INT8 *V, const float *Vs,
+                          int ld, int sld, int n, int head_size, float scale, float *out) {
+    djiblas_attn_q8_sse2(q, K, Ks, V, Vs, ld, sld, n, head_size, scale, out);
+}
+
+void djiblas_attn_gqa_avx2(const float *q, int g, const float *K, const float *V, int ld, int n,
+                           int head_size, float scale, float *out) {
+    djiblas_attn_gqa_sse2(q, g, K, V, ld, n, head_size, scale, out);
+}
+
+void djiblas_attn_gqa_q8_avx2(const float *q, int g, const INT8 *K, const float *Ks, const INT8 *V,
+                              const float *Vs, int ld, int sld, int n, int head_size, float scale, float *out) {
+    djiblas_attn_gqa_q8_sse2(q, g, K, Ks, V, Vs, ld, sld, n, head_size, scale, out);
+}
 #endif
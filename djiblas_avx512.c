@@ -0,0 +1,617 @@
+/*
+ * DjibLAS - AVX-512F kernels (built with -mavx512f -mfma)
+ *
+ * Kept in its own translation unit (like djiblas_avx2.c) so the rest of the
+ * binary never contains EVEX-encoded instructions. Only reached through the
+ * kernel selection in djiblas.c when the CPU reports AVX-512F.
+ */
+
+#include "djiblas.h"
+#include "djiblas_vmath.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+// Fold a ZMM accumulator down to YMM (AVX-512F only, no DQ needed).
+static inline __m256 fold512_ps(__m512 v) {
+    __m256 lo = _mm512_castps512_ps256(v);
+    __m256 hi = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1));
+    return _mm256_add_ps(lo, hi);
+}
+
+static inline float hsum512_ps(__m512 v) {
+    return djiblas_hsum256_ps(fold512_ps(v));
+}
+
+// Lane r of the result is the horizontal sum of c[r].
+static inline __m256 hsum8x8_avx512(__m512 c0, __m512 c1, __m512 c2, __m512 c3,
+                                    __m512 c4, __m512 c5, __m512 c6, __m512 c7) {
+    return djiblas_hsum8x8_ps(fold512_ps(c0), fold512_ps(c1), fold512_ps(c2), fold512_ps(c3),
+                              fold512_ps(c4), fold512_ps(c5), fold512_ps(c6), fold512_ps(c7));
+}
+
+// Lane r of the result is the horizontal sum of c[r].
+static inline __m128 hsum4x4_avx512(__m512 c0, __m512 c1, __m512 c2, __m512 c3) {
+    __m256 t0 = _mm256_hadd_ps(fold512_ps(c0), fold512_ps(c1));
+    __m256 t1 = _mm256_hadd_ps(fold512_ps(c2), fold512_ps(c3));
+    t0 = _mm256_hadd_ps(t0, t1);
+    return _mm_add_ps(_mm256_castps256_ps128(t0), _mm256_extractf128_ps(t0, 1));
+}
+
+// Mask selecting the first `rem` (1..15) lanes of a k-tail.
+static inline __mmask16 tail_mask16(int rem) {
+    return (__mmask16)((1u << rem) - 1u);
+}
+
+// Dot products of 8 consecutive rows (stride ldw) with x: lane r = row r.
+// The k-tail is one masked step; km == 0 when n % 16 == 0.
+static inline __m256 rows8_dot_avx512(const float *W, int ldw, int n16, __mmask16 km,
+                                      const float *x) {
+    const float *w0 = W + (UINTN)ldw * 0;
+    const float *w1 = W + (UINTN)ldw * 1;
+    const float *w2 = W + (UINTN)ldw * 2;
+    const float *w3 = W + (UINTN)ldw * 3;
+    const float *w4 = W + (UINTN)ldw * 4;
+    const float *w5 = W + (UINTN)ldw * 5;
+    const float *w6 = W + (UINTN)ldw * 6;
+    const float *w7 = W + (UINTN)ldw * 7;
+    __m512 c0 = _mm512_setzero_ps();
+    __m512 c1 = _mm512_setzero_ps();
+    __m512 c2 = _mm512_setzero_ps();
+    __m512 c3 = _mm512_setzero_ps();
+    __m512 c4 = _mm512_setzero_ps();
+    __m512 c5 = _mm512_setzero_ps();
+    __m512 c6 = _mm512_setzero_ps();
+    __m512 c7 = _mm512_setzero_ps();
+
+    int l = 0;
+    for (; l < n16; l += 16) {
+        __m512 xv = _mm512_loadu_ps(x + l);
+        c0 = _mm512_fmadd_ps(_mm512_loadu_ps(w0 + l), xv, c0);
+        c1 = _mm512_fmadd_ps(_mm512_loadu_ps(w1 + l), xv, c1);
+        c2 = _mm512_fmadd_ps(_mm512_loadu_ps(w2 + l), xv, c2);
+        c3 = _mm512_fmadd_ps(_mm512_loadu_ps(w3 + l), xv, c3);
+        c4 = _mm512_fmadd_ps(_mm512_loadu_ps(w4 + l), xv, c4);
+        c5 = _mm512_fmadd_ps(_mm512_loadu_ps(w5 + l), xv, c5);
+        c6 = _mm512_fmadd_ps(_mm512_loadu_ps(w6 + l), xv, c6);
+        c7 = _mm512_fmadd_ps(_mm512_loadu_ps(w7 + l), xv, c7);
+    }
+    if (km) {
+        // Masked loads never touch memory past the row end.
+        __m512 xv = _mm512_maskz_loadu_ps(km, x + l);
+        c0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(km, w0 + l), xv, c0);
+        c1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(km, w1 + l), xv, c1);
+        c2 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(km, w2 + l), xv, c2);
+        c3 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(km, w3 + l), xv, c3);
+        c4 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(km, w4 + l), xv, c4);
+        c5 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(km, w5 + l), xv, c5);
+        c6 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(km, w6 + l), xv, c6);
+        c7 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(km, w7 + l), xv, c7);
+    }
+    return hsum8x8_avx512(c0, c1, c2, c3, c4, c5, c6, c7);
+}
+
+static inline float row_dot_avx512(const float *w0, int n16, __mmask16 km, const float *x) {
+    __m512 c0 = _mm512_setzero_ps();
+    int l = 0;
+    for (; l < n16; l += 16) {
+        c0 = _mm512_fmadd_ps(_mm512_loadu_ps(w0 + l), _mm512_loadu_ps(x + l), c0);
+    }
+    if (km) {
+        c0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(km, w0 + l), _mm512_maskz_loadu_ps(km, x + l), c0);
+    }
+    return hsum512_ps(c0);
+}
+
+void djiblas_sgemv_avx512(int d, int n,
+                          const float *W, int ldw,
+                          const float *x,
+                          float *y) {
+    // Same shape as the AVX2 kernel (8 rows per pass, deferred reduction),
+    // but each step consumes 16 floats per row and the k-tail is a single
+    // masked step instead of a scalar loop.
+    const int n16 = n & ~15;
+    const __mmask16 km = tail_mask16(n - n16);
+    int i = 0;
+    for (; i + 8 <= d; i += 8) {
+        _mm256_storeu_ps(y + i, rows8_dot_avx512(W + (UINTN)ldw * i, ldw, n16, km, x));
+    }
+
+    // Leftover rows (d % 8): one row at a time.
+    for (; i < d; i++) {
+        y[i] = row_dot_avx512(W + (UINTN)ldw * i, n16, km, x);
+    }
+}
+
+void djiblas_ffn_gate_up_avx512(int d, int n,
+                                const float *W1, const float *W3, int ldw,
+                                const float *x, float *hb) {
+    // Gate and up for the same 8 rows, SwiGLU on the result registers.
+    const int n16 = n & ~15;
+    const __mmask16 km = tail_mask16(n - n16);
+    int i = 0;
+    for (; i + 8 <= d; i += 8) {
+        __m256 g = rows8_dot_avx512(W1 + (UINTN)ldw * i, ldw, n16, km, x);
+        __m256 u = rows8_dot_avx512(W3 + (UINTN)ldw * i, ldw, n16, km, x);
+        _mm256_storeu_ps(hb + i, djiblas_silu_mul256_ps(g, u));
+    }
+    if (i < d) {
+        float g[8] = {0};
+        float u[8] = {0};
+        float h[8];
+        int rem = d - i;
+        for (int r = 0; r < rem; r++) {
+            g[r] = row_dot_avx512(W1 + (UINTN)ldw * (i + r), n16, km, x);
+            u[r] = row_dot_avx512(W3 + (UINTN)ldw * (i + r), n16, km, x);
+        }
+        _mm256_storeu_ps(h, djiblas_silu_mul256_ps(_mm256_loadu_ps(g), _mm256_loadu_ps(u)));
+        for (int r = 0; r < rem; r++) hb[i + r] = h[r];
+    }
+}
+
+void djiblas_sgemm_avx512(int m, int n, int k,
+                          const float *A, int lda,
+                          const float *B, int ldb,
+                          float *C, int ldc) {
+    // 4x4 dot-product tile: 4 rows of A against 4 rows of B, 16 ZMM
+    // accumulators, 16 floats of k per step with a masked k-tail.
+    // Rows of C for one B column are contiguous (C[ldc*j + i]), so the four
+    // row sums for column j reduce into one XMM and store together.
+    // Edge tiles clamp their row pointers to the last valid row and skip the
+    // corresponding stores, so no load ever leaves A or B.
+    const int k16 = k & ~15;
+    const __mmask16 km = tail_mask16(k - k16);
+
+    for (int i = 0; i < m; i += 4) {
+        const int mi = (m - i < 4) ? (m - i) : 4;
+        const float *a0 = A + (UINTN)lda * (i + 0);
+        const float *a1 = A + (UINTN)lda * (i + (mi > 1 ? 1 : 0));
+        const float *a2 = A + (UINTN)lda * (i + (mi > 2 ? 2 : 0));
+        const float *a3 = A + (UINTN)lda * (i + (mi > 3 ? 3 : 0));
+
+        for (int j = 0; j < n; j += 4) {
+            const int nj = (n - j < 4) ? (n - j) : 4;
+            const float *b0 = B + (UINTN)ldb * (j + 0);
+            const float *b1 = B + (UINTN)ldb * (j + (nj > 1 ? 1 : 0));
+            const float *b2 = B + (UINTN)ldb * (j + (nj > 2 ? 2 : 0));
+            const float *b3 = B + (UINTN)ldb * (j + (nj > 3 ? 3 : 0));
+
+            __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+            __m512 c02 = _mm512_setzero_ps(), c03 = _mm512_setzero_ps();
+            __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+            __m512 c12 = _mm512_setzero_ps(), c13 = _mm512_setzero_ps();
+            __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+            __m512 c22 = _mm512_setzero_ps(), c23 = _mm512_setzero_ps();
+            __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+            __m512 c32 = _mm512_setzero_ps(), c33 = _mm512_setzero_ps();
+
+#define DJIBLAS_AVX512_TILE_STEP(LOAD_A, LOAD_B)                          \
+            do {                                                          \
+                __m512 bv0 = LOAD_B(b0), bv1 = LOAD_B(b1);                \
+                __m512 bv2 = LOAD_B(b2), bv3 = LOAD_B(b3);                \
+                __m512 av = LOAD_A(a0);                                   \
+                c00 = _mm512_fmadd_ps(av, bv0, c00);                      \
+                c01 = _mm512_fmadd_ps(av, bv1, c01);                      \
+                c02 = _mm512_fmadd_ps(av, bv2, c02);                      \
+                c03 = _mm512_fmadd_ps(av, bv3, c03);                      \
+                av = LOAD_A(a1);                                          \
+                c10 = _mm512_fmadd_ps(av, bv0, c10);                      \
+                c11 = _mm512_fmadd_ps(av, bv1, c11);                      \
+                c12 = _mm512_fmadd_ps(av, bv2, c12);                      \
+                c13 = _mm512_fmadd_ps(av, bv3, c13);                      \
+                av = LOAD_A(a2);                                          \
+                c20 = _mm512_fmadd_ps(av, bv0, c20);                      \
+                c21 = _mm512_fmadd_ps(av, bv1, c21);                      \
+                c22 = _mm512_fmadd_ps(av, bv2, c22);                      \
+                c23 = _mm512_fmadd_ps(av, bv3, c23);                      \
+                av = LOAD_A(a3);                                          \
+                c30 = _mm512_fmadd_ps(av, bv0, c30);                      \
+                c31 = _mm512_fmadd_ps(av, bv1, c31);                      \
+                c32 = _mm512_fmadd_ps(av, bv2, c32);                      \
+                c33 = _mm512_fmadd_ps(av, bv3, c33);                      \
+            } while (0)
+#define DJIBLAS_LOADU(p) _mm512_loadu_ps((p) + l)
+#define DJIBLAS_LOADM(p) _mm512_maskz_loadu_ps(km, (p) + l)
+
+            int l = 0;
+            for (; l < k16; l += 16) {
+                DJIBLAS_AVX512_TILE_STEP(DJIBLAS_LOADU, DJIBLAS_LOADU);
+            }
+            if (km) {
+                DJIBLAS_AVX512_TILE_STEP(DJIBLAS_LOADM, DJIBLAS_LOADM);
+            }
+
+#undef DJIBLAS_LOADM
+#undef DJIBLAS_LOADU
+#undef DJIBLAS_AVX512_TILE_STEP
+
+            // Column jj of the tile: lanes are rows i..i+3.
+            __m128 s0 = hsum4x4_avx512(c00, c10, c20, c30);
+            __m128 s1 = hsum4x4_avx512(c01, c11, c21, c31);
+            __m128 s2 = hsum4x4_avx512(c02, c12, c22, c32);
+            __m128 s3 = hsum4x4_avx512(c03, c13, c23, c33);
+
+            if (mi == 4) {
+                _mm_storeu_ps(C + (UINTN)ldc * (j + 0) + i, s0);
+                if (nj > 1) _mm_storeu_ps(C + (UINTN)ldc * (j + 1) + i, s1);
+                if (nj > 2) _mm_storeu_ps(C + (UINTN)ldc * (j + 2) + i, s2);
+                if (nj > 3) _mm_storeu_ps(C + (UINTN)ldc * (j + 3) + i, s3);
+            } else {
+                float t[4][4];
+                _mm_storeu_ps(t[0], s0);
+                _mm_storeu_ps(t[1], s1);
+                _mm_storeu_ps(t[2], s2);
+                _mm_storeu_ps(t[3], s3);
+                for (int jj = 0; jj < nj; jj++) {
+                    for (int ii = 0; ii < mi; ii++) {
+                        C[(UINTN)ldc * (j + jj) + i + ii] = t[jj][ii];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// One 16-row panel x 16 floats per k-step: sixteen consecutive ZMM loads
+// (1 KB) per step, one forward stream per panel, 16 accumulators.
+// Rows 0-7 land in *lo, rows 8-15 in *hi.
+static inline void panel16_dot_avx512(const float *p, int n, const float *x,
+                                      __m256 *lo, __m256 *hi) {
+    __m512 c0 = _mm512_setzero_ps(), c1 = _mm512_setzero_ps();
+    __m512 c2 = _mm512_setzero_ps(), c3 = _mm512_setzero_ps();
+    __m512 c4 = _mm512_setzero_ps(), c5 = _mm512_setzero_ps();
+    __m512 c6 = _mm512_setzero_ps(), c7 = _mm512_setzero_ps();
+    __m512 c8 = _mm512_setzero_ps(), c9 = _mm512_setzero_ps();
+    __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+    __m512 c12 = _mm512_setzero_ps(), c13 = _mm512_setzero_ps();
+    __m512 c14 = _mm512_setzero_ps(), c15 = _mm512_setzero_ps();
+    for (int l = 0; l < n; l += 16) {
+        __m512 xv = _mm512_loadu_ps(x + l);
+        c0 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 0), xv, c0);
+        c1 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 16), xv, c1);
+        c2 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 32), xv, c2);
+        c3 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 48), xv, c3);
+        c4 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 64), xv, c4);
+        c5 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 80), xv, c5);
+        c6 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 96), xv, c6);
+        c7 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 112), xv, c7);
+        c8 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 128), xv, c8);
+        c9 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 144), xv, c9);
+        c10 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 160), xv, c10);
+        c11 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 176), xv, c11);
+        c12 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 192), xv, c12);
+        c13 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 208), xv, c13);
+        c14 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 224), xv, c14);
+        c15 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 240), xv, c15);
+        p += 256;
+    }
+    *lo = hsum8x8_avx512(c0, c1, c2, c3, c4, c5, c6, c7);
+    *hi = hsum8x8_avx512(c8, c9, c10, c11, c12, c13, c14, c15);
+}
+
+void djiblas_sgemv_panel16_avx512(int d, int n, const float *P, const float *x, float *y) {
+    for (int i = 0; i < d; i += 16) {
+        __m256 lo, hi;
+        panel16_dot_avx512(P + (UINTN)i * (UINTN)n, n, x, &lo, &hi);
+        _mm256_storeu_ps(y + i, lo);
+        _mm256_storeu_ps(y + i + 8, hi);
+    }
+}
+
+void djiblas_ffn_gate_up_panel16_avx512(int d, int n, const float *P1, const float *P3,
+                                        const float *x, float *hb) {
+    for (int i = 0; i < d; i += 16) {
+        __m256 g0, g1, u0, u1;
+        panel16_dot_avx512(P1 + (UINTN)i * (UINTN)n, n, x, &g0, &g1);
+        panel16_dot_avx512(P3 + (UINTN)i * (UINTN)n, n, x, &u0, &u1);
+        _mm256_storeu_ps(hb + i, djiblas_silu_mul256_ps(g0, u0));
+        _mm256_storeu_ps(hb + i + 8, djiblas_silu_mul256_ps(g1, u1));
+    }
+}
+
+// Streaming panel16 (matrices larger than the LLC): each of the 1 KB
+// k-step's 16 lines is prefetched pf floats ahead, NTA or T0 (see djiblas.h).
+static inline __attribute__((always_inline)) void panel16_dot_stream_avx512(
+        const float *p, int n, const float *x, int pf, BOOLEAN nta, __m256 *lo, __m256 *hi) {
+    __m512 c0 = _mm512_setzero_ps(), c1 = _mm512_setzero_ps();
+    __m512 c2 = _mm512_setzero_ps(), c3 = _mm512_setzero_ps();
+    __m512 c4 = _mm512_setzero_ps(), c5 = _mm512_setzero_ps();
+    __m512 c6 = _mm512_setzero_ps(), c7 = _mm512_setzero_ps();
+    __m512 c8 = _mm512_setzero_ps(), c9 = _mm512_setzero_ps();
+    __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+    __m512 c12 = _mm512_setzero_ps(), c13 = _mm512_setzero_ps();
+    __m512 c14 = _mm512_setzero_ps(), c15 = _mm512_setzero_ps();
+#define DJIBLAS_PF16(o) do { \
+        if (nta) _mm_prefetch((const char *)(p + pf + (o)), _MM_HINT_NTA); \
+        else _mm_prefetch((const char *)(p + pf + (o)), _MM_HINT_T0); \
+    } while (0)
+    for (int l = 0; l < n; l += 16) {
+        __m512 xv = _mm512_loadu_ps(x + l);
+        DJIBLAS_PF16(0);
+        c0 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 0), xv, c0);
+        DJIBLAS_PF16(16);
+        c1 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 16), xv, c1);
+        DJIBLAS_PF16(32);
+        c2 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 32), xv, c2);
+        DJIBLAS_PF16(48);
+        c3 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 48), xv, c3);
+        DJIBLAS_PF16(64);
+        c4 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 64), xv, c4);
+        DJIBLAS_PF16(80);
+        c5 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 80), xv, c5);
+        DJIBLAS_PF16(96);
+        c6 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 96), xv, c6);
+        DJIBLAS_PF16(112);
+        c7 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 112), xv, c7);
+        DJIBLAS_PF16(128);
+        c8 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 128), xv, c8);
+        DJIBLAS_PF16(144);
+        c9 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 144), xv, c9);
+        DJIBLAS_PF16(160);
+        c10 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 160), xv, c10);
+        DJIBLAS_PF16(176);
+        c11 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 176), xv, c11);
+        DJIBLAS_PF16(192);
+        c12 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 192), xv, c12);
+        DJIBLAS_PF16(208);
+        c13 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 208), xv, c13);
+        DJIBLAS_PF16(224);
+        c14 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 224), xv, c14);
+        DJIBLAS_PF16(240);
+        c15 = _mm512_fmadd_ps(_mm512_loadu_ps(p + 240), xv, c15);
+        p += 256;
+    }
+#undef DJIBLAS_PF16
+    *lo = hsum8x8_avx512(c0, c1, c2, c3, c4, c5, c6, c7);
+    *hi = hsum8x8_avx512(c8, c9, c10, c11, c12, c13, c14, c15);
+}
+
+void djiblas_sgemv_panel16_stream_avx512(int d, int n, const float *P, const float *x, float *y) {
+    int pf = g_djiblas.stream_pf / (int)sizeof(float);
+    BOOLEAN nta = g_djiblas.stream_nta;
+    for (int i = 0; i < d; i += 16) {
+        const float *Pi = P + (UINTN)i * (UINTN)n;
+        __m256 lo, hi;
+        if (nta) panel16_dot_stream_avx512(Pi, n, x, pf, TRUE, &lo, &hi);
+        else panel16_dot_stream_avx512(Pi, n, x, pf, FALSE, &lo, &hi);
+        _mm256_storeu_ps(y + i, lo);
+        _mm256_storeu_ps(y + i + 8, hi);
+    }
+}
+
+void djiblas_ffn_gate_up_panel16_stream_avx512(int d, int n, const float *P1, const float *P3,
+                                               const float *x, float *hb) {
+    int pf = g_djiblas.stream_pf / (int)sizeof(float);
+    BOOLEAN nta = g_djiblas.stream_nta;
+    for (int i = 0; i < d; i += 16) {
+        const float *A = P1 + (UINTN)i * (UINTN)n;
+        const float *B = P3 + (UINTN)i * (UINTN)n;
+        __m256 g0, g1, u0, u1;
+        if (nta) {
+            panel16_dot_stream_avx512(A, n, x, pf, TRUE, &g0, &g1);
+            panel16_dot_stream_avx512(B, n, x, pf, TRUE, &u0, &u1);
+        } else {
+            panel16_dot_stream_avx512(A, n, x, pf, FALSE, &g0, &g1);
+            panel16_dot_stream_avx512(B, n, x, pf, FALSE, &u0, &u1);
+        }
+        _mm256_storeu_ps(hb + i, djiblas_silu_mul256_ps(g0, u0));
+        _mm256_storeu_ps(hb + i + 8, djiblas_silu_mul256_ps(g1, u1));
+    }
+}
+
+// bf16 selects the shift widening, otherwise vcvtph2ps (AVX-512F).
+static inline void gemv_half_avx512(int d, int n, const UINT16 *W, BOOLEAN bf16,
+                                    const float *x, float *y) {
+    int n16 = n & ~15;
+    __mmask16 km = tail_mask16(n - n16);
+    for (int i = 0; i < d; i++) {
+        const UINT16 *w = W + (UINTN)i * (UINTN)n;
+        __m512 s0 = _mm512_setzero_ps();
+        __m512 s1 = _mm512_setzero_ps();
+        int l = 0;
+        for (; l + 32 <= n16; l += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(w + l));
+            __m256i u = _mm256_loadu_si256((const __m256i *)(w + l + 16));
+            __m512 f0 = bf16 ? _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(v), 16)) : _mm512_cvtph_ps(v);
+            __m512 f1 = bf16 ? _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(u), 16)) : _mm512_cvtph_ps(u);
+            s0 = _mm512_fmadd_ps(f0, _mm512_loadu_ps(x + l), s0);
+            s1 = _mm512_fmadd_ps(f1, _mm512_loadu_ps(x + l + 16), s1);
+        }
+        for (; l < n16; l += 16) {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(w + l));
+            __m512 f0 = bf16 ? _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(v), 16)) : _mm512_cvtph_ps(v);
+            s0 = _mm512_fmadd_ps(f0, _mm512_loadu_ps(x + l), s0);
+        }
+        if (km) {
+            // Tail: widen into a zero-padded block (no masked 16-bit loads without AVX512BW).
+            UINT16 t[16] = { 0 };
+            for (int j = 0; j < n - n16; j++) t[j] = w[n16 + j];
+            __m256i v = _mm256_loadu_si256((const __m256i *)t);
+            __m512 f0 = bf16 ? _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(v), 16)) : _mm512_cvtph_ps(v);
+            s0 = _mm512_fmadd_ps(f0, _mm512_maskz_loadu_ps(km, x + n16), s0);
+        }
+        y[i] = hsum512_ps(_mm512_add_ps(s0, s1));
+    }
+}
+
+void djiblas_gemv_f16_avx512(int d, int n, const UINT16 *W, const float *x, float *y) {
+    gemv_half_avx512(d, n, W, FALSE, x, y);
+}
+
+void djiblas_gemv_bf16_avx512(int d, int n, const UINT16 *W, const float *x, float *y) {
+    gemv_half_avx512(d, n, W, TRUE, x, y);
+}
+
+void djiblas_gemv_q6_avx512(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                            const float *x, float *y) {
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        UINT64 e = e0 + (UINT64)i * (UINT64)n;
+        __m512 acc = _mm512_setzero_ps();
+        float tail = 0.0f;
+        int l = 0;
+        while (l < n) {
+            UINT64 g = (e + (UINT64)l) / DJIBLAS_Q6_GROUP;
+            int end = (int)((g + 1) * DJIBLAS_Q6_GROUP - e);
+            if (end > n) end = n;
+            __m512 s0 = _mm512_setzero_ps();
+            __m512 s1 = _mm512_setzero_ps();
+            for (; l + 32 <= end; l += 32) {
+                __m512 w0 = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *)(w + l))));
+                __m512 w1 = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *)(w + l + 16))));
+                s0 = _mm512_fmadd_ps(w0, _mm512_loadu_ps(x + l), s0);
+                s1 = _mm512_fmadd_ps(w1, _mm512_loadu_ps(x + l + 16), s1);
+            }
+            for (; l + 16 <= end; l += 16) {
+                __m512 w0 = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *)(w + l))));
+                s0 = _mm512_fmadd_ps(w0, _mm512_loadu_ps(x + l), s0);
+            }
+            float st = 0.0f;
+            for (; l < end; l++) st += (float)w[l] * x[l];
+            acc = _mm512_fmadd_ps(_mm512_add_ps(s0, s1), _mm512_set1_ps(S[g]), acc);
+            tail += st * S[g];
+        }
+        y[i] = hsum512_ps(acc) + tail;
+    }
+}
+
+// ===================================================================
+// exp-based vector primitives (softmax, SwiGLU)
+// ===================================================================
+
+float djiblas_exp_sum_avx512(float *x, int n) {
+    if (n <= 0) return 0.0f;
+    const int n16 = n & ~15;
+    const __mmask16 km = tail_mask16(n - n16);
+    const __m512 pad = _mm512_set1_ps(DJIBLAS_EXP_PAD);
+
+    __m512 m0 = _mm512_set1_ps(x[0]);
+    __m512 m1 = m0;
+    int i = 0;
+    for (; i + 32 <= n16; i += 32) {
+        m0 = _mm512_max_ps(m0, _mm512_loadu_ps(x + i));
+        m1 = _mm512_max_ps(m1, _mm512_loadu_ps(x + i + 16));
+    }
+    for (; i < n16; i += 16) m0 = _mm512_max_ps(m0, _mm512_loadu_ps(x + i));
+    if (km) m1 = _mm512_max_ps(m1, _mm512_mask_loadu_ps(pad, km, x + n16));
+    const __m512 vm = _mm512_set1_ps(_mm512_reduce_max_ps(_mm512_max_ps(m0, m1)));
+
+    __m512 s0 = _mm512_setzero_ps();
+    __m512 s1 = _mm512_setzero_ps();
+    i = 0;
+    for (; i + 32 <= n16; i += 32) {
+        __m512 e0 = djiblas_exp512_ps(_mm512_sub_ps(_mm512_loadu_ps(x + i), vm));
+        __m512 e1 = djiblas_exp512_ps(_mm512_sub_ps(_mm512_loadu_ps(x + i + 16), vm));
+        _mm512_storeu_ps(x + i, e0);
+        _mm512_storeu_ps(x + i + 16, e1);
+        s0 = _mm512_add_ps(s0, e0);
+        s1 = _mm512_add_ps(s1, e1);
+    }
+    for (; i < n16; i += 16) {
+        __m512 e = djiblas_exp512_ps(_mm512_sub_ps(_mm512_loadu_ps(x + i), vm));
+        _mm512_storeu_ps(x + i, e);
+        s0 = _mm512_add_ps(s0, e);
+    }
+    if (km) {
+        // Pad lanes load as -huge and come out as exactly 0.
+        __m512 e = djiblas_exp512_ps(_mm512_sub_ps(_mm512_mask_loadu_ps(pad, km, x + n16), vm));
+        _mm512_mask_storeu_ps(x + n16, km, e);
+        s1 = _mm512_add_ps(s1, e);
+    }
+    return hsum512_ps(_mm512_add_ps(s0, s1));
+}
+
+void djiblas_softmax_avx512(float *x, int n) {
+    float sum = djiblas_exp_sum_avx512(x, n);
+    if (sum <= 0.0f) return;
+    const int n16 = n & ~15;
+    const __mmask16 km = tail_mask16(n - n16);
+    const __m512 vinv = _mm512_set1_ps(1.0f / sum);
+    for (int i = 0; i < n16; i += 16) {
+        _mm512_storeu_ps(x + i, _mm512_mul_ps(_mm512_loadu_ps(x + i), vinv));
+    }
+    if (km) {
+        _mm512_mask_storeu_ps(x + n16, km, _mm512_mul_ps(_mm512_maskz_loadu_ps(km, x + n16), vinv));
+    }
+}
+
+void djiblas_silu_avx512(float *hb, const float *hb2, int n) {
+    const int n16 = n & ~15;
+    const __mmask16 km = tail_mask16(n - n16);
+    for (int i = 0; i < n16; i += 16) {
+        __m512 g = _mm512_loadu_ps(hb + i);
+        __m512 u = _mm512_loadu_ps(hb2 + i);
+        _mm512_storeu_ps(hb + i, djiblas_silu_mul512_ps(g, u));
+    }
+    if (km) {
+        __m512 g = _mm512_maskz_loadu_ps(km, hb + n16);
+        __m512 u = _mm512_maskz_loadu_ps(km, hb2 + n16);
+        _mm512_mask_storeu_ps(hb + n16, km, djiblas_silu_mul512_ps(g, u));
+    }
+}
+
+#else
+void djiblas_sgemv_avx512(int d, int n,
+                          const float *W, int ldw,
+                          const float *x,
+                          float *y) {
+    djiblas_sgemv_avx2(d, n, W, ldw, x, y);
+}
+
+void djiblas_sgemm_avx512(int m, int n, int k,
+                          const float *A, int lda,
+                          const float *B, int ldb,
+                          float *C, int ldc) {
+    djiblas_sgemm_avx2(m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+void djiblas_sgemv_panel16_avx512(int d, int n, const float *P, const float *x, float *y) {
+    // Never selected without AVX-512F (no panel16 kernel in the dispatch table).
+    (void)d; (void)n; (void)P; (void)x; (void)y;
+}
+
+void djiblas_sgemv_panel16_stream_avx512(int d, int n, const float *P, const float *x, float *y) {
+    (void)d; (void)n; (void)P; (void)x; (void)y;
+}
+
+void djiblas_ffn_gate_up_panel16_stream_avx512(int d, int n, const float *P1, const float *P3,
+                                               const float *x, float *hb) {
+    (void)d; (void)n; (void)P1; (void)P3; (void)x; (void)hb;
+}
+
+void djiblas_ffn_gate_up_avx512(int d, int n,
+                                const float *W1, const float *W3, int ldw,
+                                const float *x, float *hb) {
+    djiblas_ffn_gate_up_avx2(d, n, W1, W3, ldw, x, hb);
+}
+
+void djiblas_ffn_gate_up_panel16_avx512(int d, int n, const float *P1, const float *P3,
+                                        const float *x, float *hb) {
+    (void)d; (void)n; (void)P1; (void)P3; (void)x; (void)hb;
+}
+
+void djiblas_gemv_q6_avx512(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                            const float *x, float *y) {
+    djiblas_gemv_q6_avx2(d, n, W, S, e0, x, y);
+}
+
+void djiblas_gemv_f16_avx512(int d, int n, const UINT16 *W, const float *x, float *y) {
+    djiblas_gemv_f16_sse2(d, n, W, x, y);
+}
+
+void djiblas_gemv_bf16_avx512(int d, int n, const UINT16 *W, const float *x, float *y) {
+    djiblas_gemv_bf16_avx2(d, n, W, x, y);
+}
+
+float djiblas_exp_sum_avx512(float *x, int n) {
+    return djiblas_exp_sum_sse2(x, n);
+}
+
+void djiblas_softmax_avx512(float *x, int n) {
+    djiblas_softmax_sse2(x, n);
+}
+
+void djiblas_silu_avx512(float *hb, const float *hb2, int n) {
+    djiblas_silu_sse2(hb, hb2, n);
+}
+#endif
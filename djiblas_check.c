@@ -0,0 +1,1587 @@
+/*
+ * DjibLAS - kernel correctness check + micro-benchmark
+ *
+ * Runs the x86 GEMV / SGEMM (fp32, panel, Q8_0, Q4, Q6, fp16, bf16), fused
+ * gate/up, vector, norm, attention and RoPE kernels the CPU can execute
+ * against a scalar or double reference on the real model shapes, then times
+ * each with rdtsc. Results are one CSV row per (kernel, shape), handed to the caller
+ * line by line, so the same code backs the REPL's /bench_kernels and the
+ * hosted llmk-bench-kernels binary (hosted/bench_kernels.c).
+ *
+ * Built with the baseline flags: AVX2 / AVX-512 kernels are only reached
+ * through their function pointers, after the ISA check.
+ */
+
+#include "djiblas.h"
+
+#define DJIBLAS_CHECK_GEMV    0
+#define DJIBLAS_CHECK_GEMM    1
+#define DJIBLAS_CHECK_DOT     2
+#define DJIBLAS_CHECK_AXPY    3
+#define DJIBLAS_CHECK_DEQUANT 4
+#define DJIBLAS_CHECK_ATTN    5
+#define DJIBLAS_CHECK_ATTN_F16 6
+#define DJIBLAS_CHECK_ATTN_Q8  7
+#define DJIBLAS_CHECK_ROPE     8
+#define DJIBLAS_CHECK_GQA      9    // GQA / GQA_F16 / GQA_Q8 follow ATTN's order
+#define DJIBLAS_CHECK_GQA_F16  10
+#define DJIBLAS_CHECK_GQA_Q8   11
+#define DJIBLAS_CHECK_GEMV_Q8  12   // weight formats: see djiblas_check_wmat
+#define DJIBLAS_CHECK_GEMM_Q8  13
+#define DJIBLAS_CHECK_GEMV_Q4  14
+#define DJIBLAS_CHECK_GEMM_Q4  15
+#define DJIBLAS_CHECK_GEMV_Q6  16
+#define DJIBLAS_CHECK_GEMV_Q6P 17
+#define DJIBLAS_CHECK_GEMV_Q6_Q8  18
+#define DJIBLAS_CHECK_GEMV_Q6P_Q8 19
+#define DJIBLAS_CHECK_GEMV_F16 20
+#define DJIBLAS_CHECK_GEMV_BF16 21
+#define DJIBLAS_CHECK_PANEL8   22
+#define DJIBLAS_CHECK_PANEL16  23
+#define DJIBLAS_CHECK_GATE_UP  24
+#define DJIBLAS_CHECK_GATE_UP8 25
+#define DJIBLAS_CHECK_GATE_UP16 26
+#define DJIBLAS_CHECK_SOFTMAX  27   // vector primitives: see djiblas_check_act
+#define DJIBLAS_CHECK_EXP_SUM  28
+#define DJIBLAS_CHECK_SILU     29
+#define DJIBLAS_CHECK_RMSNORM  30
+#define DJIBLAS_CHECK_RES_RMSNORM 31
+
+typedef struct {
+    const char *name;
+    int kind;               // DJIBLAS_CHECK_*
+    const void *fn;
+    UINT32 isa;             // DJIBLAS_TUNE_ISA_* bits required; 0 = scalar reference
+} DjibCheckKernel;
+
+// The first kernel of each kind is its reference.
+static const DjibCheckKernel k_check_kernels[] = {
+    { "sgemv_scalar",              DJIBLAS_CHECK_GEMV, (const void *)djiblas_sgemv_scalar,   0 },
+    { "sgemv_sse2",                DJIBLAS_CHECK_GEMV, (const void *)djiblas_sgemv_sse2,     DJIBLAS_TUNE_ISA_SSE2 },
+    { "sgemv_avx2",                DJIBLAS_CHECK_GEMV, (const void *)djiblas_sgemv_avx2,     DJIBLAS_TUNE_ISA_AVX2 },
+    { "sgemv4_avx2",               DJIBLAS_CHECK_GEMV, (const void *)djiblas_sgemv4_avx2,    DJIBLAS_TUNE_ISA_AVX2 },
+    { "sgemv_avx512",              DJIBLAS_CHECK_GEMV, (const void *)djiblas_sgemv_avx512,   DJIBLAS_TUNE_ISA_AVX512 },
+    { "sgemv_stream_avx2",         DJIBLAS_CHECK_GEMV, (const void *)djiblas_sgemv_stream_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "sgemm_scalar",              DJIBLAS_CHECK_GEMM, (const void *)djiblas_sgemm_scalar,   0 },
+    { "sgemm_sse2",                DJIBLAS_CHECK_GEMM, (const void *)djiblas_sgemm_sse2,     DJIBLAS_TUNE_ISA_SSE2 },
+    { "sgemm_avx2",                DJIBLAS_CHECK_GEMM, (const void *)djiblas_sgemm_avx2,     DJIBLAS_TUNE_ISA_AVX2 },
+    { "sgemm_avx2_2x4",            DJIBLAS_CHECK_GEMM, (const void *)djiblas_sgemm_avx2_2x4, DJIBLAS_TUNE_ISA_AVX2 },
+    { "sgemm_avx512",              DJIBLAS_CHECK_GEMM, (const void *)djiblas_sgemm_avx512,   DJIBLAS_TUNE_ISA_AVX512 },
+    { "dot_scalar",                DJIBLAS_CHECK_DOT,  0,                                     0 },
+    { "dot_sse2",                  DJIBLAS_CHECK_DOT,  (const void *)djiblas_dot_sse2,       DJIBLAS_TUNE_ISA_SSE2 },
+    { "llmk_dot_f32_avx2",         DJIBLAS_CHECK_DOT,  (const void *)llmk_dot_f32_avx2,      DJIBLAS_TUNE_ISA_AVX2 },
+    { "axpy_scalar",               DJIBLAS_CHECK_AXPY, 0,                                     0 },
+    { "axpy_sse2",                 DJIBLAS_CHECK_AXPY, (const void *)djiblas_axpy_sse2,      DJIBLAS_TUNE_ISA_SSE2 },
+    { "llmk_axpy_f32_avx2",        DJIBLAS_CHECK_AXPY, (const void *)llmk_axpy_f32_avx2,     DJIBLAS_TUNE_ISA_AVX2 },
+    { "dequant_scalar",            DJIBLAS_CHECK_DEQUANT, 0,                                  0 },
+    { "djibquant_dequantize_sse2", DJIBLAS_CHECK_DEQUANT, (const void *)djiblas_dequant_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "djibquant_dequantize_avx2", DJIBLAS_CHECK_DEQUANT, (const void *)djiblas_dequant_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "attn_scalar",               DJIBLAS_CHECK_ATTN, 0,                                     0 },
+    { "attn_sse2",                 DJIBLAS_CHECK_ATTN, (const void *)djiblas_attn_sse2,      DJIBLAS_TUNE_ISA_SSE2 },
+    { "attn_avx2",                 DJIBLAS_CHECK_ATTN, (const void *)djiblas_attn_avx2,      DJIBLAS_TUNE_ISA_AVX2 },
+    { "attn_f16_scalar",           DJIBLAS_CHECK_ATTN_F16, 0,                                 0 },
+    { "attn_f16_sse2",             DJIBLAS_CHECK_ATTN_F16, (const void *)djiblas_attn_f16_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "attn_f16_f16c",             DJIBLAS_CHECK_ATTN_F16, (const void *)djiblas_attn_f16_f16c,
+                                   DJIBLAS_TUNE_ISA_AVX2 | DJIBLAS_TUNE_ISA_F16C },
+    { "attn_q8_scalar",            DJIBLAS_CHECK_ATTN_Q8, 0,                                  0 },
+    { "attn_q8_sse2",              DJIBLAS_CHECK_ATTN_Q8, (const void *)djiblas_attn_q8_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "attn_q8_avx2",              DJIBLAS_CHECK_ATTN_Q8, (const void *)djiblas_attn_q8_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "attn_gqa_scalar",           DJIBLAS_CHECK_GQA,  0,                                     0 },
+    { "attn_gqa_sse2",             DJIBLAS_CHECK_GQA,  (const void *)djiblas_attn_gqa_sse2,  DJIBLAS_TUNE_ISA_SSE2 },
+    { "attn_gqa_avx2",             DJIBLAS_CHECK_GQA,  (const void *)djiblas_attn_gqa_avx2,  DJIBLAS_TUNE_ISA_AVX2 },
+    { "attn_gqa_f16_scalar",       DJIBLAS_CHECK_GQA_F16, 0,                                  0 },
+    { "attn_gqa_f16_sse2",         DJIBLAS_CHECK_GQA_F16, (const void *)djiblas_attn_gqa_f16_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "attn_gqa_f16_f16c",         DJIBLAS_CHECK_GQA_F16, (const void *)djiblas_attn_gqa_f16_f16c,
+                                   DJIBLAS_TUNE_ISA_AVX2 | DJIBLAS_TUNE_ISA_F16C },
+    { "attn_gqa_q8_scalar",        DJIBLAS_CHECK_GQA_Q8, 0,                                   0 },
+    { "attn_gqa_q8_sse2",          DJIBLAS_CHECK_GQA_Q8, (const void *)djiblas_attn_gqa_q8_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "attn_gqa_q8_avx2",          DJIBLAS_CHECK_GQA_Q8, (const void *)djiblas_attn_gqa_q8_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "rope_scalar",               DJIBLAS_CHECK_ROPE, 0,                                     0 },
+    { "rope_sse2",                 DJIBLAS_CHECK_ROPE, (const void *)djiblas_rope_sse2,      DJIBLAS_TUNE_ISA_SSE2 },
+    { "rope_avx2",                 DJIBLAS_CHECK_ROPE, (const void *)djiblas_rope_avx2,      DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemv_q8_ref",               DJIBLAS_CHECK_GEMV_Q8, 0,                                  0 },
+    { "gemv_q8_scalar",            DJIBLAS_CHECK_GEMV_Q8, (const void *)djiblas_gemv_q8_scalar, 0 },
+    { "gemv_q8_sse2",              DJIBLAS_CHECK_GEMV_Q8, (const void *)djiblas_gemv_q8_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "gemv_q8_avx2",              DJIBLAS_CHECK_GEMV_Q8, (const void *)djiblas_gemv_q8_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemv_q8_vnni",              DJIBLAS_CHECK_GEMV_Q8, (const void *)djiblas_gemv_q8_vnni,
+                                   DJIBLAS_TUNE_ISA_AVX2 | DJIBLAS_TUNE_ISA_VNNI },
+    { "gemm_q8_ref",               DJIBLAS_CHECK_GEMM_Q8, 0,                                  0 },
+    { "gemm_q8_scalar",            DJIBLAS_CHECK_GEMM_Q8, (const void *)djiblas_gemm_q8_scalar, 0 },
+    { "gemm_q8_sse2",              DJIBLAS_CHECK_GEMM_Q8, (const void *)djiblas_gemm_q8_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "gemm_q8_avx2",              DJIBLAS_CHECK_GEMM_Q8, (const void *)djiblas_gemm_q8_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemm_q8_vnni",              DJIBLAS_CHECK_GEMM_Q8, (const void *)djiblas_gemm_q8_vnni,
+                                   DJIBLAS_TUNE_ISA_AVX2 | DJIBLAS_TUNE_ISA_VNNI },
+    { "gemv_q4_ref",               DJIBLAS_CHECK_GEMV_Q4, 0,                                  0 },
+    { "gemv_q4_scalar",            DJIBLAS_CHECK_GEMV_Q4, (const void *)djiblas_gemv_q4_scalar, 0 },
+    { "gemv_q4_sse2",              DJIBLAS_CHECK_GEMV_Q4, (const void *)djiblas_gemv_q4_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "gemv_q4_avx2",              DJIBLAS_CHECK_GEMV_Q4, (const void *)djiblas_gemv_q4_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemm_q4_ref",               DJIBLAS_CHECK_GEMM_Q4, 0,                                  0 },
+    { "gemm_q4_scalar",            DJIBLAS_CHECK_GEMM_Q4, (const void *)djiblas_gemm_q4_scalar, 0 },
+    { "gemm_q4_sse2",              DJIBLAS_CHECK_GEMM_Q4, (const void *)djiblas_gemm_q4_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "gemm_q4_avx2",              DJIBLAS_CHECK_GEMM_Q4, (const void *)djiblas_gemm_q4_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemv_q6_ref",               DJIBLAS_CHECK_GEMV_Q6, 0,                                  0 },
+    { "gemv_q6_sse2",              DJIBLAS_CHECK_GEMV_Q6, (const void *)djiblas_gemv_q6_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "gemv_q6_avx2",              DJIBLAS_CHECK_GEMV_Q6, (const void *)djiblas_gemv_q6_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemv_q6_avx512",            DJIBLAS_CHECK_GEMV_Q6, (const void *)djiblas_gemv_q6_avx512, DJIBLAS_TUNE_ISA_AVX512 },
+    { "gemv_q6p_ref",              DJIBLAS_CHECK_GEMV_Q6P, 0,                                 0 },
+    { "gemv_q6p_sse2",             DJIBLAS_CHECK_GEMV_Q6P, (const void *)djiblas_gemv_q6p_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "gemv_q6p_avx2",             DJIBLAS_CHECK_GEMV_Q6P, (const void *)djiblas_gemv_q6p_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemv_q6_q8_ref",            DJIBLAS_CHECK_GEMV_Q6_Q8, 0,                               0 },
+    { "gemv_q6_q8_scalar",         DJIBLAS_CHECK_GEMV_Q6_Q8, (const void *)djiblas_gemv_q6_q8_scalar, 0 },
+    { "gemv_q6_q8_avx2",           DJIBLAS_CHECK_GEMV_Q6_Q8, (const void *)djiblas_gemv_q6_q8_avx2,
+                                   DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemv_q6_q8_vnni",           DJIBLAS_CHECK_GEMV_Q6_Q8, (const void *)djiblas_gemv_q6_q8_vnni,
+                                   DJIBLAS_TUNE_ISA_AVX2 | DJIBLAS_TUNE_ISA_VNNI },
+    { "gemv_q6p_q8_ref",           DJIBLAS_CHECK_GEMV_Q6P_Q8, 0,                              0 },
+    { "gemv_q6p_q8_scalar",        DJIBLAS_CHECK_GEMV_Q6P_Q8, (const void *)djiblas_gemv_q6p_q8_scalar, 0 },
+    { "gemv_q6p_q8_avx2",          DJIBLAS_CHECK_GEMV_Q6P_Q8, (const void *)djiblas_gemv_q6p_q8_avx2,
+                                   DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemv_f16_ref",              DJIBLAS_CHECK_GEMV_F16, 0,                                 0 },
+    { "gemv_f16_sse2",             DJIBLAS_CHECK_GEMV_F16, (const void *)djiblas_gemv_f16_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "gemv_f16_f16c",             DJIBLAS_CHECK_GEMV_F16, (const void *)djiblas_gemv_f16_f16c,
+                                   DJIBLAS_TUNE_ISA_AVX2 | DJIBLAS_TUNE_ISA_F16C },
+    { "gemv_f16_avx512",           DJIBLAS_CHECK_GEMV_F16, (const void *)djiblas_gemv_f16_avx512, DJIBLAS_TUNE_ISA_AVX512 },
+    { "gemv_bf16_ref",             DJIBLAS_CHECK_GEMV_BF16, 0,                                0 },
+    { "gemv_bf16_sse2",            DJIBLAS_CHECK_GEMV_BF16, (const void *)djiblas_gemv_bf16_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "gemv_bf16_avx2",            DJIBLAS_CHECK_GEMV_BF16, (const void *)djiblas_gemv_bf16_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "gemv_bf16_avx512",          DJIBLAS_CHECK_GEMV_BF16, (const void *)djiblas_gemv_bf16_avx512, DJIBLAS_TUNE_ISA_AVX512 },
+    { "sgemv_panel8_ref",          DJIBLAS_CHECK_PANEL8, 0,                                   0 },
+    { "sgemv_panel8_avx2",         DJIBLAS_CHECK_PANEL8, (const void *)djiblas_sgemv_panel8_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "sgemv_panel8_stream_avx2",  DJIBLAS_CHECK_PANEL8, (const void *)djiblas_sgemv_panel8_stream_avx2,
+                                   DJIBLAS_TUNE_ISA_AVX2 },
+    { "sgemv_panel16_ref",         DJIBLAS_CHECK_PANEL16, 0,                                  0 },
+    { "sgemv_panel16_avx512",      DJIBLAS_CHECK_PANEL16, (const void *)djiblas_sgemv_panel16_avx512,
+                                   DJIBLAS_TUNE_ISA_AVX512 },
+    { "sgemv_panel16_stream_avx512", DJIBLAS_CHECK_PANEL16, (const void *)djiblas_sgemv_panel16_stream_avx512,
+                                   DJIBLAS_TUNE_ISA_AVX512 },
+    { "gate_up_ref",               DJIBLAS_CHECK_GATE_UP, 0,                                  0 },
+    { "ffn_gate_up_blocked",       DJIBLAS_CHECK_GATE_UP, (const void *)djiblas_ffn_gate_up_blocked,
+                                   DJIBLAS_TUNE_ISA_SSE2 },
+    { "ffn_gate_up_avx2",          DJIBLAS_CHECK_GATE_UP, (const void *)djiblas_ffn_gate_up_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "ffn_gate_up_avx512",        DJIBLAS_CHECK_GATE_UP, (const void *)djiblas_ffn_gate_up_avx512,
+                                   DJIBLAS_TUNE_ISA_AVX512 },
+    { "ffn_gate_up_stream_avx2",   DJIBLAS_CHECK_GATE_UP, (const void *)djiblas_ffn_gate_up_stream_avx2,
+                                   DJIBLAS_TUNE_ISA_AVX2 },
+    { "gate_up_panel8_ref",        DJIBLAS_CHECK_GATE_UP8, 0,                                 0 },
+    { "ffn_gate_up_panel8_avx2",   DJIBLAS_CHECK_GATE_UP8, (const void *)djiblas_ffn_gate_up_panel8_avx2,
+                                   DJIBLAS_TUNE_ISA_AVX2 },
+    { "ffn_gate_up_panel8_stream_avx2", DJIBLAS_CHECK_GATE_UP8,
+                                   (const void *)djiblas_ffn_gate_up_panel8_stream_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "gate_up_panel16_ref",       DJIBLAS_CHECK_GATE_UP16, 0,                                0 },
+    { "ffn_gate_up_panel16_avx512", DJIBLAS_CHECK_GATE_UP16, (const void *)djiblas_ffn_gate_up_panel16_avx512,
+                                   DJIBLAS_TUNE_ISA_AVX512 },
+    { "ffn_gate_up_panel16_stream_avx512", DJIBLAS_CHECK_GATE_UP16,
+                                   (const void *)djiblas_ffn_gate_up_panel16_stream_avx512, DJIBLAS_TUNE_ISA_AVX512 },
+    { "softmax_ref",               DJIBLAS_CHECK_SOFTMAX, 0,                                  0 },
+    { "softmax_sse2",              DJIBLAS_CHECK_SOFTMAX, (const void *)djiblas_softmax_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "softmax_avx2",              DJIBLAS_CHECK_SOFTMAX, (const void *)djiblas_softmax_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "softmax_avx512",            DJIBLAS_CHECK_SOFTMAX, (const void *)djiblas_softmax_avx512, DJIBLAS_TUNE_ISA_AVX512 },
+    { "exp_sum_ref",               DJIBLAS_CHECK_EXP_SUM, 0,                                  0 },
+    { "exp_sum_sse2",              DJIBLAS_CHECK_EXP_SUM, (const void *)djiblas_exp_sum_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "exp_sum_avx2",              DJIBLAS_CHECK_EXP_SUM, (const void *)djiblas_exp_sum_avx2, DJIBLAS_TUNE_ISA_AVX2 },
+    { "exp_sum_avx512",            DJIBLAS_CHECK_EXP_SUM, (const void *)djiblas_exp_sum_avx512, DJIBLAS_TUNE_ISA_AVX512 },
+    { "silu_ref",                  DJIBLAS_CHECK_SILU, 0,                                     0 },
+    { "silu_sse2",                 DJIBLAS_CHECK_SILU, (const void *)djiblas_silu_sse2,      DJIBLAS_TUNE_ISA_SSE2 },
+    { "silu_avx2",                 DJIBLAS_CHECK_SILU, (const void *)djiblas_silu_avx2,      DJIBLAS_TUNE_ISA_AVX2 },
+    { "silu_avx512",               DJIBLAS_CHECK_SILU, (const void *)djiblas_silu_avx512,    DJIBLAS_TUNE_ISA_AVX512 },
+    { "rmsnorm_ref",               DJIBLAS_CHECK_RMSNORM, 0,                                  0 },
+    { "rmsnorm_sse2",              DJIBLAS_CHECK_RMSNORM, (const void *)djiblas_rmsnorm_sse2, DJIBLAS_TUNE_ISA_SSE2 },
+    { "residual_rmsnorm_ref",      DJIBLAS_CHECK_RES_RMSNORM, 0,                              0 },
+    { "residual_rmsnorm_sse2",     DJIBLAS_CHECK_RES_RMSNORM, (const void *)djiblas_residual_rmsnorm_sse2,
+                                   DJIBLAS_TUNE_ISA_SSE2 },
+    { "residual_rmsnorm_avx2",     DJIBLAS_CHECK_RES_RMSNORM, (const void *)djiblas_residual_rmsnorm_avx2,
+                                   DJIBLAS_TUNE_ISA_AVX2 },
+};
+
+#define DJIBLAS_CHECK_N_KERNELS ((int)(sizeof(k_check_kernels) / sizeof(k_check_kernels[0])))
+
+// rows x cols of the stories15M / stories110M projections: wq/wo, wqkv, w1/w3,
+// w2 and the classifier, at dim 288 and 768.
+static const int k_check_mat_shapes[][2] = {
+    { 288, 288 }, { 864, 288 }, { 768, 288 }, { 288, 768 }, { 32000, 288 },
+    { 768, 768 }, { 2304, 768 }, { 2048, 768 }, { 768, 2048 }, { 32000, 768 },
+};
+#define DJIBLAS_CHECK_N_MAT ((int)(sizeof(k_check_mat_shapes) / sizeof(k_check_mat_shapes[0])))
+
+// Prefill GEMMs run on one LLMK_PREFILL_BLOCK of tokens; the classifier is
+// only ever a GEMV (last token), so vocab-sized shapes skip the GEMM.
+#define DJIBLAS_CHECK_NTOK      32
+#define DJIBLAS_CHECK_GEMM_ROWS 4096
+
+// Head sizes and dims for dot/axpy; group, row and matrix sizes for dequant.
+static const int k_check_vec_lens[] = { 48, 64, 288, 768 };
+static const int k_check_deq_lens[] = { 64, 4096, 288 * 768 };
+#define DJIBLAS_CHECK_N_VEC ((int)(sizeof(k_check_vec_lens) / sizeof(k_check_vec_lens[0])))
+#define DJIBLAS_CHECK_N_DEQ ((int)(sizeof(k_check_deq_lens) / sizeof(k_check_deq_lens[0])))
+
+// Decode attention: head_size x positions (stories15M / 110M heads, a
+// 128-wide head), over K/V rows two heads apart as in the KV cache.
+static const int k_check_attn_shapes[][2] = {
+    { 48, 256 }, { 64, 1024 }, { 128, 2048 }, { 36, 100 },
+};
+#define DJIBLAS_CHECK_N_ATTN ((int)(sizeof(k_check_attn_shapes) / sizeof(k_check_attn_shapes[0])))
+
+// Grouped-query attention runs the same shapes with this many query heads
+// per KV head (TinyLlama / Llama-2-70B style).
+#define DJIBLAS_CHECK_GQA_GROUP 4
+
+// RoPE: head_size x heads (q and k both get all heads).
+static const int k_check_rope_shapes[][2] = {
+    { 48, 6 }, { 64, 12 }, { 128, 32 }, { 36, 4 },
+};
+#define DJIBLAS_CHECK_N_ROPE ((int)(sizeof(k_check_rope_shapes) / sizeof(k_check_rope_shapes[0])))
+
+// Weight formats run the GEMV shapes (GEMMs up to DJIBLAS_CHECK_GEMM_ROWS);
+// the fused gate/up kernels run w1/w3. The int8 / int4 GEMMs take one column
+// less than a prefill block, so the DJIBLAS_Q8_NCOL tile has a tail. Q6
+// tensors start an odd number of 32-blocks into their first scale group
+// (e0 / 32 = 3), so groups straddle rows and, with the 288-wide rows (not a
+// multiple of 64), a row may start on either half of a group: the block ->
+// group mapping of the int8 Q6 kernels sees every case.
+static const int k_check_ffn_shapes[][2] = {
+    { 768, 288 }, { 2048, 768 },
+};
+#define DJIBLAS_CHECK_N_FFN ((int)(sizeof(k_check_ffn_shapes) / sizeof(k_check_ffn_shapes[0])))
+#define DJIBLAS_CHECK_NTOK_Q8 (DJIBLAS_CHECK_NTOK - 1)
+#define DJIBLAS_CHECK_Q6_E0   96
+
+// softmax / exp_sum / silu / norms: attention scores (no vector multiple),
+// dim, hidden and vocab.
+static const int k_check_act_lens[] = { 100, 288, 768, 2048, 32000 };
+#define DJIBLAS_CHECK_N_ACT ((int)(sizeof(k_check_act_lens) / sizeof(k_check_act_lens[0])))
+
+// Timed samples per kernel (after one warm-up call); the minimum wins. Small
+// problems are batched so one sample is at least ~100k flops of work.
+#define DJIBLAS_CHECK_SAMPLES     5
+#define DJIBLAS_CHECK_BATCH_FLOPS 100000ULL
+#define DJIBLAS_CHECK_MAX_BATCH   10000ULL
+
+static inline UINT64 djiblas_check_rdtsc(void) {
+#if defined(__x86_64__) || defined(_M_X64)
+    UINT32 lo, hi;
+    __asm__ volatile("lfence\nrdtsc" : "=a"(lo), "=d"(hi) :: "memory");
+    return ((UINT64)hi << 32) | (UINT64)lo;
+#else
+    return 0;
+#endif
+}
+
+static UINT32 djiblas_check_isa(const CPUFeatures *f) {
+    UINT32 isa = 0;
+    if (f->has_sse2) isa |= DJIBLAS_TUNE_ISA_SSE2;
+    if (f->has_avx2 && f->has_fma) isa |= DJIBLAS_TUNE_ISA_AVX2;
+    if (f->has_avx512f) isa |= DJIBLAS_TUNE_ISA_AVX512;
+    if (f->has_f16c) isa |= DJIBLAS_TUNE_ISA_F16C;
+    if (f->has_avx512_vnni && f->has_avx512vl) isa |= DJIBLAS_TUNE_ISA_VNNI;
+    return isa;
+}
+
+// ----------------------------------------------------------------------------
+// Inputs and error measure
+// ----------------------------------------------------------------------------
+
+// Uniform [-1, 1) from a fixed LCG, so a buffer can be regenerated exactly.
+static void djiblas_check_fill(float *p, UINT64 n, UINT32 seed) {
+    UINT32 s = seed * 2654435761u + 1u;
+    for (UINT64 i = 0; i < n; i++) {
+        s = s * 1664525u + 1013904223u;
+        p[i] = (float)(INT32)(s >> 8) * (1.0f / 8388608.0f) - 1.0f;
+    }
+}
+
+static void djiblas_check_abs(float *p, UINT64 n) {
+    for (UINT64 i = 0; i < n; i++) {
+        if (p[i] < 0.0f) p[i] = -p[i];
+    }
+}
+
+// One unit in the last place at the magnitude of v (v >= 0).
+static float djiblas_check_ulp(float v) {
+    union { float f; UINT32 u; } b;
+    b.f = v;
+    UINT32 e = (b.u >> 23) & 0xFFu;
+    if (e <= 23) {
+        b.u = 1;            // subnormal step
+    } else {
+        b.u = (e - 23) << 23;
+    }
+    return b.f;
+}
+
+// Worst |y - ref| over n outputs, in ULPs of scale[i] = sum |a*b| (the
+// magnitude the reduction rounds at), so cancellation in ref does not
+// inflate the error of a merely reordered sum.
+static UINT32 djiblas_check_max_ulp(const float *y, const float *ref, const float *scale, UINT64 n) {
+    float worst = 0.0f;
+    for (UINT64 i = 0; i < n; i++) {
+        float d = y[i] - ref[i];
+        if (d < 0.0f) d = -d;
+        if (!(d == d)) return 0xFFFFFFFFu;      // NaN
+        float u = d / djiblas_check_ulp(scale[i]);
+        if (u > worst) worst = u;
+    }
+    if (worst >= 4.0e9f) return 0xFFFFFFFFu;
+    return (UINT32)worst + ((worst > (float)(UINT32)worst) ? 1u : 0u);
+}
+
+// Tolerance of a k-term reduction, in ULPs of sum |a*b|. The inputs are fixed
+// and random-signed, so the rounding errors of either side walk like sqrt(k)
+// half-ULP steps (measured worst: a few ULPs); 4 * sqrt(k) leaves a wide
+// margin, while a dropped, doubled or misaligned term (about 2^23 / k ULPs at
+// these sizes) still fails by an order of magnitude.
+static UINT32 djiblas_check_sum_tol(int k) {
+    UINT32 r = 1;
+    while (r * r < (UINT32)k) r++;
+    return 4u * r;
+}
+
+// Next draw of the same LCG as djiblas_check_fill, 16 bits.
+static UINT32 djiblas_check_rand(UINT32 *s) {
+    *s = *s * 1664525u + 1013904223u;
+    return *s >> 16;
+}
+
+// ----------------------------------------------------------------------------
+// Kernel calls
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    const DjibCheckKernel *k;
+    int rows;               // GEMV/GEMM: weight rows; vectors: length
+    int cols;
+    int ntok;
+    const float *A;         // weights / first vector
+    const float *x;         // activation(s) / second vector
+    float *y;               // output (dot: y[0])
+    const INT8 *q;          // dequant input
+    float alpha;
+    const float *V;         // attention values (A = K, x = q, cols = positions)
+    const void *Kc;         // fp16 / int8 attention: the encoded K and V, and
+    const void *Vc;         // the int8 row scales (K: S[t], V: S[cols + t])
+    const float *S;
+    const void *W;          // weight formats: encoded W (gate/up: W1 and W3)
+    const void *W3;
+    const float *Wd;        // block / group scales (Q6: of element e0 + e)
+    UINT64 e0;
+    const INT8 *xq;         // int8 activation columns and their block scales
+    const float *xd;
+    double *dec;            // reference scratch: decoded activation + two rows
+} DjibCheckJob;
+
+// RoPE input (q then k, rows * cols floats each) sits in A; each call
+// rotates a fresh copy in y, so repeated timing calls see the same data.
+// The table row is x (C) and V (S).
+static void djiblas_check_rope_call(const DjibCheckJob *j) {
+    int hs = j->rows, n = j->rows * j->cols;
+    for (int i = 0; i < 2 * n; i++) j->y[i] = j->A[i];
+    if (j->k->fn) {
+        ((djiblas_rope_fn)j->k->fn)(j->y, n, j->y + n, n, hs, j->x, j->V);
+        return;
+    }
+    for (int i = 0; i < 2 * n; i += 2) {
+        int c = i % hs;
+        double x0 = j->y[i], x1 = j->y[i + 1];
+        j->y[i] = (float)(x0 * (double)j->x[c] - x1 * (double)j->V[c + 1]);
+        j->y[i + 1] = (float)(x1 * (double)j->x[c] + x0 * (double)j->V[c + 1]);
+    }
+}
+
+static float djiblas_check_dot_scalar(const float *a, const float *b, int n) {
+    float s = 0.0f;
+    for (int i = 0; i < n; i++) s += a[i] * b[i];
+    return s;
+}
+
+// e^x in double (x <= 0): 2^k * e^r with |r| <= ln2 / 2 and a Taylor series.
+static double djiblas_check_exp(double x) {
+    if (x < -700.0) return 0.0;
+    const double ln2 = 0.69314718055994530942;
+    int k = (int)(x / ln2 - 0.5);
+    double r = x - (double)k * ln2;
+    double t = 1.0, e = 1.0;
+    for (int i = 1; i < 16; i++) {
+        t *= r / (double)i;
+        e += t;
+    }
+    for (; k < 0; k++) e *= 0.5;
+    return e;
+}
+
+// Three-pass softmax attention in double: scores, max/exp/sum, weighted V,
+// for query head h (q at x + h * head_size).
+static void djiblas_check_attn_scalar(const DjibCheckJob *j, int h, float *out, BOOLEAN magnitude) {
+    int hs = j->rows, n = j->cols, ld = 2 * hs;
+    const float *q = j->x + h * hs;
+    float scale = j->alpha;
+    double m = -1.0e300, l = 0.0;
+    for (int t = 0; t < n; t++) {
+        double d = 0.0;
+        for (int i = 0; i < hs; i++) d += (double)q[i] * (double)j->A[(UINTN)t * ld + i];
+        d *= scale;
+        if (d > m) m = d;
+    }
+    for (int i = 0; i < hs; i++) out[i] = 0.0f;
+    double acc[DJIBLAS_ATTN_MAX_HEAD];
+    for (int i = 0; i < hs; i++) acc[i] = 0.0;
+    for (int t = 0; t < n; t++) {
+        double d = 0.0;
+        for (int i = 0; i < hs; i++) d += (double)q[i] * (double)j->A[(UINTN)t * ld + i];
+        double p = djiblas_check_exp(d * scale - m);
+        l += p;
+        for (int i = 0; i < hs; i++) {
+            double v = j->V[(UINTN)t * ld + i];
+            acc[i] += p * ((magnitude && v < 0.0) ? -v : v);
+        }
+    }
+    for (int i = 0; i < hs; i++) out[i] = (float)(acc[i] / l);
+}
+
+static int djiblas_check_panel_rows(int kind) {
+    if (kind == DJIBLAS_CHECK_PANEL8 || kind == DJIBLAS_CHECK_GATE_UP8) return 8;
+    if (kind == DJIBLAS_CHECK_PANEL16 || kind == DJIBLAS_CHECK_GATE_UP16) return 16;
+    return 0;
+}
+
+static BOOLEAN djiblas_check_is_gate_up(int kind) {
+    return kind == DJIBLAS_CHECK_GATE_UP || kind == DJIBLAS_CHECK_GATE_UP8 || kind == DJIBLAS_CHECK_GATE_UP16;
+}
+
+// Kinds whose activation is the int8 xq / xd instead of the float x.
+static BOOLEAN djiblas_check_is_int8_act(int kind) {
+    return kind == DJIBLAS_CHECK_GEMV_Q8 || kind == DJIBLAS_CHECK_GEMM_Q8 ||
+           kind == DJIBLAS_CHECK_GEMV_Q4 || kind == DJIBLAS_CHECK_GEMM_Q4 ||
+           kind == DJIBLAS_CHECK_GEMV_Q6_Q8 || kind == DJIBLAS_CHECK_GEMV_Q6P_Q8;
+}
+
+static BOOLEAN djiblas_check_is_q6(int kind) {
+    return kind == DJIBLAS_CHECK_GEMV_Q6 || kind == DJIBLAS_CHECK_GEMV_Q6_Q8;
+}
+
+static BOOLEAN djiblas_check_is_q6p(int kind) {
+    return kind == DJIBLAS_CHECK_GEMV_Q6P || kind == DJIBLAS_CHECK_GEMV_Q6P_Q8;
+}
+
+// Weight (i, l) of an encoded matrix, decoded here rather than through the
+// library's unpack helpers (fp16 widens through djiblas_widen_f16, as in
+// the attention check).
+static double djiblas_check_weight(const DjibCheckJob *j, const void *W, int i, int l) {
+    UINT64 e = (UINT64)i * (UINT64)j->cols + (UINT64)l;
+    int R = djiblas_check_panel_rows(j->k->kind);
+    if (djiblas_check_is_q6(j->k->kind)) {
+        return (double)((const INT8 *)W)[e] * (double)j->Wd[(j->e0 + e) / DJIBLAS_Q6_GROUP];
+    }
+    if (djiblas_check_is_q6p(j->k->kind)) {
+        const UINT8 *p = (const UINT8 *)W + e / 4 * 3;
+        UINT32 v = (UINT32)p[0] | ((UINT32)p[1] << 8) | ((UINT32)p[2] << 16);
+        INT32 q = (INT32)(v << (26 - 6 * (int)(e % 4))) >> 26;
+        return (double)q * (double)j->Wd[(j->e0 + e) / DJIBLAS_Q6_GROUP];
+    }
+    switch (j->k->kind) {
+        case DJIBLAS_CHECK_GEMV_Q8:
+        case DJIBLAS_CHECK_GEMM_Q8:
+            return (double)((const INT8 *)W)[e] * (double)j->Wd[e / DJIBLAS_Q8_BLOCK];
+        case DJIBLAS_CHECK_GEMV_Q4:
+        case DJIBLAS_CHECK_GEMM_Q4: {
+            UINT8 b = ((const UINT8 *)W)[e / DJIBLAS_Q8_BLOCK * DJIBLAS_Q4_BLOCK_BYTES + e % DJIBLAS_Q4_BLOCK_BYTES];
+            int q = ((e % DJIBLAS_Q8_BLOCK < DJIBLAS_Q4_BLOCK_BYTES) ? (b & 0x0F) : (b >> 4)) - 8;
+            return (double)q * (double)j->Wd[e / DJIBLAS_Q8_BLOCK];
+        }
+        case DJIBLAS_CHECK_GEMV_F16: {
+            float t;
+            djiblas_widen_f16((const UINT16 *)W + e, &t, 1);
+            return (double)t;
+        }
+        case DJIBLAS_CHECK_GEMV_BF16: {
+            union { UINT32 u; float f; } b;
+            b.u = (UINT32)((const UINT16 *)W)[e] << 16;
+            return (double)b.f;
+        }
+        default:
+            if (R) {
+                // Panel of R rows, R-wide k chunks (V == R for both layouts).
+                e = (UINT64)(i / R) * (UINT64)R * (UINT64)j->cols + (UINT64)(l / R) * (UINT64)(R * R) +
+                    (UINT64)((i % R) * R + l % R);
+            }
+            return (double)((const float *)W)[e];
+    }
+}
+
+static double djiblas_check_silu(double g) {
+    double e = djiblas_check_exp((g < 0.0) ? g : -g);
+    return (g < 0.0) ? g * e / (1.0 + e) : g / (1.0 + e);
+}
+
+// Weight-format reference in double: every row decoded once and dotted with
+// all ntok columns (gate/up: silu(W1 x) * (W3 x)). magnitude gives the
+// scale instead: sum |w x|, or sum |w1 x| * sum |w3 x| for gate/up (the
+// product rounds at both).
+static void djiblas_check_wmat_ref(const DjibCheckJob *j, float *out, BOOLEAN magnitude) {
+    int d = j->rows, n = j->cols, kind = j->k->kind;
+    BOOLEAN gate = djiblas_check_is_gate_up(kind);
+    double *xr = j->dec;
+    double *w1 = xr + (UINTN)j->ntok * (UINTN)n;
+    double *w3 = w1 + n;
+    for (int c = 0; c < j->ntok; c++) {
+        for (int l = 0; l < n; l++) {
+            UINTN e = (UINTN)c * (UINTN)n + (UINTN)l;
+            double v = djiblas_check_is_int8_act(kind) ? (double)j->xq[e] * (double)j->xd[e / DJIBLAS_Q8_BLOCK]
+                                                       : (double)j->x[e];
+            xr[e] = (magnitude && v < 0.0) ? -v : v;
+        }
+    }
+    for (int i = 0; i < d; i++) {
+        for (int l = 0; l < n; l++) {
+            double v = djiblas_check_weight(j, j->W, i, l);
+            w1[l] = (magnitude && v < 0.0) ? -v : v;
+            if (gate) {
+                v = djiblas_check_weight(j, j->W3, i, l);
+                w3[l] = (magnitude && v < 0.0) ? -v : v;
+            }
+        }
+        for (int c = 0; c < j->ntok; c++) {
+            const double *x = xr + (UINTN)c * (UINTN)n;
+            double g = 0.0, u = 0.0;
+            for (int l = 0; l < n; l++) g += w1[l] * x[l];
+            if (gate) {
+                for (int l = 0; l < n; l++) u += w3[l] * x[l];
+                out[i] = (float)(magnitude ? g * u : djiblas_check_silu(g) * u);
+            } else {
+                out[(UINTN)c * (UINTN)d + i] = (float)g;
+            }
+        }
+    }
+}
+
+static double djiblas_check_sqrt(double v) {
+    if (v <= 0.0) return 0.0;
+    double r = (v > 1.0) ? v : 1.0;
+    for (int i = 0; i < 64; i++) r = 0.5 * (r + v / r);
+    return r;
+}
+
+// Vector primitive reference in double on A (second operand x, residual
+// delta V), plus the scale when scale != 0: |out|, and |a| + |delta| for
+// the residual sum (one rounding of a float add on both sides).
+static void djiblas_check_act_ref(const DjibCheckJob *j, float *out, float *scale) {
+    int n = j->rows, kind = j->k->kind;
+    const float *a = j->A;
+    if (kind == DJIBLAS_CHECK_SOFTMAX || kind == DJIBLAS_CHECK_EXP_SUM) {
+        double m = a[0], l = 0.0;
+        for (int i = 1; i < n; i++) {
+            if (a[i] > m) m = a[i];
+        }
+        for (int i = 0; i < n; i++) l += djiblas_check_exp((double)a[i] - m);
+        for (int i = 0; i < n; i++) {
+            double e = djiblas_check_exp((double)a[i] - m);
+            out[i] = (float)((kind == DJIBLAS_CHECK_SOFTMAX) ? e / l : e);
+        }
+        if (kind == DJIBLAS_CHECK_EXP_SUM) out[n] = (float)l;
+    } else if (kind == DJIBLAS_CHECK_SILU) {
+        for (int i = 0; i < n; i++) out[i] = (float)(djiblas_check_silu((double)a[i]) * (double)j->x[i]);
+    } else {
+        // rmsnorm on a, or on the rounded a + delta written back to x.
+        const float *x = a;
+        int o = 0;
+        if (kind == DJIBLAS_CHECK_RES_RMSNORM) {
+            for (int i = 0; i < n; i++) out[i] = a[i] + j->V[i];
+            x = out;
+            o = n;
+        }
+        double ss = 0.0;
+        for (int i = 0; i < n; i++) ss += (double)x[i] * (double)x[i];
+        double inv = 1.0 / djiblas_check_sqrt(ss / (double)n + 1e-5);
+        for (int i = 0; i < n; i++) out[o + i] = (float)((double)j->x[i] * ((double)x[i] * inv));
+    }
+    if (!scale) return;
+    int nout = (kind == DJIBLAS_CHECK_EXP_SUM) ? n + 1 : (kind == DJIBLAS_CHECK_RES_RMSNORM) ? 2 * n : n;
+    for (int i = 0; i < nout; i++) scale[i] = (out[i] < 0.0f) ? -out[i] : out[i];
+    if (kind == DJIBLAS_CHECK_RES_RMSNORM) {
+        for (int i = 0; i < n; i++) {
+            scale[i] = ((a[i] < 0.0f) ? -a[i] : a[i]) + ((j->V[i] < 0.0f) ? -j->V[i] : j->V[i]);
+        }
+    }
+}
+
+// In-place primitives work on a fresh copy of A in y, so repeated timing
+// calls see the same input; exp_sum returns its sum in y[n], the residual
+// norm writes x to y[0..n) and out to y[n..2n).
+static void djiblas_check_act_call(DjibCheckJob *j) {
+    int n = j->rows;
+    const void *fn = j->k->fn;
+    for (int i = 0; i < n; i++) j->y[i] = j->A[i];
+    if (!fn) {
+        djiblas_check_act_ref(j, j->y, 0);
+        return;
+    }
+    switch (j->k->kind) {
+        case DJIBLAS_CHECK_SOFTMAX: ((djiblas_softmax_fn)fn)(j->y, n); break;
+        case DJIBLAS_CHECK_EXP_SUM: j->y[n] = ((djiblas_exp_sum_fn)fn)(j->y, n); break;
+        case DJIBLAS_CHECK_SILU:    ((djiblas_silu_fn)fn)(j->y, j->x, n); break;
+        case DJIBLAS_CHECK_RMSNORM: ((djiblas_rmsnorm_fn)fn)(j->y, j->A, j->x, n); break;
+        default:                    ((djiblas_residual_rmsnorm_fn)fn)(j->y, j->V, j->x, j->y + n, n); break;
+    }
+}
+
+static void djiblas_check_call(DjibCheckJob *j) {
+    const void *fn = j->k->fn;
+    switch (j->k->kind) {
+        case DJIBLAS_CHECK_GEMV:
+            ((sgemv_kernel_t)fn)(j->rows, j->cols, j->A, j->cols, j->x, j->y);
+            break;
+        case DJIBLAS_CHECK_GEMM:
+            ((sgemm_kernel_t)fn)(j->rows, j->ntok, j->cols, j->A, j->cols, j->x, j->cols, j->y, j->rows);
+            break;
+        case DJIBLAS_CHECK_DOT:
+            j->y[0] = fn ? ((djiblas_dot_fn)fn)(j->A, j->x, j->rows)
+                         : djiblas_check_dot_scalar(j->A, j->x, j->rows);
+            break;
+        case DJIBLAS_CHECK_AXPY:
+            if (fn) {
+                ((djiblas_axpy_fn)fn)(j->y, j->x, j->alpha, j->rows);
+            } else {
+                for (int i = 0; i < j->rows; i++) j->y[i] += j->alpha * j->x[i];
+            }
+            break;
+        case DJIBLAS_CHECK_DEQUANT:
+            if (fn) {
+                ((djiblas_dequant_fn)fn)(j->q, j->alpha, j->y, (UINT32)j->rows);
+            } else {
+                for (int i = 0; i < j->rows; i++) j->y[i] = (float)j->q[i] * j->alpha;
+            }
+            break;
+        case DJIBLAS_CHECK_ATTN:
+        case DJIBLAS_CHECK_ATTN_F16:
+        case DJIBLAS_CHECK_ATTN_Q8:
+            // The references run on A / V, which hold the decoded fp16 / int8 values.
+            if (!fn) {
+                djiblas_check_attn_scalar(j, 0, j->y, FALSE);
+            } else if (j->k->kind == DJIBLAS_CHECK_ATTN) {
+                ((djiblas_attn_fn)fn)(j->x, j->A, j->V, 2 * j->rows, j->cols, j->rows, j->alpha, j->y);
+            } else if (j->k->kind == DJIBLAS_CHECK_ATTN_F16) {
+                ((djiblas_attn_f16_fn)fn)(j->x, (const UINT16 *)j->Kc, (const UINT16 *)j->Vc, 2 * j->rows,
+                                          j->cols, j->rows, j->alpha, j->y);
+            } else {
+                ((djiblas_attn_q8_fn)fn)(j->x, (const INT8 *)j->Kc, j->S, (const INT8 *)j->Vc, j->S + j->cols,
+                                         2 * j->rows, 1, j->cols, j->rows, j->alpha, j->y);
+            }
+            break;
+        case DJIBLAS_CHECK_ROPE:
+            djiblas_check_rope_call(j);
+            break;
+        case DJIBLAS_CHECK_GQA:
+        case DJIBLAS_CHECK_GQA_F16:
+        case DJIBLAS_CHECK_GQA_Q8:
+            // ntok query heads against one K/V head.
+            if (!fn) {
+                for (int h = 0; h < j->ntok; h++) djiblas_check_attn_scalar(j, h, j->y + h * j->rows, FALSE);
+            } else if (j->k->kind == DJIBLAS_CHECK_GQA) {
+                ((djiblas_attn_gqa_fn)fn)(j->x, j->ntok, j->A, j->V, 2 * j->rows, j->cols, j->rows, j->alpha, j->y);
+            } else if (j->k->kind == DJIBLAS_CHECK_GQA_F16) {
+                ((djiblas_attn_gqa_f16_fn)fn)(j->x, j->ntok, (const UINT16 *)j->Kc, (const UINT16 *)j->Vc,
+                                              2 * j->rows, j->cols, j->rows, j->alpha, j->y);
+            } else {
+                ((djiblas_attn_gqa_q8_fn)fn)(j->x, j->ntok, (const INT8 *)j->Kc, j->S, (const INT8 *)j->Vc,
+                                             j->S + j->cols, 2 * j->rows, 1, j->cols, j->rows, j->alpha, j->y);
+            }
+            break;
+        case DJIBLAS_CHECK_SOFTMAX:
+        case DJIBLAS_CHECK_EXP_SUM:
+        case DJIBLAS_CHECK_SILU:
+        case DJIBLAS_CHECK_RMSNORM:
+        case DJIBLAS_CHECK_RES_RMSNORM:
+            djiblas_check_act_call(j);
+            break;
+        default:
+            // Weight formats.
+            if (!fn) {
+                djiblas_check_wmat_ref(j, j->y, FALSE);
+            } else if (j->k->kind == DJIBLAS_CHECK_GEMV_Q8) {
+                ((djiblas_gemv_q8_fn)fn)(j->rows, j->cols, (const INT8 *)j->W, j->Wd, j->xq, j->xd, j->y);
+            } else if (j->k->kind == DJIBLAS_CHECK_GEMM_Q8) {
+                ((djiblas_gemm_q8_fn)fn)(j->rows, j->cols, j->ntok, (const INT8 *)j->W, j->Wd, j->xq, j->xd,
+                                         j->y, j->rows);
+            } else if (j->k->kind == DJIBLAS_CHECK_GEMV_Q4) {
+                ((djiblas_gemv_q4_fn)fn)(j->rows, j->cols, (const UINT8 *)j->W, j->Wd, j->xq, j->xd, j->y);
+            } else if (j->k->kind == DJIBLAS_CHECK_GEMM_Q4) {
+                ((djiblas_gemm_q4_fn)fn)(j->rows, j->cols, j->ntok, (const UINT8 *)j->W, j->Wd, j->xq, j->xd,
+                                         j->y, j->rows);
+            } else if (j->k->kind == DJIBLAS_CHECK_GEMV_Q6) {
+                ((djiblas_gemv_q6_fn)fn)(j->rows, j->cols, (const INT8 *)j->W, j->Wd, j->e0, j->x, j->y);
+            } else if (j->k->kind == DJIBLAS_CHECK_GEMV_Q6P) {
+                ((djiblas_gemv_q6p_fn)fn)(j->rows, j->cols, (const UINT8 *)j->W, j->Wd, j->e0, j->x, j->y);
+            } else if (j->k->kind == DJIBLAS_CHECK_GEMV_Q6_Q8) {
+                ((djiblas_gemv_q6_q8_fn)fn)(j->rows, j->cols, (const INT8 *)j->W, j->Wd, j->e0, j->xq, j->xd, j->y);
+            } else if (j->k->kind == DJIBLAS_CHECK_GEMV_Q6P_Q8) {
+                ((djiblas_gemv_q6p_q8_fn)fn)(j->rows, j->cols, (const UINT8 *)j->W, j->Wd, j->e0, j->xq, j->xd,
+                                             j->y);
+            } else if (j->k->kind == DJIBLAS_CHECK_GEMV_F16 || j->k->kind == DJIBLAS_CHECK_GEMV_BF16) {
+                ((djiblas_gemv_h_fn)fn)(j->rows, j->cols, (const UINT16 *)j->W, j->x, j->y);
+            } else if (j->k->kind == DJIBLAS_CHECK_GATE_UP) {
+                ((djiblas_gate_up_fn)fn)(j->rows, j->cols, (const float *)j->W, (const float *)j->W3, j->cols,
+                                         j->x, j->y);
+            } else if (djiblas_check_is_gate_up(j->k->kind)) {
+                ((djiblas_gate_up_panel_fn)fn)(j->rows, j->cols, (const float *)j->W, (const float *)j->W3,
+                                               j->x, j->y);
+            } else {
+                ((sgemv_panel_kernel_t)fn)(j->rows, j->cols, (const float *)j->W, j->x, j->y);
+            }
+            break;
+    }
+}
+
+static UINT64 djiblas_check_flops(const DjibCheckJob *j) {
+    UINT64 r = (UINT64)j->rows, c = (UINT64)j->cols;
+    switch (j->k->kind) {
+        case DJIBLAS_CHECK_GEMV: return 2ULL * r * c;
+        case DJIBLAS_CHECK_GEMM: return 2ULL * r * c * (UINT64)j->ntok;
+        case DJIBLAS_CHECK_DOT:  return 2ULL * r;
+        case DJIBLAS_CHECK_AXPY: return 2ULL * r;
+        case DJIBLAS_CHECK_ATTN:
+        case DJIBLAS_CHECK_ATTN_F16:
+        case DJIBLAS_CHECK_ATTN_Q8: return 4ULL * r * c;
+        case DJIBLAS_CHECK_ROPE: return 6ULL * r * c;
+        case DJIBLAS_CHECK_GQA:
+        case DJIBLAS_CHECK_GQA_F16:
+        case DJIBLAS_CHECK_GQA_Q8: return 4ULL * r * c * (UINT64)j->ntok;
+        case DJIBLAS_CHECK_DEQUANT: return r;
+        case DJIBLAS_CHECK_SOFTMAX:
+        case DJIBLAS_CHECK_SILU:
+        case DJIBLAS_CHECK_RMSNORM: return 4ULL * r;
+        case DJIBLAS_CHECK_EXP_SUM: return 3ULL * r;
+        case DJIBLAS_CHECK_RES_RMSNORM: return 5ULL * r;
+        default:
+            // Weight formats.
+            if (djiblas_check_is_gate_up(j->k->kind)) return 4ULL * r * c;
+            return 2ULL * r * c * (UINT64)j->ntok;
+    }
+}
+
+// Encoded bytes of ne weights, scales included.
+static UINT64 djiblas_check_weight_bytes(int kind, UINT64 ne) {
+    switch (kind) {
+        case DJIBLAS_CHECK_GEMV_Q8:
+        case DJIBLAS_CHECK_GEMM_Q8: return ne + ne / 8ULL;
+        case DJIBLAS_CHECK_GEMV_Q4:
+        case DJIBLAS_CHECK_GEMM_Q4: return ne / 2ULL + ne / 8ULL;
+        case DJIBLAS_CHECK_GEMV_Q6:
+        case DJIBLAS_CHECK_GEMV_Q6_Q8: return ne + ne / 16ULL;
+        case DJIBLAS_CHECK_GEMV_Q6P:
+        case DJIBLAS_CHECK_GEMV_Q6P_Q8: return ne / 4ULL * 3ULL + ne / 16ULL;
+        case DJIBLAS_CHECK_GEMV_F16:
+        case DJIBLAS_CHECK_GEMV_BF16: return 2ULL * ne;
+        default:                    return 4ULL * ne;
+    }
+}
+
+// Compulsory traffic of one call (each operand touched once).
+static UINT64 djiblas_check_bytes(const DjibCheckJob *j) {
+    UINT64 r = (UINT64)j->rows, c = (UINT64)j->cols, t = (UINT64)j->ntok;
+    switch (j->k->kind) {
+        case DJIBLAS_CHECK_GEMV: return 4ULL * (r * c + c + r);
+        case DJIBLAS_CHECK_GEMM: return 4ULL * (r * c + t * c + t * r);
+        case DJIBLAS_CHECK_DOT:  return 8ULL * r;
+        case DJIBLAS_CHECK_AXPY: return 12ULL * r;
+        case DJIBLAS_CHECK_ATTN: return 8ULL * r * c;
+        case DJIBLAS_CHECK_ATTN_F16: return 4ULL * r * c;
+        case DJIBLAS_CHECK_ATTN_Q8: return 2ULL * r * c + 8ULL * c;
+        case DJIBLAS_CHECK_ROPE: return 16ULL * r * c + 8ULL * r;
+        // K/V once for the whole group: the point of the grouped kernels.
+        case DJIBLAS_CHECK_GQA: return 8ULL * r * c;
+        case DJIBLAS_CHECK_GQA_F16: return 4ULL * r * c;
+        case DJIBLAS_CHECK_GQA_Q8: return 2ULL * r * c + 8ULL * c;
+        case DJIBLAS_CHECK_DEQUANT: return 5ULL * r;
+        case DJIBLAS_CHECK_SOFTMAX:
+        case DJIBLAS_CHECK_EXP_SUM: return 8ULL * r;
+        case DJIBLAS_CHECK_SILU:
+        case DJIBLAS_CHECK_RMSNORM: return 12ULL * r;
+        case DJIBLAS_CHECK_RES_RMSNORM: return 20ULL * r;
+        default: {
+            // Weight formats: weights once, int8 or float activation columns.
+            UINT64 w = djiblas_check_weight_bytes(j->k->kind, r * c);
+            if (djiblas_check_is_gate_up(j->k->kind)) w *= 2ULL;
+            UINT64 x = djiblas_check_is_int8_act(j->k->kind) ? c + c / 8ULL : 4ULL * c;
+            return w + t * x + 4ULL * t * r;
+        }
+    }
+}
+
+// Cycles per call: min over samples of a batch of calls.
+static UINT64 djiblas_check_time(DjibCheckJob *j) {
+    UINT64 batch = DJIBLAS_CHECK_BATCH_FLOPS / (djiblas_check_flops(j) + 1) + 1;
+    if (batch > DJIBLAS_CHECK_MAX_BATCH) batch = DJIBLAS_CHECK_MAX_BATCH;
+    djiblas_check_call(j);
+    UINT64 best = ~0ULL;
+    for (int s = 0; s < DJIBLAS_CHECK_SAMPLES; s++) {
+        UINT64 t0 = djiblas_check_rdtsc();
+        for (UINT64 b = 0; b < batch; b++) djiblas_check_call(j);
+        UINT64 dt = djiblas_check_rdtsc() - t0;
+        if (dt < best) best = dt;
+    }
+    best /= batch;
+    return best ? best : 1;
+}
+
+// ----------------------------------------------------------------------------
+// CSV output
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    char buf[160];
+    int pos;
+} DjibCheckLine;
+
+static void djiblas_check_put(DjibCheckLine *l, const char *s) {
+    while (*s && l->pos + 1 < (int)sizeof(l->buf)) l->buf[l->pos++] = *s++;
+    l->buf[l->pos] = 0;
+}
+
+static void djiblas_check_put_u64(DjibCheckLine *l, UINT64 v) {
+    char tmp[24];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + (int)(v % 10ULL));
+        v /= 10ULL;
+    } while (v && n < (int)sizeof(tmp));
+    while (n > 0 && l->pos + 1 < (int)sizeof(l->buf)) l->buf[l->pos++] = tmp[--n];
+    l->buf[l->pos] = 0;
+}
+
+// v >= 0 with two decimals.
+static void djiblas_check_put_fix2(DjibCheckLine *l, double v) {
+    UINT64 c = (UINT64)(v * 100.0 + 0.5);
+    djiblas_check_put_u64(l, c / 100ULL);
+    char frac[4] = { '.', (char)('0' + (int)((c / 10ULL) % 10ULL)), (char)('0' + (int)(c % 10ULL)), 0 };
+    djiblas_check_put(l, frac);
+}
+
+// n for vectors, rows x cols for matrices / attention / RoPE, then x ntok
+// for GEMMs and grouped attention.
+static void djiblas_check_put_shape(DjibCheckLine *l, const DjibCheckJob *j) {
+    int dims = 2;
+    switch (j->k->kind) {
+        case DJIBLAS_CHECK_DOT:
+        case DJIBLAS_CHECK_AXPY:
+        case DJIBLAS_CHECK_DEQUANT:
+        case DJIBLAS_CHECK_SOFTMAX:
+        case DJIBLAS_CHECK_EXP_SUM:
+        case DJIBLAS_CHECK_SILU:
+        case DJIBLAS_CHECK_RMSNORM:
+        case DJIBLAS_CHECK_RES_RMSNORM:
+            dims = 1;
+            break;
+        case DJIBLAS_CHECK_GEMM:
+        case DJIBLAS_CHECK_GEMM_Q8:
+        case DJIBLAS_CHECK_GEMM_Q4:
+        case DJIBLAS_CHECK_GQA:
+        case DJIBLAS_CHECK_GQA_F16:
+        case DJIBLAS_CHECK_GQA_Q8:
+            dims = 3;
+            break;
+    }
+    djiblas_check_put_u64(l, (UINT64)j->rows);
+    if (dims >= 2) {
+        djiblas_check_put(l, "x");
+        djiblas_check_put_u64(l, (UINT64)j->cols);
+    }
+    if (dims == 3) {
+        djiblas_check_put(l, "x");
+        djiblas_check_put_u64(l, (UINT64)j->ntok);
+    }
+}
+
+typedef struct {
+    djiblas_check_emit_fn emit;
+    void *ctx;
+    UINT64 tsc_hz;
+    UINT32 isa;
+    DjibLasCheckSummary *sum;
+} DjibCheckRun;
+
+static void djiblas_check_emit_row(DjibCheckRun *R, const DjibCheckJob *j, const char *status,
+                                   UINT32 max_ulp, UINT32 tol_ulp, UINT64 cycles) {
+    DjibCheckLine l;
+    l.pos = 0;
+    l.buf[0] = 0;
+    djiblas_check_put(&l, j->k->name);
+    djiblas_check_put(&l, ",");
+    djiblas_check_put_shape(&l, j);
+    djiblas_check_put(&l, ",");
+    djiblas_check_put_u64(&l, max_ulp);
+    djiblas_check_put(&l, ",");
+    djiblas_check_put_u64(&l, tol_ulp);
+    djiblas_check_put(&l, ",");
+    djiblas_check_put(&l, status);
+    djiblas_check_put(&l, ",");
+    djiblas_check_put_u64(&l, cycles);
+    double sec = (R->tsc_hz && cycles) ? (double)cycles / (double)R->tsc_hz : 0.0;
+    djiblas_check_put(&l, ",");
+    djiblas_check_put_fix2(&l, sec > 0.0 ? (double)djiblas_check_flops(j) / sec * 1e-9 : 0.0);
+    djiblas_check_put(&l, ",");
+    djiblas_check_put_fix2(&l, sec > 0.0 ? (double)djiblas_check_bytes(j) / sec * 1e-9 : 0.0);
+    djiblas_check_put(&l, "\n");
+    R->emit(R->ctx, l.buf);
+}
+
+// Check (against ref / scale, n outputs) and time one non-reference kernel.
+static void djiblas_check_one(DjibCheckRun *R, DjibCheckJob *j, const float *ref, const float *scale,
+                              UINT64 n, UINT32 tol) {
+    if ((j->k->isa & R->isa) != j->k->isa) {
+        R->sum->n_skip++;
+        djiblas_check_emit_row(R, j, "skip", 0, tol, 0);
+        return;
+    }
+    djiblas_check_call(j);
+    UINT32 ulp = djiblas_check_max_ulp(j->y, ref, scale, n);
+    BOOLEAN ok = (ulp <= tol);
+    UINT64 cycles = djiblas_check_time(j);
+    R->sum->n_run++;
+    if (!ok) R->sum->n_fail++;
+    djiblas_check_emit_row(R, j, ok ? "ok" : "FAIL", ulp, tol, cycles);
+}
+
+// ----------------------------------------------------------------------------
+// Per-kind drivers
+// ----------------------------------------------------------------------------
+
+static UINT64 djiblas_check_mat_floats(int rows, int cols, int ntok) {
+    UINT64 out = (UINT64)rows * (UINT64)ntok;
+    return (UINT64)rows * (UINT64)cols + (UINT64)ntok * (UINT64)cols + 3ULL * out;
+}
+
+// GEMV (ntok 1) or GEMM over one shape. Buffers: A | X | ref | y | scale.
+static void djiblas_check_mat(DjibCheckRun *R, int kind, int rows, int cols, int ntok,
+                              float *scratch, UINT64 scratch_floats) {
+    UINT64 na = (UINT64)rows * (UINT64)cols;
+    UINT64 nx = (UINT64)ntok * (UINT64)cols;
+    UINT64 ny = (UINT64)rows * (UINT64)ntok;
+    BOOLEAN fits = djiblas_check_mat_floats(rows, cols, ntok) <= scratch_floats;
+
+    float *A = scratch;
+    float *X = A + na;
+    float *ref = X + nx;
+    float *y = ref + ny;
+    float *scale = y + ny;
+
+    DjibCheckJob j;
+    j.rows = rows;
+    j.cols = cols;
+    j.ntok = ntok;
+    j.A = A;
+    j.x = X;
+    j.q = 0;
+    j.alpha = 0.0f;
+    j.V = 0;
+    j.Kc = j.Vc = 0;
+    j.S = 0;
+
+    int first = -1;
+    for (int i = 0; i < DJIBLAS_CHECK_N_KERNELS; i++) {
+        if (k_check_kernels[i].kind != kind) continue;
+        j.k = &k_check_kernels[i];
+        if (!fits) {
+            R->sum->n_skip++;
+            djiblas_check_emit_row(R, &j, "skip", 0, 0, 0);
+            continue;
+        }
+        if (first < 0) {
+            // Reference kernel: scale = |A| * |X| first, then the real inputs.
+            first = i;
+            djiblas_check_fill(A, na, 1);
+            djiblas_check_fill(X, nx, 2);
+            djiblas_check_abs(A, na);
+            djiblas_check_abs(X, nx);
+            j.y = scale;
+            djiblas_check_call(&j);
+            djiblas_check_fill(A, na, 1);
+            djiblas_check_fill(X, nx, 2);
+            j.y = ref;
+            djiblas_check_call(&j);
+            djiblas_check_emit_row(R, &j, "ref", 0, 0, djiblas_check_time(&j));
+            continue;
+        }
+        j.y = y;
+        djiblas_check_one(R, &j, ref, scale, ny, djiblas_check_sum_tol(cols));
+    }
+}
+
+// dot / axpy over n. Buffers: a | b | ref | y | scale | y0.
+static void djiblas_check_vec(DjibCheckRun *R, int kind, int n, float *scratch, UINT64 scratch_floats) {
+    DjibCheckJob j;
+    j.rows = n;
+    j.cols = 0;
+    j.ntok = 1;
+    j.q = 0;
+    j.alpha = 0.75f;
+    j.V = 0;
+    j.Kc = j.Vc = 0;
+    j.S = 0;
+
+    float *a = scratch;
+    float *b = a + n;
+    float *ref = b + n;
+    float *y = ref + n;
+    float *scale = y + n;
+    float *y0 = scale + n;
+    BOOLEAN fits = 6ULL * (UINT64)n <= scratch_floats;
+    if (fits) {
+        djiblas_check_fill(a, (UINT64)n, 3);
+        djiblas_check_fill(b, (UINT64)n, 4);
+        djiblas_check_fill(y0, (UINT64)n, 5);
+    }
+    j.A = a;
+    j.x = b;
+    UINT64 nout = (kind == DJIBLAS_CHECK_DOT) ? 1ULL : (UINT64)n;
+
+    for (int i = 0; i < DJIBLAS_CHECK_N_KERNELS; i++) {
+        const DjibCheckKernel *k = &k_check_kernels[i];
+        if (k->kind != kind) continue;
+        j.k = k;
+        if (!fits) {
+            R->sum->n_skip++;
+            djiblas_check_emit_row(R, &j, "skip", 0, 0, 0);
+            continue;
+        }
+        if (!k->fn) {
+            // Reference + scale.
+            if (kind == DJIBLAS_CHECK_DOT) {
+                float s = 0.0f;
+                for (int l = 0; l < n; l++) {
+                    float p = a[l] * b[l];
+                    s += (p < 0.0f) ? -p : p;
+                }
+                scale[0] = s;
+                j.y = ref;
+                djiblas_check_call(&j);
+            } else {
+                for (int l = 0; l < n; l++) {
+                    float p = j.alpha * b[l];
+                    scale[l] = ((y0[l] < 0.0f) ? -y0[l] : y0[l]) + ((p < 0.0f) ? -p : p);
+                    ref[l] = y0[l];
+                }
+                j.y = ref;
+                djiblas_check_call(&j);
+            }
+            j.y = y;
+            djiblas_check_emit_row(R, &j, "ref", 0, 0, djiblas_check_time(&j));
+            continue;
+        }
+        // dot: a reordered n-term sum; axpy: one fused or two separate
+        // roundings per element per side.
+        if (kind == DJIBLAS_CHECK_AXPY) {
+            for (int l = 0; l < n; l++) y[l] = y0[l];
+        }
+        j.y = y;
+        djiblas_check_one(R, &j, ref, scale, nout, (kind == DJIBLAS_CHECK_DOT) ? djiblas_check_sum_tol(n) : 2u);
+    }
+}
+
+// int8 * scale is one rounding everywhere: exact match (0 ULP).
+static void djiblas_check_deq(DjibCheckRun *R, int n, float *scratch, UINT64 scratch_floats) {
+    UINT64 qf = ((UINT64)n + 3ULL) / 4ULL;
+    BOOLEAN fits = 2ULL * (UINT64)n + qf <= scratch_floats;
+    float *ref = scratch;
+    float *y = ref + n;
+    INT8 *q = (INT8 *)(y + n);
+
+    DjibCheckJob j;
+    j.rows = n;
+    j.cols = 0;
+    j.ntok = 1;
+    j.A = 0;
+    j.x = 0;
+    j.q = q;
+    j.alpha = 0.0123f;
+    j.V = 0;
+    j.Kc = j.Vc = 0;
+    j.S = 0;
+
+    if (fits) {
+        UINT32 s = 12345u;
+        for (int i = 0; i < n; i++) {
+            s = s * 1664525u + 1013904223u;
+            q[i] = (INT8)((INT32)((s >> 16) % 63u) - 31);   // DjibQuant Q6 range
+        }
+    }
+    for (int i = 0; i < DJIBLAS_CHECK_N_KERNELS; i++) {
+        const DjibCheckKernel *k = &k_check_kernels[i];
+        if (k->kind != DJIBLAS_CHECK_DEQUANT) continue;
+        j.k = k;
+        if (!fits) {
+            R->sum->n_skip++;
+            djiblas_check_emit_row(R, &j, "skip", 0, 0, 0);
+            continue;
+        }
+        if (!k->fn) {
+            j.y = ref;
+            djiblas_check_call(&j);
+            djiblas_check_emit_row(R, &j, "ref", 0, 0, djiblas_check_time(&j));
+            continue;
+        }
+        j.y = y;
+        // scale = |ref| makes the error ULPs of the value itself.
+        djiblas_check_one(R, &j, ref, ref, (UINT64)n, 0);
+    }
+}
+
+static UINT64 djiblas_check_attn_floats(int hs, int n, int g) {
+    UINT64 nkv = 2ULL * (UINT64)n * (UINT64)hs;
+    return 3ULL * nkv + 4ULL * (UINT64)g * (UINT64)hs + 2ULL * (UINT64)n;
+}
+
+// fp16 / int8 cache rows: encode K and V into Kc / Vc (+ S), then overwrite
+// K and V with the decoded values, so the fp32 reference sees exactly what
+// the kernel reads.
+static void djiblas_check_attn_encode(int kind, int hs, int n, float *K, float *V, void *Kc, void *Vc, float *S) {
+    int ld = 2 * hs;
+    for (int t = 0; t < n; t++) {
+        UINTN off = (UINTN)t * (UINTN)ld;
+        for (int kv = 0; kv < 2; kv++) {
+            float *row = (kv ? V : K) + off;
+            if (kind == DJIBLAS_CHECK_ATTN_F16) {
+                UINT16 *h = (UINT16 *)(kv ? Vc : Kc) + off;
+                djiblas_narrow_f16(row, h, hs);
+                djiblas_widen_f16(h, row, hs);
+            } else {
+                INT8 *c = (INT8 *)(kv ? Vc : Kc) + off;
+                float sc = djiblas_quantize_kv_q8(row, c, hs);
+                S[kv * n + t] = sc;
+                for (int i = 0; i < hs; i++) row[i] = (float)c[i] * sc;
+            }
+        }
+    }
+}
+
+// head_size x n positions, g query heads (1 for the single-head kinds).
+// Buffers: K | V (rows 2 * head_size apart) | q | ref | y | scale (g heads
+// each) | Kc | Vc | S. scale is the same softmax average over |V|, the
+// magnitude the output rounds at.
+static void djiblas_check_attn(DjibCheckRun *R, int kind, int hs, int n, int g, float *scratch,
+                               UINT64 scratch_floats) {
+    UINT64 nkv = 2ULL * (UINT64)n * (UINT64)hs;
+    UINT64 nq = (UINT64)g * (UINT64)hs;
+    int enc = (kind >= DJIBLAS_CHECK_GQA) ? kind - DJIBLAS_CHECK_GQA + DJIBLAS_CHECK_ATTN : kind;
+    BOOLEAN fits = djiblas_check_attn_floats(hs, n, g) <= scratch_floats;
+    float *K = scratch;
+    float *V = K + nkv;
+    float *q = V + nkv;
+    float *ref = q + nq;
+    float *y = ref + nq;
+    float *scale = y + nq;
+    float *Kc = scale + nq;          // nkv halves or bytes each
+    float *Vc = Kc + nkv / 2;
+    float *S = Vc + nkv / 2;
+
+    DjibCheckJob j;
+    j.rows = hs;
+    j.cols = n;
+    j.ntok = g;
+    j.A = K;
+    j.x = q;
+    j.V = V;
+    j.q = 0;
+    j.alpha = 1.0f / (float)hs;   // wider scores than 1/sqrt(hs) on [-1, 1) inputs: exercises the rescale
+    j.Kc = Kc;
+    j.Vc = Vc;
+    j.S = S;
+
+    if (fits) {
+        djiblas_check_fill(K, nkv, 6);
+        djiblas_check_fill(V, nkv, 7);
+        djiblas_check_fill(q, nq, 8);
+        for (UINT64 i = 0; i < nq; i++) q[i] *= 8.0f;
+        if (enc != DJIBLAS_CHECK_ATTN) djiblas_check_attn_encode(enc, hs, n, K, V, Kc, Vc, S);
+    }
+    for (int i = 0; i < DJIBLAS_CHECK_N_KERNELS; i++) {
+        const DjibCheckKernel *k = &k_check_kernels[i];
+        if (k->kind != kind) continue;
+        j.k = k;
+        if (!fits) {
+            R->sum->n_skip++;
+            djiblas_check_emit_row(R, &j, "skip", 0, 0, 0);
+            continue;
+        }
+        if (!k->fn) {
+            for (int h = 0; h < g; h++) djiblas_check_attn_scalar(&j, h, scale + h * hs, TRUE);
+            j.y = ref;
+            djiblas_check_call(&j);
+            djiblas_check_emit_row(R, &j, "ref", 0, 0, djiblas_check_time(&j));
+            continue;
+        }
+        // The vector exp is ~2 ULP and the scores here are small (|s| < 8),
+        // so their rounding moves each weight by a few ULP; the weighted sum
+        // is only reordered (int8 adds one rounding of the row scale per
+        // score and per weight). 32 ULPs leaves room for both.
+        j.y = y;
+        djiblas_check_one(R, &j, ref, scale, nq, 32u);
+    }
+}
+
+// head_size x heads. Buffers: A (q | k) | ref | y | scale | C | S. The
+// pair terms are one product each in double, so scale = |x0 c| + |x1 s|.
+static void djiblas_check_rope(DjibCheckRun *R, int hs, int heads, float *scratch, UINT64 scratch_floats) {
+    UINT64 n = 2ULL * (UINT64)hs * (UINT64)heads;
+    BOOLEAN fits = 4ULL * n + 2ULL * (UINT64)hs <= scratch_floats;
+    float *A = scratch;
+    float *ref = A + n;
+    float *y = ref + n;
+    float *scale = y + n;
+    float *C = scale + n;
+    float *S = C + hs;
+
+    DjibCheckJob j;
+    j.rows = hs;
+    j.cols = heads;
+    j.ntok = 1;
+    j.A = A;
+    j.x = C;
+    j.V = S;
+    j.q = 0;
+    j.alpha = 0.0f;
+    j.Kc = j.Vc = 0;
+    j.S = 0;
+
+    if (fits) {
+        djiblas_check_fill(A, n, 9);
+        djiblas_check_fill(C, (UINT64)hs, 10);
+        djiblas_check_fill(S, (UINT64)hs, 11);
+        for (int i = 0; i < hs; i += 2) {
+            C[i + 1] = C[i];
+            S[i] = -S[i + 1];
+        }
+        for (UINT64 i = 0; i < n; i += 2) {
+            int c = (int)(i % (UINT64)hs);
+            float a0 = A[i] * C[c], a1 = A[i + 1] * S[c + 1];
+            float b0 = A[i + 1] * C[c], b1 = A[i] * S[c + 1];
+            scale[i] = ((a0 < 0.0f) ? -a0 : a0) + ((a1 < 0.0f) ? -a1 : a1);
+            scale[i + 1] = ((b0 < 0.0f) ? -b0 : b0) + ((b1 < 0.0f) ? -b1 : b1);
+        }
+    }
+    for (int i = 0; i < DJIBLAS_CHECK_N_KERNELS; i++) {
+        const DjibCheckKernel *k = &k_check_kernels[i];
+        if (k->kind != DJIBLAS_CHECK_ROPE) continue;
+        j.k = k;
+        if (!fits) {
+            R->sum->n_skip++;
+            djiblas_check_emit_row(R, &j, "skip", 0, 0, 0);
+            continue;
+        }
+        if (!k->fn) {
+            j.y = ref;
+            djiblas_check_call(&j);
+            djiblas_check_emit_row(R, &j, "ref", 0, 0, djiblas_check_time(&j));
+            continue;
+        }
+        // Two products and a sum, fused or not: at most 2 ULPs.
+        j.y = y;
+        djiblas_check_one(R, &j, ref, scale, n, 2u);
+    }
+}
+
+// Floats taken by the encoded weights of one matrix.
+static UINT64 djiblas_check_wmat_wfloats(int kind, UINT64 ne) {
+    return (djiblas_check_weight_bytes(kind, ne) + 3ULL) / 4ULL;
+}
+
+static UINT64 djiblas_check_wmat_floats(int kind, int rows, int cols, int ntok) {
+    UINT64 ne = (UINT64)rows * (UINT64)cols;
+    UINT64 nx = (UINT64)ntok * (UINT64)cols;
+    UINT64 nw = djiblas_check_wmat_wfloats(kind, ne) * (djiblas_check_is_gate_up(kind) ? 2ULL : 1ULL);
+    UINT64 ns = (DJIBLAS_CHECK_Q6_E0 + ne) / DJIBLAS_Q8_BLOCK + 1ULL;
+    return 2ULL * (nx + 2ULL * (UINT64)cols) + nw + ns + nx + nx / 4ULL + nx / DJIBLAS_Q8_BLOCK +
+           3ULL * (UINT64)rows * (UINT64)ntok;
+}
+
+// Encoded weights: random codes in the format's range (int8 without -128,
+// which the quantizers never produce; Q6 in [-31, 31]), halves narrowed from
+// [-1, 1), fp32 in any order since a panel of random values is random.
+static void djiblas_check_wmat_fill(int kind, void *W, UINT64 ne, UINT32 seed) {
+    UINT32 s = seed * 2654435761u + 1u;
+    if (kind == DJIBLAS_CHECK_GEMV_Q8 || kind == DJIBLAS_CHECK_GEMM_Q8) {
+        for (UINT64 e = 0; e < ne; e++) ((INT8 *)W)[e] = (INT8)((INT32)(djiblas_check_rand(&s) % 255u) - 127);
+    } else if (kind == DJIBLAS_CHECK_GEMV_Q4 || kind == DJIBLAS_CHECK_GEMM_Q4) {
+        for (UINT64 e = 0; e < ne / 2ULL; e++) ((UINT8 *)W)[e] = (UINT8)djiblas_check_rand(&s);
+    } else if (djiblas_check_is_q6(kind)) {
+        for (UINT64 e = 0; e < ne; e++) ((INT8 *)W)[e] = (INT8)((INT32)(djiblas_check_rand(&s) % 63u) - 31);
+    } else if (djiblas_check_is_q6p(kind)) {
+        UINT8 *p = (UINT8 *)W;
+        for (UINT64 k = 0; k < ne / 4ULL; k++) {
+            UINT32 v = 0;
+            for (int i = 0; i < 4; i++) {
+                UINT32 q = (UINT32)((INT32)(djiblas_check_rand(&s) % 63u) - 31) & 0x3Fu;
+                v |= q << (6 * i);
+            }
+            p[3 * k] = (UINT8)v;
+            p[3 * k + 1] = (UINT8)(v >> 8);
+            p[3 * k + 2] = (UINT8)(v >> 16);
+        }
+    } else if (kind == DJIBLAS_CHECK_GEMV_F16 || kind == DJIBLAS_CHECK_GEMV_BF16) {
+        UINT16 *h = (UINT16 *)W;
+        for (UINT64 e = 0; e < ne; e++) {
+            union { float f; UINT32 u; } b;
+            b.f = (float)((INT32)djiblas_check_rand(&s) - 32768) * (1.0f / 32768.0f);
+            if (kind == DJIBLAS_CHECK_GEMV_F16) djiblas_narrow_f16(&b.f, h + e, 1);
+            else h[e] = (UINT16)(b.u >> 16);
+        }
+    } else {
+        djiblas_check_fill((float *)W, ne, seed);
+    }
+}
+
+// Quantized / half / panel GEMVs, int8 GEMMs and the fused gate/up kernels
+// over one shape, against a double reference on the decoded weights (for
+// the int8 activation kinds, the decoded xq * xd), so a bug shared by the
+// scalar and SIMD kernels still shows. Buffers: decode (doubles) | W | W3 |
+// scales | x | xq | xd | ref | y | scale.
+static void djiblas_check_wmat(DjibCheckRun *R, int kind, int rows, int cols, int ntok,
+                               float *scratch, UINT64 scratch_floats) {
+    UINT64 ne = (UINT64)rows * (UINT64)cols;
+    UINT64 nx = (UINT64)ntok * (UINT64)cols;
+    UINT64 ny = (UINT64)rows * (UINT64)ntok;
+    UINT64 nw = djiblas_check_wmat_wfloats(kind, ne);
+    UINT64 ns = (DJIBLAS_CHECK_Q6_E0 + ne) / DJIBLAS_Q8_BLOCK + 1ULL;
+    BOOLEAN gate = djiblas_check_is_gate_up(kind);
+    BOOLEAN fits = djiblas_check_wmat_floats(kind, rows, cols, ntok) <= scratch_floats;
+
+    double *dec = (double *)scratch;
+    float *W = scratch + 2ULL * (nx + 2ULL * (UINT64)cols);
+    float *W3 = W + nw;
+    float *Wd = W3 + (gate ? nw : 0ULL);
+    float *X = Wd + ns;
+    INT8 *xq = (INT8 *)(X + nx);
+    float *xd = X + nx + nx / 4ULL;
+    float *ref = xd + nx / DJIBLAS_Q8_BLOCK;
+    float *y = ref + ny;
+    float *scale = y + ny;
+
+    DjibCheckJob j;
+    j.rows = rows;
+    j.cols = cols;
+    j.ntok = ntok;
+    j.A = 0;
+    j.x = X;
+    j.q = 0;
+    j.alpha = 0.0f;
+    j.V = 0;
+    j.Kc = j.Vc = 0;
+    j.S = 0;
+    j.W = W;
+    j.W3 = W3;
+    j.Wd = Wd;
+    j.e0 = (djiblas_check_is_q6(kind) || djiblas_check_is_q6p(kind)) ? DJIBLAS_CHECK_Q6_E0 : 0;
+    j.xq = xq;
+    j.xd = xd;
+    j.dec = dec;
+
+    if (fits) {
+        djiblas_check_wmat_fill(kind, W, ne, 1);
+        if (gate) djiblas_check_wmat_fill(kind, W3, ne, 12);
+        djiblas_check_fill(Wd, ns, 13);
+        djiblas_check_abs(Wd, ns);
+        djiblas_check_fill(X, nx, 2);
+        djiblas_check_fill(xd, nx / DJIBLAS_Q8_BLOCK, 14);
+        djiblas_check_abs(xd, nx / DJIBLAS_Q8_BLOCK);
+        UINT32 s = 15u;
+        for (UINT64 i = 0; i < nx; i++) xq[i] = (INT8)((INT32)(djiblas_check_rand(&s) % 255u) - 127);
+    }
+    for (int i = 0; i < DJIBLAS_CHECK_N_KERNELS; i++) {
+        const DjibCheckKernel *k = &k_check_kernels[i];
+        if (k->kind != kind) continue;
+        j.k = k;
+        if (!fits) {
+            R->sum->n_skip++;
+            djiblas_check_emit_row(R, &j, "skip", 0, 0, 0);
+            continue;
+        }
+        if (!k->fn) {
+            djiblas_check_wmat_ref(&j, scale, TRUE);
+            j.y = ref;
+            djiblas_check_call(&j);
+            djiblas_check_emit_row(R, &j, "ref", 0, 0, djiblas_check_time(&j));
+            continue;
+        }
+        // A reordered cols-term sum (the int8 kinds round a block product
+        // and two scales per 32 terms); gate/up rounds two of them plus the
+        // vector exp, and its scale is their product.
+        j.y = y;
+        djiblas_check_one(R, &j, ref, scale, gate ? (UINT64)rows : ny,
+                          gate ? 2u * djiblas_check_sum_tol(cols) + 8u : djiblas_check_sum_tol(cols));
+    }
+}
+
+// softmax / exp_sum / silu / rmsnorm / residual rmsnorm over n. Buffers:
+// a | b | delta | ref | y | scale (2n + 1 each). Scores and gate inputs span
+// [-8, 8), the rest [-1, 1).
+static void djiblas_check_act(DjibCheckRun *R, int kind, int n, float *scratch, UINT64 scratch_floats) {
+    UINT64 no = 2ULL * (UINT64)n + 1ULL;
+    BOOLEAN fits = 3ULL * (UINT64)n + 3ULL * no <= scratch_floats;
+    float *a = scratch;
+    float *b = a + n;
+    float *delta = b + n;
+    float *ref = delta + n;
+    float *y = ref + no;
+    float *scale = y + no;
+
+    DjibCheckJob j;
+    j.rows = n;
+    j.cols = 0;
+    j.ntok = 1;
+    j.A = a;
+    j.x = b;
+    j.V = delta;
+    j.q = 0;
+    j.alpha = 0.0f;
+    j.Kc = j.Vc = 0;
+    j.S = 0;
+
+    if (fits) {
+        djiblas_check_fill(a, (UINT64)n, 16);
+        djiblas_check_fill(b, (UINT64)n, 17);
+        djiblas_check_fill(delta, (UINT64)n, 18);
+        if (kind == DJIBLAS_CHECK_SOFTMAX || kind == DJIBLAS_CHECK_EXP_SUM || kind == DJIBLAS_CHECK_SILU) {
+            for (int i = 0; i < n; i++) a[i] *= 8.0f;
+        }
+    }
+    UINT64 nout = (kind == DJIBLAS_CHECK_EXP_SUM) ? (UINT64)n + 1ULL
+                : (kind == DJIBLAS_CHECK_RES_RMSNORM) ? 2ULL * (UINT64)n : (UINT64)n;
+    for (int i = 0; i < DJIBLAS_CHECK_N_KERNELS; i++) {
+        const DjibCheckKernel *k = &k_check_kernels[i];
+        if (k->kind != kind) continue;
+        j.k = k;
+        if (!fits) {
+            R->sum->n_skip++;
+            djiblas_check_emit_row(R, &j, "skip", 0, 0, 0);
+            continue;
+        }
+        if (!k->fn) {
+            djiblas_check_act_ref(&j, ref, scale);
+            j.y = y;
+            djiblas_check_emit_row(R, &j, "ref", 0, 0, djiblas_check_time(&j));
+            continue;
+        }
+        // The vector exp and the norm's sqrt / divide are a few ULP; softmax,
+        // exp_sum and the norms also carry the rounding of an n-term sum.
+        j.y = y;
+        djiblas_check_one(R, &j, ref, scale, nout,
+                          (kind == DJIBLAS_CHECK_SILU) ? 8u : 8u + djiblas_check_sum_tol(n));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Entry points
+// ----------------------------------------------------------------------------
+
+UINT64 djiblas_check_scratch_floats(void) {
+    UINT64 need = 0;
+    for (int s = 0; s < DJIBLAS_CHECK_N_MAT; s++) {
+        int r = k_check_mat_shapes[s][0], c = k_check_mat_shapes[s][1];
+        UINT64 g = djiblas_check_mat_floats(r, c, 1);
+        if (g > need) need = g;
+        if (r <= DJIBLAS_CHECK_GEMM_ROWS) {
+            g = djiblas_check_mat_floats(r, c, DJIBLAS_CHECK_NTOK);
+            if (g > need) need = g;
+        }
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_DEQ; s++) {
+        UINT64 g = 2ULL * (UINT64)k_check_deq_lens[s] + (UINT64)k_check_deq_lens[s] / 4ULL + 1ULL;
+        if (g > need) need = g;
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_ATTN; s++) {
+        UINT64 g = djiblas_check_attn_floats(k_check_attn_shapes[s][0], k_check_attn_shapes[s][1],
+                                             DJIBLAS_CHECK_GQA_GROUP);
+        if (g > need) need = g;
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_ROPE; s++) {
+        UINT64 hs = (UINT64)k_check_rope_shapes[s][0];
+        UINT64 g = 8ULL * hs * (UINT64)k_check_rope_shapes[s][1] + 2ULL * hs;
+        if (g > need) need = g;
+    }
+    for (int kind = DJIBLAS_CHECK_GEMV_Q8; kind <= DJIBLAS_CHECK_PANEL16; kind++) {
+        for (int s = 0; s < DJIBLAS_CHECK_N_MAT; s++) {
+            int r = k_check_mat_shapes[s][0], c = k_check_mat_shapes[s][1];
+            int t = (kind == DJIBLAS_CHECK_GEMM_Q8 || kind == DJIBLAS_CHECK_GEMM_Q4) ? DJIBLAS_CHECK_NTOK_Q8 : 1;
+            if (t > 1 && r > DJIBLAS_CHECK_GEMM_ROWS) continue;
+            UINT64 g = djiblas_check_wmat_floats(kind, r, c, t);
+            if (g > need) need = g;
+        }
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_FFN; s++) {
+        UINT64 g = djiblas_check_wmat_floats(DJIBLAS_CHECK_GATE_UP, k_check_ffn_shapes[s][0],
+                                             k_check_ffn_shapes[s][1], 1);
+        if (g > need) need = g;
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_ACT; s++) {
+        UINT64 g = 9ULL * (UINT64)k_check_act_lens[s] + 3ULL;
+        if (g > need) need = g;
+    }
+    return need;
+}
+
+void djiblas_check_run(float *scratch, UINT64 scratch_floats, UINT64 tsc_hz,
+                       djiblas_check_emit_fn emit, void *ctx, DjibLasCheckSummary *out) {
+    DjibLasCheckSummary sum;
+    sum.n_run = 0;
+    sum.n_fail = 0;
+    sum.n_skip = 0;
+
+    DjibCheckRun R;
+    R.emit = emit;
+    R.ctx = ctx;
+    R.tsc_hz = tsc_hz;
+    R.isa = djiblas_check_isa(&g_djiblas.cpu);
+    R.sum = &sum;
+
+    emit(ctx, DJIBLAS_CHECK_CSV_HEADER "\n");
+    for (int s = 0; s < DJIBLAS_CHECK_N_MAT; s++) {
+        djiblas_check_mat(&R, DJIBLAS_CHECK_GEMV, k_check_mat_shapes[s][0], k_check_mat_shapes[s][1], 1,
+                          scratch, scratch_floats);
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_MAT; s++) {
+        if (k_check_mat_shapes[s][0] > DJIBLAS_CHECK_GEMM_ROWS) continue;
+        djiblas_check_mat(&R, DJIBLAS_CHECK_GEMM, k_check_mat_shapes[s][0], k_check_mat_shapes[s][1],
+                          DJIBLAS_CHECK_NTOK, scratch, scratch_floats);
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_VEC; s++) {
+        djiblas_check_vec(&R, DJIBLAS_CHECK_DOT, k_check_vec_lens[s], scratch, scratch_floats);
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_VEC; s++) {
+        djiblas_check_vec(&R, DJIBLAS_CHECK_AXPY, k_check_vec_lens[s], scratch, scratch_floats);
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_DEQ; s++) {
+        djiblas_check_deq(&R, k_check_deq_lens[s], scratch, scratch_floats);
+    }
+    for (int kind = DJIBLAS_CHECK_ATTN; kind <= DJIBLAS_CHECK_ATTN_Q8; kind++) {
+        for (int s = 0; s < DJIBLAS_CHECK_N_ATTN; s++) {
+            djiblas_check_attn(&R, kind, k_check_attn_shapes[s][0], k_check_attn_shapes[s][1], 1,
+                               scratch, scratch_floats);
+        }
+    }
+    for (int kind = DJIBLAS_CHECK_GQA; kind <= DJIBLAS_CHECK_GQA_Q8; kind++) {
+        for (int s = 0; s < DJIBLAS_CHECK_N_ATTN; s++) {
+            djiblas_check_attn(&R, kind, k_check_attn_shapes[s][0], k_check_attn_shapes[s][1],
+                               DJIBLAS_CHECK_GQA_GROUP, scratch, scratch_floats);
+        }
+    }
+    for (int s = 0; s < DJIBLAS_CHECK_N_ROPE; s++) {
+        djiblas_check_rope(&R, k_check_rope_shapes[s][0], k_check_rope_shapes[s][1], scratch, scratch_floats);
+    }
+    for (int kind = DJIBLAS_CHECK_GEMV_Q8; kind <= DJIBLAS_CHECK_PANEL16; kind++) {
+        BOOLEAN gemm = (kind == DJIBLAS_CHECK_GEMM_Q8 || kind == DJIBLAS_CHECK_GEMM_Q4);
+        for (int s = 0; s < DJIBLAS_CHECK_N_MAT; s++) {
+            if (gemm && k_check_mat_shapes[s][0] > DJIBLAS_CHECK_GEMM_ROWS) continue;
+            djiblas_check_wmat(&R, kind, k_check_mat_shapes[s][0], k_check_mat_shapes[s][1],
+                               gemm ? DJIBLAS_CHECK_NTOK_Q8 : 1, scratch, scratch_floats);
+        }
+    }
+    for (int kind = DJIBLAS_CHECK_GATE_UP; kind <= DJIBLAS_CHECK_GATE_UP16; kind++) {
+        for (int s = 0; s < DJIBLAS_CHECK_N_FFN; s++) {
+            djiblas_check_wmat(&R, kind, k_check_ffn_shapes[s][0], k_check_ffn_shapes[s][1], 1,
+                               scratch, scratch_floats);
+        }
+    }
+    for (int kind = DJIBLAS_CHECK_SOFTMAX; kind <= DJIBLAS_CHECK_RES_RMSNORM; kind++) {
+        for (int s = 0; s < DJIBLAS_CHECK_N_ACT; s++) {
+            djiblas_check_act(&R, kind, k_check_act_lens[s], scratch, scratch_floats);
+        }
+    }
+    if (out) *out = sum;
+}
@@ -0,0 +1,181 @@
+/*
+ * DjibLAS - fp16 weight GEMV and fp16 KV attention (built with -mavx2 -mfma -mf16c)
+ *
+ * Own translation unit so that F16C code is only ever reached through the
+ * dispatch table: djiblas.c selects it when CPUID reports AVX2, FMA and
+ * F16C (AVX-512F CPUs take the vcvtph2ps ZMM kernel in djiblas_avx512.c).
+ * Eight halves are widened per vcvtph2ps and accumulated in fp32.
+ */
+
+#include "djiblas.h"
+#include "djiblas_vmath.h"
+
+#if defined(__F16C__) && defined(__AVX2__)
+#include <immintrin.h>
+
+void djiblas_gemv_f16_f16c(int d, int n, const UINT16 *W, const float *x, float *y) {
+    for (int i = 0; i < d; i++) {
+        const UINT16 *w = W + (UINTN)i * (UINTN)n;
+        __m256 s0 = _mm256_setzero_ps();
+        __m256 s1 = _mm256_setzero_ps();
+        int l = 0;
+        for (; l + 16 <= n; l += 16) {
+            __m256 f0 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(w + l)));
+            __m256 f1 = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(w + l + 8)));
+            s0 = _mm256_fmadd_ps(f0, _mm256_loadu_ps(x + l), s0);
+            s1 = _mm256_fmadd_ps(f1, _mm256_loadu_ps(x + l + 8), s1);
+        }
+        float sum = djiblas_hsum256_ps(_mm256_add_ps(s0, s1));
+        for (; l < n; l++) {
+            float t;
+            djiblas_widen_f16(w + l, &t, 1);
+            sum += t * x[l];
+        }
+        y[i] = sum;
+    }
+}
+
+static inline __m256 kv_f16_load8(const UINT16 *p) {
+    return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)p));
+}
+
+// djiblas_attn_avx2 over an fp16 cache (see djiblas_avx2.c): same tiles and
+// register accumulator, each K/V chunk widened by one vcvtph2ps.
+static inline __attribute__((always_inline)) void attn_f16_nv(const float *q, const UINT16 *K, const UINT16 *V,
+                                                              int ld, int n, float scale, float *out,
+                                                              const int NV) {
+    __m256 acc[16];
+    for (int c = 0; c < NV; c++) acc[c] = _mm256_setzero_ps();
+    const __m256 vscale = _mm256_set1_ps(scale);
+    float p[DJIBLAS_ATTN_TILE];
+    float m = DJIBLAS_EXP_PAD;
+    float l = 0.0f;
+    for (int t0 = 0; t0 < n; t0 += DJIBLAS_ATTN_TILE) {
+        int nt = (n - t0 < DJIBLAS_ATTN_TILE) ? n - t0 : DJIBLAS_ATTN_TILE;
+        const UINT16 *k = K + (UINTN)t0 * (UINTN)ld;
+        const UINT16 *v = V + (UINTN)t0 * (UINTN)ld;
+        __m256 s;
+        if (nt == DJIBLAS_ATTN_TILE) {
+            __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+            __m256 c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps();
+            __m256 c4 = _mm256_setzero_ps(), c5 = _mm256_setzero_ps();
+            __m256 c6 = _mm256_setzero_ps(), c7 = _mm256_setzero_ps();
+            for (int c = 0; c < NV; c++) {
+                const __m256 qv = _mm256_loadu_ps(q + 8 * c);
+                const UINT16 *kc = k + 8 * c;
+                c0 = _mm256_fmadd_ps(kv_f16_load8(kc + (UINTN)ld * 0), qv, c0);
+                c1 = _mm256_fmadd_ps(kv_f16_load8(kc + (UINTN)ld * 1), qv, c1);
+                c2 = _mm256_fmadd_ps(kv_f16_load8(kc + (UINTN)ld * 2), qv, c2);
+                c3 = _mm256_fmadd_ps(kv_f16_load8(kc + (UINTN)ld * 3), qv, c3);
+                c4 = _mm256_fmadd_ps(kv_f16_load8(kc + (UINTN)ld * 4), qv, c4);
+                c5 = _mm256_fmadd_ps(kv_f16_load8(kc + (UINTN)ld * 5), qv, c5);
+                c6 = _mm256_fmadd_ps(kv_f16_load8(kc + (UINTN)ld * 6), qv, c6);
+                c7 = _mm256_fmadd_ps(kv_f16_load8(kc + (UINTN)ld * 7), qv, c7);
+            }
+            s = _mm256_mul_ps(djiblas_hsum8x8_ps(c0, c1, c2, c3, c4, c5, c6, c7), vscale);
+        } else {
+            for (int j = 0; j < DJIBLAS_ATTN_TILE; j++) {
+                p[j] = DJIBLAS_EXP_PAD;
+                if (j < nt) {
+                    __m256 c0 = _mm256_setzero_ps();
+                    for (int c = 0; c < NV; c++) {
+                        c0 = _mm256_fmadd_ps(kv_f16_load8(k + (UINTN)j * (UINTN)ld + 8 * c),
+                                             _mm256_loadu_ps(q + 8 * c), c0);
+                    }
+                    p[j] = djiblas_hsum256_ps(c0) * scale;
+                }
+            }
+            s = _mm256_loadu_ps(p);
+        }
+
+        float tm = djiblas_hmax256_ps(s);
+        if (tm > m) {
+            __m256 corr = djiblas_exp256_ps(_mm256_set1_ps(m - tm));
+            for (int c = 0; c < NV; c++) acc[c] = _mm256_mul_ps(acc[c], corr);
+            l *= _mm256_cvtss_f32(corr);
+            m = tm;
+        }
+        __m256 e = djiblas_exp256_ps(_mm256_sub_ps(s, _mm256_set1_ps(m)));
+        l += djiblas_hsum256_ps(e);
+        _mm256_storeu_ps(p, e);
+
+        for (int j = 0; j < nt; j++) {
+            const __m256 pj = _mm256_broadcast_ss(p + j);
+            const UINT16 *vj = v + (UINTN)j * (UINTN)ld;
+            for (int c = 0; c < NV; c++) acc[c] = _mm256_fmadd_ps(pj, kv_f16_load8(vj + 8 * c), acc[c]);
+        }
+    }
+    const __m256 inv = _mm256_set1_ps((l > 0.0f) ? 1.0f / l : 0.0f);
+    for (int c = 0; c < NV; c++) _mm256_storeu_ps(out + 8 * c, _mm256_mul_ps(acc[c], inv));
+}
+
+void djiblas_attn_f16_f16c(const float *q, const UINT16 *K, const UINT16 *V, int ld, int n,
+                           int head_size, float scale, float *out) {
+#define DJIBLAS_ATTN_NV(nv) case nv: attn_f16_nv(q, K, V, ld, n, scale, out, nv); return
+    if ((head_size & 7) == 0) {
+        switch (head_size >> 3) {
+        DJIBLAS_ATTN_NV(1);  DJIBLAS_ATTN_NV(2);  DJIBLAS_ATTN_NV(3);  DJIBLAS_ATTN_NV(4);
+        DJIBLAS_ATTN_NV(5);  DJIBLAS_ATTN_NV(6);  DJIBLAS_ATTN_NV(7);  DJIBLAS_ATTN_NV(8);
+        DJIBLAS_ATTN_NV(9);  DJIBLAS_ATTN_NV(10); DJIBLAS_ATTN_NV(11); DJIBLAS_ATTN_NV(12);
+        DJIBLAS_ATTN_NV(13); DJIBLAS_ATTN_NV(14); DJIBLAS_ATTN_NV(15); DJIBLAS_ATTN_NV(16);
+        default: break;
+        }
+    }
+#undef DJIBLAS_ATTN_NV
+    djiblas_attn_f16_sse2(q, K, V, ld, n, head_size, scale, out);
+}
+
+// Grouped-query attention over an fp16 cache (see attn_gqa_avx2 in
+// djiblas_avx2.c): each tile is widened once into kt / vt and shared by
+// all heads of the group.
+void djiblas_attn_gqa_f16_f16c(const float *q, int g, const UINT16 *K, const UINT16 *V, int ld, int n,
+                               int head_size, float scale, float *out) {
+    if ((head_size & 7) || head_size > DJIBLAS_ATTN_MAX_HEAD) {
+        djiblas_attn_gqa_f16_sse2(q, g, K, V, ld, n, head_size, scale, out);
+        return;
+    }
+    float kt[DJIBLAS_ATTN_TILE * DJIBLAS_ATTN_MAX_HEAD];
+    float vt[DJIBLAS_ATTN_TILE * DJIBLAS_ATTN_MAX_HEAD];
+    float m[DJIBLAS_ATTN_MAX_GROUP];
+    float l[DJIBLAS_ATTN_MAX_GROUP];
+    for (int gc; g > 0; g -= gc, q += gc * head_size, out += gc * head_size) {
+        gc = (g < DJIBLAS_ATTN_MAX_GROUP) ? g : DJIBLAS_ATTN_MAX_GROUP;
+        for (int i = 0; i < gc * head_size; i++) out[i] = 0.0f;
+        for (int i = 0; i < gc; i++) {
+            m[i] = DJIBLAS_EXP_PAD;
+            l[i] = 0.0f;
+        }
+        for (int t0 = 0; t0 < n; t0 += DJIBLAS_ATTN_TILE) {
+            int nt = (n - t0 < DJIBLAS_ATTN_TILE) ? n - t0 : DJIBLAS_ATTN_TILE;
+            for (int j = 0; j < nt; j++) {
+                UINTN off = (UINTN)(t0 + j) * (UINTN)ld;
+                for (int d = 0; d < head_size; d += 8) {
+                    _mm256_storeu_ps(kt + j * head_size + d, kv_f16_load8(K + off + d));
+                    _mm256_storeu_ps(vt + j * head_size + d, kv_f16_load8(V + off + d));
+                }
+            }
+            djiblas_attn_group_tile256(q, gc, kt, head_size, vt, head_size, nt, head_size, scale, m, l, out);
+        }
+        for (int i = 0; i < gc; i++) {
+            const __m256 inv = _mm256_set1_ps((l[i] > 0.0f) ? 1.0f / l[i] : 0.0f);
+            float *oi = out + i * head_size;
+            for (int d = 0; d < head_size; d += 8) _mm256_storeu_ps(oi + d, _mm256_mul_ps(_mm256_loadu_ps(oi + d), inv));
+        }
+    }
+}
+
+#else
+void djiblas_gemv_f16_f16c(int d, int n, const UINT16 *W, const float *x, float *y) {
+    djiblas_gemv_f16_sse2(d, n, W, x, y);
+}
+
+void djiblas_attn_f16_f16c(const float *q, const UINT16 *K, const UINT16 *V, int ld, int n,
+                           int head_size, float scale, float *out) {
+    djiblas_attn_f16_sse2(q, K, V, ld, n, head_size, scale, out);
+}
+
+void djiblas_attn_gqa_f16_f16c(const float *q, int g, const UINT16 *K, const UINT16 *V, int ld, int n,
+                               int head_size, float scale, float *out) {
+    djiblas_attn_gqa_f16_sse2(q, g, K, V, ld, n, head_size, scale, out);
+}
+#endif
@@ -0,0 +1,389 @@
+/*
+ * DjibLAS - boot-time autotuner
+ *
+ * The dispatch table picks kernels by ISA flags alone, but the fastest GEMV
+ * unroll, SGEMM tile and prefill row block differ between Skylake-SP, Zen
+ * and QEMU TCG. This unit times the candidates with rdtsc on the model's own
+ * weights, keeps the fastest per (layout, rows, cols) and round-trips the
+ * result through a small ASCII profile (djiblas.tune on the boot volume).
+ *
+ * Built with the baseline flags: AVX2 / AVX-512 candidates are only reached
+ * through their function pointers, after the ISA check below.
+ */
+
+#include "djiblas.h"
+
+typedef struct {
+    const char *name;
+    sgemv_kernel_t fn;
+    UINT32 isa;
+    BOOLEAN stream;         // prefetch-ahead kernel: only for M->stream tensors
+} DjibTuneGemv;
+
+typedef struct {
+    const char *name;
+    sgemm_kernel_t fn;
+    UINT32 isa;
+} DjibTuneGemm;
+
+// Names are the on-disk identifiers: append new candidates, never rename.
+static const DjibTuneGemv k_tune_gemv[] = {
+    { "sse2x4",      djiblas_sgemv_sse2,        DJIBLAS_TUNE_ISA_SSE2,   FALSE },
+    { "avx2x8",      djiblas_sgemv_avx2,        DJIBLAS_TUNE_ISA_AVX2,   FALSE },
+    { "avx2x4",      djiblas_sgemv4_avx2,       DJIBLAS_TUNE_ISA_AVX2,   FALSE },
+    { "avx512x8",    djiblas_sgemv_avx512,      DJIBLAS_TUNE_ISA_AVX512, FALSE },
+    { "avx2x8_pf",   djiblas_sgemv_stream_avx2, DJIBLAS_TUNE_ISA_AVX2,   TRUE },
+};
+
+static const DjibTuneGemm k_tune_gemm[] = {
+    { "sse2_1x1",   djiblas_sgemm_sse2,     DJIBLAS_TUNE_ISA_SSE2 },
+    { "avx2_3x4",   djiblas_sgemm_avx2,     DJIBLAS_TUNE_ISA_AVX2 },
+    { "avx2_2x4",   djiblas_sgemm_avx2_2x4, DJIBLAS_TUNE_ISA_AVX2 },
+    { "avx512_4x4", djiblas_sgemm_avx512,   DJIBLAS_TUNE_ISA_AVX512 },
+};
+
+// Rows per token-inner prefill block (panel layouts round down to whole panels).
+static const int k_tune_row_blocks[] = { 8, 16, 32, 64, 128 };
+
+#define DJIBLAS_TUNE_N_GEMV   ((int)(sizeof(k_tune_gemv) / sizeof(k_tune_gemv[0])))
+#define DJIBLAS_TUNE_N_GEMM   ((int)(sizeof(k_tune_gemm) / sizeof(k_tune_gemm[0])))
+#define DJIBLAS_TUNE_N_BLOCKS ((int)(sizeof(k_tune_row_blocks) / sizeof(k_tune_row_blocks[0])))
+
+// Timed repetitions per candidate (after one warm-up call); the minimum wins.
+#define DJIBLAS_TUNE_REPS 5
+
+static inline UINT64 djiblas_tune_rdtsc(void) {
+#if defined(__x86_64__) || defined(_M_X64)
+    UINT32 lo, hi;
+    __asm__ volatile("lfence\nrdtsc" : "=a"(lo), "=d"(hi) :: "memory");
+    return ((UINT64)hi << 32) | (UINT64)lo;
+#else
+    return 0;
+#endif
+}
+
+static UINT32 djiblas_tune_isa(const CPUFeatures *f) {
+    UINT32 isa = 0;
+    if (f->has_sse2) isa |= DJIBLAS_TUNE_ISA_SSE2;
+    if (f->has_avx2 && f->has_fma) isa |= DJIBLAS_TUNE_ISA_AVX2;
+    if (f->has_avx512f) isa |= DJIBLAS_TUNE_ISA_AVX512;
+    return isa;
+}
+
+static BOOLEAN djiblas_tune_row_blocked(int type) {
+    return type == DJIBLAS_MAT_F32_PANEL || type == DJIBLAS_MAT_Q6 || type == DJIBLAS_MAT_Q6P ||
+           type == DJIBLAS_MAT_F16 || type == DJIBLAS_MAT_BF16;
+}
+
+void djiblas_tune_init(DjibLasTuneProfile *P) {
+    P->cpu_signature = g_djiblas.cpu.signature;
+    P->isa = djiblas_tune_isa(&g_djiblas.cpu);
+    P->n = 0;
+}
+
+static DjibLasTuneEntry *djiblas_tune_lookup(DjibLasTuneProfile *P, int type, int rows, int cols) {
+    for (int i = 0; i < P->n; i++) {
+        DjibLasTuneEntry *e = &P->e[i];
+        if (e->type == type && e->rows == rows && e->cols == cols) return e;
+    }
+    return 0;
+}
+
+const DjibLasTuneEntry *djiblas_tune_find(const DjibLasTuneProfile *P, const DjibLasMatrix *M) {
+    return djiblas_tune_lookup((DjibLasTuneProfile *)P, M->type, M->rows, M->cols);
+}
+
+UINT64 djiblas_tune_scratch_floats(const DjibLasMatrix *M, int ntok) {
+    UINT64 per_tok = (UINT64)M->rows + (UINT64)M->cols;
+    return per_tok * (UINT64)(ntok > 1 ? ntok : 1);
+}
+
+// Minimum over DJIBLAS_TUNE_REPS of one GEMV (ntok == 0) or one prefill
+// block GEMM, rotating the layer each repetition.
+static UINT64 djiblas_tune_time(const DjibLasMatrix *T, int n_layers, int ntok,
+                                const float *X, float *Y) {
+    UINT64 best = ~0ULL;
+    for (int r = 0; r <= DJIBLAS_TUNE_REPS; r++) {
+        int layer = r % n_layers;
+        UINT64 t0 = djiblas_tune_rdtsc();
+        if (ntok == 0) djiblas_gemv_rows(T, layer, 0, T->rows, X, Y);
+        else djiblas_gemm_rows(T, layer, 0, T->rows, X, T->cols, ntok, Y, T->rows);
+        UINT64 dt = djiblas_tune_rdtsc() - t0;
+        if (r > 0 && dt < best) best = dt;   // r == 0 is the warm-up
+    }
+    return best;
+}
+
+BOOLEAN djiblas_tune_matrix(DjibLasTuneProfile *P, const DjibLasMatrix *M, int n_layers, int ntok,
+                            float *scratch, UINT64 scratch_floats) {
+    BOOLEAN f32 = (M->type == DJIBLAS_MAT_F32);
+    BOOLEAN blocked = djiblas_tune_row_blocked(M->type) && ntok > 0;
+    if (!f32 && !blocked) return FALSE;
+    if (M->type == DJIBLAS_MAT_F32_PANEL && !g_djiblas.gemv_panel) return FALSE;
+    if (P->n >= DJIBLAS_TUNE_MAX_SHAPES || !scratch) return FALSE;
+    if (scratch_floats < djiblas_tune_scratch_floats(M, ntok)) return FALSE;
+    if (djiblas_tune_rdtsc() == 0) return FALSE;
+    if (n_layers < 1) n_layers = 1;
+
+    // Activations: small, normal values (denormals would skew the timings).
+    int nt = ntok > 1 ? ntok : 1;
+    float *X = scratch;
+    float *Y = scratch + (UINTN)nt * (UINTN)M->cols;
+    for (UINTN i = 0; i < (UINTN)nt * (UINTN)M->cols; i++) {
+        X[i] = (float)((int)(i % 13) - 6) * 0.01f;
+    }
+
+    DjibLasTuneEntry e;
+    e.type = M->type;
+    e.rows = M->rows;
+    e.cols = M->cols;
+    e.gemv = -1;
+    e.sgemm = -1;
+    e.row_block = 0;
+    e.gemv_cycles = 0;
+    e.gemm_cycles = 0;
+
+    DjibLasMatrix T = *M;
+    T.gemv = 0;
+    T.sgemm = 0;
+    T.row_block = 0;
+
+    if (f32) {
+        for (int c = 0; c < DJIBLAS_TUNE_N_GEMV; c++) {
+            if ((k_tune_gemv[c].isa & P->isa) != k_tune_gemv[c].isa) continue;
+            if (k_tune_gemv[c].stream && !M->stream) continue;
+            T.gemv = k_tune_gemv[c].fn;
+            UINT64 t = djiblas_tune_time(&T, n_layers, 0, X, Y);
+            if (e.gemv < 0 || t < e.gemv_cycles) {
+                e.gemv = c;
+                e.gemv_cycles = t;
+            }
+        }
+        for (int c = 0; c < DJIBLAS_TUNE_N_GEMM && ntok > 0; c++) {
+            if ((k_tune_gemm[c].isa & P->isa) != k_tune_gemm[c].isa) continue;
+            T.sgemm = k_tune_gemm[c].fn;
+            UINT64 t = djiblas_tune_time(&T, n_layers, ntok, X, Y);
+            if (e.sgemm < 0 || t < e.gemm_cycles) {
+                e.sgemm = c;
+                e.gemm_cycles = t;
+            }
+        }
+        if (e.gemv < 0) return FALSE;
+    } else {
+        for (int c = 0; c < DJIBLAS_TUNE_N_BLOCKS; c++) {
+            T.row_block = k_tune_row_blocks[c];
+            UINT64 t = djiblas_tune_time(&T, n_layers, ntok, X, Y);
+            if (e.row_block == 0 || t < e.gemm_cycles) {
+                e.row_block = k_tune_row_blocks[c];
+                e.gemm_cycles = t;
+            }
+        }
+    }
+
+    P->e[P->n++] = e;
+    return TRUE;
+}
+
+void djiblas_tune_apply(const DjibLasTuneProfile *P, DjibLasMatrix *M) {
+    const DjibLasTuneEntry *e = djiblas_tune_find(P, M);
+    if (!e) return;
+    if (e->gemv >= 0 && e->gemv < DJIBLAS_TUNE_N_GEMV && (M->stream || !k_tune_gemv[e->gemv].stream)) {
+        M->gemv = k_tune_gemv[e->gemv].fn;
+    }
+    if (e->sgemm >= 0 && e->sgemm < DJIBLAS_TUNE_N_GEMM) M->sgemm = k_tune_gemm[e->sgemm].fn;
+    if (e->row_block > 0) M->row_block = e->row_block;
+}
+
+const char *djiblas_tune_gemv_name(int idx) {
+    return (idx >= 0 && idx < DJIBLAS_TUNE_N_GEMV) ? k_tune_gemv[idx].name : "-";
+}
+
+const char *djiblas_tune_sgemm_name(int idx) {
+    return (idx >= 0 && idx < DJIBLAS_TUNE_N_GEMM) ? k_tune_gemm[idx].name : "-";
+}
+
+static const char *const k_tune_type_names[] = {
+    "f32", "panel", "q8", "q6", "q6p", "q4", "f16", "bf16",
+};
+
+const char *djiblas_tune_type_name(int type) {
+    int n = (int)(sizeof(k_tune_type_names) / sizeof(k_tune_type_names[0]));
+    return (type >= 0 && type < n) ? k_tune_type_names[type] : "?";
+}
+
+// ===================================================================
+// PROFILE TEXT FORMAT
+// ===================================================================
+//   # comment
+//   cpu=000806EC isa=3
+//   f32 864x288 gemv=avx2x8 gemm=avx2_3x4
+//   panel 768x288 block=32
+
+static int djiblas_tune_put(char *buf, int cap, int pos, const char *s) {
+    while (*s && pos + 1 < cap) buf[pos++] = *s++;
+    return pos;
+}
+
+static int djiblas_tune_put_u32(char *buf, int cap, int pos, UINT32 v, int base, int min_digits) {
+    char tmp[12];
+    int n = 0;
+    do {
+        UINT32 d = v % (UINT32)base;
+        tmp[n++] = (char)(d < 10 ? '0' + d : 'A' + (d - 10));
+        v /= (UINT32)base;
+    } while (v && n < (int)sizeof(tmp));
+    while (n < min_digits && n < (int)sizeof(tmp)) tmp[n++] = '0';
+    while (n > 0 && pos + 1 < cap) buf[pos++] = tmp[--n];
+    return pos;
+}
+
+int djiblas_tune_format(const DjibLasTuneProfile *P, char *buf, int cap) {
+    int pos = 0;
+    if (!buf || cap <= 0) return 0;
+    pos = djiblas_tune_put(buf, cap, pos, "# djiblas.tune - boot autotune profile (delete to re-measure)\n");
+    pos = djiblas_tune_put(buf, cap, pos, "cpu=");
+    pos = djiblas_tune_put_u32(buf, cap, pos, P->cpu_signature, 16, 8);
+    pos = djiblas_tune_put(buf, cap, pos, " isa=");
+    pos = djiblas_tune_put_u32(buf, cap, pos, P->isa, 10, 1);
+    pos = djiblas_tune_put(buf, cap, pos, "\n");
+    for (int i = 0; i < P->n; i++) {
+        const DjibLasTuneEntry *e = &P->e[i];
+        pos = djiblas_tune_put(buf, cap, pos, djiblas_tune_type_name(e->type));
+        pos = djiblas_tune_put(buf, cap, pos, " ");
+        pos = djiblas_tune_put_u32(buf, cap, pos, (UINT32)e->rows, 10, 1);
+        pos = djiblas_tune_put(buf, cap, pos, "x");
+        pos = djiblas_tune_put_u32(buf, cap, pos, (UINT32)e->cols, 10, 1);
+        if (e->gemv >= 0) {
+            pos = djiblas_tune_put(buf, cap, pos, " gemv=");
+            pos = djiblas_tune_put(buf, cap, pos, djiblas_tune_gemv_name(e->gemv));
+        }
+        if (e->sgemm >= 0) {
+            pos = djiblas_tune_put(buf, cap, pos, " gemm=");
+            pos = djiblas_tune_put(buf, cap, pos, djiblas_tune_sgemm_name(e->sgemm));
+        }
+        if (e->row_block > 0) {
+            pos = djiblas_tune_put(buf, cap, pos, " block=");
+            pos = djiblas_tune_put_u32(buf, cap, pos, (UINT32)e->row_block, 10, 1);
+        }
+        pos = djiblas_tune_put(buf, cap, pos, "\n");
+    }
+    buf[pos] = 0;
+    return pos;
+}
+
+// Token [s, s+n) equals the NUL-terminated string z.
+static BOOLEAN djiblas_tune_tok_eq(const char *s, int n, const char *z) {
+    int i = 0;
+    for (; i < n; i++) {
+        if (z[i] == 0 || z[i] != s[i]) return FALSE;
+    }
+    return z[i] == 0;
+}
+
+// Parse digits of s[0..n) in base 10 or 16; FALSE on any other character.
+static BOOLEAN djiblas_tune_parse_u32(const char *s, int n, int base, UINT32 *out) {
+    UINT32 v = 0;
+    if (n <= 0) return FALSE;
+    for (int i = 0; i < n; i++) {
+        char c = s[i];
+        UINT32 d;
+        if (c >= '0' && c <= '9') d = (UINT32)(c - '0');
+        else if (base == 16 && c >= 'a' && c <= 'f') d = (UINT32)(c - 'a' + 10);
+        else if (base == 16 && c >= 'A' && c <= 'F') d = (UINT32)(c - 'A' + 10);
+        else return FALSE;
+        v = v * (UINT32)base + d;
+    }
+    *out = v;
+    return TRUE;
+}
+
+// Entries go straight into P; djiblas_tune_parse empties it on FALSE.
+static BOOLEAN djiblas_tune_parse_lines(DjibLasTuneProfile *P, const char *buf, int len) {
+    BOOLEAN have_cpu = FALSE;
+    UINT32 cpu = 0, isa = 0;
+    int pos = 0;
+    P->n = 0;
+
+    while (pos < len) {
+        int eol = pos;
+        while (eol < len && buf[eol] != '\n') eol++;
+
+        // Split the line into up to 8 whitespace-separated tokens.
+        const char *tok[8];
+        int tlen[8];
+        int nt = 0;
+        int i = pos;
+        while (i < eol && nt < 8) {
+            while (i < eol && (buf[i] == ' ' || buf[i] == '\t' || buf[i] == '\r')) i++;
+            if (i >= eol) break;
+            int s = i;
+            while (i < eol && buf[i] != ' ' && buf[i] != '\t' && buf[i] != '\r') i++;
+            tok[nt] = buf + s;
+            tlen[nt] = i - s;
+            nt++;
+        }
+        pos = eol + 1;
+        if (nt == 0 || tok[0][0] == '#') continue;
+
+        if (tlen[0] > 4 && djiblas_tune_tok_eq(tok[0], 4, "cpu=")) {
+            if (nt < 2 || tlen[1] < 5 || !djiblas_tune_tok_eq(tok[1], 4, "isa=")) return FALSE;
+            if (!djiblas_tune_parse_u32(tok[0] + 4, tlen[0] - 4, 16, &cpu)) return FALSE;
+            if (!djiblas_tune_parse_u32(tok[1] + 4, tlen[1] - 4, 10, &isa)) return FALSE;
+            have_cpu = TRUE;
+            continue;
+        }
+
+        // <type> <rows>x<cols> key=value...
+        if (nt < 2 || P->n >= DJIBLAS_TUNE_MAX_SHAPES) return FALSE;
+        DjibLasTuneEntry e;
+        e.type = -1;
+        for (int t = 0; t < (int)(sizeof(k_tune_type_names) / sizeof(k_tune_type_names[0])); t++) {
+            if (djiblas_tune_tok_eq(tok[0], tlen[0], k_tune_type_names[t])) e.type = t;
+        }
+        int x = 0;
+        while (x < tlen[1] && tok[1][x] != 'x') x++;
+        UINT32 rows, cols;
+        if (e.type < 0 || x >= tlen[1] ||
+            !djiblas_tune_parse_u32(tok[1], x, 10, &rows) ||
+            !djiblas_tune_parse_u32(tok[1] + x + 1, tlen[1] - x - 1, 10, &cols)) {
+            return FALSE;
+        }
+        e.rows = (int)rows;
+        e.cols = (int)cols;
+        e.gemv = -1;
+        e.sgemm = -1;
+        e.row_block = 0;
+        e.gemv_cycles = 0;
+        e.gemm_cycles = 0;
+        for (int t = 2; t < nt; t++) {
+            const char *v = tok[t];
+            int vn = tlen[t];
+            if (vn > 5 && djiblas_tune_tok_eq(v, 5, "gemv=")) {
+                for (int c = 0; c < DJIBLAS_TUNE_N_GEMV; c++) {
+                    if (djiblas_tune_tok_eq(v + 5, vn - 5, k_tune_gemv[c].name)) e.gemv = c;
+                }
+            } else if (vn > 5 && djiblas_tune_tok_eq(v, 5, "gemm=")) {
+                for (int c = 0; c < DJIBLAS_TUNE_N_GEMM; c++) {
+                    if (djiblas_tune_tok_eq(v + 5, vn - 5, k_tune_gemm[c].name)) e.sgemm = c;
+                }
+            } else if (vn > 6 && djiblas_tune_tok_eq(v, 6, "block=")) {
+                UINT32 b;
+                if (djiblas_tune_parse_u32(v + 6, vn - 6, 10, &b) && b > 0 && b <= 4096) e.row_block = (int)b;
+            }
+        }
+        // A kernel this CPU cannot run never gets applied.
+        if (e.gemv >= 0 && (k_tune_gemv[e.gemv].isa & P->isa) != k_tune_gemv[e.gemv].isa) e.gemv = -1;
+        if (e.sgemm >= 0 && (k_tune_gemm[e.sgemm].isa & P->isa) != k_tune_gemm[e.sgemm].isa) e.sgemm = -1;
+        P->e[P->n++] = e;
+    }
+
+    return have_cpu && cpu == P->cpu_signature && isa == P->isa;
+}
+
+BOOLEAN djiblas_tune_parse(DjibLasTuneProfile *P, const char *buf, int len) {
+    // A malformed line or another CPU's profile leaves P empty, never with
+    // the entries read before the bad line.
+    if (djiblas_tune_parse_lines(P, buf, len)) return TRUE;
+    P->n = 0;
+    return FALSE;
+}
@@ -0,0 +1,223 @@
+/*
+ * DjibLAS - vector math helpers (exp, SiLU, grouped attention tile)
+ *
+ * Header-only, included after djiblas.h by djiblas.c (SSE2) and the per-ISA
+ * translation units (AVX2, F16C, AVX-512, VNNI, attention). Each section is
+ * only compiled when that unit is built with the matching -m flags, so the
+ * SSE2-only parts of the binary never see AVX code.
+ *
+ * exp: range reduction x = n*ln2 + r, |r| <= ln2/2, degree-5 polynomial for
+ * e^r, then 2^n through the exponent bits. Relative error ~2 ULP over the
+ * clamped range [-87.3, 88.3] (inputs below give 0, not denormals).
+ */
+
+#ifndef DJIBLAS_VMATH_H
+#define DJIBLAS_VMATH_H
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+
+#define DJIBLAS_EXP_HI      88.3762626647949f
+#define DJIBLAS_EXP_LO     -87.3365447504019f
+#define DJIBLAS_LOG2E       1.44269504088896341f
+#define DJIBLAS_LN2_HI      0.693359375f
+#define DJIBLAS_LN2_LO     -2.12194440e-4f
+#define DJIBLAS_EXP_P0      1.9875691500e-4f
+#define DJIBLAS_EXP_P1      1.3981999507e-3f
+#define DJIBLAS_EXP_P2      8.3334519073e-3f
+#define DJIBLAS_EXP_P3      4.1665795894e-2f
+#define DJIBLAS_EXP_P4      1.6666665459e-1f
+#define DJIBLAS_EXP_P5      5.0000001201e-1f
+
+// Tail padding for exp-based reductions: exp(pad - max) is exactly 0.
+#define DJIBLAS_EXP_PAD    -1.0e30f
+
+#if defined(__SSE2__)
+
+// No roundps before SSE4.1: cvtps2dq rounds to nearest under the default MXCSR.
+static inline __m128 djiblas_exp128_ps(__m128 x) {
+    x = _mm_min_ps(x, _mm_set1_ps(DJIBLAS_EXP_HI));
+    __m128 under = _mm_cmplt_ps(x, _mm_set1_ps(DJIBLAS_EXP_LO));
+
+    __m128i ni = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(DJIBLAS_LOG2E)));
+    __m128 n = _mm_cvtepi32_ps(ni);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(n, _mm_set1_ps(DJIBLAS_LN2_HI)));
+    r = _mm_sub_ps(r, _mm_mul_ps(n, _mm_set1_ps(DJIBLAS_LN2_LO)));
+
+    __m128 p = _mm_set1_ps(DJIBLAS_EXP_P0);
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(DJIBLAS_EXP_P1));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(DJIBLAS_EXP_P2));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(DJIBLAS_EXP_P3));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(DJIBLAS_EXP_P4));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(DJIBLAS_EXP_P5));
+    p = _mm_add_ps(_mm_mul_ps(p, _mm_mul_ps(r, r)), _mm_add_ps(r, _mm_set1_ps(1.0f)));
+
+    __m128i e = _mm_slli_epi32(_mm_add_epi32(ni, _mm_set1_epi32(127)), 23);
+    __m128 y = _mm_mul_ps(p, _mm_castsi128_ps(e));
+    return _mm_andnot_ps(under, y);
+}
+
+static inline __m128 djiblas_silu_mul128_ps(__m128 g, __m128 u) {
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 den = _mm_add_ps(one, djiblas_exp128_ps(_mm_sub_ps(_mm_setzero_ps(), g)));
+    return _mm_div_ps(_mm_mul_ps(g, u), den);
+}
+
+#endif // __SSE2__
+
+#if defined(__AVX__)
+
+// Horizontal reductions shared by every 256-bit unit (AVX2, F16C, VNNI and
+// the attention helpers), so they all reduce in the same order.
+static inline float djiblas_hsum256_ps(__m256 v) {
+    __m128 lo = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_add_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_add_ss(lo, _mm_shuffle_ps(lo, lo, 1));
+    return _mm_cvtss_f32(lo);
+}
+
+static inline float djiblas_hmax256_ps(__m256 v) {
+    __m128 lo = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    lo = _mm_max_ps(lo, _mm_movehl_ps(lo, lo));
+    lo = _mm_max_ss(lo, _mm_shuffle_ps(lo, lo, 1));
+    return _mm_cvtss_f32(lo);
+}
+
+// Reduce 8 accumulators at once: lane r of the result is the horizontal sum of c[r].
+static inline __m256 djiblas_hsum8x8_ps(__m256 c0, __m256 c1, __m256 c2, __m256 c3,
+                                        __m256 c4, __m256 c5, __m256 c6, __m256 c7) {
+    __m256 t0 = _mm256_hadd_ps(_mm256_hadd_ps(c0, c1), _mm256_hadd_ps(c2, c3));
+    __m256 t2 = _mm256_hadd_ps(_mm256_hadd_ps(c4, c5), _mm256_hadd_ps(c6, c7));
+    return _mm256_add_ps(_mm256_permute2f128_ps(t0, t2, 0x20), _mm256_permute2f128_ps(t0, t2, 0x31));
+}
+
+#endif // __AVX__
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+static inline __m256 djiblas_exp256_ps(__m256 x) {
+    x = _mm256_min_ps(x, _mm256_set1_ps(DJIBLAS_EXP_HI));
+    __m256 under = _mm256_cmp_ps(x, _mm256_set1_ps(DJIBLAS_EXP_LO), _CMP_LT_OQ);
+
+    __m256 n = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(DJIBLAS_LOG2E)),
+                               _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(DJIBLAS_LN2_HI), x);
+    r = _mm256_fnmadd_ps(n, _mm256_set1_ps(DJIBLAS_LN2_LO), r);
+
+    __m256 p = _mm256_set1_ps(DJIBLAS_EXP_P0);
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DJIBLAS_EXP_P1));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DJIBLAS_EXP_P2));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DJIBLAS_EXP_P3));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DJIBLAS_EXP_P4));
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(DJIBLAS_EXP_P5));
+    p = _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), _mm256_add_ps(r, _mm256_set1_ps(1.0f)));
+
+    __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+    __m256 y = _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+    return _mm256_andnot_ps(under, y);
+}
+
+// SwiGLU on one register pair: silu(g) * u = g * u / (1 + exp(-g))
+static inline __m256 djiblas_silu_mul256_ps(__m256 g, __m256 u) {
+    __m256 one = _mm256_set1_ps(1.0f);
+    __m256 den = _mm256_add_ps(one, djiblas_exp256_ps(_mm256_sub_ps(_mm256_setzero_ps(), g)));
+    return _mm256_div_ps(_mm256_mul_ps(g, u), den);
+}
+
+// One tile of grouped-query attention (djiblas_attn_gqa_*): nt <= 8 fp32 K / V
+// rows, kld / vld floats apart, against g query heads of head_size (a
+// multiple of 8). Head i keeps its running max m[i], sum l[i] and
+// unnormalized output at out + i*head_size (zeroed by the caller), so only
+// the first head pulls the tile from memory; the others reread it from L1.
+// Rows past nt are never read: the missing rows repeat row 0 and their
+// scores are replaced by the exp pad.
+static inline void djiblas_attn_group_tile256(const float *q, int g, const float *K, int kld,
+                                              const float *V, int vld, int nt, int head_size,
+                                              float scale, float *m, float *l, float *out) {
+    const float *k[8];
+    for (int j = 0; j < 8; j++) k[j] = K + (UINTN)((j < nt) ? j : 0) * (UINTN)kld;
+    const __m256 valid = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(nt),
+                                                                _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 vpad = _mm256_set1_ps(DJIBLAS_EXP_PAD);
+    float p[8];
+    for (int i = 0; i < g; i++) {
+        const float *qi = q + i * head_size;
+        float *oi = out + i * head_size;
+        __m256 c0 = _mm256_setzero_ps(), c1 = _mm256_setzero_ps();
+        __m256 c2 = _mm256_setzero_ps(), c3 = _mm256_setzero_ps();
+        __m256 c4 = _mm256_setzero_ps(), c5 = _mm256_setzero_ps();
+        __m256 c6 = _mm256_setzero_ps(), c7 = _mm256_setzero_ps();
+        for (int d = 0; d < head_size; d += 8) {
+            const __m256 qv = _mm256_loadu_ps(qi + d);
+            c0 = _mm256_fmadd_ps(_mm256_loadu_ps(k[0] + d), qv, c0);
+            c1 = _mm256_fmadd_ps(_mm256_loadu_ps(k[1] + d), qv, c1);
+            c2 = _mm256_fmadd_ps(_mm256_loadu_ps(k[2] + d), qv, c2);
+            c3 = _mm256_fmadd_ps(_mm256_loadu_ps(k[3] + d), qv, c3);
+            c4 = _mm256_fmadd_ps(_mm256_loadu_ps(k[4] + d), qv, c4);
+            c5 = _mm256_fmadd_ps(_mm256_loadu_ps(k[5] + d), qv, c5);
+            c6 = _mm256_fmadd_ps(_mm256_loadu_ps(k[6] + d), qv, c6);
+            c7 = _mm256_fmadd_ps(_mm256_loadu_ps(k[7] + d), qv, c7);
+        }
+        __m256 s = djiblas_hsum8x8_ps(c0, c1, c2, c3, c4, c5, c6, c7);
+        s = _mm256_blendv_ps(vpad, _mm256_mul_ps(s, vscale), valid);
+
+        float tm = djiblas_hmax256_ps(s);
+        if (tm > m[i]) {
+            __m256 corr = djiblas_exp256_ps(_mm256_set1_ps(m[i] - tm));
+            for (int d = 0; d < head_size; d += 8) {
+                _mm256_storeu_ps(oi + d, _mm256_mul_ps(_mm256_loadu_ps(oi + d), corr));
+            }
+            l[i] *= _mm256_cvtss_f32(corr);
+            m[i] = tm;
+        }
+        __m256 e = djiblas_exp256_ps(_mm256_sub_ps(s, _mm256_set1_ps(m[i])));
+        l[i] += djiblas_hsum256_ps(e);
+        _mm256_storeu_ps(p, e);
+
+        for (int d = 0; d < head_size; d += 8) {
+            __m256 acc = _mm256_loadu_ps(oi + d);
+            for (int j = 0; j < nt; j++) {
+                acc = _mm256_fmadd_ps(_mm256_broadcast_ss(p + j), _mm256_loadu_ps(V + (UINTN)j * (UINTN)vld + d), acc);
+            }
+            _mm256_storeu_ps(oi + d, acc);
+        }
+    }
+}
+
+#endif // __AVX2__ && __FMA__
+
+#if defined(__AVX512F__)
+
+// vscalefps does the 2^n step and flushes to 0 / inf on its own.
+static inline __m512 djiblas_exp512_ps(__m512 x) {
+    x = _mm512_min_ps(x, _mm512_set1_ps(DJIBLAS_EXP_HI));
+    __mmask16 ok = _mm512_cmp_ps_mask(x, _mm512_set1_ps(DJIBLAS_EXP_LO), _CMP_GE_OQ);
+
+    __m512 n = _mm512_roundscale_ps(_mm512_mul_ps(x, _mm512_set1_ps(DJIBLAS_LOG2E)),
+                                    _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512 r = _mm512_fnmadd_ps(n, _mm512_set1_ps(DJIBLAS_LN2_HI), x);
+    r = _mm512_fnmadd_ps(n, _mm512_set1_ps(DJIBLAS_LN2_LO), r);
+
+    __m512 p = _mm512_set1_ps(DJIBLAS_EXP_P0);
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DJIBLAS_EXP_P1));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DJIBLAS_EXP_P2));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DJIBLAS_EXP_P3));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DJIBLAS_EXP_P4));
+    p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(DJIBLAS_EXP_P5));
+    p = _mm512_fmadd_ps(p, _mm512_mul_ps(r, r), _mm512_add_ps(r, _mm512_set1_ps(1.0f)));
+
+    return _mm512_maskz_scalef_ps(ok, p, n);
+}
+
+static inline __m512 djiblas_silu_mul512_ps(__m512 g, __m512 u) {
+    __m512 one = _mm512_set1_ps(1.0f);
+    __m512 den = _mm512_add_ps(one, djiblas_exp512_ps(_mm512_sub_ps(_mm512_setzero_ps(), g)));
+    return _mm512_div_ps(_mm512_mul_ps(g, u), den);
+}
+
+#endif // __AVX512F__
+
+#endif // x86_64
+
+#endif // DJIBLAS_VMATH_H
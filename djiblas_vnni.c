@@ -0,0 +1,113 @@
+/*
+ * DjibLAS - AVX512_VNNI int8 kernels (built with -mavx512f -mavx512vl -mavx512vnni -mavx2 -mfma)
+ *
+ * Own translation unit for the same reason as djiblas_avx512.c. Uses the
+ * EVEX YMM form of vpdpbusd: one Q8_0 block (32 int8) is exactly one YMM,
+ * so a block's products land in 8 int32 lanes with a single instruction
+ * instead of the AVX2 maddubs + madd pair. Selected in djiblas.c only when
+ * the CPU reports AVX512_VNNI and AVX512VL.
+ */
+
+#include "djiblas.h"
+#include "djiblas_vmath.h"
+
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+#include <immintrin.h>
+
+void djiblas_gemv_q8_vnni(int d, int n, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    // vpdpbusd is unsigned x signed like maddubs: |w| against sign(w) * x.
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        __m256 acc = _mm256_setzero_ps();
+        for (int b = 0; b < nb; b++) {
+            __m256i vw = _mm256_loadu_si256((const __m256i *)(w + b * DJIBLAS_Q8_BLOCK));
+            __m256i vx = _mm256_loadu_si256((const __m256i *)(xq + b * DJIBLAS_Q8_BLOCK));
+            __m256i p32 = _mm256_dpbusd_epi32(_mm256_setzero_si256(),
+                                              _mm256_sign_epi8(vw, vw), _mm256_sign_epi8(vx, vw));
+            acc = _mm256_fmadd_ps(_mm256_cvtepi32_ps(p32), _mm256_set1_ps(wd[b] * xd[b]), acc);
+        }
+        y[i] = djiblas_hsum256_ps(acc);
+    }
+}
+
+static inline __m256 q8_block_dot_vnni(__m256i uw, __m256i vw, const INT8 *x) {
+    __m256i vx = _mm256_loadu_si256((const __m256i *)x);
+    return _mm256_cvtepi32_ps(_mm256_dpbusd_epi32(_mm256_setzero_si256(), uw, _mm256_sign_epi8(vx, vw)));
+}
+
+void djiblas_gemm_q8_vnni(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    // As djiblas_gemm_q8_avx2, one vpdpbusd per block and column.
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        const float *wd = Wd + (UINTN)i * (UINTN)nb;
+        int c = 0;
+        for (; c + DJIBLAS_Q8_NCOL <= ncol; c += DJIBLAS_Q8_NCOL) {
+            const INT8 *x = xq + (UINTN)c * (UINTN)n;
+            const float *dx = xd + (UINTN)c * (UINTN)nb;
+            __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+            __m256 a2 = _mm256_setzero_ps(), a3 = _mm256_setzero_ps();
+            for (int b = 0; b < nb; b++) {
+                __m256i vw = _mm256_loadu_si256((const __m256i *)(w + b * DJIBLAS_Q8_BLOCK));
+                __m256i uw = _mm256_sign_epi8(vw, vw);
+                const INT8 *xb = x + b * DJIBLAS_Q8_BLOCK;
+                a0 = _mm256_fmadd_ps(q8_block_dot_vnni(uw, vw, xb), _mm256_set1_ps(wd[b] * dx[b]), a0);
+                a1 = _mm256_fmadd_ps(q8_block_dot_vnni(uw, vw, xb + n), _mm256_set1_ps(wd[b] * dx[b + nb]), a1);
+                a2 = _mm256_fmadd_ps(q8_block_dot_vnni(uw, vw, xb + 2 * n), _mm256_set1_ps(wd[b] * dx[b + 2 * nb]), a2);
+                a3 = _mm256_fmadd_ps(q8_block_dot_vnni(uw, vw, xb + 3 * n), _mm256_set1_ps(wd[b] * dx[b + 3 * nb]), a3);
+            }
+            Y[(UINTN)c * (UINTN)ldy + i] = djiblas_hsum256_ps(a0);
+            Y[(UINTN)(c + 1) * (UINTN)ldy + i] = djiblas_hsum256_ps(a1);
+            Y[(UINTN)(c + 2) * (UINTN)ldy + i] = djiblas_hsum256_ps(a2);
+            Y[(UINTN)(c + 3) * (UINTN)ldy + i] = djiblas_hsum256_ps(a3);
+        }
+        for (; c < ncol; c++) {
+            djiblas_gemv_q8_vnni(1, n, w, wd, xq + (UINTN)c * (UINTN)n, xd + (UINTN)c * (UINTN)nb,
+                                 Y + (UINTN)c * (UINTN)ldy + i);
+        }
+    }
+}
+
+void djiblas_gemv_q6_q8_vnni(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                             const INT8 *xq, const float *xd, float *y) {
+    // As djiblas_gemv_q6_q8_avx2: block b of row i is in group (e / 32 + b) / 2.
+    int nb = n / DJIBLAS_Q8_BLOCK;
+    for (int i = 0; i < d; i++) {
+        const INT8 *w = W + (UINTN)i * (UINTN)n;
+        const float *s = S + (e0 + (UINT64)i * (UINT64)n) / DJIBLAS_Q6_GROUP;
+        int odd = (int)(((e0 + (UINT64)i * (UINT64)n) / DJIBLAS_Q8_BLOCK) & 1);
+        __m256 acc = _mm256_setzero_ps();
+        for (int b = 0; b < nb; b++) {
+            __m256i vw = _mm256_loadu_si256((const __m256i *)(w + b * DJIBLAS_Q8_BLOCK));
+            __m256i vx = _mm256_loadu_si256((const __m256i *)(xq + b * DJIBLAS_Q8_BLOCK));
+            __m256i p32 = _mm256_dpbusd_epi32(_mm256_setzero_si256(),
+                                              _mm256_sign_epi8(vw, vw), _mm256_sign_epi8(vx, vw));
+            acc = _mm256_fmadd_ps(_mm256_cvtepi32_ps(p32), _mm256_set1_ps(s[(b + odd) >> 1] * xd[b]), acc);
+        }
+        y[i] = djiblas_hsum256_ps(acc);
+    }
+}
+
+#else
+
+void djiblas_gemv_q8_vnni(int d, int n, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *y) {
+    // Never selected without AVX512_VNNI + VL.
+    djiblas_gemv_q8_sse2(d, n, W, Wd, xq, xd, y);
+}
+
+void djiblas_gemm_q8_vnni(int d, int n, int ncol, const INT8 *W, const float *Wd,
+                          const INT8 *xq, const float *xd, float *Y, int ldy) {
+    djiblas_gemm_q8_sse2(d, n, ncol, W, Wd, xq, xd, Y, ldy);
+}
+
+void djiblas_gemv_q6_q8_vnni(int d, int n, const INT8 *W, const float *S, UINT64 e0,
+                             const INT8 *xq, const float *xd, float *y) {
+    djiblas_gemv_q6_q8_scalar(d, n, W, S, e0, xq, xd, y);
+}
+
+#endif
@@ -16,6 +16,7 @@
 
 #include <efi.h>
 #include <efilib.h>
+#include "djiblas.h"
 
 #if defined(__x86_64__) || defined(_M_X64)
 #include <immintrin.h>
@@ -23,11 +24,34 @@
 
 // DjibQuant magic: 0xD31B0006 = "D31B" + Q6
 #define DJIBQUANT_MAGIC 0xD31B0006
-#define DJIBQUANT_VERSION 1
+#define DJIBQUANT_VERSION 2
+
+// Q6 value storage by header version:
+//   v1: one int8 per value
+//   v2: 4 values in 3 bytes, value 4k + j = bits [6j, 6j + 6) of the
+//       little-endian 24-bit word at byte 3k (djiblas_unpack_q6p)
+#define DJIBQUANT_VERSION_UNPACKED 1
+#define DJIBQUANT_VERSION_PACKED   2
 
 // Group size optimized for AVX2 (32 floats = 256 bits = 1 YMM register)
 #define DJIBQUANT_GROUP_SIZE 64
 
+// Other tensor record types in a .djibq model file. Every tensor starts with
+// a DjibQuantHeader; its magic says how the payload that follows is stored.
+#define DJIBQUANT_MAGIC_Q8  0xD31B0008   // Q8_0: int8 q[n], float scales[n/32]
+#define DJIBQUANT_MAGIC_F32 0xD31B0032   // float[n] as-is (norm weights), no scales
+#define DJIBQUANT_MAGIC_Q4  0xD31B0004   // Q4: UINT8 nibbles[n/2], scales[n/32] (fp32 or fp16)
+#define DJIBQUANT_MAGIC_F16  0xD31B0016  // IEEE half[n], no scales
+#define DJIBQUANT_MAGIC_BF16 0xD31B00BF  // bfloat16[n], no scales
+#define DJIBQUANT_Q8_GROUP_SIZE 32
+#define DJIBQUANT_Q4_GROUP_SIZE 32
+
+// DjibQuantHeader.scale_type (Q4 records; the other formats use fp32)
+#define DJIBQUANT_SCALE_F32 0
+#define DJIBQUANT_SCALE_F16 1
+
+#define DJIBQUANT_IS_MAGIC(m) (((m) & 0xFFFF0000u) == 0xD31B0000u)
+
 // File format header
 typedef struct {
     UINT32 magic;           // 0xD31B0006
@@ -35,12 +59,13 @@ typedef struct {
     UINT32 n_elements;      // Total number of quantized values
     UINT32 n_groups;        // Number of quantization groups
     UINT32 group_size;      // Elements per group (64)
-    UINT32 reserved[3];     // Future use
+    UINT32 scale_type;      // DJIBQUANT_SCALE_* (0 = fp32)
+    UINT32 reserved[2];     // Future use
 } DjibQuantHeader;
 
 // Quantized tensor (in-memory representation)
 typedef struct {
-    INT8* q;                // Quantized values (6-bit packed in 8-bit)
+    INT8* q;                // Quantized values, one int8 each (v1 layout)
     float* scales;          // Scale factors (one per group)
     UINT32 n_elements;      // Total elements
     UINT32 n_groups;        // Number of groups
@@ -127,51 +152,13 @@ static inline void djibquant_dequantize_avx2(const INT8* q, const float scale,
 }
 #endif
 
-// SSE2 fallback dequantization
+// SSE2 fallback dequantization (pure SSE2 sign extension, see djiblas.c)
 static inline void djibquant_dequantize_sse2(const INT8* q, const float scale,
                                               float* output, UINT32 n) {
-    #if defined(__SSE2__)
-    __m128 scale_vec = _mm_set1_ps(scale);
-    
-    UINT32 i = 0;
-    for (; i + 16 <= n; i += 16) {
-        // Load 16 x int8
-        __m128i q_vec = _mm_loadu_si128((const __m128i*)(q + i));
-        
-        // Convert to int32 and then to float (4 at a time)
-        __m128i q32_0 = _mm_cvtepi8_epi32(q_vec);
-        __m128i q32_1 = _mm_cvtepi8_epi32(_mm_shuffle_epi32(q_vec, 0x55));
-        __m128i q32_2 = _mm_cvtepi8_epi32(_mm_shuffle_epi32(q_vec, 0xAA));
-        __m128i q32_3 = _mm_cvtepi8_epi32(_mm_shuffle_epi32(q_vec, 0xFF));
-        
-        __m128 f0 = _mm_cvtepi32_ps(q32_0);
-        __m128 f1 = _mm_cvtepi32_ps(q32_1);
-        __m128 f2 = _mm_cvtepi32_ps(q32_2);
-        __m128 f3 = _mm_cvtepi32_ps(q32_3);
-        
-        f0 = _mm_mul_ps(f0, scale_vec);
-        f1 = _mm_mul_ps(f1, scale_vec);
-        f2 = _mm_mul_ps(f2, scale_vec);
-        f3 = _mm_mul_ps(f3, scale_vec);
-        
-        _mm_storeu_ps(output + i + 0, f0);
-        _mm_storeu_ps(output + i + 4, f1);
-        _mm_storeu_ps(output + i + 8, f2);
-        _mm_storeu_ps(output + i + 12, f3);
-    }
-    
-    for (; i < n; i++) {
-        output[i] = (float)q[i] * scale;
-    }
-    #else
-    // Pure scalar fallback
-    for (UINT32 i = 0; i < n; i++) {
-        output[i] = (float)q[i] * scale;
-    }
-    #endif
+    djiblas_dequant_sse2(q, scale, output, n);
 }
 
-// Main dequantization dispatcher (runtime detection)
+// Main dequantization dispatcher (kernel picked once by djiblas_dispatch_init)
 static inline void djibquant_dequantize(const DjibQuantTensor* tensor, 
                                         float* output, UINT32 offset, UINT32 n) {
     if (offset + n > tensor->n_elements) {
@@ -195,21 +182,80 @@ static inline void djibquant_dequantize(const DjibQuantTensor* tensor,
         float* out_ptr = output + (group_offset + elem_start - offset);
         float scale = tensor->scales[g];
         
-        #if defined(__AVX2__)
-        djibquant_dequantize_avx2(q_ptr, scale, out_ptr, n_elems);
-        #else
-        djibquant_dequantize_sse2(q_ptr, scale, out_ptr, n_elems);
-        #endif
+        g_djiblas.dequant(q_ptr, scale, out_ptr, n_elems);
     }
 }
 
+// ============================================================================
+// Tensor Records
+// ============================================================================
+
+// Bytes per scale of a record (0: the format has no scales).
+static inline UINT64 djibquant_scale_bytes(const DjibQuantHeader *h) {
+    switch (h->magic) {
+    case DJIBQUANT_MAGIC_F32:
+    case DJIBQUANT_MAGIC_F16:
+    case DJIBQUANT_MAGIC_BF16:
+        return 0;
+    case DJIBQUANT_MAGIC_Q4:
+        return (h->scale_type == DJIBQUANT_SCALE_F16) ? 2 : sizeof(float);
+    default:
+        return sizeof(float);
+    }
+}
+
+// Bytes of the quantized values of a record (before its scales).
+static inline UINT64 djibquant_q_bytes(UINT32 magic, UINT32 version, UINT64 n_elements) {
+    switch (magic) {
+    case DJIBQUANT_MAGIC_F32: return n_elements * sizeof(float);
+    case DJIBQUANT_MAGIC_Q8:  return n_elements;
+    case DJIBQUANT_MAGIC_Q4:  return n_elements / 2;
+    case DJIBQUANT_MAGIC_F16:
+    case DJIBQUANT_MAGIC_BF16: return n_elements * sizeof(UINT16);
+    case DJIBQUANT_MAGIC:
+        return (version >= DJIBQUANT_VERSION_PACKED) ? (n_elements + 3) / 4 * 3 : n_elements;
+    default:                  return 0;
+    }
+}
+
+// Payload bytes following a record header (0 = unknown magic).
+static inline UINT64 djibquant_payload_bytes(const DjibQuantHeader *h) {
+    UINT64 q = djibquant_q_bytes(h->magic, h->version, h->n_elements);
+    return q ? (q + (UINT64)h->n_groups * djibquant_scale_bytes(h)) : 0;
+}
+
+// IEEE half -> float (scales only; not on a hot path).
+static inline float djibquant_f16_to_f32(UINT16 h) {
+    UINT32 sign = (UINT32)(h & 0x8000) << 16;
+    UINT32 exp = (h >> 10) & 0x1F;
+    UINT32 man = h & 0x3FF;
+    union { UINT32 u; float f; } v;
+    if (exp == 0) {
+        // Zero / subnormal: man * 2^-24
+        v.f = (float)man * (1.0f / 16777216.0f);
+        v.u |= sign;
+        return v.f;
+    }
+    if (exp == 31) v.u = sign | 0x7F800000u | (man << 13);
+    else v.u = sign | ((exp + 112) << 23) | (man << 13);
+    return v.f;
+}
+
+// Widens n fp16 scales stored at the start of buf to fp32 in place (buf must
+// hold n floats). Walks backwards so no half is overwritten before it is read.
+static inline void djibquant_widen_scales(void *buf, UINT64 n) {
+    const UINT16 *h = (const UINT16 *)buf;
+    float *f = (float *)buf;
+    for (UINT64 i = n; i-- > 0;) f[i] = djibquant_f16_to_f32(h[i]);
+}
+
 // ============================================================================
 // Memory Estimation
 // ============================================================================
 
 static inline UINT64 djibquant_memory_size(UINT32 n_elements) {
     UINT32 n_groups = (n_elements + DJIBQUANT_GROUP_SIZE - 1) / DJIBQUANT_GROUP_SIZE;
-    UINT64 q_size = n_elements * sizeof(INT8);           // 1 byte per element
+    UINT64 q_size = ((UINT64)n_elements + 3) / 4 * 3;    // 6 bits per element (v2)
     UINT64 scales_size = n_groups * sizeof(float);       // 4 bytes per group
     return q_size + scales_size;
 }
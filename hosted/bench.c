@@ -0,0 +1,188 @@
+/*
+ * bench - hosted tokens/sec benchmark for the inference core.
+ *
+ * Builds llama2_efi_final.c (without efi_main) against the hosted efi.h /
+ * efilib.h shim and drives the same loader, prefill, decode, sampler and
+ * tokenizer the REPL uses, so kernel changes can be A/B'd in seconds on
+ * Linux instead of booting QEMU:
+ *
+ *   make bench
+ *   ./llmk-bench -m stories15M.bin -z tokenizer.bin -n 128 -r 5
+ *
+ * Reports prefill tok/s, decode tok/s and the per-op split of both phases
+ * (best of -r runs). repl.cfg / djiblas.tune are read from the working
+ * directory like the boot volume, so repack / autotune behave as on boot.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LLMK_HOSTED 1
+#include "../llama2_efi_final.c"
+
+static const char *g_op_names[LLMK_OP_COUNT] = {
+    "embed", "qkv", "attn", "wo", "norm", "ffn_up", "ffn_down", "cls",
+};
+
+static void usage(const char *argv0) {
+    printf("usage: %s [-m model] [-z tokenizer] [-p prompt] [-n decode_tokens] [-r runs]\n"
+           "          [-a autotune(0|1|2)] [-k repack(0|1)] [-s seed]\n"
+           "defaults: -m model.bin -z tokenizer.bin -n 128 -r 3\n", argv0);
+}
+
+static double cyc_ms(UINT64 cycles) {
+    return (double)cycles * 1000.0 / (double)tsc_per_sec;
+}
+
+int main(int argc, char **argv) {
+    const char *model_path = "model.bin";
+    const char *tok_path = "tokenizer.bin";
+    const char *prompt = "Once upon a time, there was a little girl named Lily. She loved to play outside";
+    int n_decode = 128;
+    int runs = 3;
+    int autotune = -1;
+    int repack = -1;
+    unsigned int seed = 42;
+
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (a[0] != '-' || a[1] == 0 || a[2] != 0 || i + 1 >= argc) {
+            usage(argv[0]);
+            return 2;
+        }
+        const char *v = argv[++i];
+        switch (a[1]) {
+            case 'm': model_path = v; break;
+            case 'z': tok_path = v; break;
+            case 'p': prompt = v; break;
+            case 'n': n_decode = atoi(v); break;
+            case 'r': runs = atoi(v); break;
+            case 'a': autotune = atoi(v); break;
+            case 'k': repack = atoi(v); break;
+            case 's': seed = (unsigned int)strtoul(v, NULL, 10); break;
+            default: usage(argv[0]); return 2;
+        }
+    }
+    if (runs < 1) runs = 1;
+    if (n_decode < 0) n_decode = 0;
+
+    EFI_FILE_HANDLE Root;
+    EFI_STATUS status = llmk_hosted_init(".", &Root);
+    if (EFI_ERROR(status)) return 1;
+    g_root = Root;
+    djibmark_init();
+
+    llmk_load_boot_cfg_best_effort(&g_boot_cfg);
+    if (autotune >= 0) g_boot_cfg.autotune = autotune;
+    if (repack >= 0) g_boot_cfg.repack = repack;
+
+    djiblas_dispatch_init();
+
+    CHAR16 model16[512], tok16[512];
+    ascii_to_char16(model16, model_path, 512);
+    ascii_to_char16(tok16, tok_path, 512);
+
+    Config config;
+    TransformerWeights weights;
+    RunState state;
+    Tokenizer tokenizer;
+    CHAR16 *model_filename = NULL;
+    status = llmk_load_model(Root, model16, tok16, &config, &weights, &state, &tokenizer, &model_filename);
+    if (EFI_ERROR(status)) {
+        fprintf(stderr, "bench: loading %s / %s failed\n", model_path, tok_path);
+        return 1;
+    }
+
+    calibrate_tsc_once();
+    if (tsc_per_sec == 0) {
+        fprintf(stderr, "bench: TSC calibration failed\n");
+        return 1;
+    }
+
+    // Encode once for the token count; time it separately (it is a linear
+    // vocab scan per piece, so it matters for long prompts).
+    int *tokens = (int *)malloc((size_t)config.seq_len * sizeof(int));
+    int n_prompt = 0;
+    UINT64 t0 = rdtsc();
+    encode((char *)prompt, tokens, &n_prompt, config.seq_len, &tokenizer);
+    UINT64 encode_cycles = rdtsc() - t0;
+    if (!state.kv_rolling && n_prompt + n_decode > config.seq_len) n_decode = config.seq_len - n_prompt;
+
+    UINT64 best_prefill = ~0ULL, best_decode = ~0ULL, best_sample = ~0ULL;
+    UINT64 op_prefill[LLMK_OP_COUNT], op_decode[LLMK_OP_COUNT];
+    int recent[64];
+
+    for (int r = 0; r < runs; r++) {
+        reset_kv_cache(&state, &config);
+        set_seed(seed);
+        int n_recent = 0;
+
+        for (int i = 0; i < LLMK_OP_COUNT; i++) g_llmk_op_cycles[i] = 0;
+        t0 = rdtsc();
+        transformer_prefill(&state, &weights, &config, tokens, n_prompt, 0, TRUE);
+        UINT64 prefill = rdtsc() - t0;
+        UINT64 run_prefill_ops[LLMK_OP_COUNT];
+        for (int i = 0; i < LLMK_OP_COUNT; i++) {
+            run_prefill_ops[i] = g_llmk_op_cycles[i];
+            g_llmk_op_cycles[i] = 0;
+        }
+
+        // Same default sampling as the REPL.
+        UINT64 decode = 0, sample_cycles = 0;
+        for (int i = 0; i < n_decode; i++) {
+            t0 = rdtsc();
+            int next = sample_advanced(state.logits, config.vocab_size, 0.85f, 0.05f, 0.95f, 80,
+                                       recent, n_recent, 1.15f);
+            UINT64 t1 = rdtsc();
+            sample_cycles += t1 - t0;
+            if (n_recent < 64) recent[n_recent++] = next;
+            else {
+                memmove(recent, recent + 1, 63 * sizeof(int));
+                recent[63] = next;
+            }
+            transformer_forward(&state, &weights, &config, next, n_prompt + i);
+            decode += rdtsc() - t1;
+        }
+
+        if (prefill < best_prefill) {
+            best_prefill = prefill;
+            memcpy(op_prefill, run_prefill_ops, sizeof(op_prefill));
+        }
+        if (decode < best_decode) {
+            best_decode = decode;
+            memcpy(op_decode, g_llmk_op_cycles, sizeof(op_decode));
+        }
+        if (sample_cycles < best_sample) best_sample = sample_cycles;
+    }
+
+    double prefill_ms = cyc_ms(best_prefill);
+    double decode_ms = cyc_ms(best_decode);
+    double sample_ms = cyc_ms(best_sample);
+
+    printf("\n== bench: %s (dim=%d hidden=%d layers=%d heads=%d kv=%d vocab=%d seq=%d)\n",
+           model_path, config.dim, config.hidden_dim, config.n_layers, config.n_heads,
+           config.n_kv_heads, config.vocab_size, config.seq_len);
+    fflush(stdout);
+    // Kernel names are CHAR16: go through Print (libc %ls wants 4-byte wchar_t).
+    Print(L"kernels: gemv=%s sgemm=%s attn=%s vmath=%s norm=%s tsc=%d MHz\r\n",
+          g_djiblas.gemv_name, g_djiblas.sgemm_name, g_djiblas.attn_name,
+          g_djiblas.vmath_name, g_djiblas.norm_name, (int)(tsc_per_sec / 1000000ULL));
+    printf("prompt %d tokens, decode %d tokens, best of %d runs\n", n_prompt, n_decode, runs);
+    printf("encode   %9.3f ms\n", cyc_ms(encode_cycles));
+    printf("prefill  %9.3f ms  %9.1f tok/s\n", prefill_ms,
+           prefill_ms > 0 ? n_prompt * 1000.0 / prefill_ms : 0.0);
+    printf("decode   %9.3f ms  %9.1f tok/s  (%.3f ms/tok forward)\n", decode_ms,
+           decode_ms > 0 ? n_decode * 1000.0 / decode_ms : 0.0,
+           n_decode ? decode_ms / n_decode : 0.0);
+    printf("sample   %9.3f ms  %9.3f ms/tok\n", sample_ms, n_decode ? sample_ms / n_decode : 0.0);
+
+    printf("\n%-9s %12s %6s %14s %6s\n", "op", "prefill ms", "%", "decode ms/tok", "%");
+    for (int i = 0; i < LLMK_OP_COUNT; i++) {
+        printf("%-9s %12.3f %5.1f%% %14.4f %5.1f%%\n", g_op_names[i],
+               cyc_ms(op_prefill[i]), best_prefill ? 100.0 * op_prefill[i] / best_prefill : 0.0,
+               n_decode ? cyc_ms(op_decode[i]) / n_decode : 0.0,
+               best_decode ? 100.0 * op_decode[i] / best_decode : 0.0);
+    }
+    return 0;
+}
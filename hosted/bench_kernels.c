@@ -0,0 +1,87 @@
+/*
+ * bench_kernels - hosted kernel correctness check + micro-benchmark.
+ *
+ * Runs djiblas_check_run() (djiblas_check.c) on Linux: every GEMV / SGEMM /
+ * dot / axpy / dequant / attention / RoPE kernel this CPU supports, against
+ * the scalar reference, over the real model shapes.
+ *
+ *   make bench_kernels
+ *   ./llmk-bench-kernels -o kernels.csv
+ *
+ * Writes the CSV to -o (default stdout) and a summary to stderr. Exits 1 if
+ * any kernel is out of tolerance, so it can gate a build.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "efi.h"
+#include "djiblas.h"
+
+static void emit_line(void *ctx, const char *line) {
+    fputs(line, (FILE *)ctx);
+}
+
+static UINT64 ns_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (UINT64)ts.tv_sec * 1000000000ULL + (UINT64)ts.tv_nsec;
+}
+
+static UINT64 rdtsc_now(void) {
+    UINT32 lo, hi;
+    __asm__ volatile("lfence\nrdtsc" : "=a"(lo), "=d"(hi) :: "memory");
+    return ((UINT64)hi << 32) | (UINT64)lo;
+}
+
+// TSC ticks per second over ~100 ms of wall clock.
+static UINT64 calibrate_tsc(void) {
+    UINT64 n0 = ns_now(), t0 = rdtsc_now();
+    struct timespec d = { 0, 100000000L };
+    nanosleep(&d, NULL);
+    UINT64 n1 = ns_now(), t1 = rdtsc_now();
+    if (n1 <= n0) return 0;
+    return (UINT64)((double)(t1 - t0) * 1e9 / (double)(n1 - n0));
+}
+
+int main(int argc, char **argv) {
+    const char *out_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-' && argv[i][1] == 'o' && argv[i][2] == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [-o out.csv]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    djiblas_dispatch_init();
+
+    UINT64 floats = djiblas_check_scratch_floats();
+    float *scratch = (float *)aligned_alloc(64, (size_t)((floats * sizeof(float) + 63) & ~63ULL));
+    if (!scratch) {
+        fprintf(stderr, "bench_kernels: cannot allocate %llu MB of scratch\n",
+                (unsigned long long)(floats * sizeof(float) >> 20));
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            perror(out_path);
+            return 1;
+        }
+    }
+
+    UINT64 tsc_hz = calibrate_tsc();
+    DjibLasCheckSummary sum;
+    djiblas_check_run(scratch, floats, tsc_hz, emit_line, out, &sum);
+    if (out != stdout) fclose(out);
+    free(scratch);
+
+    fprintf(stderr, "bench_kernels: %d checked, %d failed, %d skipped (tsc %llu MHz)\n",
+            sum.n_run, sum.n_fail, sum.n_skip, (unsigned long long)(tsc_hz / 1000000ULL));
+    return sum.n_fail ? 1 : 0;
+}
@@ -0,0 +1,231 @@
+/*
+ * Minimal efi.h for the hosted (Linux) build.
+ *
+ * Only the types, status codes and protocol members the inference core
+ * actually touches, with the gnu-efi names. Member order does not match the
+ * UEFI spec: nothing here is ever handed to real firmware. The behaviour
+ * behind the function pointers lives in hosted/llmk_hosted.c.
+ */
+
+#ifndef LLMK_HOSTED_EFI_H
+#define LLMK_HOSTED_EFI_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t  UINT8;
+typedef uint16_t UINT16;
+typedef uint32_t UINT32;
+typedef uint64_t UINT64;
+typedef int8_t   INT8;
+typedef int16_t  INT16;
+typedef int32_t  INT32;
+typedef int64_t  INT64;
+typedef uint64_t UINTN;
+typedef int64_t  INTN;
+typedef uint8_t  CHAR8;
+typedef uint16_t CHAR16;   // requires -fshort-wchar, like the UEFI build
+typedef uint8_t  BOOLEAN;
+typedef void     VOID;
+
+#define TRUE  1
+#define FALSE 0
+#define IN
+#define OUT
+#define OPTIONAL
+#define CONST const
+#define EFIAPI
+
+typedef UINTN  EFI_STATUS;
+typedef void  *EFI_HANDLE;
+typedef void  *EFI_EVENT;
+typedef UINT64 EFI_PHYSICAL_ADDRESS;
+
+#define EFI_ERROR_BIT          0x8000000000000000ULL
+#define EFIERR(a)              (EFI_ERROR_BIT | (a))
+#define EFI_ERROR(a)           (((INTN)(a)) < 0)
+
+#define EFI_SUCCESS            0
+#define EFI_LOAD_ERROR         EFIERR(1)
+#define EFI_INVALID_PARAMETER  EFIERR(2)
+#define EFI_UNSUPPORTED        EFIERR(3)
+#define EFI_BAD_BUFFER_SIZE    EFIERR(4)
+#define EFI_BUFFER_TOO_SMALL   EFIERR(5)
+#define EFI_NOT_READY          EFIERR(6)
+#define EFI_DEVICE_ERROR       EFIERR(7)
+#define EFI_OUT_OF_RESOURCES   EFIERR(9)
+#define EFI_NOT_FOUND          EFIERR(14)
+#define EFI_ALREADY_STARTED    EFIERR(20)
+#define EFI_COMPROMISED_DATA   EFIERR(33)
+
+typedef struct {
+    UINT32 Data1;
+    UINT16 Data2;
+    UINT16 Data3;
+    UINT8  Data4[8];
+} EFI_GUID;
+
+typedef enum {
+    AllocateAnyPages,
+    AllocateMaxAddress,
+    AllocateAddress,
+} EFI_ALLOCATE_TYPE;
+
+typedef enum {
+    EfiReservedMemoryType,
+    EfiLoaderCode,
+    EfiLoaderData,
+} EFI_MEMORY_TYPE;
+
+typedef struct {
+    UINT16 Year;
+    UINT8  Month;
+    UINT8  Day;
+    UINT8  Hour;
+    UINT8  Minute;
+    UINT8  Second;
+    UINT8  Pad1;
+    UINT32 Nanosecond;
+    INT16  TimeZone;
+    UINT8  Daylight;
+    UINT8  Pad2;
+} EFI_TIME;
+
+typedef struct {
+    UINT16 ScanCode;
+    CHAR16 UnicodeChar;
+} EFI_INPUT_KEY;
+
+// ---------------------------------------------------------------------------
+// File protocol
+// ---------------------------------------------------------------------------
+
+#define EFI_FILE_MODE_READ    0x0000000000000001ULL
+#define EFI_FILE_MODE_WRITE   0x0000000000000002ULL
+#define EFI_FILE_MODE_CREATE  0x8000000000000000ULL
+
+#define EFI_FILE_INFO_ID \
+    { 0x09576e92, 0x6d3f, 0x11d2, { 0x8e, 0x39, 0x00, 0xa0, 0xc9, 0x69, 0x72, 0x3b } }
+
+typedef struct {
+    UINT64   Size;
+    UINT64   FileSize;
+    UINT64   PhysicalSize;
+    EFI_TIME CreateTime;
+    EFI_TIME LastAccessTime;
+    EFI_TIME ModificationTime;
+    UINT64   Attribute;
+    CHAR16   FileName[1];
+} EFI_FILE_INFO;
+
+typedef struct _EFI_FILE *EFI_FILE_HANDLE;
+
+typedef struct _EFI_FILE {
+    UINT64 Revision;
+    EFI_STATUS (*Open)(EFI_FILE_HANDLE File, EFI_FILE_HANDLE *NewHandle, CHAR16 *FileName, UINT64 OpenMode, UINT64 Attributes);
+    EFI_STATUS (*Close)(EFI_FILE_HANDLE File);
+    EFI_STATUS (*Delete)(EFI_FILE_HANDLE File);
+    EFI_STATUS (*Read)(EFI_FILE_HANDLE File, UINTN *BufferSize, VOID *Buffer);
+    EFI_STATUS (*Write)(EFI_FILE_HANDLE File, UINTN *BufferSize, VOID *Buffer);
+    EFI_STATUS (*GetPosition)(EFI_FILE_HANDLE File, UINT64 *Position);
+    EFI_STATUS (*SetPosition)(EFI_FILE_HANDLE File, UINT64 Position);
+    EFI_STATUS (*GetInfo)(EFI_FILE_HANDLE File, EFI_GUID *InformationType, UINTN *BufferSize, VOID *Buffer);
+    EFI_STATUS (*SetInfo)(EFI_FILE_HANDLE File, EFI_GUID *InformationType, UINTN BufferSize, VOID *Buffer);
+    EFI_STATUS (*Flush)(EFI_FILE_HANDLE File);
+} EFI_FILE;
+
+typedef struct _EFI_SIMPLE_FILE_SYSTEM_PROTOCOL {
+    UINT64 Revision;
+    EFI_STATUS (*OpenVolume)(struct _EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *This, EFI_FILE_HANDLE *Root);
+} EFI_SIMPLE_FILE_SYSTEM_PROTOCOL;
+
+typedef struct {
+    UINT32     Revision;
+    EFI_HANDLE ParentHandle;
+    VOID      *SystemTable;
+    EFI_HANDLE DeviceHandle;
+} EFI_LOADED_IMAGE;
+
+// ---------------------------------------------------------------------------
+// Graphics output (never available hosted; LocateProtocol fails)
+// ---------------------------------------------------------------------------
+
+typedef enum {
+    PixelRedGreenBlueReserved8BitPerColor,
+    PixelBlueGreenRedReserved8BitPerColor,
+    PixelBitMask,
+    PixelBltOnly,
+    PixelFormatMax
+} EFI_GRAPHICS_PIXEL_FORMAT;
+
+typedef struct {
+    UINT32 RedMask;
+    UINT32 GreenMask;
+    UINT32 BlueMask;
+    UINT32 ReservedMask;
+} EFI_PIXEL_BITMASK;
+
+typedef struct {
+    UINT32                    Version;
+    UINT32                    HorizontalResolution;
+    UINT32                    VerticalResolution;
+    EFI_GRAPHICS_PIXEL_FORMAT PixelFormat;
+    EFI_PIXEL_BITMASK         PixelInformation;
+    UINT32                    PixelsPerScanLine;
+} EFI_GRAPHICS_OUTPUT_MODE_INFORMATION;
+
+typedef struct {
+    UINT32                                MaxMode;
+    UINT32                                Mode;
+    EFI_GRAPHICS_OUTPUT_MODE_INFORMATION *Info;
+    UINTN                                 SizeOfInfo;
+    EFI_PHYSICAL_ADDRESS                  FrameBufferBase;
+    UINTN                                 FrameBufferSize;
+} EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE;
+
+typedef struct {
+    VOID                              *QueryMode;
+    VOID                              *SetMode;
+    VOID                              *Blt;
+    EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE *Mode;
+} EFI_GRAPHICS_OUTPUT_PROTOCOL;
+
+// ---------------------------------------------------------------------------
+// Console + system table
+// ---------------------------------------------------------------------------
+
+typedef struct _SIMPLE_TEXT_OUTPUT_INTERFACE {
+    VOID *Reset;
+    EFI_STATUS (*OutputString)(struct _SIMPLE_TEXT_OUTPUT_INTERFACE *This, CHAR16 *String);
+} SIMPLE_TEXT_OUTPUT_INTERFACE;
+
+typedef struct _SIMPLE_INPUT_INTERFACE {
+    VOID *Reset;
+    EFI_STATUS (*ReadKeyStroke)(struct _SIMPLE_INPUT_INTERFACE *This, EFI_INPUT_KEY *Key);
+    EFI_EVENT WaitForKey;
+} SIMPLE_INPUT_INTERFACE;
+
+typedef struct {
+    EFI_STATUS (*AllocatePages)(EFI_ALLOCATE_TYPE Type, EFI_MEMORY_TYPE MemoryType, UINTN Pages, EFI_PHYSICAL_ADDRESS *Memory);
+    EFI_STATUS (*FreePages)(EFI_PHYSICAL_ADDRESS Memory, UINTN Pages);
+    EFI_STATUS (*AllocatePool)(EFI_MEMORY_TYPE PoolType, UINTN Size, VOID **Buffer);
+    EFI_STATUS (*FreePool)(VOID *Buffer);
+    EFI_STATUS (*WaitForEvent)(UINTN NumberOfEvents, EFI_EVENT *Event, UINTN *Index);
+    EFI_STATUS (*HandleProtocol)(EFI_HANDLE Handle, EFI_GUID *Protocol, VOID **Interface);
+    EFI_STATUS (*LocateProtocol)(EFI_GUID *Protocol, VOID *Registration, VOID **Interface);
+    EFI_STATUS (*Stall)(UINTN Microseconds);
+    EFI_STATUS (*SetWatchdogTimer)(UINTN Timeout, UINT64 WatchdogCode, UINTN DataSize, CHAR16 *WatchdogData);
+} EFI_BOOT_SERVICES;
+
+typedef struct {
+    EFI_STATUS (*GetTime)(EFI_TIME *Time, VOID *Capabilities);
+} EFI_RUNTIME_SERVICES;
+
+typedef struct {
+    SIMPLE_INPUT_INTERFACE       *ConIn;
+    SIMPLE_TEXT_OUTPUT_INTERFACE *ConOut;
+    EFI_RUNTIME_SERVICES         *RuntimeServices;
+    EFI_BOOT_SERVICES            *BootServices;
+} EFI_SYSTEM_TABLE;
+
+#endif // LLMK_HOSTED_EFI_H
@@ -0,0 +1,37 @@
+/*
+ * Minimal efilib.h for the hosted (Linux) build: the gnu-efi library calls
+ * used by the inference core, implemented on top of libc in
+ * hosted/llmk_hosted.c.
+ */
+
+#ifndef LLMK_HOSTED_EFILIB_H
+#define LLMK_HOSTED_EFILIB_H
+
+#include "efi.h"
+
+extern EFI_SYSTEM_TABLE  *ST;
+extern EFI_BOOT_SERVICES *BS;
+extern EFI_RUNTIME_SERVICES *RT;
+
+extern EFI_GUID LoadedImageProtocol;
+extern EFI_GUID FileSystemProtocol;
+extern EFI_GUID gEfiGraphicsOutputProtocolGuid;
+
+// No ABI switch hosted: every "firmware" call is a plain C call.
+#define uefi_call_wrapper(func, va_num, ...) ((func)(__VA_ARGS__))
+
+void  InitializeLib(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable);
+
+// gnu-efi format subset: %d %u %x %X %lu %ld %lx %c %s (CHAR16) %a (CHAR8)
+// %r (EFI_STATUS), with '-', '0' and width.
+UINTN Print(const CHAR16 *fmt, ...);
+UINTN SPrint(CHAR16 *Str, UINTN StrSize, const CHAR16 *fmt, ...);
+
+UINTN StrLen(const CHAR16 *s);
+void  StrCpy(CHAR16 *Dest, const CHAR16 *Src);
+
+// Hosted-only: system table + a volume rooted at the directory root_dir
+// (names opened through it are relative to root_dir unless absolute).
+EFI_STATUS llmk_hosted_init(const char *root_dir, EFI_FILE_HANDLE *root_out);
+
+#endif // LLMK_HOSTED_EFILIB_H
@@ -0,0 +1,477 @@
+/*
+ * Hosted (Linux) runtime behind hosted/efi.h + hosted/efilib.h.
+ *
+ * Just enough of the firmware for the inference core to run as a normal
+ * process: Print/SPrint, boot services (page allocations are anonymous
+ * mmaps, so the 1 GB Zone B only costs what is touched), GetTime, Stall and
+ * a file protocol over stdio. Graphics and protocol lookups always fail.
+ */
+
+#define _GNU_SOURCE
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "efi.h"
+#include "efilib.h"
+
+EFI_SYSTEM_TABLE *ST = NULL;
+EFI_BOOT_SERVICES *BS = NULL;
+EFI_RUNTIME_SERVICES *RT = NULL;
+
+EFI_GUID LoadedImageProtocol;
+EFI_GUID FileSystemProtocol;
+EFI_GUID gEfiGraphicsOutputProtocolGuid;
+
+// ============================================================================
+// Formatting (gnu-efi Print subset)
+// ============================================================================
+
+typedef struct {
+    CHAR16 *buf;   // NULL: count only
+    UINTN cap;     // in CHAR16, including the terminator
+    UINTN len;
+} HostedOut;
+
+static void out_ch(HostedOut *o, CHAR16 c) {
+    if (o->buf && o->len + 1 < o->cap) o->buf[o->len] = c;
+    o->len++;
+}
+
+static const char *hosted_status_str(EFI_STATUS st) {
+    switch (st) {
+        case EFI_SUCCESS:           return "Success";
+        case EFI_LOAD_ERROR:        return "Load Error";
+        case EFI_INVALID_PARAMETER: return "Invalid Parameter";
+        case EFI_UNSUPPORTED:       return "Unsupported";
+        case EFI_BAD_BUFFER_SIZE:   return "Bad Buffer Size";
+        case EFI_BUFFER_TOO_SMALL:  return "Buffer Too Small";
+        case EFI_NOT_READY:         return "Not Ready";
+        case EFI_DEVICE_ERROR:      return "Device Error";
+        case EFI_OUT_OF_RESOURCES:  return "Out of Resources";
+        case EFI_NOT_FOUND:         return "Not Found";
+        case EFI_ALREADY_STARTED:   return "Already started";
+        case EFI_COMPROMISED_DATA:  return "Compromised Data";
+        default:                    return "Unknown Error";
+    }
+}
+
+static void hosted_vformat(HostedOut *o, const CHAR16 *fmt, va_list ap) {
+    for (; *fmt; fmt++) {
+        if (*fmt != L'%') {
+            out_ch(o, *fmt);
+            continue;
+        }
+        fmt++;
+        int left = 0, zero = 0, width = 0, is_long = 0;
+        for (;; fmt++) {
+            if (*fmt == L'-') left = 1;
+            else if (*fmt == L'0') zero = 1;
+            else break;
+        }
+        while (*fmt >= L'0' && *fmt <= L'9') width = width * 10 + (int)(*fmt++ - L'0');
+        while (*fmt == L'l') { is_long = 1; fmt++; }
+        if (*fmt == 0) break;
+
+        char tmp[32];
+        const char *a = NULL;       // ASCII / status text
+        const CHAR16 *w = NULL;     // CHAR16 text
+        CHAR16 c1[2] = { 0, 0 };
+        switch (*fmt) {
+            case L'd':
+                if (is_long) snprintf(tmp, sizeof(tmp), "%lld", (long long)va_arg(ap, INT64));
+                else snprintf(tmp, sizeof(tmp), "%d", va_arg(ap, int));
+                a = tmp;
+                break;
+            case L'u':
+                if (is_long) snprintf(tmp, sizeof(tmp), "%llu", (unsigned long long)va_arg(ap, UINT64));
+                else snprintf(tmp, sizeof(tmp), "%u", va_arg(ap, unsigned int));
+                a = tmp;
+                break;
+            case L'x':
+            case L'X':
+                if (is_long) snprintf(tmp, sizeof(tmp), *fmt == L'x' ? "%llx" : "%llX", (unsigned long long)va_arg(ap, UINT64));
+                else snprintf(tmp, sizeof(tmp), *fmt == L'x' ? "%x" : "%X", va_arg(ap, unsigned int));
+                a = tmp;
+                break;
+            case L'c':
+                c1[0] = (CHAR16)va_arg(ap, int);
+                w = c1;
+                break;
+            case L's':
+                w = va_arg(ap, const CHAR16 *);
+                if (!w) w = L"(null)";
+                break;
+            case L'a':
+                a = va_arg(ap, const char *);
+                if (!a) a = "(null)";
+                break;
+            case L'r':
+                a = hosted_status_str(va_arg(ap, EFI_STATUS));
+                break;
+            case L'%':
+                a = "%";
+                break;
+            default:
+                out_ch(o, L'%');
+                out_ch(o, *fmt);
+                continue;
+        }
+
+        int n = 0;
+        if (a) n = (int)strlen(a);
+        else while (w[n]) n++;
+        CHAR16 pad = (zero && !left && (*fmt != L's' && *fmt != L'a')) ? L'0' : L' ';
+        // Zero padding goes after a leading minus sign.
+        if (a && pad == L'0' && a[0] == '-' && n < width) {
+            out_ch(o, L'-');
+            a++;
+            n--;
+            width--;
+        }
+        if (!left) for (int i = n; i < width; i++) out_ch(o, pad);
+        for (int i = 0; i < n; i++) out_ch(o, a ? (CHAR16)(unsigned char)a[i] : w[i]);
+        if (left) for (int i = n; i < width; i++) out_ch(o, L' ');
+    }
+    if (o->buf && o->cap) o->buf[(o->len < o->cap) ? o->len : o->cap - 1] = 0;
+}
+
+// UTF-16 -> UTF-8 on stdout; CR is dropped (the sources print CRLF).
+static void hosted_puts16(const CHAR16 *s, UINTN n) {
+    for (UINTN i = 0; i < n; i++) {
+        UINT32 c = s[i];
+        if (c == L'\r') continue;
+        if (c < 0x80) {
+            putchar((int)c);
+        } else if (c < 0x800) {
+            putchar(0xC0 | (int)(c >> 6));
+            putchar(0x80 | (int)(c & 0x3F));
+        } else {
+            putchar(0xE0 | (int)(c >> 12));
+            putchar(0x80 | (int)((c >> 6) & 0x3F));
+            putchar(0x80 | (int)(c & 0x3F));
+        }
+    }
+}
+
+UINTN Print(const CHAR16 *fmt, ...) {
+    CHAR16 line[1024];
+    HostedOut o = { line, sizeof(line) / sizeof(line[0]), 0 };
+    va_list ap;
+    va_start(ap, fmt);
+    hosted_vformat(&o, fmt, ap);
+    va_end(ap);
+    if (o.len >= o.cap) {
+        // Too long for the stack buffer: format again into the heap.
+        CHAR16 *big = (CHAR16 *)malloc((o.len + 1) * sizeof(CHAR16));
+        if (!big) return 0;
+        HostedOut o2 = { big, o.len + 1, 0 };
+        va_start(ap, fmt);
+        hosted_vformat(&o2, fmt, ap);
+        va_end(ap);
+        hosted_puts16(big, o2.len);
+        free(big);
+    } else {
+        hosted_puts16(line, o.len);
+    }
+    fflush(stdout);
+    return o.len;
+}
+
+UINTN SPrint(CHAR16 *Str, UINTN StrSize, const CHAR16 *fmt, ...) {
+    // StrSize is in bytes, as in gnu-efi.
+    HostedOut o = { Str, StrSize / sizeof(CHAR16), 0 };
+    va_list ap;
+    va_start(ap, fmt);
+    hosted_vformat(&o, fmt, ap);
+    va_end(ap);
+    return (o.len < o.cap) ? o.len : (o.cap ? o.cap - 1 : 0);
+}
+
+UINTN StrLen(const CHAR16 *s) {
+    UINTN n = 0;
+    while (s[n]) n++;
+    return n;
+}
+
+void StrCpy(CHAR16 *Dest, const CHAR16 *Src) {
+    while ((*Dest++ = *Src++) != 0) { }
+}
+
+// ============================================================================
+// File protocol over stdio
+// ============================================================================
+
+typedef struct {
+    EFI_FILE proto;  // first: EFI_FILE_HANDLE points here
+    FILE *fp;        // NULL for the volume root (a directory)
+    char path[4096];
+} HostedFile;
+
+static EFI_STATUS EFIAPI hf_open(EFI_FILE_HANDLE File, EFI_FILE_HANDLE *NewHandle, CHAR16 *FileName, UINT64 OpenMode, UINT64 Attributes);
+
+static EFI_STATUS EFIAPI hf_close(EFI_FILE_HANDLE File) {
+    HostedFile *f = (HostedFile *)File;
+    if (f->fp) fclose(f->fp);
+    free(f);
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hf_delete(EFI_FILE_HANDLE File) {
+    HostedFile *f = (HostedFile *)File;
+    if (f->fp) {
+        fclose(f->fp);
+        f->fp = NULL;
+    }
+    int rc = remove(f->path);
+    free(f);
+    return (rc == 0) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+static EFI_STATUS EFIAPI hf_read(EFI_FILE_HANDLE File, UINTN *BufferSize, VOID *Buffer) {
+    HostedFile *f = (HostedFile *)File;
+    if (!f->fp) return EFI_UNSUPPORTED;
+    size_t n = fread(Buffer, 1, (size_t)*BufferSize, f->fp);
+    *BufferSize = (UINTN)n;
+    return ferror(f->fp) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hf_write(EFI_FILE_HANDLE File, UINTN *BufferSize, VOID *Buffer) {
+    HostedFile *f = (HostedFile *)File;
+    if (!f->fp) return EFI_UNSUPPORTED;
+    size_t want = (size_t)*BufferSize;
+    size_t n = fwrite(Buffer, 1, want, f->fp);
+    *BufferSize = (UINTN)n;
+    return (n < want) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hf_get_position(EFI_FILE_HANDLE File, UINT64 *Position) {
+    HostedFile *f = (HostedFile *)File;
+    if (!f->fp) return EFI_UNSUPPORTED;
+    off_t p = ftello(f->fp);
+    if (p < 0) return EFI_DEVICE_ERROR;
+    *Position = (UINT64)p;
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hf_set_position(EFI_FILE_HANDLE File, UINT64 Position) {
+    HostedFile *f = (HostedFile *)File;
+    if (!f->fp) return EFI_UNSUPPORTED;
+    // All ones means end of file (UEFI spec).
+    int rc = (Position == ~0ULL) ? fseeko(f->fp, 0, SEEK_END) : fseeko(f->fp, (off_t)Position, SEEK_SET);
+    return (rc == 0) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+static EFI_STATUS EFIAPI hf_get_info(EFI_FILE_HANDLE File, EFI_GUID *InformationType, UINTN *BufferSize, VOID *Buffer) {
+    HostedFile *f = (HostedFile *)File;
+    (void)InformationType;  // EFI_FILE_INFO is the only one asked for
+    if (*BufferSize < sizeof(EFI_FILE_INFO) || !Buffer) {
+        *BufferSize = sizeof(EFI_FILE_INFO);
+        return EFI_BUFFER_TOO_SMALL;
+    }
+    struct stat sb;
+    if (stat(f->path, &sb) != 0) return EFI_DEVICE_ERROR;
+    EFI_FILE_INFO *info = (EFI_FILE_INFO *)Buffer;
+    memset(info, 0, sizeof(*info));
+    info->Size = sizeof(EFI_FILE_INFO);
+    info->FileSize = (UINT64)sb.st_size;
+    info->PhysicalSize = (UINT64)sb.st_size;
+    *BufferSize = sizeof(EFI_FILE_INFO);
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hf_set_info(EFI_FILE_HANDLE File, EFI_GUID *InformationType, UINTN BufferSize, VOID *Buffer) {
+    (void)File; (void)InformationType; (void)BufferSize; (void)Buffer;
+    return EFI_UNSUPPORTED;
+}
+
+static EFI_STATUS EFIAPI hf_flush(EFI_FILE_HANDLE File) {
+    HostedFile *f = (HostedFile *)File;
+    if (f->fp) fflush(f->fp);
+    return EFI_SUCCESS;
+}
+
+static HostedFile *hf_new(const char *path, FILE *fp) {
+    HostedFile *f = (HostedFile *)calloc(1, sizeof(HostedFile));
+    if (!f) return NULL;
+    f->proto.Revision = 0x00010000;
+    f->proto.Open = hf_open;
+    f->proto.Close = hf_close;
+    f->proto.Delete = hf_delete;
+    f->proto.Read = hf_read;
+    f->proto.Write = hf_write;
+    f->proto.GetPosition = hf_get_position;
+    f->proto.SetPosition = hf_set_position;
+    f->proto.GetInfo = hf_get_info;
+    f->proto.SetInfo = hf_set_info;
+    f->proto.Flush = hf_flush;
+    f->fp = fp;
+    snprintf(f->path, sizeof(f->path), "%s", path);
+    return f;
+}
+
+static EFI_STATUS EFIAPI hf_open(EFI_FILE_HANDLE File, EFI_FILE_HANDLE *NewHandle, CHAR16 *FileName, UINT64 OpenMode, UINT64 Attributes) {
+    HostedFile *dir = (HostedFile *)File;
+    (void)Attributes;
+
+    // UEFI names use '\'; absolute host paths pass through unchanged.
+    char name[2048];
+    UINTN i = 0;
+    for (; FileName[i] && i + 1 < sizeof(name); i++) {
+        CHAR16 c = FileName[i];
+        name[i] = (c == L'\\') ? '/' : (char)c;
+    }
+    name[i] = 0;
+
+    char path[4096];
+    int n = (name[0] == '/') ? snprintf(path, sizeof(path), "%s", name)
+                             : snprintf(path, sizeof(path), "%s/%s", dir->path, name);
+    if (n < 0 || n >= (int)sizeof(path)) return EFI_INVALID_PARAMETER;
+
+    FILE *fp = NULL;
+    if (OpenMode & EFI_FILE_MODE_CREATE) {
+        fp = fopen(path, "r+b");
+        if (!fp) fp = fopen(path, "w+b");
+    } else if (OpenMode & EFI_FILE_MODE_WRITE) {
+        fp = fopen(path, "r+b");
+    } else {
+        fp = fopen(path, "rb");
+    }
+    if (!fp) return EFI_NOT_FOUND;
+
+    HostedFile *f = hf_new(path, fp);
+    if (!f) {
+        fclose(fp);
+        return EFI_OUT_OF_RESOURCES;
+    }
+    *NewHandle = &f->proto;
+    return EFI_SUCCESS;
+}
+
+// ============================================================================
+// Boot / runtime services
+// ============================================================================
+
+static EFI_STATUS EFIAPI hs_allocate_pages(EFI_ALLOCATE_TYPE Type, EFI_MEMORY_TYPE MemoryType, UINTN Pages, EFI_PHYSICAL_ADDRESS *Memory) {
+    (void)MemoryType;
+    if (Type != AllocateAnyPages) return EFI_UNSUPPORTED;
+    void *p = mmap(NULL, (size_t)Pages * 4096, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) return EFI_OUT_OF_RESOURCES;
+    *Memory = (EFI_PHYSICAL_ADDRESS)(UINTN)p;
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hs_free_pages(EFI_PHYSICAL_ADDRESS Memory, UINTN Pages) {
+    munmap((void *)(UINTN)Memory, (size_t)Pages * 4096);
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hs_allocate_pool(EFI_MEMORY_TYPE PoolType, UINTN Size, VOID **Buffer) {
+    (void)PoolType;
+    *Buffer = malloc(Size ? Size : 1);
+    return *Buffer ? EFI_SUCCESS : EFI_OUT_OF_RESOURCES;
+}
+
+static EFI_STATUS EFIAPI hs_free_pool(VOID *Buffer) {
+    free(Buffer);
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hs_wait_for_event(UINTN NumberOfEvents, EFI_EVENT *Event, UINTN *Index) {
+    (void)NumberOfEvents; (void)Event;
+    if (Index) *Index = 0;
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hs_no_protocol(EFI_HANDLE Handle, EFI_GUID *Protocol, VOID **Interface) {
+    (void)Handle; (void)Protocol;
+    *Interface = NULL;
+    return EFI_UNSUPPORTED;
+}
+
+static EFI_STATUS EFIAPI hs_locate_protocol(EFI_GUID *Protocol, VOID *Registration, VOID **Interface) {
+    (void)Protocol; (void)Registration;
+    *Interface = NULL;
+    return EFI_NOT_FOUND;
+}
+
+static EFI_STATUS EFIAPI hs_stall(UINTN Microseconds) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(Microseconds / 1000000);
+    ts.tv_nsec = (long)(Microseconds % 1000000) * 1000L;
+    while (nanosleep(&ts, &ts) != 0) { }
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hs_set_watchdog(UINTN Timeout, UINT64 WatchdogCode, UINTN DataSize, CHAR16 *WatchdogData) {
+    (void)Timeout; (void)WatchdogCode; (void)DataSize; (void)WatchdogData;
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hs_get_time(EFI_TIME *Time, VOID *Capabilities) {
+    (void)Capabilities;
+    struct timespec ts;
+    struct tm tm;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    localtime_r(&ts.tv_sec, &tm);
+    memset(Time, 0, sizeof(*Time));
+    Time->Year = (UINT16)(tm.tm_year + 1900);
+    Time->Month = (UINT8)(tm.tm_mon + 1);
+    Time->Day = (UINT8)tm.tm_mday;
+    Time->Hour = (UINT8)tm.tm_hour;
+    Time->Minute = (UINT8)tm.tm_min;
+    Time->Second = (UINT8)tm.tm_sec;
+    Time->Nanosecond = (UINT32)ts.tv_nsec;
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hs_output_string(SIMPLE_TEXT_OUTPUT_INTERFACE *This, CHAR16 *String) {
+    (void)This;
+    hosted_puts16(String, StrLen(String));
+    fflush(stdout);
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS EFIAPI hs_read_key(SIMPLE_INPUT_INTERFACE *This, EFI_INPUT_KEY *Key) {
+    (void)This;
+    int c = getchar();
+    if (c == EOF) return EFI_DEVICE_ERROR;
+    Key->ScanCode = 0;
+    Key->UnicodeChar = (c == '\n') ? L'\r' : (CHAR16)c;
+    return EFI_SUCCESS;
+}
+
+static EFI_BOOT_SERVICES g_hosted_bs = {
+    hs_allocate_pages,
+    hs_free_pages,
+    hs_allocate_pool,
+    hs_free_pool,
+    hs_wait_for_event,
+    hs_no_protocol,
+    hs_locate_protocol,
+    hs_stall,
+    hs_set_watchdog,
+};
+static EFI_RUNTIME_SERVICES g_hosted_rt = { hs_get_time };
+static SIMPLE_TEXT_OUTPUT_INTERFACE g_hosted_conout = { NULL, hs_output_string };
+static SIMPLE_INPUT_INTERFACE g_hosted_conin = { NULL, hs_read_key, NULL };
+static EFI_SYSTEM_TABLE g_hosted_st = { &g_hosted_conin, &g_hosted_conout, &g_hosted_rt, &g_hosted_bs };
+
+void InitializeLib(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable) {
+    (void)ImageHandle;
+    ST = SystemTable;
+    BS = SystemTable->BootServices;
+    RT = SystemTable->RuntimeServices;
+}
+
+EFI_STATUS llmk_hosted_init(const char *root_dir, EFI_FILE_HANDLE *root_out) {
+    InitializeLib(NULL, &g_hosted_st);
+    HostedFile *root = hf_new(root_dir ? root_dir : ".", NULL);
+    if (!root) return EFI_OUT_OF_RESOURCES;
+    *root_out = &root->proto;
+    return EFI_SUCCESS;
+}
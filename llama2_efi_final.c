@@ -14,6 +14,7 @@
 // djiblas optimized matmul
 #define DJIBLAS_DISABLE_CPUID 0
 #include "djiblas.h"
+#include "djibquant.h"
 
 // LLM-Kernel primitives (zones + sentinel + post-mortem log)
 #include "llmk_zones.h"
@@ -47,14 +48,6 @@ static int has_suffix_repeat(const int* tokens, int n_tokens, int span) {
     return 1;
 }
 
-// AVX2 attention helpers live in attention_avx2.c (compiled with -mavx2)
-float llmk_dot_f32_avx2(const float *a, const float *b, int n);
-void llmk_axpy_f32_avx2(float *dst, const float *src, float alpha, int n);
-
-static int g_attn_use_avx2 = 0;
-// -1=auto, 0=force SSE2, 1=force AVX2 (only allowed if auto-detected AVX2 is enabled)
-static int g_attn_force = -1;
-
 // One-shot fail-safe test harness.
 static int g_test_failsafe_active = 0;
 static BOOLEAN g_test_failsafe_prev_strict_budget = FALSE;
@@ -295,6 +288,18 @@ static void enable_avx_best_effort(void) {
         : "memory"
     );
     UINT32 new_lo = xcr0_lo | 0x7u;
+
+    // AVX-512: also enable opmask (bit5), ZMM_Hi256 (bit6), Hi16_ZMM (bit7),
+    // but only if the CPU has AVX-512F and XSAVE supports all three
+    // (CPUID.(EAX=0Dh,ECX=0):EAX lists the XCR0 bits the CPU accepts).
+    UINT32 max_leaf;
+    cpuidex_u32(0, 0, &max_leaf, &ebx, &ecx, &edx);
+    if (max_leaf >= 0xD) cpuidex_u32(7, 0, &eax, &ebx, &ecx, &edx);
+    else ebx = 0;
+    if (ebx & (1u << 16)) {
+        cpuidex_u32(0xD, 0, &eax, &ebx, &ecx, &edx);
+        if ((eax & 0xE0u) == 0xE0u) new_lo |= 0xE0u;
+    }
     if (new_lo != xcr0_lo) {
         __asm__ volatile(
             "xsetbv"
@@ -329,59 +334,6 @@ static void apply_no_repeat_ngram(float* logits, int vocab_size, const int* toke
     }
 }
 
-static inline float dot_f32_sse2(const float* a, const float* b, int n) {
-#if defined(__x86_64__) || defined(_M_X64)
-    __m128 sum = _mm_setzero_ps();
-    int i = 0;
-    for (; i + 4 <= n; i += 4) {
-        __m128 va = _mm_loadu_ps(a + i);
-        __m128 vb = _mm_loadu_ps(b + i);
-        sum = _mm_add_ps(sum, _mm_mul_ps(va, vb));
-    }
-    float tmp[4];
-    _mm_storeu_ps(tmp, sum);
-    float total = tmp[0] + tmp[1] + tmp[2] + tmp[3];
-    for (; i < n; i++) total += a[i] * b[i];
-    return total;
-#else
-    float total = 0.0f;
-    for (int i = 0; i < n; i++) total += a[i] * b[i];
-    return total;
-#endif
-}
-
-static inline void axpy_f32_sse2(float* dst, const float* src, float a, int n) {
-#if defined(__x86_64__) || defined(_M_X64)
-    __m128 va = _mm_set1_ps(a);
-    int i = 0;
-    for (; i + 4 <= n; i += 4) {
-        __m128 vd = _mm_loadu_ps(dst + i);
-        __m128 vs = _mm_loadu_ps(src + i);
-        vd = _mm_add_ps(vd, _mm_mul_ps(va, vs));
-        _mm_storeu_ps(dst + i, vd);
-    }
-    for (; i < n; i++) dst[i] += a * src[i];
-#else
-    for (int i = 0; i < n; i++) dst[i] += a * src[i];
-#endif
-}
-
-static inline float dot_f32_best(const float* a, const float* b, int n) {
-    int use_avx2 = g_attn_use_avx2;
-    if (g_attn_force == 0) use_avx2 = 0;
-    else if (g_attn_force == 1) use_avx2 = 1;
-    if (use_avx2) return llmk_dot_f32_avx2(a, b, n);
-    return dot_f32_sse2(a, b, n);
-}
-
-static inline void axpy_f32_best(float* dst, const float* src, float a, int n) {
-    int use_avx2 = g_attn_use_avx2;
-    if (g_attn_force == 0) use_avx2 = 0;
-    else if (g_attn_force == 1) use_avx2 = 1;
-    if (use_avx2) { llmk_axpy_f32_avx2(dst, src, a, n); return; }
-    axpy_f32_sse2(dst, src, a, n);
-}
-
 // ============================================================================
 // HEAP ALLOCATOR
 // ============================================================================
@@ -395,6 +347,16 @@ static LlmkLog g_llmk_log;
 static LlmkSentinel g_sentinel;
 static int g_llmk_ready = 0;
 
+// LLMK_ARENA_SCRATCH starts with the activation quant cache (the DjibLAS
+// Q8 workspace), which lives for the whole run; transient users (repack,
+// autotune, /bench_kernels) allocate above it and reset back to it.
+static UINT64 g_scratch_keep = 0;
+
+static void llmk_scratch_reset(void) {
+    llmk_arena_reset(&g_zones, LLMK_ARENA_SCRATCH);
+    if (g_scratch_keep) llmk_arena_alloc(&g_zones, LLMK_ARENA_SCRATCH, g_scratch_keep, 64);
+}
+
 // DjibMark global state
 DjibMarkState g_djibmark_state = {0};
 
@@ -842,6 +804,7 @@ static EFI_STATUS llmk_save_ppm(const CHAR16 *name) {
     return EFI_SUCCESS;
 }
 
+// Cycle budgets per token; prefill scales its budget to the block size.
 static UINT64 g_budget_prefill_cycles = 0;
 static UINT64 g_budget_decode_cycles = 0;
 
@@ -1100,32 +1063,11 @@ static int llmk_cfg_parse_bool(const char *s, int *out) {
     return 0;
 }
 
-static void llmk_load_repl_cfg_best_effort(
-    float *temperature,
-    float *min_p,
-    float *top_p,
-    int *top_k,
-    float *repeat_penalty,
-    int *no_repeat_ngram,
-    int *max_gen_tokens,
-    int *stats_enabled,
-    int *stop_on_you,
-    int *stop_on_double_nl
-) {
-    EFI_FILE_HANDLE f = NULL;
-    EFI_STATUS st = llmk_open_read_file(&f, L"repl.cfg");
-    if (EFI_ERROR(st)) return;
-
-    char buf[4096];
-    UINTN sz = sizeof(buf) - 1;
-    st = uefi_call_wrapper(f->Read, 3, f, &sz, buf);
-    uefi_call_wrapper(f->Close, 1, f);
-    if (EFI_ERROR(st) || sz == 0) return;
-    buf[sz] = 0;
-
-    int applied = 0;
-
-    char *p = buf;
+// Split the next "key=value" line out of a NUL-terminated cfg buffer.
+// Skips blank lines and comments; the key is returned lowercased.
+// Returns 0 at end of buffer.
+static int llmk_cfg_next_kv(char **cursor, char **key_out, char **val_out) {
+    char *p = *cursor;
     while (*p) {
         char *line = p;
         while (*p && *p != '\n') p++;
@@ -1157,6 +1099,119 @@ static void llmk_load_repl_cfg_best_effort(
         // Lowercase key in-place (ASCII).
         for (char *k = key; *k; k++) *k = llmk_cfg_tolower(*k);
 
+        *cursor = p;
+        *key_out = key;
+        *val_out = val;
+        return 1;
+    }
+    *cursor = p;
+    return 0;
+}
+
+// Boot-time options: read from repl.cfg before the model is loaded, because
+// they change how weights/state are laid out in the zones.
+typedef struct {
+    int repack;     // 1 = rewrite GEMV weights into panel-interleaved layout at load
+    int autotune;   // 0 = off, 1 = load djiblas.tune (measure + save if missing), 2 = always re-measure
+    UINT64 llc_kb;  // streaming GEMV threshold, 0 = CPUID last-level cache size
+    int stream_pf;  // streaming prefetch distance in bytes, 0 = never stream
+    int stream_nta; // 1 = PREFETCHNTA, 0 = PREFETCHT0
+    int kv_head_major; // 1 = KV cache [layer][kv_head][pos][head_size], 0 = [layer][pos][kv_dim]
+    int kv_type;       // DJIBLAS_KV_F32 / F16 / Q8 (int8 with one scale per head row)
+    int kv_rolling;    // 1 = full context keeps kv_sinks first tokens + a ring of the latest, 0 = reset
+    int kv_sinks;
+} LlmkBootCfg;
+
+static LlmkBootCfg g_boot_cfg = {
+    .repack = 1,
+    .autotune = 1,
+    .llc_kb = 0,
+    .stream_pf = DJIBLAS_STREAM_PF_DEFAULT,
+    .stream_nta = 0,
+    .kv_head_major = 0,
+    .kv_type = DJIBLAS_KV_F32,
+    .kv_rolling = 0,
+    .kv_sinks = 4,
+};
+
+static void llmk_load_boot_cfg_best_effort(LlmkBootCfg *cfg) {
+    EFI_FILE_HANDLE f = NULL;
+    EFI_STATUS st = llmk_open_read_file(&f, L"repl.cfg");
+    if (EFI_ERROR(st)) return;
+
+    char buf[4096];
+    UINTN sz = sizeof(buf) - 1;
+    st = uefi_call_wrapper(f->Read, 3, f, &sz, buf);
+    uefi_call_wrapper(f->Close, 1, f);
+    if (EFI_ERROR(st) || sz == 0) return;
+    buf[sz] = 0;
+
+    char *p = buf;
+    char *key;
+    char *val;
+    while (llmk_cfg_next_kv(&p, &key, &val)) {
+        if (llmk_cfg_streq_ci(key, "repack")) {
+            int b;
+            if (llmk_cfg_parse_bool(val, &b)) cfg->repack = (b != 0);
+        } else if (llmk_cfg_streq_ci(key, "autotune")) {
+            int b;
+            if (llmk_cfg_streq_ci(val, "force")) cfg->autotune = 2;
+            else if (llmk_cfg_parse_bool(val, &b)) cfg->autotune = (b != 0);
+        } else if (llmk_cfg_streq_ci(key, "llc_kb")) {
+            UINT64 v;
+            if (llmk_cfg_parse_u64(val, &v)) cfg->llc_kb = v;
+        } else if (llmk_cfg_streq_ci(key, "stream_pf")) {
+            int v;
+            if (llmk_cfg_parse_i32(val, &v) && v >= 0 && v <= 65536) cfg->stream_pf = v;
+        } else if (llmk_cfg_streq_ci(key, "stream_hint")) {
+            if (llmk_cfg_streq_ci(val, "nta")) cfg->stream_nta = 1;
+            else if (llmk_cfg_streq_ci(val, "t0")) cfg->stream_nta = 0;
+        } else if (llmk_cfg_streq_ci(key, "kv_layout")) {
+            if (llmk_cfg_streq_ci(val, "head")) cfg->kv_head_major = 1;
+            else if (llmk_cfg_streq_ci(val, "pos")) cfg->kv_head_major = 0;
+        } else if (llmk_cfg_streq_ci(key, "kv_cache")) {
+            if (llmk_cfg_streq_ci(val, "fp32")) cfg->kv_type = DJIBLAS_KV_F32;
+            else if (llmk_cfg_streq_ci(val, "fp16")) cfg->kv_type = DJIBLAS_KV_F16;
+            else if (llmk_cfg_streq_ci(val, "int8")) cfg->kv_type = DJIBLAS_KV_Q8;
+        } else if (llmk_cfg_streq_ci(key, "kv_rolling")) {
+            int b;
+            if (llmk_cfg_parse_bool(val, &b)) cfg->kv_rolling = (b != 0);
+        } else if (llmk_cfg_streq_ci(key, "kv_sinks")) {
+            int v;
+            if (llmk_cfg_parse_i32(val, &v) && v >= 0 && v <= 64) cfg->kv_sinks = v;
+        }
+    }
+}
+
+static void llmk_load_repl_cfg_best_effort(
+    float *temperature,
+    float *min_p,
+    float *top_p,
+    int *top_k,
+    float *repeat_penalty,
+    int *no_repeat_ngram,
+    int *max_gen_tokens,
+    int *stats_enabled,
+    int *stop_on_you,
+    int *stop_on_double_nl
+) {
+    EFI_FILE_HANDLE f = NULL;
+    EFI_STATUS st = llmk_open_read_file(&f, L"repl.cfg");
+    if (EFI_ERROR(st)) return;
+
+    char buf[4096];
+    UINTN sz = sizeof(buf) - 1;
+    st = uefi_call_wrapper(f->Read, 3, f, &sz, buf);
+    uefi_call_wrapper(f->Close, 1, f);
+    if (EFI_ERROR(st) || sz == 0) return;
+    buf[sz] = 0;
+
+    int applied = 0;
+
+    char *p = buf;
+    char *key;
+    char *val;
+    while (llmk_cfg_next_kv(&p, &key, &val)) {
         if (llmk_cfg_streq_ci(key, "temp") || llmk_cfg_streq_ci(key, "temperature")) {
             float v;
             if (llmk_cfg_parse_f32(val, &v)) {
@@ -1263,16 +1318,12 @@ static void llmk_load_repl_cfg_best_effort(
             }
         } else if (llmk_cfg_streq_ci(key, "attn")) {
             if (llmk_cfg_streq_ci(val, "auto")) {
-                g_attn_force = -1;
-                applied = 1;
+                applied |= djiblas_dispatch_force_attn(-1) ? 1 : 0;
             } else if (llmk_cfg_streq_ci(val, "sse2")) {
-                g_attn_force = 0;
-                applied = 1;
+                applied |= djiblas_dispatch_force_attn(0) ? 1 : 0;
             } else if (llmk_cfg_streq_ci(val, "avx2")) {
-                if (g_attn_use_avx2) {
-                    g_attn_force = 1;
-                    applied = 1;
-                }
+                // Only honored if the dispatch table found a usable AVX2 path.
+                applied |= djiblas_dispatch_force_attn(1) ? 1 : 0;
             }
         }
     }
@@ -1361,13 +1412,53 @@ float fast_sqrt(float x) {
     return 1.0f / x;
 }
 
-float fast_exp(float x) {
-    if (x < -10.0f) return 0.0f;
-    if (x > 10.0f) return 22026.0f;
-    x = 1.0f + x / 256.0f;
-    x *= x; x *= x; x *= x; x *= x;
-    x *= x; x *= x; x *= x; x *= x;
-    return x;
+// e^x in double (x <= 0): 2^k * e^r with |r| <= ln2 / 2 and a Taylor series.
+static double llmk_exp_d(double x) {
+    if (x < -700.0) return 0.0;
+    const double ln2 = 0.69314718055994530942;
+    int k = (int)(x / ln2 - 0.5);
+    double r = x - (double)k * ln2;
+    double t = 1.0, e = 1.0;
+    for (int i = 1; i < 16; i++) {
+        t *= r / (double)i;
+        e += t;
+    }
+    for (; k < 0; k++) e *= 0.5;
+    return e;
+}
+
+// sin / cos in double: reduce by multiples of pi/2 to |r| <= pi/4, then
+// Taylor series, then rotate by the quadrant.
+static void llmk_sincos_d(double a, double* sn, double* cs) {
+    const double half_pi = 1.57079632679489661923;
+    INT64 n = (INT64)(a / half_pi + ((a >= 0.0) ? 0.5 : -0.5));
+    double r = a - (double)n * half_pi;
+    double r2 = r * r, ts = r, tc = 1.0, s = r, c = 1.0;
+    for (int i = 1; i < 10; i++) {
+        ts *= -r2 / (double)((2 * i) * (2 * i + 1));
+        tc *= -r2 / (double)((2 * i - 1) * (2 * i));
+        s += ts;
+        c += tc;
+    }
+    switch (n & 3) {
+        case 0: *sn = s;  *cs = c;  break;
+        case 1: *sn = c;  *cs = -s; break;
+        case 2: *sn = -s; *cs = -c; break;
+        default: *sn = -c; *cs = s; break;
+    }
+}
+
+// RoPE table row of position pos (djiblas_rope_fn layout): pair j rotates by
+// pos * 10000^(-2j / head_size).
+static void llmk_rope_row(float* C, float* S, int head_size, int pos) {
+    const double ln_base = 9.21034037197618273607;   // ln(10000)
+    for (int i = 0; i < head_size; i += 2) {
+        double sn, cs;
+        llmk_sincos_d((double)pos * llmk_exp_d(-ln_base * (double)i / (double)head_size), &sn, &cs);
+        C[i] = C[i + 1] = (float)cs;
+        S[i] = -(float)sn;
+        S[i + 1] = (float)sn;
+    }
 }
 
 int my_strncmp(const char* s1, const char* s2, int n) {
@@ -1382,110 +1473,13 @@ int my_strncmp(const char* s1, const char* s2, int n) {
 // TRANSFORMER OPERATIONS
 // ============================================================================
 
-void rmsnorm(float* o, float* x, float* weight, int size) {
-    float ss = 0.0f;
-    for (int j = 0; j < size; j++) {
-        ss += x[j] * x[j];
-    }
-    ss /= size;
-    ss += 1e-5f;
-    ss = 1.0f / fast_sqrt(ss);
-    for (int j = 0; j < size; j++) {
-        o[j] = weight[j] * (ss * x[j]);
-    }
-}
-
-void matmul(float* xout, float* x, float* w, int n, int d) {
-    // DjibLAS computes (column-major): C(m×n) = A(k×m)^T · B(k×n)
-    // We want (row-major weights): xout(d) = W(d×n) · x(n)
-    // Trick: W(d×n) row-major has the same memory layout as B(k×n_out)
-    // column-major when k=n and n_out=d (because W[i*n + l] == B[l + k*i]).
-    // Use A = x as a (k×1) column-major matrix.
-    // Result C is (1×d) column-major, so it lands contiguous into xout.
-    djiblas_sgemm_f32(
-        /*m=*/1, /*n=*/d, /*k=*/n,
-        /*A=*/x, /*lda=*/n,
-        /*B=*/w, /*ldb=*/n,
-        /*C=*/xout, /*ldc=*/1
-    );
-}
-
-void softmax(float* x, int size) {
-    float max_val = x[0];
-#if defined(__x86_64__) || defined(_M_X64)
-    // SSE2 max reduction
-    {
-        __m128 vmax = _mm_set1_ps(max_val);
-        int i = 0;
-        for (; i + 4 <= size; i += 4) {
-            __m128 v = _mm_loadu_ps(&x[i]);
-            vmax = _mm_max_ps(vmax, v);
-        }
-        __m128 shuf = _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(2, 3, 0, 1));
-        vmax = _mm_max_ps(vmax, shuf);
-        shuf = _mm_shuffle_ps(vmax, vmax, _MM_SHUFFLE(1, 0, 3, 2));
-        vmax = _mm_max_ps(vmax, shuf);
-        _mm_store_ss(&max_val, vmax);
-        for (; i < size; i++) {
-            if (x[i] > max_val) max_val = x[i];
-        }
-    }
-#else
-    for (int i = 1; i < size; i++) {
-        if (x[i] > max_val) max_val = x[i];
-    }
-#endif
-
-    float sum = 0.0f;
-#if defined(__x86_64__) || defined(_M_X64)
-    // Scalar exp, but vectorized accumulation + normalization.
-    {
-        __m128 vsum = _mm_setzero_ps();
-        int i = 0;
-        for (; i + 4 <= size; i += 4) {
-            float e0 = fast_exp(x[i + 0] - max_val);
-            float e1 = fast_exp(x[i + 1] - max_val);
-            float e2 = fast_exp(x[i + 2] - max_val);
-            float e3 = fast_exp(x[i + 3] - max_val);
-            x[i + 0] = e0;
-            x[i + 1] = e1;
-            x[i + 2] = e2;
-            x[i + 3] = e3;
-            __m128 v = _mm_loadu_ps(&x[i]);
-            vsum = _mm_add_ps(vsum, v);
-        }
-        __m128 shuf = _mm_shuffle_ps(vsum, vsum, _MM_SHUFFLE(2, 3, 0, 1));
-        vsum = _mm_add_ps(vsum, shuf);
-        shuf = _mm_shuffle_ps(vsum, vsum, _MM_SHUFFLE(1, 0, 3, 2));
-        vsum = _mm_add_ps(vsum, shuf);
-        _mm_store_ss(&sum, vsum);
-        for (; i < size; i++) {
-            x[i] = fast_exp(x[i] - max_val);
-            sum += x[i];
-        }
-
-        float invsum = 1.0f / sum;
-        __m128 vinv = _mm_set1_ps(invsum);
-        i = 0;
-        for (; i + 4 <= size; i += 4) {
-            __m128 v = _mm_loadu_ps(&x[i]);
-            v = _mm_mul_ps(v, vinv);
-            _mm_storeu_ps(&x[i], v);
-        }
-        for (; i < size; i++) {
-            x[i] *= invsum;
-        }
-    }
-#else
-    for (int i = 0; i < size; i++) {
-        x[i] = fast_exp(x[i] - max_val);
-        sum += x[i];
-    }
-    float invsum = 1.0f / sum;
-    for (int i = 0; i < size; i++) {
-        x[i] *= invsum;
-    }
-#endif
+void matmul(float* xout, float* x, const DjibLasMatrix* w, int layer) {
+    // xout(d) = W[layer](d×n) · x(n).
+    // Decode is one token at a time, so this is a pure GEMV: use the dedicated
+    // DjibLAS kernel instead of an m=1 SGEMM tile (which wastes 2/3 of its rows
+    // and does a horizontal sum per output element). The descriptor carries the
+    // weight layout (row-major or load-time panel repack).
+    djiblas_gemv(w, layer, x, xout);
 }
 
 // ============================================================================
@@ -1517,6 +1511,10 @@ static void llmk_print_ctx(const Config *config,
     Print(L"  dim=%d layers=%d heads=%d kv=%d vocab=%d\r\n",
         config->dim, config->n_layers, config->n_heads, config->n_kv_heads, config->vocab_size);
     Print(L"  seq_len=%d kv_pos=%d\r\n", config->seq_len, kv_pos);
+    if (g_boot_cfg.kv_rolling) {
+        Print(L"  kv: rolling, %d sink tokens + ring of %d\r\n",
+              g_boot_cfg.kv_sinks, config->seq_len - g_boot_cfg.kv_sinks);
+    }
     Print(L"  sample: temp=%d.%02d min_p=%d.%02d top_p=%d.%02d top_k=%d\r\n",
         (int)temperature, (int)((temperature - (int)temperature) * 100.0f),
         (int)min_p, (int)((min_p - (int)min_p) * 100.0f),
@@ -1550,9 +1548,7 @@ static void llmk_print_log(UINT32 n) {
 typedef struct {
     float* token_embedding_table;
     float* rms_att_weight;
-    float* wq;
-    float* wk;
-    float* wv;
+    float* wqkv;    // per layer: [wq (dim rows); wk (kv_dim rows); wv (kv_dim rows)]
     float* wo;
     float* rms_ffn_weight;
     float* w1;
@@ -1560,6 +1556,18 @@ typedef struct {
     float* w3;
     float* rms_final_weight;
     float* wcls;
+
+    // GEMV views of the projection weights. The layout may differ from the
+    // raw llama2.c blob (see [4/7] repack), so the forward pass only goes
+    // through these.
+    DjibLasMatrix wqkv_m;
+    DjibLasMatrix wo_m;
+    DjibLasMatrix w1_m;
+    DjibLasMatrix w2_m;
+    DjibLasMatrix w3_m;
+    DjibLasMatrix wcls_m;
+    // Token embedding rows (aliases wcls_m when the classifier is shared).
+    DjibLasMatrix embed_m;
 } TransformerWeights;
 
 typedef struct {
@@ -1567,14 +1575,54 @@ typedef struct {
     float* xb;
     float* xb2;
     float* hb;
-    float* hb2;
     float* q;
-    float* k;
-    float* v;
-    float* att;
     float* logits;
-    float* key_cache;
-    float* value_cache;
+    void* key_cache;            // kv_type elements
+    void* value_cache;
+    float* key_scale;           // int8 cache: one scale per (layer, kv head, pos)
+    float* value_scale;
+
+    // KV cache layout (kv_layout= in repl.cfg). Row t of kv head h in layer l
+    // is at element l*kv_layer_stride + h*kv_head_stride + t*kv_ld:
+    //   pos-major  [layer][pos][kv_dim]       kv_ld = kv_dim, head stride = head_size
+    //   head-major [layer][kv_head][pos][ld]  kv_ld = head_size rounded up to 64 bytes,
+    //              so each head's attention scan is one contiguous block.
+    // Its int8 scale is at l*kv_sc_layer_stride + h*kv_sc_head_stride + t*kv_sld.
+    int kv_type;                // DJIBLAS_KV_* (kv_cache= in repl.cfg)
+    int kv_head_major;
+    int kv_stage;               // new K/V rows are staged in pf_hb/pf_hb2 and stored per head
+    int kv_ld;
+    UINTN kv_head_stride;
+    UINTN kv_layer_stride;
+    int kv_sld;
+    UINTN kv_sc_head_stride;
+    UINTN kv_sc_layer_stride;
+    UINT64 kv_bytes;            // per cache (K or V), and its int8 scales
+    UINT64 kv_scale_bytes;
+
+    // Rolling context (kv_rolling=1): positions may run past seq_len. The
+    // first kv_sinks positions keep their slots; later ones share the other
+    // seq_len - kv_sinks slots as a ring (llmk_kv_slot), so each new token
+    // overwrites the oldest non-sink entry. 0 = positions stay < seq_len.
+    int kv_rolling;
+    int kv_sinks;
+
+    // RoPE: seq_len rows of head_size cos / sin factors (djiblas_rope_fn
+    // layout), from the .bin freq_cis block or generated at boot. Positions
+    // past seq_len (rolling context) get theirs computed into rope_row.
+    float* rope_cos;
+    float* rope_sin;
+    float* rope_row;            // 2 * head_size
+
+    // Prefill activation block: up to pf_block prompt tokens go through each
+    // layer together ([pf_block x dim] / [pf_block x hidden_dim], row = token).
+    int pf_block;
+    float* pf_x;
+    float* pf_xb;
+    float* pf_xb2;
+    float* pf_q;
+    float* pf_hb;
+    float* pf_hb2;
 } RunState;
 
 typedef struct {
@@ -1584,10 +1632,487 @@ typedef struct {
     int max_token_length;
 } Tokenizer;
 
+// ============================================================================
+// DJIBQ MODEL FILES
+// ============================================================================
+// convert_to_djibquant.py output: the same 7-int Config as a .bin, then one
+// DjibQuantHeader + payload per tensor in llama2.c order. There is no
+// freq_cis block, and wcls is optional (absent = shared with the embedding).
+
+enum {
+    LLMK_T_EMBED, LLMK_T_RMS_ATT, LLMK_T_WQ, LLMK_T_WK, LLMK_T_WV, LLMK_T_WO,
+    LLMK_T_RMS_FFN, LLMK_T_W1, LLMK_T_W2, LLMK_T_W3, LLMK_T_RMS_FINAL, LLMK_T_WCLS,
+    LLMK_T_COUNT
+};
+
+typedef struct {
+    DjibQuantHeader hdr[LLMK_T_COUNT];
+    UINT64 offset[LLMK_T_COUNT];    // file offset of each payload
+    int n_tensors;                  // LLMK_T_COUNT, or one less with a shared classifier
+    UINT64 weights_bytes;           // LLMK_ARENA_WEIGHTS bytes needed by llmk_djibq_load()
+} LlmkDjibq;
+
+static const CHAR16 *g_djibq_tensor_names[LLMK_T_COUNT] = {
+    L"embedding", L"rms_att", L"wq", L"wk", L"wv", L"wo",
+    L"rms_ffn", L"w1", L"w2", L"w3", L"rms_final", L"wcls",
+};
+
+static UINT64 llmk_align64(UINT64 x) { return (x + 63ULL) & ~63ULL; }
+
+// Per-layer shape of tensor t (norms are 1 x dim).
+static void llmk_djibq_shape(const Config *c, int t, int *layers, int *rows, int *cols) {
+    int kv_dim = (c->dim * c->n_kv_heads) / c->n_heads;
+    *layers = c->n_layers;
+    *rows = c->dim;
+    *cols = c->dim;
+    switch (t) {
+    case LLMK_T_EMBED:
+    case LLMK_T_WCLS:      *layers = 1; *rows = c->vocab_size; break;
+    case LLMK_T_RMS_FINAL: *layers = 1; *rows = 1; break;
+    case LLMK_T_RMS_ATT:
+    case LLMK_T_RMS_FFN:   *rows = 1; break;
+    case LLMK_T_WK:
+    case LLMK_T_WV:        *rows = kv_dim; break;
+    case LLMK_T_W1:
+    case LLMK_T_W3:        *rows = c->hidden_dim; break;
+    case LLMK_T_W2:        *cols = c->hidden_dim; break;
+    default: break;
+    }
+}
+
+// Can the GEMV path use this record directly (rows of cols elements)?
+// layer_elems: elements per layer slice that gets restacked on its own (Q6
+// groups run over the flattened tensor, so they must not cross a slice).
+static BOOLEAN llmk_djibq_format_ok(const DjibQuantHeader *h, int cols, UINT64 layer_elems) {
+    switch (h->magic) {
+    case DJIBQUANT_MAGIC_F32:
+    case DJIBQUANT_MAGIC_F16:
+    case DJIBQUANT_MAGIC_BF16:
+        return h->n_groups == 0;
+    case DJIBQUANT_MAGIC_Q8:
+        return h->group_size == DJIBQUANT_Q8_GROUP_SIZE &&
+               (cols % DJIBQUANT_Q8_GROUP_SIZE) == 0 &&
+               h->n_groups == h->n_elements / DJIBQUANT_Q8_GROUP_SIZE;
+    case DJIBQUANT_MAGIC_Q4:
+        return h->group_size == DJIBQUANT_Q4_GROUP_SIZE &&
+               (cols % DJIBQUANT_Q4_GROUP_SIZE) == 0 &&
+               h->n_groups == h->n_elements / DJIBQUANT_Q4_GROUP_SIZE &&
+               (h->scale_type == DJIBQUANT_SCALE_F32 || h->scale_type == DJIBQUANT_SCALE_F16);
+    case DJIBQUANT_MAGIC:
+        return (h->version == DJIBQUANT_VERSION_UNPACKED || h->version == DJIBQUANT_VERSION_PACKED) &&
+               h->group_size == DJIBQUANT_GROUP_SIZE &&
+               (cols % 32) == 0 &&
+               (layer_elems == h->n_elements || (layer_elems % DJIBQUANT_GROUP_SIZE) == 0) &&
+               h->n_groups == (h->n_elements + DJIBQUANT_GROUP_SIZE - 1) / DJIBQUANT_GROUP_SIZE;
+    default:
+        return FALSE;
+    }
+}
+
+static void llmk_djibq_init_matrix(DjibLasMatrix *M, const DjibQuantHeader *h, const void *data,
+                                   const float *scales, int rows, int cols) {
+    if (h->magic == DJIBQUANT_MAGIC_Q8) {
+        djiblas_matrix_init_q8(M, (const INT8 *)data, scales, rows, cols);
+    } else if (h->magic == DJIBQUANT_MAGIC_Q4) {
+        djiblas_matrix_init_q4(M, (const UINT8 *)data, scales, rows, cols);
+    } else if (h->magic == DJIBQUANT_MAGIC_F16) {
+        djiblas_matrix_init_half(M, DJIBLAS_MAT_F16, (const UINT16 *)data, rows, cols);
+    } else if (h->magic == DJIBQUANT_MAGIC_BF16) {
+        djiblas_matrix_init_half(M, DJIBLAS_MAT_BF16, (const UINT16 *)data, rows, cols);
+    } else if (h->magic == DJIBQUANT_MAGIC && h->version >= DJIBQUANT_VERSION_PACKED) {
+        djiblas_matrix_init_q6p(M, (const UINT8 *)data, scales, rows, cols);
+    } else if (h->magic == DJIBQUANT_MAGIC) {
+        djiblas_matrix_init_q6(M, (const INT8 *)data, scales, rows, cols);
+    } else {
+        djiblas_matrix_init_f32(M, (const float *)data, rows, cols);
+    }
+}
+
+// Walk the record headers: validate shapes/formats and size LLMK_ARENA_WEIGHTS
+// from the stored bytes (not from n_floats * sizeof(float)).
+static EFI_STATUS llmk_djibq_scan(EFI_FILE_HANDLE f, UINT64 file_size, const Config *c, LlmkDjibq *out) {
+    UINT64 pos = 7 * sizeof(int);
+    out->n_tensors = 0;
+    out->weights_bytes = 0;
+    for (int t = 0; t < LLMK_T_COUNT; t++) {
+        if (t == LLMK_T_WCLS && file_size > 0 && pos >= file_size) break;
+
+        DjibQuantHeader *h = &out->hdr[t];
+        uefi_call_wrapper(f->SetPosition, 2, f, pos);
+        EFI_STATUS st = read_exact(f, h, sizeof(DjibQuantHeader));
+        if (EFI_ERROR(st)) {
+            if (t == LLMK_T_WCLS) break;
+            Print(L"ERROR: djibq: truncated before %s\r\n", g_djibq_tensor_names[t]);
+            return st;
+        }
+
+        int layers, rows, cols;
+        llmk_djibq_shape(c, t, &layers, &rows, &cols);
+        UINT64 n = (UINT64)layers * (UINT64)rows * (UINT64)cols;
+        UINT64 payload = djibquant_payload_bytes(h);
+        if (h->n_elements != n || payload == 0) {
+            Print(L"ERROR: djibq: bad %s record (magic=0x%x n=%d, expected %d)\r\n",
+                  g_djibq_tensor_names[t], h->magic, (int)h->n_elements, (int)n);
+            return EFI_LOAD_ERROR;
+        }
+        BOOLEAN is_norm = (rows == 1);
+        UINT64 layer_elems = (t == LLMK_T_EMBED || t == LLMK_T_WCLS) ? n : (UINT64)rows * (UINT64)cols;
+        if (!is_norm && !llmk_djibq_format_ok(h, cols, layer_elems)) {
+            Print(L"ERROR: djibq: unsupported format for %s (magic=0x%x group=%d)\r\n",
+                  g_djibq_tensor_names[t], h->magic, (int)h->group_size);
+            return EFI_UNSUPPORTED;
+        }
+
+        out->offset[t] = pos + sizeof(DjibQuantHeader);
+        pos = out->offset[t] + payload;
+
+        // Norms are widened to fp32 at load; matrices stay as stored (fp16
+        // scales are widened). Each allocation may need up to 64 bytes of
+        // alignment padding.
+        if (is_norm) {
+            out->weights_bytes += llmk_align64(n * sizeof(float)) + 64;
+        } else {
+            UINT64 qb = djibquant_q_bytes(h->magic, h->version, n);
+            UINT64 sb = djibquant_scale_bytes(h) ? (UINT64)h->n_groups * sizeof(float) : 0;
+            out->weights_bytes += llmk_align64(qb) + 64 + llmk_align64(sb) + 64;
+        }
+        out->n_tensors++;
+    }
+    if (out->n_tensors < LLMK_T_WCLS) return EFI_LOAD_ERROR;
+
+    // wq/wk/wv are restacked per layer into one matrix, so they must match.
+    if (out->hdr[LLMK_T_WK].magic != out->hdr[LLMK_T_WQ].magic ||
+        out->hdr[LLMK_T_WV].magic != out->hdr[LLMK_T_WQ].magic ||
+        out->hdr[LLMK_T_WK].version != out->hdr[LLMK_T_WQ].version ||
+        out->hdr[LLMK_T_WV].version != out->hdr[LLMK_T_WQ].version ||
+        out->hdr[LLMK_T_WK].scale_type != out->hdr[LLMK_T_WQ].scale_type ||
+        out->hdr[LLMK_T_WV].scale_type != out->hdr[LLMK_T_WQ].scale_type) {
+        Print(L"ERROR: djibq: wq/wk/wv must use the same format\r\n");
+        return EFI_UNSUPPORTED;
+    }
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS llmk_djibq_read_norm(EFI_FILE_HANDLE f, const LlmkDjibq *q, int t, const Config *c, float **out) {
+    const DjibQuantHeader *h = &q->hdr[t];
+    float *dst = (float *)llmk_alloc_weights((UINT64)h->n_elements * sizeof(float), g_djibq_tensor_names[t]);
+    if (!dst) return EFI_OUT_OF_RESOURCES;
+    uefi_call_wrapper(f->SetPosition, 2, f, q->offset[t]);
+
+    EFI_STATUS st;
+    if (h->magic == DJIBQUANT_MAGIC_F32) {
+        st = read_exact(f, dst, (UINTN)h->n_elements * sizeof(float));
+    } else {
+        // Quantized norm (older converters quantize every tensor): stage the
+        // record in SCRATCH and dequantize it row by row.
+        UINT64 payload = djibquant_payload_bytes(h);
+        UINT64 qb = djibquant_q_bytes(h->magic, h->version, h->n_elements);
+        UINT64 room = qb + (UINT64)h->n_groups * sizeof(float);
+        UINT8 *buf = (UINT8 *)llmk_sentinel_alloc(&g_sentinel, LLMK_ARENA_SCRATCH,
+                                                  room > payload ? room : payload, 64, L"djibq norm");
+        if (!buf) return EFI_OUT_OF_RESOURCES;
+        st = read_exact(f, buf, (UINTN)payload);
+        if (!EFI_ERROR(st) && djibquant_scale_bytes(h) == 2) {
+            djibquant_widen_scales(buf + qb, h->n_groups);
+        }
+        if (!EFI_ERROR(st)) {
+            if (!llmk_djibq_format_ok(h, c->dim, h->n_elements)) {
+                st = EFI_UNSUPPORTED;
+            } else {
+                int rows = (int)(h->n_elements / (UINT32)c->dim);
+                DjibLasMatrix M;
+                llmk_djibq_init_matrix(&M, h, buf, (const float *)(buf + qb), rows, c->dim);
+                for (int r = 0; r < rows; r++) djiblas_matrix_get_row(&M, r, dst + (UINTN)r * (UINTN)c->dim);
+            }
+        }
+        llmk_scratch_reset();
+    }
+    *out = dst;
+    return st;
+}
+
+// Reads tensors ts[0..nt) (same format, same cols) into one matrix whose
+// layer l is [ts[0] layer l; ts[1] layer l; ...], like the fp32 [wq; wk; wv].
+static EFI_STATUS llmk_djibq_read_stacked(EFI_FILE_HANDLE f, const LlmkDjibq *q, const int *ts, int nt,
+                                          const Config *c, DjibLasMatrix *M) {
+    const DjibQuantHeader *h0 = &q->hdr[ts[0]];
+    UINT32 magic = h0->magic;
+    UINT32 version = h0->version;
+    UINT32 group = djibquant_scale_bytes(h0) ? h0->group_size : 0;
+    int layers = 1, rows_total = 0, cols = 0;
+    int rows[3];
+    for (int i = 0; i < nt; i++) {
+        llmk_djibq_shape(c, ts[i], &layers, &rows[i], &cols);
+        rows_total += rows[i];
+    }
+
+    UINT64 layer_elems = (UINT64)rows_total * (UINT64)cols;
+    UINT64 total = layer_elems * (UINT64)layers;
+    UINT64 layer_qb = djibquant_q_bytes(magic, version, layer_elems);
+    UINT8 *data = (UINT8 *)llmk_alloc_weights(djibquant_q_bytes(magic, version, total), g_djibq_tensor_names[ts[0]]);
+    float *scales = NULL;
+    if (!data) return EFI_OUT_OF_RESOURCES;
+    if (group) {
+        scales = (float *)llmk_alloc_weights(((total + group - 1) / group) * sizeof(float), L"scales");
+        if (!scales) return EFI_OUT_OF_RESOURCES;
+    }
+
+    UINT64 row_off = 0;
+    EFI_STATUS st = EFI_SUCCESS;
+    for (int i = 0; i < nt && !EFI_ERROR(st); i++) {
+        UINT64 elems = (UINT64)rows[i] * (UINT64)cols;
+        UINT64 qb = djibquant_q_bytes(magic, version, elems);
+        uefi_call_wrapper(f->SetPosition, 2, f, q->offset[ts[i]]);
+        for (int l = 0; l < layers && !EFI_ERROR(st); l++) {
+            st = read_exact(f, data + (UINTN)l * (UINTN)layer_qb + (UINTN)djibquant_q_bytes(magic, version, row_off * cols),
+                            (UINTN)qb);
+        }
+        // Scales follow all the quantized values of the record (fp16 ones
+        // are widened in place, chunk by chunk).
+        UINT64 sbytes = djibquant_scale_bytes(&q->hdr[ts[i]]);
+        for (int l = 0; group && l < layers && !EFI_ERROR(st); l++) {
+            float *dst = scales + (UINTN)((l * layer_elems + row_off * cols) / group);
+            UINT64 cnt = (elems + group - 1) / group;
+            st = read_exact(f, dst, (UINTN)(cnt * sbytes));
+            if (!EFI_ERROR(st) && sbytes == 2) djibquant_widen_scales(dst, cnt);
+        }
+        row_off += (UINT64)rows[i];
+    }
+    if (EFI_ERROR(st)) return st;
+
+    llmk_djibq_init_matrix(M, h0, data, scales, rows_total, cols);
+    return EFI_SUCCESS;
+}
+
+static EFI_STATUS llmk_djibq_read_matrix(EFI_FILE_HANDLE f, const LlmkDjibq *q, int t,
+                                         const Config *c, DjibLasMatrix *M) {
+    return llmk_djibq_read_stacked(f, q, &t, 1, c, M);
+}
+
+// Loads every tensor of a scanned .djibq into LLMK_ARENA_WEIGHTS.
+static EFI_STATUS llmk_djibq_load(EFI_FILE_HANDLE f, const LlmkDjibq *q, const Config *c, TransformerWeights *w) {
+    static const int qkv[3] = { LLMK_T_WQ, LLMK_T_WK, LLMK_T_WV };
+    EFI_STATUS st;
+
+    w->token_embedding_table = NULL;
+    w->wqkv = NULL;
+    w->wo = w->w1 = w->w2 = w->w3 = w->wcls = NULL;
+
+    st = llmk_djibq_read_matrix(f, q, LLMK_T_EMBED, c, &w->embed_m);
+    if (!EFI_ERROR(st)) st = llmk_djibq_read_norm(f, q, LLMK_T_RMS_ATT, c, &w->rms_att_weight);
+    if (!EFI_ERROR(st)) st = llmk_djibq_read_stacked(f, q, qkv, 3, c, &w->wqkv_m);
+    if (!EFI_ERROR(st)) st = llmk_djibq_read_matrix(f, q, LLMK_T_WO, c, &w->wo_m);
+    if (!EFI_ERROR(st)) st = llmk_djibq_read_norm(f, q, LLMK_T_RMS_FFN, c, &w->rms_ffn_weight);
+    if (!EFI_ERROR(st)) st = llmk_djibq_read_matrix(f, q, LLMK_T_W1, c, &w->w1_m);
+    if (!EFI_ERROR(st)) st = llmk_djibq_read_matrix(f, q, LLMK_T_W2, c, &w->w2_m);
+    if (!EFI_ERROR(st)) st = llmk_djibq_read_matrix(f, q, LLMK_T_W3, c, &w->w3_m);
+    if (!EFI_ERROR(st)) st = llmk_djibq_read_norm(f, q, LLMK_T_RMS_FINAL, c, &w->rms_final_weight);
+    if (EFI_ERROR(st)) return st;
+
+    if (q->n_tensors == LLMK_T_COUNT) {
+        st = llmk_djibq_read_matrix(f, q, LLMK_T_WCLS, c, &w->wcls_m);
+    } else {
+        w->wcls_m = w->embed_m;
+    }
+    return st;
+}
+
 // ============================================================================
 // FORWARD PASS
 // ============================================================================
 
+// Per-op cycle counters, read by the hosted bench (hosted/bench.c). Only
+// built with -DLLMK_OP_PROFILE; the UEFI image compiles the marks away.
+// Each LLMK_OP_MARK charges the cycles since the previous mark to one op.
+enum {
+    LLMK_OP_EMBED,
+    LLMK_OP_QKV,
+    LLMK_OP_ATTN,
+    LLMK_OP_WO,
+    LLMK_OP_NORM,
+    LLMK_OP_FFN_UP,
+    LLMK_OP_FFN_DOWN,
+    LLMK_OP_CLS,
+    LLMK_OP_COUNT
+};
+
+#ifdef LLMK_OP_PROFILE
+static UINT64 g_llmk_op_cycles[LLMK_OP_COUNT];
+#define LLMK_OP_BEGIN() UINT64 llmk_op_t = djibmark_rdtsc()
+#define LLMK_OP_MARK(op) do { \
+        UINT64 llmk_op_now = djibmark_rdtsc(); \
+        g_llmk_op_cycles[op] += llmk_op_now - llmk_op_t; \
+        llmk_op_t = llmk_op_now; \
+    } while (0)
+#else
+#define LLMK_OP_BEGIN() do { } while (0)
+#define LLMK_OP_MARK(op) do { } while (0)
+#endif
+
+// Sets the KV cache element type and strides for the chosen layout, and
+// kv_bytes / kv_scale_bytes. Every layout but fp32 pos-major stages new K/V
+// rows in pf_hb/pf_hb2, so it falls back to that if they are too small; the
+// fp16 / int8 kernels need head_size <= DJIBLAS_ATTN_MAX_HEAD.
+static void llmk_kv_layout_init(RunState* s, const Config* p, int head_major, int type) {
+    int head_size = p->dim / p->n_heads;
+    int kv_dim = head_size * p->n_kv_heads;
+    if (head_size > DJIBLAS_ATTN_MAX_HEAD) type = DJIBLAS_KV_F32;
+    if (p->hidden_dim < kv_dim) {
+        head_major = 0;
+        type = DJIBLAS_KV_F32;
+    }
+    int eb = (type == DJIBLAS_KV_F32) ? 4 : (type == DJIBLAS_KV_F16) ? 2 : 1;
+    s->kv_type = type;
+    s->kv_head_major = head_major;
+    s->kv_stage = head_major || type != DJIBLAS_KV_F32;
+    if (head_major) {
+        int per_line = 64 / eb;
+        s->kv_ld = (head_size + per_line - 1) / per_line * per_line;
+        s->kv_head_stride = (UINTN)p->seq_len * (UINTN)s->kv_ld;
+        s->kv_layer_stride = (UINTN)p->n_kv_heads * s->kv_head_stride;
+        s->kv_sld = 1;
+        s->kv_sc_head_stride = (UINTN)p->seq_len;
+    } else {
+        s->kv_ld = kv_dim;
+        s->kv_head_stride = (UINTN)head_size;
+        s->kv_layer_stride = (UINTN)p->seq_len * (UINTN)kv_dim;
+        s->kv_sld = p->n_kv_heads;
+        s->kv_sc_head_stride = 1;
+    }
+    s->kv_sc_layer_stride = (UINTN)p->seq_len * (UINTN)p->n_kv_heads;
+    s->kv_bytes = (UINT64)p->n_layers * (UINT64)s->kv_layer_stride * (UINT64)eb;
+    s->kv_scale_bytes = (type == DJIBLAS_KV_Q8)
+        ? (UINT64)p->n_layers * (UINT64)s->kv_sc_layer_stride * sizeof(float) : 0;
+}
+
+// Cache slot of position pos (see kv_rolling). Attention is a softmax-weighted
+// sum, so the slots need no particular order: once the ring is full, the
+// whole cache is the window.
+static inline int llmk_kv_slot(const RunState* s, const Config* p, int pos) {
+    if (pos < p->seq_len) return pos;
+    return s->kv_sinks + (pos - s->kv_sinks) % (p->seq_len - s->kv_sinks);
+}
+
+// Element offset of slot 0 of kv head kvh in layer l; slot t is t*kv_ld
+// elements further.
+static inline UINTN llmk_kv_off(const RunState* s, int l, int kvh) {
+    return (UINTN)l * s->kv_layer_stride + (UINTN)kvh * s->kv_head_stride;
+}
+
+static inline UINTN llmk_kv_sc_off(const RunState* s, int l, int kvh) {
+    return (UINTN)l * s->kv_sc_layer_stride + (UINTN)kvh * s->kv_sc_head_stride;
+}
+
+// Stores n staged [kv_dim] rows at positions pos..pos+n-1 of every kv head of
+// layer l, converted to the cache type.
+static void llmk_kv_store(const RunState* s, void* cache, float* scale, int l, const float* rows,
+                          int kv_dim, int head_size, int pos, int n) {
+    for (int kvh = 0; kvh * head_size < kv_dim; kvh++) {
+        UINTN off = llmk_kv_off(s, l, kvh) + (UINTN)pos * (UINTN)s->kv_ld;
+        UINTN soff = llmk_kv_sc_off(s, l, kvh) + (UINTN)pos * (UINTN)s->kv_sld;
+        const float* src = rows + kvh * head_size;
+        for (int t = 0; t < n; t++) {
+            if (s->kv_type == DJIBLAS_KV_F16) {
+                djiblas_narrow_f16(src, (UINT16*)cache + off, head_size);
+            } else if (s->kv_type == DJIBLAS_KV_Q8) {
+                scale[soff] = djiblas_quantize_kv_q8(src, (INT8*)cache + off, head_size);
+            } else {
+                float* dst = (float*)cache + off;
+                for (int i = 0; i < head_size; i++) dst[i] = src[i];
+            }
+            off += (UINTN)s->kv_ld;
+            soff += (UINTN)s->kv_sld;
+            src += kv_dim;
+        }
+    }
+}
+
+// Attention of the g query heads sharing kv head kvh (q / out: g heads of
+// head_size floats) over its positions 0..n-1. GQA groups go through the
+// grouped kernels, which stream each K/V row once for the whole group.
+static inline void llmk_kv_attn(const RunState* s, int l, int kvh, const float* q, int g, int n,
+                                int head_size, float scale, float* out) {
+    UINTN off = llmk_kv_off(s, l, kvh);
+    if (g > 1) {
+        if (s->kv_type == DJIBLAS_KV_F16) {
+            g_djiblas.attn_gqa_f16(q, g, (const UINT16*)s->key_cache + off, (const UINT16*)s->value_cache + off,
+                                   s->kv_ld, n, head_size, scale, out);
+        } else if (s->kv_type == DJIBLAS_KV_Q8) {
+            UINTN soff = llmk_kv_sc_off(s, l, kvh);
+            g_djiblas.attn_gqa_q8(q, g, (const INT8*)s->key_cache + off, s->key_scale + soff,
+                                  (const INT8*)s->value_cache + off, s->value_scale + soff,
+                                  s->kv_ld, s->kv_sld, n, head_size, scale, out);
+        } else {
+            g_djiblas.attn_gqa(q, g, (const float*)s->key_cache + off, (const float*)s->value_cache + off,
+                               s->kv_ld, n, head_size, scale, out);
+        }
+        return;
+    }
+    if (s->kv_type == DJIBLAS_KV_F16) {
+        g_djiblas.attn_f16(q, (const UINT16*)s->key_cache + off, (const UINT16*)s->value_cache + off,
+                           s->kv_ld, n, head_size, scale, out);
+    } else if (s->kv_type == DJIBLAS_KV_Q8) {
+        UINTN soff = llmk_kv_sc_off(s, l, kvh);
+        g_djiblas.attn_q8(q, (const INT8*)s->key_cache + off, s->key_scale + soff,
+                          (const INT8*)s->value_cache + off, s->value_scale + soff,
+                          s->kv_ld, s->kv_sld, n, head_size, scale, out);
+    } else {
+        g_djiblas.attn(q, (const float*)s->key_cache + off, (const float*)s->value_cache + off,
+                       s->kv_ld, n, head_size, scale, out);
+    }
+}
+
+// Fills the RoPE table from a llama2.c freq_cis block ([seq_len][head_size / 2]
+// cos, then sin) if every entry is on the unit circle, else generates it.
+// Returns 1 if the file table was used.
+static int llmk_rope_init(RunState* s, const Config* p, const float* freq_cis) {
+    int head_size = p->dim / p->n_heads;
+    int half = head_size / 2;
+    UINTN n = (UINTN)p->seq_len * (UINTN)half;
+    int use_file = (freq_cis != NULL);
+    for (UINTN i = 0; use_file && i < n; i++) {
+        float c = freq_cis[i], sn = freq_cis[n + i];
+        float e = c * c + sn * sn - 1.0f;
+        if (!(e < 1e-3f && e > -1e-3f)) use_file = 0;
+    }
+    for (int pos = 0; pos < p->seq_len; pos++) {
+        float* C = s->rope_cos + (UINTN)pos * (UINTN)head_size;
+        float* S = s->rope_sin + (UINTN)pos * (UINTN)head_size;
+        if (!use_file) {
+            llmk_rope_row(C, S, head_size, pos);
+            continue;
+        }
+        for (int j = 0; j < half; j++) {
+            UINTN i = (UINTN)pos * (UINTN)half + (UINTN)j;
+            C[2 * j] = C[2 * j + 1] = freq_cis[i];
+            S[2 * j] = -freq_cis[n + i];
+            S[2 * j + 1] = freq_cis[n + i];
+        }
+    }
+    return use_file;
+}
+
+// cos / sin rows of position pos: the table row, or past seq_len (rolling
+// context) a row generated into s->rope_row. Call once per token, before the
+// layer loop, so the rolling row is not rebuilt per layer.
+static inline void llmk_rope_rows(RunState* s, const Config* p, int pos, const float** C, const float** S) {
+    int head_size = p->dim / p->n_heads;
+    if (pos >= p->seq_len) {
+        llmk_rope_row(s->rope_row, s->rope_row + head_size, head_size, pos);
+        *C = s->rope_row;
+        *S = s->rope_row + head_size;
+        return;
+    }
+    *C = s->rope_cos + (UINTN)pos * (UINTN)head_size;
+    *S = s->rope_sin + (UINTN)pos * (UINTN)head_size;
+}
+
+// Rotates q ([dim]) and k ([kv_dim]) of one token by the rows of llmk_rope_rows.
+static inline void llmk_rope(const Config* p, float* q, float* k, const float* C, const float* S) {
+    int head_size = p->dim / p->n_heads;
+    g_djiblas.rope(q, p->dim, k, head_size * p->n_kv_heads, head_size, C, S);
+}
+
 void transformer_forward(RunState* s, TransformerWeights* w, Config* p, int token, int pos) {
     // DjibMark: record entry into transformer (prefill vs decode determined by caller)
     if (pos == 0) {
@@ -1597,100 +2122,290 @@ void transformer_forward(RunState* s, TransformerWeights* w, Config* p, int toke
     }
     
     int dim = p->dim;
-    int hidden_dim = p->hidden_dim;
     int n_layers = p->n_layers;
     int n_heads = p->n_heads;
     int head_size = dim / n_heads;
     int kv_dim = (dim * p->n_kv_heads) / n_heads;
     int kv_mul = n_heads / p->n_kv_heads;
+    float inv_scale = 1.0f / fast_sqrt((float)head_size);
+    int slot = llmk_kv_slot(s, p, pos);
+    int n_att = (pos < p->seq_len) ? pos + 1 : p->seq_len;
+    const float *rope_c, *rope_s;
+    LLMK_OP_BEGIN();
     
     // Copy embedding
-    float* content_row = w->token_embedding_table + token * dim;
-    for (int i = 0; i < dim; i++) {
-        s->x[i] = content_row[i];
-    }
+    djiblas_matrix_get_row(&w->embed_m, token, s->x);
+    LLMK_OP_MARK(LLMK_OP_EMBED);
+    
+    // Attention RMSNorm of layer 0; later layers get theirs fused with the
+    // preceding FFN residual.
+    g_djiblas.rmsnorm(s->xb, s->x, w->rms_att_weight, dim);
+    LLMK_OP_MARK(LLMK_OP_NORM);
+    llmk_rope_rows(s, p, pos, &rope_c, &rope_s);
     
     // Forward all layers
     for (int l = 0; l < n_layers; l++) {
-        // Attention RMSNorm
-        rmsnorm(s->xb, s->x, w->rms_att_weight + l*dim, dim);
-        
-        // Q, K, V matrices
-        matmul(s->q, s->xb, w->wq + l*dim*dim, dim, dim);
-        matmul(s->k, s->xb, w->wk + l*dim*kv_dim, dim, kv_dim);
-        matmul(s->v, s->xb, w->wv + l*dim*kv_dim, dim, kv_dim);
-        
-        // Store in KV cache
-        int loff = l * p->seq_len * kv_dim;
-        float* key_cache_row = s->key_cache + loff + pos * kv_dim;
-        float* value_cache_row = s->value_cache + loff + pos * kv_dim;
-        for (int i = 0; i < kv_dim; i++) {
-            key_cache_row[i] = s->k[i];
-            value_cache_row[i] = s->v[i];
+        // Fused Q, K, V: one pass over this layer's [wq; wk; wv] rows.
+        // fp32 pos-major: k and v land directly in the KV cache row of slot.
+        // Otherwise they are staged, then converted / scattered per head.
+        float* key_cache_row = s->pf_hb;
+        float* value_cache_row = s->pf_hb2;
+        if (!s->kv_stage) {
+            key_cache_row = (float*)s->key_cache + llmk_kv_off(s, l, 0) + (UINTN)slot * (UINTN)kv_dim;
+            value_cache_row = (float*)s->value_cache + llmk_kv_off(s, l, 0) + (UINTN)slot * (UINTN)kv_dim;
         }
-        
-        // Multihead attention
-        for (int h = 0; h < n_heads; h++) {
-            float* q_h = s->q + h * head_size;
-            int att_offset = h * p->seq_len;
-            float inv_scale = 1.0f / fast_sqrt((float)head_size);
-            
-            // Attention scores
-            for (int t = 0; t <= pos; t++) {
-                float* k_t = s->key_cache + loff + t * kv_dim + (h / kv_mul) * head_size;
-                float score = dot_f32_best(q_h, k_t, head_size) * inv_scale;
-                s->att[att_offset + t] = score;
-            }
-            
-            // Softmax
-            softmax(s->att + att_offset, pos + 1);
-            
-            // Weighted sum
-            float* xb_h = s->xb + h * head_size;
-            for (int i = 0; i < head_size; i++) xb_h[i] = 0.0f;
-            
-            for (int t = 0; t <= pos; t++) {
-                float* v_t = s->value_cache + loff + t * kv_dim + (h / kv_mul) * head_size;
-                float a = s->att[att_offset + t];
-                axpy_f32_best(xb_h, v_t, a, head_size);
-            }
+        // Int8 weights: xb is quantized once for all three projections.
+        if (djiblas_matrix_act_q8(&w->wqkv_m)) djiblas_act_quantize(s->xb, dim);
+        djiblas_gemv_split3(&w->wqkv_m, l, s->xb,
+                            s->q, dim,
+                            key_cache_row, kv_dim,
+                            value_cache_row, kv_dim);
+        djiblas_act_release();
+        llmk_rope(p, s->q, key_cache_row, rope_c, rope_s);
+        if (s->kv_stage) {
+            llmk_kv_store(s, s->key_cache, s->key_scale, l, key_cache_row, kv_dim, head_size, slot, 1);
+            llmk_kv_store(s, s->value_cache, s->value_scale, l, value_cache_row, kv_dim, head_size, slot, 1);
         }
+        LLMK_OP_MARK(LLMK_OP_QKV);
         
-        // Output projection
-        matmul(s->xb2, s->xb, w->wo + l*dim*dim, dim, dim);
-        
-        // Residual
-        for (int i = 0; i < dim; i++) {
-            s->x[i] += s->xb2[i];
+        // Multihead attention: one online-softmax pass over K/V per kv head,
+        // shared by its kv_mul query heads (h = kvh * kv_mul + i).
+        for (int kvh = 0; kvh < p->n_kv_heads; kvh++) {
+            int h = kvh * kv_mul;
+            llmk_kv_attn(s, l, kvh, s->q + h * head_size, kv_mul, n_att, head_size, inv_scale,
+                         s->xb + h * head_size);
         }
+        LLMK_OP_MARK(LLMK_OP_ATTN);
         
-        // FFN RMSNorm
-        rmsnorm(s->xb, s->x, w->rms_ffn_weight + l*dim, dim);
+        // Output projection
+        matmul(s->xb2, s->xb, &w->wo_m, l);
+        LLMK_OP_MARK(LLMK_OP_WO);
         
-        // FFN
-        matmul(s->hb, s->xb, w->w1 + l*dim*hidden_dim, dim, hidden_dim);
-        matmul(s->hb2, s->xb, w->w3 + l*dim*hidden_dim, dim, hidden_dim);
+        // Residual + FFN RMSNorm
+        g_djiblas.residual_rmsnorm(s->x, s->xb2, w->rms_ffn_weight + l*dim, s->xb, dim);
+        LLMK_OP_MARK(LLMK_OP_NORM);
         
-        // SwiGLU
-        for (int i = 0; i < hidden_dim; i++) {
-            float val = s->hb[i];
-            val *= (1.0f / (1.0f + fast_exp(-val)));
-            s->hb[i] = val * s->hb2[i];
-        }
+        // FFN gate/up + SwiGLU, fused: hb = silu(w1 x) * (w3 x), no hb2.
+        // Likewise one int8 copy of xb for w1 and w3.
+        if (djiblas_matrix_act_q8(&w->w1_m)) djiblas_act_quantize(s->xb, dim);
+        djiblas_ffn_gate_up(&w->w1_m, &w->w3_m, l, s->xb, s->hb);
+        djiblas_act_release();
+        LLMK_OP_MARK(LLMK_OP_FFN_UP);
         
-        matmul(s->xb, s->hb, w->w2 + l*dim*hidden_dim, hidden_dim, dim);
+        matmul(s->xb, s->hb, &w->w2_m, l);
+        LLMK_OP_MARK(LLMK_OP_FFN_DOWN);
         
-        // Residual
-        for (int i = 0; i < dim; i++) {
-            s->x[i] += s->xb[i];
+        // Residual + next layer's attention RMSNorm (final RMSNorm, in place,
+        // after the last layer)
+        if (l + 1 < n_layers) {
+            g_djiblas.residual_rmsnorm(s->x, s->xb, w->rms_att_weight + (l + 1)*dim, s->xb, dim);
+        } else {
+            g_djiblas.residual_rmsnorm(s->x, s->xb, w->rms_final_weight, s->x, dim);
         }
+        LLMK_OP_MARK(LLMK_OP_NORM);
     }
     
-    // Final RMSNorm
-    rmsnorm(s->x, s->x, w->rms_final_weight, dim);
-    
     // Classifier
-    matmul(s->logits, s->x, w->wcls, dim, p->vocab_size);
+    matmul(s->logits, s->x, &w->wcls_m, 0);
+    LLMK_OP_MARK(LLMK_OP_CLS);
+}
+
+// Prompt tokens processed per prefill block (and per sentinel prefill budget).
+#define LLMK_PREFILL_BLOCK 32
+
+// Batched prefill: tokens[0..n) at positions pos0..pos0+n-1. Each layer runs
+// over a block of tokens at once, so every weight matrix is read once per
+// block instead of once per token (projections are GEMMs, not GEMVs).
+// Positions past seq_len (rolling context) go through transformer_forward.
+// need_logits: on return s->logits holds the logits of the last token, like
+// the last transformer_forward() call would have. Callers feeding a prompt in
+// several calls pass it only for the call holding the prompt's last token;
+// the others just fill the KV cache.
+void transformer_prefill(RunState* s, TransformerWeights* w, Config* p, const int* tokens, int n, int pos0,
+                         BOOLEAN need_logits) {
+    DJIBMARK_PREFILL();
+
+    int dim = p->dim;
+    int hidden_dim = p->hidden_dim;
+    int n_layers = p->n_layers;
+    int n_heads = p->n_heads;
+    int head_size = dim / n_heads;
+    int kv_dim = (dim * p->n_kv_heads) / n_heads;
+    int kv_mul = n_heads / p->n_kv_heads;
+    float inv_scale = 1.0f / fast_sqrt((float)head_size);
+    LLMK_OP_BEGIN();
+
+    for (int b0 = 0, nb; b0 < n; b0 += nb) {
+        int bpos = pos0 + b0;
+        nb = n - b0;
+        if (nb > s->pf_block) nb = s->pf_block;
+        if (bpos + nb > p->seq_len) nb = p->seq_len - bpos;
+        if (nb <= 0) {
+            // Rolling context past seq_len: each token evicts a slot that the
+            // earlier tokens of its block still attend to, so one at a time.
+            transformer_forward(s, w, p, tokens[b0], bpos);
+            nb = 1;
+            continue;
+        }
+
+        for (int t = 0; t < nb; t++) {
+            djiblas_matrix_get_row(&w->embed_m, tokens[b0 + t], s->pf_x + t * dim);
+        }
+        LLMK_OP_MARK(LLMK_OP_EMBED);
+
+        // Layer 0 attention RMSNorm; later layers fuse it into the FFN residual.
+        for (int t = 0; t < nb; t++) {
+            g_djiblas.rmsnorm(s->pf_xb + t * dim, s->pf_x + t * dim, w->rms_att_weight, dim);
+        }
+        LLMK_OP_MARK(LLMK_OP_NORM);
+
+        for (int l = 0; l < n_layers; l++) {
+
+            // Q for the block. fp32 pos-major: K/V straight into the cache
+            // rows bpos..bpos+nb-1 (consecutive positions are consecutive
+            // kv_dim rows). Otherwise staged in pf_hb/pf_hb2, then stored.
+            float* k_rows = s->pf_hb;
+            float* v_rows = s->pf_hb2;
+            if (!s->kv_stage) {
+                k_rows = (float*)s->key_cache + llmk_kv_off(s, l, 0) + (UINTN)bpos * (UINTN)kv_dim;
+                v_rows = (float*)s->value_cache + llmk_kv_off(s, l, 0) + (UINTN)bpos * (UINTN)kv_dim;
+            }
+            djiblas_gemm_rows(&w->wqkv_m, l, 0, dim, s->pf_xb, dim, nb, s->pf_q, dim);
+            djiblas_gemm_rows(&w->wqkv_m, l, dim, dim + kv_dim, s->pf_xb, dim, nb, k_rows, kv_dim);
+            djiblas_gemm_rows(&w->wqkv_m, l, dim + kv_dim, dim + 2 * kv_dim, s->pf_xb, dim, nb, v_rows, kv_dim);
+            for (int t = 0; t < nb; t++) {
+                const float *rope_c, *rope_s;
+                llmk_rope_rows(s, p, bpos + t, &rope_c, &rope_s);
+                llmk_rope(p, s->pf_q + t * dim, k_rows + t * kv_dim, rope_c, rope_s);
+            }
+            if (s->kv_stage) {
+                llmk_kv_store(s, s->key_cache, s->key_scale, l, k_rows, kv_dim, head_size, bpos, nb);
+                llmk_kv_store(s, s->value_cache, s->value_scale, l, v_rows, kv_dim, head_size, bpos, nb);
+            }
+            LLMK_OP_MARK(LLMK_OP_QKV);
+
+            // Causal attention: token t sees positions 0..bpos+t.
+            for (int t = 0; t < nb; t++) {
+                int pos = bpos + t;
+                for (int kvh = 0; kvh < p->n_kv_heads; kvh++) {
+                    int h = kvh * kv_mul;
+                    llmk_kv_attn(s, l, kvh, s->pf_q + t * dim + h * head_size, kv_mul, pos + 1,
+                                 head_size, inv_scale, s->pf_xb + t * dim + h * head_size);
+                }
+            }
+            LLMK_OP_MARK(LLMK_OP_ATTN);
+
+            // Output projection, then residual + FFN RMSNorm per token
+            djiblas_gemm(&w->wo_m, l, s->pf_xb, dim, nb, s->pf_xb2, dim);
+            LLMK_OP_MARK(LLMK_OP_WO);
+            for (int t = 0; t < nb; t++) {
+                g_djiblas.residual_rmsnorm(s->pf_x + t * dim, s->pf_xb2 + t * dim,
+                                           w->rms_ffn_weight + l*dim, s->pf_xb + t * dim, dim);
+            }
+            LLMK_OP_MARK(LLMK_OP_NORM);
+
+            // FFN
+            djiblas_gemm(&w->w1_m, l, s->pf_xb, dim, nb, s->pf_hb, hidden_dim);
+            djiblas_gemm(&w->w3_m, l, s->pf_xb, dim, nb, s->pf_hb2, hidden_dim);
+            g_djiblas.silu(s->pf_hb, s->pf_hb2, nb * hidden_dim);
+            LLMK_OP_MARK(LLMK_OP_FFN_UP);
+            djiblas_gemm(&w->w2_m, l, s->pf_hb, hidden_dim, nb, s->pf_xb2, dim);
+            LLMK_OP_MARK(LLMK_OP_FFN_DOWN);
+            if (l + 1 < n_layers) {
+                for (int t = 0; t < nb; t++) {
+                    g_djiblas.residual_rmsnorm(s->pf_x + t * dim, s->pf_xb2 + t * dim,
+                                               w->rms_att_weight + (l + 1)*dim, s->pf_xb + t * dim, dim);
+                }
+            } else {
+                g_djiblas.axpy(s->pf_x, s->pf_xb2, 1.0f, nb * dim);
+            }
+            LLMK_OP_MARK(LLMK_OP_NORM);
+        }
+
+        // Only the last token needs logits; earlier blocks just fill the KV cache.
+        if (need_logits && b0 + nb == n) {
+            g_djiblas.rmsnorm(s->x, s->pf_x + (nb - 1) * dim, w->rms_final_weight, dim);
+            matmul(s->logits, s->x, &w->wcls_m, 0);
+            LLMK_OP_MARK(LLMK_OP_CLS);
+        }
+    }
+}
+
+// ============================================================================
+// BOOT AUTOTUNE (djiblas.tune)
+// ============================================================================
+
+static DjibLasTuneProfile g_tune;
+static const CHAR16 *g_tune_status = L"off";
+
+static BOOLEAN llmk_tune_load(DjibLasTuneProfile *P) {
+    EFI_FILE_HANDLE f = NULL;
+    if (EFI_ERROR(llmk_open_read_file(&f, L"djiblas.tune"))) return FALSE;
+
+    char buf[2048];
+    UINTN sz = sizeof(buf) - 1;
+    EFI_STATUS st = uefi_call_wrapper(f->Read, 3, f, &sz, buf);
+    uefi_call_wrapper(f->Close, 1, f);
+    if (EFI_ERROR(st) || sz == 0) return FALSE;
+    buf[sz] = 0;
+    return djiblas_tune_parse(P, buf, (int)sz);
+}
+
+static EFI_STATUS llmk_tune_save(const DjibLasTuneProfile *P) {
+    char buf[2048];
+    int n = djiblas_tune_format(P, buf, (int)sizeof(buf));
+
+    EFI_FILE_HANDLE f = NULL;
+    EFI_STATUS st = llmk_open_binary_file(&f, L"djiblas.tune");
+    if (EFI_ERROR(st)) return st;
+    st = llmk_file_write_bytes(f, buf, (UINTN)n);
+    uefi_call_wrapper(f->Flush, 1, f);
+    uefi_call_wrapper(f->Close, 1, f);
+    return st;
+}
+
+// Load the tuning profile, measure any shape it does not cover (all of them
+// on a new CPU or with autotune=force), save it back if anything was
+// measured, and attach the choices to the weight matrices.
+static void llmk_autotune_best_effort(TransformerWeights *w, Config *p, int mode) {
+    if (mode == 0) return;
+
+    djiblas_tune_init(&g_tune);
+    BOOLEAN loaded = (mode == 1) && llmk_tune_load(&g_tune);
+
+    DjibLasMatrix *mats[6] = {
+        &w->wqkv_m, &w->wo_m, &w->w1_m, &w->w2_m, &w->w3_m, &w->wcls_m,
+    };
+    int measured = 0;
+    for (int i = 0; i < 6; i++) {
+        DjibLasMatrix *M = mats[i];
+        if (!djiblas_tune_find(&g_tune, M)) {
+            // The classifier only ever runs as a GEMV.
+            BOOLEAN cls = (M == &w->wcls_m);
+            int ntok = cls ? 0 : LLMK_PREFILL_BLOCK;
+            UINT64 nf = djiblas_tune_scratch_floats(M, ntok);
+            float *scratch = (float *)llmk_sentinel_alloc(&g_sentinel, LLMK_ARENA_SCRATCH,
+                                                          nf * sizeof(float), 64, L"autotune");
+            if (scratch && djiblas_tune_matrix(&g_tune, M, cls ? 1 : p->n_layers, ntok, scratch, nf)) {
+                const DjibLasTuneEntry *e = djiblas_tune_find(&g_tune, M);
+                Print(L"  [tune] %a %dx%d gemv=%a gemm=%a block=%d (%d / %d kcyc)\r\n",
+                      djiblas_tune_type_name(e->type), e->rows, e->cols,
+                      djiblas_tune_gemv_name(e->gemv), djiblas_tune_sgemm_name(e->sgemm), e->row_block,
+                      (int)(e->gemv_cycles / 1000ULL), (int)(e->gemm_cycles / 1000ULL));
+                measured++;
+            }
+            llmk_scratch_reset();
+        }
+        djiblas_tune_apply(&g_tune, M);
+    }
+
+    if (measured > 0) {
+        EFI_STATUS st = llmk_tune_save(&g_tune);
+        g_tune_status = EFI_ERROR(st) ? L"measured (save failed)" : L"measured, saved djiblas.tune";
+    } else {
+        g_tune_status = loaded ? L"loaded djiblas.tune" : L"nothing to tune";
+    }
+    Print(L"  Autotune: %s (%d shapes)\r\n", g_tune_status, g_tune.n);
 }
 
 // Simple PRNG for sampling
@@ -1746,6 +2461,65 @@ static void calibrate_tsc_once(void) {
     tsc_per_sec = dt * 2ULL;
 }
 
+// ----------------------------------------------------------------------------
+// /bench_kernels: djiblas_check_run() rows to the console + djiblas_bench.csv
+// ----------------------------------------------------------------------------
+
+typedef struct {
+    EFI_FILE_HANDLE f;
+    EFI_STATUS st;
+} LlmkBenchKernelsCtx;
+
+static void llmk_bench_kernels_emit(void *ctx, const char *line) {
+    LlmkBenchKernelsCtx *c = (LlmkBenchKernelsCtx *)ctx;
+    char row[160];
+    int n = 0;
+    while (line[n] && line[n] != '\n' && n + 1 < (int)sizeof(row)) {
+        row[n] = line[n];
+        n++;
+    }
+    row[n] = 0;
+    Print(L"  %a\r\n", row);
+    if (c->f && !EFI_ERROR(c->st)) {
+        row[n] = '\n';
+        c->st = llmk_file_write_bytes(c->f, row, (UINTN)(n + 1));
+    }
+}
+
+// Shapes that do not fit the SCRATCH arena are reported as skipped (the
+// hosted llmk-bench-kernels binary runs all of them).
+static void llmk_bench_kernels(void) {
+    UINT64 want = djiblas_check_scratch_floats();
+    UINT64 avail = llmk_arena_remaining_bytes(&g_zones, LLMK_ARENA_SCRATCH);
+    avail = (avail > 4096ULL) ? (avail - 4096ULL) / sizeof(float) : 0;
+    UINT64 nf = (want < avail) ? want : avail;
+    float *scratch = nf ? (float *)llmk_sentinel_alloc(&g_sentinel, LLMK_ARENA_SCRATCH,
+                                                       nf * sizeof(float), 64, L"bench_kernels") : NULL;
+    if (!scratch) {
+        Print(L"\r\n  bench_kernels: no scratch memory\r\n\r\n");
+        return;
+    }
+
+    calibrate_tsc_once();
+    LlmkBenchKernelsCtx c;
+    c.f = NULL;
+    c.st = llmk_open_binary_file(&c.f, L"djiblas_bench.csv");
+    if (EFI_ERROR(c.st)) c.f = NULL;
+
+    Print(L"\r\nKernel check (%d MB scratch, tsc=%d MHz):\r\n", (int)((nf * sizeof(float)) >> 20),
+          (int)(tsc_per_sec / 1000000ULL));
+    DjibLasCheckSummary sum;
+    djiblas_check_run(scratch, nf, tsc_per_sec, llmk_bench_kernels_emit, &c, &sum);
+    llmk_scratch_reset();
+
+    if (c.f) {
+        uefi_call_wrapper(c.f->Flush, 1, c.f);
+        uefi_call_wrapper(c.f->Close, 1, c.f);
+    }
+    Print(L"  %d checked, %d FAIL, %d skipped; %s\r\n\r\n", sum.n_run, sum.n_fail, sum.n_skip,
+          (c.f && !EFI_ERROR(c.st)) ? L"saved djiblas_bench.csv" : L"csv not saved");
+}
+
 static float randf(void) {
     g_seed = g_seed * 1664525 + 1013904223;
     return (float)(g_seed >> 8) / 16777216.0f;
@@ -1786,40 +2560,24 @@ int sample_advanced(float* logits, int n, float temperature, float min_p, float
         logits[i] /= temperature;
     }
     
-    // Softmax
-    float max_val = logits[0];
-    for (int i = 1; i < n; i++) {
-        if (logits[i] > max_val) max_val = logits[i];
-    }
-    float sum = 0.0f;
-    for (int i = 0; i < n; i++) {
-        logits[i] = fast_exp(logits[i] - max_val);
-        sum += logits[i];
-    }
-    for (int i = 0; i < n; i++) {
-        logits[i] /= sum;
-    }
+    // Unnormalized softmax (vector exp via DjibLAS dispatch; vocab-wide, so
+    // it matters): logits[i] = exp(logit - max), sum is the normalizer. The
+    // division is folded into the top-p / sampling thresholds below instead
+    // of another pass over the vocab.
+    float sum = g_djiblas.exp_sum(logits, n);
 
-    // Min-p filtering (relative to max probability)
+    // Min-p filtering (relative to max probability, which is exp(0) = 1 here)
     if (min_p > 0.0f) {
-        float max_p = 0.0f;
-        for (int i = 0; i < n; i++) {
-            if (logits[i] > max_p) max_p = logits[i];
-        }
-        float thresh = min_p * max_p;
         float new_sum = 0.0f;
         for (int i = 0; i < n; i++) {
-            if (logits[i] < thresh) {
+            if (logits[i] < min_p) {
                 logits[i] = 0.0f;
             }
             new_sum += logits[i];
         }
-        if (new_sum > 0.0f) {
-            for (int i = 0; i < n; i++) {
-                logits[i] /= new_sum;
-            }
-        }
+        if (new_sum > 0.0f) sum = new_sum;
     }
+    float top_mass = top_p * sum;
     
     // Top-k / Top-p sampling
     {
@@ -1865,7 +2623,7 @@ int sample_advanced(float* logits, int n, float temperature, float min_p, float
             for (int i = 0; i < top_count; i++) {
                 mass += top_prob[i];
                 cutoff++;
-                if (top_p < 1.0f && mass >= top_p) break;
+                if (top_p < 1.0f && mass >= top_mass) break;
             }
             if (cutoff < 1) cutoff = 1;
 
@@ -1883,7 +2641,7 @@ int sample_advanced(float* logits, int n, float temperature, float min_p, float
     }
     
     // Sample from distribution
-    float r = randf();
+    float r = randf() * sum;
     float cumsum = 0.0f;
     for (int i = 0; i < n; i++) {
         cumsum += logits[i];
@@ -2077,102 +2835,33 @@ int check_quit_command(char* text) {
 }
 
 void reset_kv_cache(RunState* s, Config* p) {
-    // Clear KV cache for new conversation
-    int kv_dim = (p->dim * p->n_kv_heads) / p->n_heads;
-    int cache_size = p->n_layers * p->seq_len * kv_dim;
-    
-    for (int i = 0; i < cache_size; i++) {
-        s->key_cache[i] = 0.0f;
-        s->value_cache[i] = 0.0f;
+    // Clear KV cache for new conversation (head-major padding and int8 scales included)
+    (void)p;
+    UINT8* k = (UINT8*)s->key_cache;
+    UINT8* v = (UINT8*)s->value_cache;
+    for (UINT64 i = 0; i < s->kv_bytes; i++) {
+        k[i] = 0;
+        v[i] = 0;
+    }
+    for (UINT64 i = 0; s->key_scale && i < s->kv_scale_bytes / sizeof(float); i++) {
+        s->key_scale[i] = 0.0f;
+        s->value_scale[i] = 0.0f;
     }
 }
 
 // ============================================================================
-// MAIN
+// MODEL LOADING
 // ============================================================================
 
-EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable) {
-    InitializeLib(ImageHandle, SystemTable);
+// Boot steps [2/7]..[6/7]: model header, kernel zones, weights, state buffers
+// and tokenizer, all read through Root. Shared by efi_main and the hosted
+// bench (hosted/bench.c). model_name NULL tries the usual candidate names.
+static EFI_STATUS llmk_load_model(EFI_FILE_HANDLE Root, CHAR16 *model_name, CHAR16 *tokenizer_name,
+                                  Config *config_out, TransformerWeights *weights_out,
+                                  RunState *state_out, Tokenizer *tokenizer_out,
+                                  CHAR16 **model_filename_out) {
+    EFI_STATUS status = EFI_SUCCESS;
 
-    // Initialize DjibMark tracing system (Made in Senegal 🇸🇳)
-    djibmark_init();
-    DJIBMARK_BOOT();
-
-    // Disable the UEFI watchdog timer (large model loads can take minutes).
-    // If not disabled, firmware may reset/reboot mid-load and it looks like a hang.
-    uefi_call_wrapper(BS->SetWatchdogTimer, 4, 0, 0, 0, NULL);
-    
-    Print(L"\r\n");
-    Print(L"----------------------------------------\r\n");
-    Print(L"  LLAMA2 CHAT REPL V3 - Full Loop\r\n");
-    Print(L"----------------------------------------\r\n\r\n");
-    
-    // ========================================================================
-    // [1/7] File System
-    // ========================================================================
-    
-    Print(L"[1/7] Opening file system...\r\n");
-    
-    EFI_LOADED_IMAGE *LoadedImage;
-    EFI_STATUS status = uefi_call_wrapper(BS->HandleProtocol, 3, ImageHandle, &LoadedImageProtocol, &LoadedImage);
-    if (EFI_ERROR(status)) {
-        Print(L"ERROR: LoadedImage protocol failed\r\n");
-        return status;
-    }
-    
-    EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
-    status = uefi_call_wrapper(BS->HandleProtocol, 3, LoadedImage->DeviceHandle, &FileSystemProtocol, &FileSystem);
-    if (EFI_ERROR(status)) {
-        Print(L"ERROR: FileSystem protocol failed\r\n");
-        return status;
-    }
-    
-    EFI_FILE_HANDLE Root;
-    status = uefi_call_wrapper(FileSystem->OpenVolume, 2, FileSystem, &Root);
-    if (EFI_ERROR(status)) {
-        Print(L"ERROR: OpenVolume failed\r\n");
-        return status;
-    }
-
-    // Persist root handle for best-effort dumps.
-    g_root = Root;
-    
-    Print(L"OK: File system ready\r\n\r\n");
-
-    // Best-effort enable AVX/AVX2 state before feature detection.
-    enable_avx_best_effort();
-
-    // CPU feature detection (djiblas)
-    {
-        CPUFeatures cpu_features;
-        djiblas_detect_cpu(&cpu_features);
-        sgemm_kernel_t k = djiblas_get_best_kernel(&cpu_features);
-        const CHAR16 *name = L"SCALAR";
-        if (k == djiblas_sgemm_avx512) name = L"AVX512";
-        else if (k == djiblas_sgemm_avx2) name = (cpu_features.has_fma ? L"AVX2+FMA" : L"AVX2");
-        else if (k == djiblas_sgemm_sse2) name = L"SSE2";
-        Print(L"[DJIBLAS] SGEMM kernel: %s (sse2=%d avx=%d avx2=%d fma=%d)\r\n\r\n",
-              name,
-              (int)cpu_features.has_sse2,
-              (int)cpu_features.has_avx,
-              (int)cpu_features.has_avx2,
-              (int)cpu_features.has_fma);
-
-          // Attention SIMD dispatch: only use AVX2 if firmware/OS state supports it.
-          g_attn_use_avx2 = (cpu_features.has_avx2 && cpu_features.has_avx);
-          Print(L"[ATTN] SIMD path: %s\r\n\r\n", g_attn_use_avx2 ? L"AVX2" : L"SSE2");
-    }
-
-    // Best-effort graphics init (GOP). Optional: REPL still works without it.
-    {
-        EFI_STATUS gst = llmk_gop_init_best_effort();
-        if (!EFI_ERROR(gst)) {
-            Print(L"[GOP] Framebuffer ready: %dx%d (ppsl=%d)\r\n\r\n", (int)g_gop_w, (int)g_gop_h, (int)g_gop_ppsl);
-        } else {
-            Print(L"[GOP] Not available (%r)\r\n\r\n", gst);
-        }
-    }
-    
     // ========================================================================
     // [2/7] Load Model Header
     // ========================================================================
@@ -2184,15 +2873,26 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     {
         // Try larger models first when present. Keep the list small and explicit
         // (UEFI shell users can rename the file to match one of these).
+        // A quantized .djibq (convert_to_djibquant.py) wins over the .bin of the same model.
         CHAR16 *candidates[] = {
+            L"stories300M.djibq",
             L"stories300M.bin",
+            L"stories260M.djibq",
             L"stories260M.bin",
+            L"stories200M.djibq",
             L"stories200M.bin",
+            L"stories110M.djibq",
             L"stories110M.bin",
+            L"stories15M.djibq",
             L"stories15M.bin",
+            L"model.djibq",
             L"model.bin",
         };
-        const int n_candidates = (int)(sizeof(candidates) / sizeof(candidates[0]));
+        int n_candidates = (int)(sizeof(candidates) / sizeof(candidates[0]));
+        if (model_name) {
+            candidates[0] = model_name;
+            n_candidates = 1;
+        }
         EFI_STATUS last = EFI_NOT_FOUND;
         for (int i = 0; i < n_candidates; i++) {
             EFI_FILE_HANDLE f = 0;
@@ -2206,7 +2906,11 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
             last = st;
         }
         if (model_filename == NULL) {
-            Print(L"ERROR: Model file not found. Expected one of: stories300M.bin stories260M.bin stories200M.bin stories110M.bin stories15M.bin model.bin\r\n");
+            if (model_name) {
+                Print(L"ERROR: Model file not found: %s\r\n", model_name);
+            } else {
+                Print(L"ERROR: Model file not found. Expected one of: stories300M/260M/200M/110M/15M or model (.djibq or .bin)\r\n");
+            }
             return last;
         }
     }
@@ -2215,6 +2919,17 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     UINTN bytes_to_read = 7 * sizeof(int);
     uefi_call_wrapper(ModelFile->Read, 3, ModelFile, &bytes_to_read, &config);
     
+    // A .djibq file has the same Config header, followed by tensor records
+    // instead of raw floats (a DjibQuant magic is never a plausible float).
+    BOOLEAN is_djibq = FALSE;
+    {
+        UINT32 magic = 0;
+        UINTN n = sizeof(magic);
+        uefi_call_wrapper(ModelFile->Read, 3, ModelFile, &n, &magic);
+        is_djibq = (n == sizeof(magic) && DJIBQUANT_IS_MAGIC(magic));
+        uefi_call_wrapper(ModelFile->SetPosition, 2, ModelFile, (UINT64)(7 * sizeof(int)));
+    }
+
     // In llama2.c format, a negative vocab_size indicates shared classifier weights.
     int shared_classifier = (config.vocab_size < 0);
     if (config.vocab_size < 0) config.vocab_size = -config.vocab_size;
@@ -2249,6 +2964,13 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     int kv_dim = (config.dim * config.n_kv_heads) / config.n_heads;
     int head_size = config.dim / config.n_heads;
 
+    RunState state;
+    llmk_kv_layout_init(&state, &config, g_boot_cfg.kv_head_major, g_boot_cfg.kv_type);
+    if (g_boot_cfg.kv_sinks > config.seq_len / 2) g_boot_cfg.kv_sinks = config.seq_len / 2;
+    state.kv_rolling = g_boot_cfg.kv_rolling;
+    state.kv_sinks = g_boot_cfg.kv_sinks;
+    UINT64 kv_cache_bytes = ((state.kv_bytes + 63ULL) & ~63ULL) + ((state.kv_scale_bytes + 63ULL) & ~63ULL);
+
     // Compute total weights size (floats)
     UINTN n_floats_base = 0;
     n_floats_base += (UINTN)config.vocab_size * (UINTN)config.dim;                   // token_embedding_table
@@ -2267,8 +2989,16 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
 
     UINTN n_floats_with_cls = n_floats_base + (UINTN)config.vocab_size * (UINTN)config.dim;
 
-    // If file size is known, use it to infer whether wcls is present.
-    if (model_file_size > 0) {
+    LlmkDjibq djibq;
+    if (is_djibq) {
+        status = llmk_djibq_scan(ModelFile, model_file_size, &config, &djibq);
+        if (EFI_ERROR(status)) {
+            Print(L"ERROR: Unusable .djibq model file: %r\r\n", status);
+            return status;
+        }
+        shared_classifier = (djibq.n_tensors < LLMK_T_COUNT);
+    } else if (model_file_size > 0) {
+        // If file size is known, use it to infer whether wcls is present.
         UINT64 available = model_file_size;
         UINT64 header_bytes = (UINT64)(7 * sizeof(int));
         if (available > header_bytes) available -= header_bytes;
@@ -2283,15 +3013,17 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     }
 
     UINTN n_floats = shared_classifier ? n_floats_base : n_floats_with_cls;
-    UINTN weights_bytes = n_floats * sizeof(float);
+    UINTN weights_bytes = is_djibq ? (UINTN)djibq.weights_bytes : n_floats * sizeof(float);
     UINTN state_bytes = 0;
     state_bytes += (UINTN)config.dim * sizeof(float) * 3; // x, xb, xb2
-    state_bytes += (UINTN)config.hidden_dim * sizeof(float) * 2; // hb, hb2
+    state_bytes += (UINTN)config.hidden_dim * sizeof(float); // hb
+    state_bytes += (UINTN)djiblas_workspace_bytes(LLMK_PREFILL_BLOCK * (config.hidden_dim > config.dim ? config.hidden_dim : config.dim)); // int8 activations
+    state_bytes += (UINTN)LLMK_PREFILL_BLOCK * (UINTN)config.dim * sizeof(float) * 4; // pf_x, pf_xb, pf_xb2, pf_q
+    state_bytes += (UINTN)LLMK_PREFILL_BLOCK * (UINTN)config.hidden_dim * sizeof(float) * 2; // pf_hb, pf_hb2
     state_bytes += (UINTN)config.dim * sizeof(float); // q
-    state_bytes += (UINTN)kv_dim * sizeof(float) * 2; // k, v
-    state_bytes += (UINTN)config.n_heads * (UINTN)config.seq_len * sizeof(float); // att
     state_bytes += (UINTN)config.vocab_size * sizeof(float); // logits
-    state_bytes += (UINTN)config.n_layers * (UINTN)config.seq_len * (UINTN)kv_dim * sizeof(float) * 2; // key/value cache
+    state_bytes += (UINTN)kv_cache_bytes * 2; // key/value cache (+ int8 scales)
+    state_bytes += ((UINTN)config.seq_len + 1) * (UINTN)head_size * sizeof(float) * 2; // rope_cos, rope_sin, rope_row
 
     // Tokenizer: pointers + scores + strings (strings size varies; reserve a safe budget)
     UINTN tokenizer_bytes = (UINTN)config.vocab_size * (sizeof(char*) + sizeof(float));
@@ -2308,15 +3040,17 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
         UINT64 scratch_bytes = 32ULL * 1024ULL * 1024ULL;
 
         // KV cache lives in its own arena.
-        UINT64 kv_bytes = (UINT64)config.n_layers * (UINT64)config.seq_len * (UINT64)kv_dim * sizeof(float) * 2ULL;
+        UINT64 kv_bytes = kv_cache_bytes * 2ULL;
 
         UINT64 weights_u64 = (UINT64)weights_bytes;
         UINT64 acts_u64 = (UINT64)(state_bytes - (UINTN)kv_bytes) + (UINT64)tokenizer_bytes + (UINT64)slack_bytes;
 
         // Total Zone B includes all arenas.
-        UINT64 total = weights_u64 + kv_bytes + scratch_bytes + acts_u64 + zonec_bytes;
-        // Min 1GB for larger models; fallback to 768MB if allocation fails.
-        UINT64 min_total = (total > 768ULL * 1024ULL * 1024ULL) ? (1024ULL * 1024ULL * 1024ULL) : (768ULL * 1024ULL * 1024ULL);
+        UINT64 need = weights_u64 + kv_bytes + scratch_bytes + acts_u64 + zonec_bytes;
+        // Prefer headroom (768MB / 1GB), but only as a first try: a quantized
+        // model on a low-RAM machine must still boot with exactly what it needs.
+        UINT64 total = need;
+        UINT64 min_total = (need > 768ULL * 1024ULL * 1024ULL) ? (1024ULL * 1024ULL * 1024ULL) : (768ULL * 1024ULL * 1024ULL);
         if (total < min_total) total = min_total;
 
         LlmkZonesConfig zcfg;
@@ -2329,16 +3063,11 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
 
         Print(L"[3/7] Init kernel zones (%d MB)...\r\n", (int)(total / (1024 * 1024)));
         status = llmk_zones_init(BS, &zcfg, &g_zones);
-        if (EFI_ERROR(status) && total > min_total) {
-            // If the computed size can't be allocated (e.g. low guest RAM / fragmentation),
-            // fall back to a smaller default so the REPL can still boot with smaller models.
-            Print(L"[llmk] zones alloc failed, retrying with %d MB...\r\n", (int)(min_total / (1024 * 1024)));
-            zcfg.total_bytes = min_total;
-            zcfg.weights_bytes = 0;
-            zcfg.kv_bytes = 0;
-            zcfg.scratch_bytes = 0;
-            zcfg.activations_bytes = 0;
-            zcfg.zone_c_bytes = 0;
+        if (EFI_ERROR(status) && total > need) {
+            // Headroom can't be allocated (low guest RAM / fragmentation):
+            // retry with the exact per-arena sizes computed above.
+            Print(L"[llmk] zones alloc failed, retrying with %d MB...\r\n", (int)(need / (1024 * 1024)));
+            zcfg.total_bytes = need;
             status = llmk_zones_init(BS, &zcfg, &g_zones);
         }
         if (EFI_ERROR(status)) {
@@ -2384,61 +3113,124 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     // ========================================================================
     
     Print(L"[4/7] Mapping weights...\r\n");
-    bytes_to_read = weights_bytes;
-    float* weights_mem = (float*)llmk_alloc_weights((UINT64)bytes_to_read, L"weights");
-    if (weights_mem == NULL) {
-        Print(L"ERROR: Out of heap while allocating weights (%d MB needed)\r\n", (int)(bytes_to_read / (1024 * 1024)));
-        return EFI_OUT_OF_RESOURCES;
-    }
-    status = read_exact(ModelFile, weights_mem, bytes_to_read);
-    if (EFI_ERROR(status)) {
-        Print(L"ERROR: Failed to read weights (need model file + enough RAM).\r\n");
-        return EFI_LOAD_ERROR;
-    }
+    TransformerWeights weights;
+    const float* freq_cis = NULL;
+    if (is_djibq) {
+        status = llmk_djibq_load(ModelFile, &djibq, &config, &weights);
+        uefi_call_wrapper(ModelFile->Close, 1, ModelFile);
+        if (EFI_ERROR(status)) {
+            Print(L"ERROR: Failed to load .djibq weights: %r\r\n", status);
+            return EFI_LOAD_ERROR;
+        }
+        Print(L"  DjibQuant model: %d MB of weights\r\n", (int)(weights_bytes / (1024 * 1024)));
+    } else {
+        bytes_to_read = weights_bytes;
+        float* weights_mem = (float*)llmk_alloc_weights((UINT64)bytes_to_read, L"weights");
+        if (weights_mem == NULL) {
+            Print(L"ERROR: Out of heap while allocating weights (%d MB needed)\r\n", (int)(bytes_to_read / (1024 * 1024)));
+            return EFI_OUT_OF_RESOURCES;
+        }
 
-    float* weights_ptr = weights_mem;
+        // File order is embedding | rms_att | wq | wk | wv | wo | ... with each of
+        // wq/wk/wv stacked over all layers. Read wq/wk/wv straight into a per-layer
+        // [wq; wk; wv] stack instead (same region, same size), so each layer's QKV
+        // projection is one (dim + 2*kv_dim) x dim GEMV.
+        UINTN head_floats = (UINTN)config.vocab_size * (UINTN)config.dim + (UINTN)config.n_layers * (UINTN)config.dim;
+        UINTN q_floats = (UINTN)config.dim * (UINTN)config.dim;
+        UINTN kv_floats = (UINTN)kv_dim * (UINTN)config.dim;
+        UINTN qkv_layer_floats = q_floats + 2 * kv_floats;
+        UINTN qkv_floats = (UINTN)config.n_layers * qkv_layer_floats;
+        float* qkv_mem = weights_mem + head_floats;
+
+        status = read_exact(ModelFile, weights_mem, head_floats * sizeof(float));
+        for (int t = 0; t < 3 && !EFI_ERROR(status); t++) {
+            UINTN off = (t == 0) ? 0 : (t == 1) ? q_floats : (q_floats + kv_floats);
+            UINTN n = (t == 0) ? q_floats : kv_floats;
+            for (int l = 0; l < config.n_layers && !EFI_ERROR(status); l++) {
+                status = read_exact(ModelFile, qkv_mem + (UINTN)l * qkv_layer_floats + off, n * sizeof(float));
+            }
+        }
+        if (!EFI_ERROR(status)) {
+            status = read_exact(ModelFile, qkv_mem + qkv_floats, bytes_to_read - (head_floats + qkv_floats) * sizeof(float));
+        }
+        if (EFI_ERROR(status)) {
+            Print(L"ERROR: Failed to read weights (need model file + enough RAM).\r\n");
+            return EFI_LOAD_ERROR;
+        }
 
-    TransformerWeights weights;
-    weights.token_embedding_table = weights_ptr;
-    weights_ptr += config.vocab_size * config.dim;
-    
-    weights.rms_att_weight = weights_ptr;
-    weights_ptr += config.n_layers * config.dim;
-    
-    weights.wq = weights_ptr;
-    weights_ptr += config.n_layers * config.dim * config.dim;
+        float* weights_ptr = weights_mem;
+
+        weights.token_embedding_table = weights_ptr;
+        weights_ptr += config.vocab_size * config.dim;
     
-    weights.wk = weights_ptr;
-    weights_ptr += config.n_layers * config.dim * kv_dim;
+        weights.rms_att_weight = weights_ptr;
+        weights_ptr += config.n_layers * config.dim;
     
-    weights.wv = weights_ptr;
-    weights_ptr += config.n_layers * config.dim * kv_dim;
+        weights.wqkv = weights_ptr;
+        weights_ptr += qkv_floats;
     
-    weights.wo = weights_ptr;
-    weights_ptr += config.n_layers * config.dim * config.dim;
+        weights.wo = weights_ptr;
+        weights_ptr += config.n_layers * config.dim * config.dim;
     
-    weights.rms_ffn_weight = weights_ptr;
-    weights_ptr += config.n_layers * config.dim;
+        weights.rms_ffn_weight = weights_ptr;
+        weights_ptr += config.n_layers * config.dim;
     
-    weights.w1 = weights_ptr;
-    weights_ptr += config.n_layers * config.dim * config.hidden_dim;
+        weights.w1 = weights_ptr;
+        weights_ptr += config.n_layers * config.dim * config.hidden_dim;
     
-    weights.w2 = weights_ptr;
-    weights_ptr += config.n_layers * config.hidden_dim * config.dim;
+        weights.w2 = weights_ptr;
+        weights_ptr += config.n_layers * config.hidden_dim * config.dim;
     
-    weights.w3 = weights_ptr;
-    weights_ptr += config.n_layers * config.dim * config.hidden_dim;
+        weights.w3 = weights_ptr;
+        weights_ptr += config.n_layers * config.dim * config.hidden_dim;
     
-    weights.rms_final_weight = weights_ptr;
-    weights_ptr += config.dim;
+        weights.rms_final_weight = weights_ptr;
+        weights_ptr += config.dim;
     
-    // Skip freq_cis_real and freq_cis_imag (RoPE precomputed freqs)
-    weights_ptr += config.seq_len * head_size / 2;  // freq_cis_real
-    weights_ptr += config.seq_len * head_size / 2;  // freq_cis_imag
+        // freq_cis_real and freq_cis_imag (RoPE table, expanded in [5/7])
+        freq_cis = weights_ptr;
+        weights_ptr += config.seq_len * head_size / 2;  // freq_cis_real
+        weights_ptr += config.seq_len * head_size / 2;  // freq_cis_imag
     
-    weights.wcls = shared_classifier ? weights.token_embedding_table : weights_ptr;
+        weights.wcls = shared_classifier ? weights.token_embedding_table : weights_ptr;
     
-    uefi_call_wrapper(ModelFile->Close, 1, ModelFile);
+        uefi_call_wrapper(ModelFile->Close, 1, ModelFile);
+
+        djiblas_matrix_init_f32(&weights.wqkv_m, weights.wqkv, config.dim + 2 * kv_dim, config.dim);
+        djiblas_matrix_init_f32(&weights.wo_m, weights.wo, config.dim, config.dim);
+        djiblas_matrix_init_f32(&weights.w1_m, weights.w1, config.hidden_dim, config.dim);
+        djiblas_matrix_init_f32(&weights.w2_m, weights.w2, config.dim, config.hidden_dim);
+        djiblas_matrix_init_f32(&weights.w3_m, weights.w3, config.hidden_dim, config.dim);
+        djiblas_matrix_init_f32(&weights.wcls_m, weights.wcls, config.vocab_size, config.dim);
+    }
+
+    // Optional: rewrite GEMV weights into the panel-interleaved layout of the
+    // boot-selected kernel (in place, same bytes in LLMK_ARENA_WEIGHTS), so
+    // each GEMV reads one contiguous stream per panel instead of 8/16 rows.
+    if (g_boot_cfg.repack && g_djiblas.gemv_panel) {
+        int max_cols = (config.hidden_dim > config.dim) ? config.hidden_dim : config.dim;
+        UINT64 tmp_bytes = djiblas_panel_tmp_floats(max_cols) * sizeof(float);
+        float *tmp = (float *)llmk_sentinel_alloc(&g_sentinel, LLMK_ARENA_SCRATCH, tmp_bytes, 64, L"repack tmp");
+        if (tmp) {
+            DjibLasMatrix *mats[6] = {
+                &weights.wqkv_m, &weights.wo_m,
+                &weights.w1_m, &weights.w2_m, &weights.w3_m, &weights.wcls_m,
+            };
+            int n_packed = 0;
+            for (int i = 0; i < 6; i++) {
+                int layers = (mats[i] == &weights.wcls_m) ? 1 : config.n_layers;
+                if (djiblas_repack_panels(mats[i], layers, tmp)) n_packed++;
+            }
+            llmk_scratch_reset();
+            Print(L"  Repacked %d/6 weight tensors into %s panels\r\n", n_packed, g_djiblas.panel_name);
+        }
+    }
+
+    if (shared_classifier) {
+        weights.embed_m = weights.wcls_m;
+    } else if (!is_djibq) {
+        djiblas_matrix_init_f32(&weights.embed_m, weights.token_embedding_table, config.vocab_size, config.dim);
+    }
     
     Print(L"OK: Weights mapped\r\n\r\n");
     
@@ -2448,22 +3240,71 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     
     Print(L"[5/7] Allocating state buffers...\r\n");
     
-    RunState state;
-    
     state.x = (float*)simple_alloc(config.dim * sizeof(float));
     state.xb = (float*)simple_alloc(config.dim * sizeof(float));
     state.xb2 = (float*)simple_alloc(config.dim * sizeof(float));
     state.hb = (float*)simple_alloc(config.hidden_dim * sizeof(float));
-    state.hb2 = (float*)simple_alloc(config.hidden_dim * sizeof(float));
     state.q = (float*)simple_alloc(config.dim * sizeof(float));
-    state.k = (float*)simple_alloc(kv_dim * sizeof(float));
-    state.v = (float*)simple_alloc(kv_dim * sizeof(float));
-    state.att = (float*)simple_alloc(config.n_heads * config.seq_len * sizeof(float));
     state.logits = (float*)simple_alloc(config.vocab_size * sizeof(float));
-    state.key_cache = (float*)llmk_alloc_kv((UINT64)config.n_layers * (UINT64)config.seq_len * (UINT64)kv_dim * sizeof(float), L"key cache");
-    state.value_cache = (float*)llmk_alloc_kv((UINT64)config.n_layers * (UINT64)config.seq_len * (UINT64)kv_dim * sizeof(float), L"value cache");
+    state.key_cache = llmk_alloc_kv(state.kv_bytes, L"key cache");
+    state.value_cache = llmk_alloc_kv(state.kv_bytes, L"value cache");
+    state.key_scale = NULL;
+    state.value_scale = NULL;
+    if (state.kv_scale_bytes) {
+        state.key_scale = (float*)llmk_alloc_kv(state.kv_scale_bytes, L"key scales");
+        state.value_scale = (float*)llmk_alloc_kv(state.kv_scale_bytes, L"value scales");
+    }
+    state.pf_block = LLMK_PREFILL_BLOCK;
+    state.pf_x = (float*)simple_alloc(LLMK_PREFILL_BLOCK * config.dim * sizeof(float));
+    state.pf_xb = (float*)simple_alloc(LLMK_PREFILL_BLOCK * config.dim * sizeof(float));
+    state.pf_xb2 = (float*)simple_alloc(LLMK_PREFILL_BLOCK * config.dim * sizeof(float));
+    state.pf_q = (float*)simple_alloc(LLMK_PREFILL_BLOCK * config.dim * sizeof(float));
+    state.pf_hb = (float*)simple_alloc(LLMK_PREFILL_BLOCK * config.hidden_dim * sizeof(float));
+    state.pf_hb2 = (float*)simple_alloc(LLMK_PREFILL_BLOCK * config.hidden_dim * sizeof(float));
+    state.rope_cos = (float*)simple_alloc(config.seq_len * head_size * sizeof(float));
+    state.rope_sin = (float*)simple_alloc(config.seq_len * head_size * sizeof(float));
+    state.rope_row = (float*)simple_alloc(2 * head_size * sizeof(float));
+    int rope_from_file = llmk_rope_init(&state, &config, freq_cis);
+    {
+        // int8 copy of the activation for Q8_0 / Q4 / Q6 weights, quantized
+        // once per layer input (djiblas_act_quantize); room for a whole
+        // prefill block so its tokens share one pass over the int8 weights.
+        // Kept at the base of SCRATCH, which decode does not otherwise touch.
+        int max_cols = (config.hidden_dim > config.dim) ? config.hidden_dim : config.dim;
+        UINT64 ws_bytes = djiblas_workspace_bytes(LLMK_PREFILL_BLOCK * max_cols);
+        g_scratch_keep = 0;
+        llmk_scratch_reset();
+        void *ws = llmk_sentinel_alloc(&g_sentinel, LLMK_ARENA_SCRATCH, ws_bytes, 64, L"act quant cache");
+        if (!ws) ws = simple_alloc((unsigned long)ws_bytes);
+        else g_scratch_keep = ws_bytes;
+        djiblas_set_workspace(ws, ws_bytes);
+    }
+
+    // Tensors that do not fit the LLC stream through prefetch-ahead kernels.
+    {
+        djiblas_stream_config(g_boot_cfg.llc_kb * 1024ULL, g_boot_cfg.stream_pf, g_boot_cfg.stream_nta != 0);
+        DjibLasMatrix *mats[6] = {
+            &weights.wqkv_m, &weights.wo_m, &weights.w1_m, &weights.w2_m, &weights.w3_m, &weights.wcls_m,
+        };
+        int n_stream = 0;
+        for (int i = 0; i < 6; i++) {
+            int layers = (mats[i] == &weights.wcls_m) ? 1 : config.n_layers;
+            if (djiblas_matrix_set_stream(mats[i], layers)) n_stream++;
+        }
+        Print(L"  Streaming GEMV: %d/6 tensors > LLC %d KB (prefetch %d B %s)\r\n", n_stream,
+              (int)(g_djiblas.llc_bytes >> 10), g_djiblas.stream_pf, g_djiblas.stream_nta ? L"NTA" : L"T0");
+    }
+
+    // Per-shape kernel / block choices (after the repack: the layout is part of
+    // the key; after the streaming marks: streaming tensors also time the
+    // prefetch-ahead GEMV).
+    llmk_autotune_best_effort(&weights, &config, g_boot_cfg.autotune);
+    Print(L"  RoPE: %d x %d table (%s)\r\n", config.seq_len, head_size,
+          rope_from_file ? L"freq_cis" : L"generated");
     
-    Print(L"OK: State buffers allocated\r\n\r\n");
+    Print(L"OK: State buffers allocated (KV %s %s-major, %d MB)\r\n\r\n",
+          state.kv_type == DJIBLAS_KV_Q8 ? L"int8" : state.kv_type == DJIBLAS_KV_F16 ? L"fp16" : L"fp32",
+          state.kv_head_major ? L"head" : L"pos", (int)((kv_cache_bytes * 2ULL) >> 20));
     
     // ========================================================================
     // [6/7] Tokenizer
@@ -2472,7 +3313,7 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     Print(L"[6/7] Loading tokenizer...\r\n");
     
     EFI_FILE_HANDLE TokFile;
-    status = uefi_call_wrapper(Root->Open, 5, Root, &TokFile, L"tokenizer.bin", EFI_FILE_MODE_READ, 0);
+    status = uefi_call_wrapper(Root->Open, 5, Root, &TokFile, tokenizer_name, EFI_FILE_MODE_READ, 0);
     if (EFI_ERROR(status)) {
         Print(L"ERROR: Tokenizer file not found\r\n");
         return status;
@@ -2503,6 +3344,111 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     uefi_call_wrapper(TokFile->Close, 1, TokFile);
     
     Print(L"OK: Tokenizer loaded (%d tokens)\r\n\r\n", tokenizer.vocab_size);
+
+    *config_out = config;
+    *weights_out = weights;
+    *state_out = state;
+    *tokenizer_out = tokenizer;
+    *model_filename_out = model_filename;
+    return EFI_SUCCESS;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+// The hosted bench (hosted/bench.c) includes this file with LLMK_HOSTED set
+// and brings its own main().
+#ifndef LLMK_HOSTED
+EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable) {
+    InitializeLib(ImageHandle, SystemTable);
+
+    // Initialize DjibMark tracing system (Made in Senegal 🇸🇳)
+    djibmark_init();
+    DJIBMARK_BOOT();
+
+    // Disable the UEFI watchdog timer (large model loads can take minutes).
+    // If not disabled, firmware may reset/reboot mid-load and it looks like a hang.
+    uefi_call_wrapper(BS->SetWatchdogTimer, 4, 0, 0, 0, NULL);
+    
+    Print(L"\r\n");
+    Print(L"----------------------------------------\r\n");
+    Print(L"  LLAMA2 CHAT REPL V3 - Full Loop\r\n");
+    Print(L"----------------------------------------\r\n\r\n");
+    
+    // ========================================================================
+    // [1/7] File System
+    // ========================================================================
+    
+    Print(L"[1/7] Opening file system...\r\n");
+    
+    EFI_LOADED_IMAGE *LoadedImage;
+    EFI_STATUS status = uefi_call_wrapper(BS->HandleProtocol, 3, ImageHandle, &LoadedImageProtocol, &LoadedImage);
+    if (EFI_ERROR(status)) {
+        Print(L"ERROR: LoadedImage protocol failed\r\n");
+        return status;
+    }
+    
+    EFI_SIMPLE_FILE_SYSTEM_PROTOCOL *FileSystem;
+    status = uefi_call_wrapper(BS->HandleProtocol, 3, LoadedImage->DeviceHandle, &FileSystemProtocol, &FileSystem);
+    if (EFI_ERROR(status)) {
+        Print(L"ERROR: FileSystem protocol failed\r\n");
+        return status;
+    }
+    
+    EFI_FILE_HANDLE Root;
+    status = uefi_call_wrapper(FileSystem->OpenVolume, 2, FileSystem, &Root);
+    if (EFI_ERROR(status)) {
+        Print(L"ERROR: OpenVolume failed\r\n");
+        return status;
+    }
+
+    // Persist root handle for best-effort dumps.
+    g_root = Root;
+    
+    Print(L"OK: File system ready\r\n\r\n");
+
+    // Boot-time options (weight layout, ...) must be known before loading.
+    llmk_load_boot_cfg_best_effort(&g_boot_cfg);
+
+    // Best-effort enable AVX/AVX2 state before feature detection.
+    enable_avx_best_effort();
+
+    // CPU feature detection + kernel dispatch (djiblas). Done exactly once:
+    // every hot path goes through g_djiblas afterwards.
+    {
+        djiblas_dispatch_init();
+        const CPUFeatures *f = &g_djiblas.cpu;
+        Print(L"[DJIBLAS] SGEMM kernel: %s, GEMV kernel: %s (sse2=%d avx=%d avx2=%d fma=%d avx512f=%d)\r\n",
+              g_djiblas.sgemm_name,
+              g_djiblas.gemv_name,
+              (int)f->has_sse2,
+              (int)f->has_avx,
+              (int)f->has_avx2,
+              (int)f->has_fma,
+              (int)f->has_avx512f);
+        Print(L"[ATTN] SIMD path: %s\r\n\r\n", g_djiblas.attn_name);
+    }
+
+    // Best-effort graphics init (GOP). Optional: REPL still works without it.
+    {
+        EFI_STATUS gst = llmk_gop_init_best_effort();
+        if (!EFI_ERROR(gst)) {
+            Print(L"[GOP] Framebuffer ready: %dx%d (ppsl=%d)\r\n\r\n", (int)g_gop_w, (int)g_gop_h, (int)g_gop_ppsl);
+        } else {
+            Print(L"[GOP] Not available (%r)\r\n\r\n", gst);
+        }
+    }
+    
+    Config config;
+    TransformerWeights weights;
+    RunState state;
+    Tokenizer tokenizer;
+    CHAR16 *model_filename = NULL;
+    status = llmk_load_model(Root, NULL, L"tokenizer.bin", &config, &weights, &state, &tokenizer, &model_filename);
+    if (EFI_ERROR(status)) {
+        return status;
+    }
     
     // ========================================================================
     // [7/7] Interactive REPL Loop
@@ -2514,7 +3460,7 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
     Print(L"  CHAT MODE ACTIVE\r\n");
     Print(L"  Type 'quit' or 'exit' to stop\r\n");
     Print(L"  Multi-line: end line with '\\' to continue; ';;' alone submits\r\n");
-    Print(L"  Commands: /temp /min_p /top_p /top_k /norepeat /repeat /max_tokens /seed /stats /stop_you /stop_nl /model /cpu /zones /budget /attn /test_failsafe /ctx /log /save_log /save_dump /gop /render /save_img /draw /reset /version /help\r\n");
+    Print(L"  Commands: /temp /min_p /top_p /top_k /norepeat /repeat /max_tokens /seed /stats /stop_you /stop_nl /model /cpu /bench_kernels /zones /budget /attn /test_failsafe /ctx /log /save_log /save_dump /gop /render /save_img /draw /reset /version /help\r\n");
     Print(L"----------------------------------------\r\n\r\n");
     
     // Sampling parameters
@@ -2801,20 +3747,37 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
                       config.dim, config.n_layers, config.n_heads, config.n_kv_heads, config.vocab_size, config.seq_len);
                 continue;
             } else if (my_strncmp(prompt, "/cpu", 4) == 0) {
-                CPUFeatures f;
-                djiblas_detect_cpu(&f);
-                sgemm_kernel_t k = djiblas_get_best_kernel(&f);
-                const CHAR16 *name = L"SCALAR";
-                if (k == djiblas_sgemm_avx512) name = L"AVX512";
-                else if (k == djiblas_sgemm_avx2) name = (f.has_fma ? L"AVX2+FMA" : L"AVX2");
-                else if (k == djiblas_sgemm_sse2) name = L"SSE2";
+                // Report the boot-time dispatch table (no CPUID re-run).
+                const CPUFeatures *f = &g_djiblas.cpu;
                 Print(L"\r\nCPU features:\r\n");
-                Print(L"  sse2=%d avx=%d avx2=%d fma=%d\r\n", (int)f.has_sse2, (int)f.has_avx, (int)f.has_avx2, (int)f.has_fma);
-                Print(L"  djiblas_sgemm=%s\r\n", name);
-                const CHAR16 *attn = g_attn_use_avx2 ? L"AVX2" : L"SSE2";
-                if (g_attn_force == 0) attn = L"SSE2 (forced)";
-                else if (g_attn_force == 1) attn = L"AVX2 (forced)";
-                Print(L"  attn_simd=%s\r\n\r\n", attn);
+                Print(L"  sse2=%d avx=%d avx2=%d fma=%d f16c=%d avx512f=%d avx512vl=%d avx512_vnni=%d\r\n",
+                      (int)f->has_sse2, (int)f->has_avx, (int)f->has_avx2, (int)f->has_fma, (int)f->has_f16c,
+                      (int)f->has_avx512f, (int)f->has_avx512vl, (int)f->has_avx512_vnni);
+                Print(L"  djiblas_sgemm=%s\r\n", g_djiblas.sgemm_name);
+                Print(L"  djiblas_gemv=%s\r\n", g_djiblas.gemv_name);
+                Print(L"  gemv_panels=%s (repack=%d)\r\n", g_djiblas.panel_name, g_boot_cfg.repack);
+                Print(L"  dequant=%s\r\n", g_djiblas.dequant_name);
+                Print(L"  gemv_q8=%s gemv_q4=%s\r\n", g_djiblas.q8_name, g_djiblas.q4_name);
+                Print(L"  gemv_q6=%s gemv_q6p=%s int8-act=%s\r\n", g_djiblas.q6_name, g_djiblas.q6p_name,
+                      g_djiblas.gemv_q6_q8 ? g_djiblas.q8_name : L"off");
+                Print(L"  gemv_f16=%s gemv_bf16=%s\r\n", g_djiblas.f16_name, g_djiblas.bf16_name);
+                Print(L"  vmath=%s (softmax/exp_sum/silu) residual_rmsnorm/rope=%s\r\n",
+                      g_djiblas.vmath_name, g_djiblas.norm_name);
+                Print(L"  gemv_stream=%s llc=%d KB (cpuid %d KB) prefetch=%d B %s\r\n", g_djiblas.stream_name,
+                      (int)(g_djiblas.llc_bytes >> 10), (int)(f->llc_bytes >> 10), g_djiblas.stream_pf,
+                      g_djiblas.stream_nta ? L"NTA" : L"T0");
+                Print(L"  autotune=%s (%d shapes)\r\n", g_tune_status, g_tune.n);
+                for (int i = 0; i < g_tune.n; i++) {
+                    const DjibLasTuneEntry *e = &g_tune.e[i];
+                    Print(L"    %a %dx%d gemv=%a gemm=%a block=%d\r\n",
+                          djiblas_tune_type_name(e->type), e->rows, e->cols,
+                          djiblas_tune_gemv_name(e->gemv), djiblas_tune_sgemm_name(e->sgemm), e->row_block);
+                }
+                Print(L"  attn_simd=%s%s\r\n\r\n", g_djiblas.attn_name,
+                      (g_djiblas.attn_force == -1) ? L"" : L" (forced)");
+                continue;
+            } else if (my_strncmp(prompt, "/bench_kernels", 14) == 0) {
+                llmk_bench_kernels();
                 continue;
             } else if (my_strncmp(prompt, "/zones", 6) == 0) {
                 Print(L"\r\nZones:\r\n");
@@ -2840,7 +3803,7 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
                 while (prompt[i] == ' ') i++;
                 if (prompt[i] == 0) {
                     Print(L"\r\nBudgets (cycles):\r\n");
-                    Print(L"  prefill_max=%lu\r\n", g_budget_prefill_cycles);
+                    Print(L"  prefill_max=%lu/tok\r\n", g_budget_prefill_cycles);
                     Print(L"  decode_max=%lu\r\n\r\n", g_budget_decode_cycles);
                     continue;
                 }
@@ -2864,7 +3827,7 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
                 g_budget_prefill_cycles = pre;
                 g_budget_decode_cycles = dec;
                 Print(L"\r\nBudgets set (cycles):\r\n");
-                Print(L"  prefill_max=%lu\r\n", g_budget_prefill_cycles);
+                Print(L"  prefill_max=%lu/tok\r\n", g_budget_prefill_cycles);
                 Print(L"  decode_max=%lu\r\n\r\n", g_budget_decode_cycles);
                 continue;
             } else if (my_strncmp(prompt, "/attn", 5) == 0) {
@@ -2878,28 +3841,27 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
 
                 if (prompt[i] == 0) {
                     Print(L"\r\nAttention SIMD:\r\n");
-                    Print(L"  auto=%s\r\n", g_attn_use_avx2 ? L"AVX2" : L"SSE2");
+                    Print(L"  auto=%s\r\n", g_djiblas.attn_auto_avx2 ? L"AVX2" : L"SSE2");
                     Print(L"  mode=%s\r\n\r\n",
-                          (g_attn_force == -1) ? L"auto" : (g_attn_force == 0 ? L"sse2 (forced)" : L"avx2 (forced)"));
+                          (g_djiblas.attn_force == -1) ? L"auto" : (g_djiblas.attn_force == 0 ? L"sse2 (forced)" : L"avx2 (forced)"));
                     continue;
                 }
 
-                if (prompt[i] == 'a') {
-                    g_attn_force = -1;
-                    Print(L"\r\nOK: attn mode=auto\r\n\r\n");
+                if (my_strncmp(prompt + i, "auto", 4) == 0) {
+                    djiblas_dispatch_force_attn(-1);
+                    Print(L"\r\nOK: attn mode=auto (%s)\r\n\r\n", g_djiblas.attn_name);
                     continue;
                 }
-                if (prompt[i] == 's') {
-                    g_attn_force = 0;
+                if (my_strncmp(prompt + i, "sse2", 4) == 0) {
+                    djiblas_dispatch_force_attn(0);
                     Print(L"\r\nOK: attn mode=sse2 (forced)\r\n\r\n");
                     continue;
                 }
-                if (prompt[i] == 'v') {
-                    if (!g_attn_use_avx2) {
+                if (my_strncmp(prompt + i, "avx2", 4) == 0) {
+                    if (!djiblas_dispatch_force_attn(1)) {
                         Print(L"\r\nERROR: AVX2 attention not available (auto is SSE2)\r\n\r\n");
                         continue;
                     }
-                    g_attn_force = 1;
                     Print(L"\r\nOK: attn mode=avx2 (forced)\r\n\r\n");
                     continue;
                 }
@@ -2961,7 +3923,7 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
                 }
 
                 Print(L"\r\n[test] fail-safe armed (strict_budget=1)\r\n");
-                Print(L"  prefill_max=%lu decode_max=%lu\r\n", g_budget_prefill_cycles, g_budget_decode_cycles);
+                Print(L"  prefill_max=%lu/tok decode_max=%lu\r\n", g_budget_prefill_cycles, g_budget_decode_cycles);
                 Print(L"  Next prompt should trip and auto-dump ctx/zones/sentinel/log.\r\n\r\n");
                 continue;
             } else if (my_strncmp(prompt, "/ctx", 4) == 0) {
@@ -3051,7 +4013,7 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
                            max_gen_tokens);
                     llmk_file_write_u16(f, line);
                     llmk_file_write_u16(f, L"Budgets:\r\n");
-                    SPrint(line, sizeof(line), L"  prefill_max=%lu decode_max=%lu overruns(p=%d d=%d)\r\n\r\n",
+                    SPrint(line, sizeof(line), L"  prefill_max=%lu/tok decode_max=%lu overruns(p=%d d=%d)\r\n\r\n",
                            g_budget_prefill_cycles, g_budget_decode_cycles,
                            (int)g_budget_overruns_prefill, (int)g_budget_overruns_decode);
                     llmk_file_write_u16(f, line);
@@ -3233,6 +4195,7 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
                 Print(L"  /repeat <val> - Set repetition penalty (1.0=none, 1.5=strong)\r\n");
                 Print(L"  /model        - Show loaded model config\r\n");
                 Print(L"  /cpu          - Show CPU SIMD status\r\n");
+                Print(L"  /bench_kernels - Check + time every kernel, save djiblas_bench.csv\r\n");
                 Print(L"  /zones        - Dump allocator zones + sentinel\r\n");
                 Print(L"  /budget [p] [d] - Set budgets in cycles (p=prefill, d=decode)\r\n");
                 Print(L"  /attn [auto|sse2|avx2] - Force attention SIMD path\r\n");
@@ -3284,8 +4247,8 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
         int n_prompt_tokens = 0;
         encode(prompt, prompt_tokens, &n_prompt_tokens, 256, &tokenizer);
         
-        // Check if KV cache will overflow
-        if (kv_pos + n_prompt_tokens + max_gen_tokens > config.seq_len) {
+        // Check if KV cache will overflow (a rolling cache evicts as it goes)
+        if (!state.kv_rolling && kv_pos + n_prompt_tokens + max_gen_tokens > config.seq_len) {
             Print(L"\r\nWARNING: context too long (%d + %d tokens), clearing KV cache\r\n", 
                   kv_pos, n_prompt_tokens + max_gen_tokens);
             reset_kv_cache(&state, &config);
@@ -3301,24 +4264,29 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
             g_budget_overruns_prefill = 0;
             g_budget_overruns_decode = 0;
             if (!g_capture_mode) {
-                Print(L"\r\n[llmk][budget] prefill_max=%lu decode_max=%lu\r\n",
+                Print(L"\r\n[llmk][budget] prefill_max=%lu/tok decode_max=%lu\r\n",
                       g_budget_prefill_cycles, g_budget_decode_cycles);
             }
         }
         
-        // Process prompt tokens through model first (prefill)
-        for (int i = 0; i < n_prompt_tokens; i++) {
+        // Process prompt tokens through model first (prefill), LLMK_PREFILL_BLOCK at a time
+        for (int i = 0; i < n_prompt_tokens; i += LLMK_PREFILL_BLOCK) {
             int pos = kv_pos + i;  // Use persistent KV position
+            int nb = n_prompt_tokens - i;
+            if (nb > LLMK_PREFILL_BLOCK) nb = LLMK_PREFILL_BLOCK;
             if (g_llmk_ready) {
-                // Per-token prefill budgeting (pos-dependent): set budget before each forward.
+                // Per-block prefill budgeting (pos-dependent): the budget is kept per
+                // token and scaled to the block, since blocks run 1..LLMK_PREFILL_BLOCK
+                // tokens and the budget carries over between turns.
                 if (g_budget_prefill_cycles == 0) {
                     // Start huge to ensure we get a first measurement without tripping.
                     // llmk_budget_update() will snap down quickly after the first dt sample.
                     g_budget_prefill_cycles = 100000000000ULL;
                 }
-                g_sentinel.cfg.max_cycles_prefill = g_budget_prefill_cycles;
+                g_sentinel.cfg.max_cycles_prefill = g_budget_prefill_cycles * (UINT64)nb;
                 llmk_sentinel_phase_start(&g_sentinel, LLMK_PHASE_PREFILL);
-                transformer_forward(&state, &weights, &config, prompt_tokens[i], pos);
+                transformer_prefill(&state, &weights, &config, prompt_tokens + i, nb, pos,
+                                    i + nb == n_prompt_tokens);
                 BOOLEAN ok = llmk_sentinel_phase_end(&g_sentinel);
                 if (g_sentinel.tripped) {
                     Print(L"\r\n[llmk] prefill stopped (fail-safe) at i=%d\r\n", i);
@@ -3358,9 +4326,10 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
                               i, g_sentinel.last_dt_cycles, g_sentinel.last_budget_cycles);
                     }
                 }
-                llmk_budget_update(&g_budget_prefill_cycles, g_sentinel.last_dt_cycles);
+                llmk_budget_update(&g_budget_prefill_cycles, g_sentinel.last_dt_cycles / (UINT64)nb);
             } else {
-                transformer_forward(&state, &weights, &config, prompt_tokens[i], i);
+                transformer_prefill(&state, &weights, &config, prompt_tokens + i, nb, pos,
+                                    i + nb == n_prompt_tokens);
             }
         }
         
@@ -3503,7 +4472,7 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
             // Advance position and compute next logits
             token = next;
             pos++;
-            if (pos >= config.seq_len) break;
+            if (pos >= config.seq_len && !state.kv_rolling) break;
 
             if (g_llmk_ready) {
                 if (g_budget_decode_cycles == 0) {
@@ -3570,7 +4539,7 @@ EFI_STATUS EFIAPI efi_main(EFI_HANDLE ImageHandle, EFI_SYSTEM_TABLE *SystemTable
         }
 
         if (g_llmk_ready && !g_capture_mode) {
-            Print(L"\r\n[llmk][budget] final prefill_max=%lu decode_max=%lu overruns(p=%d d=%d)\r\n",
+            Print(L"\r\n[llmk][budget] final prefill_max=%lu/tok decode_max=%lu overruns(p=%d d=%d)\r\n",
                   g_budget_prefill_cycles,
                   g_budget_decode_cycles,
                   (int)g_budget_overruns_prefill,
@@ -3659,3 +4628,4 @@ stats_done:
     
     return EFI_SUCCESS;
 }
+#endif // LLMK_HOSTED